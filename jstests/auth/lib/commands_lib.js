@@ -4001,6 +4001,24 @@ var authCommandsLib = {
               {runOnDb: secondDbName, roles: {}}
           ]
         },
+        {
+          testname: "getDiagnosticDataRange",
+          skipSharded: true,
+          command: {getDiagnosticDataRange: 1},
+          testcases: [
+              {
+                runOnDb: adminDbName,
+                roles: roles_monitoring,
+                privileges: [
+                    {resource: {cluster: true}, actions: ["serverStatus"]},
+                    {resource: {cluster: true}, actions: ["replSetGetStatus"]},
+                    {resource: {db: "local", collection: "oplog.rs"}, actions: ["collStats"]},
+                ]
+              },
+              {runOnDb: firstDbName, roles: {}},
+              {runOnDb: secondDbName, roles: {}}
+          ]
+        },
         {
           testname: "getFreeMonitoringStatus",
           skipSharded: true,
@@ -0,0 +1,68 @@
+// Tests that a batch of inserts into an empty collection, whose index keys are inserted in key
+// order rather than document by document, leaves every kind of index consistent with the
+// documents and reports errors for the right documents.
+//
+// @tags: [
+//   assumes_no_implicit_index_creation,
+//   cannot_create_unique_index_when_using_hashed_shard_key,
+//   requires_fastcount,
+// ]
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    const coll = db.insert_batch_into_empty_collection;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: -1, a: 1}));
+    assert.commandWorked(coll.createIndex({tags: 1}));
+    assert.commandWorked(coll.createIndex({u: 1}, {unique: true, sparse: true}));
+    assert.commandWorked(
+        coll.createIndex({p: 1}, {partialFilterExpression: {a: {$gte: 50}}, name: "p_partial"}));
+
+    const kNumDocs = 100;
+    let docs = [];
+    for (let i = 0; i < kNumDocs; ++i) {
+        // Insert in an order which does not match any of the indexes.
+        const a = (i * 37) % kNumDocs;
+        docs.push({_id: i, a: a, b: a % 7, tags: [a % 3, a % 5], u: a, p: -a});
+    }
+    assert.writeOK(coll.insert(docs));
+    assert.eq(kNumDocs, coll.count());
+
+    // Every index must return every document it covers, in order.
+    function assertIndexScan(hint, filter, expectedCount) {
+        const results = coll.find(filter).hint(hint).toArray();
+        assert.eq(expectedCount, results.length, tojson(hint));
+    }
+    assertIndexScan({a: 1}, {a: {$gte: 0}}, kNumDocs);
+    assertIndexScan({b: -1, a: 1}, {b: {$gte: 0}}, kNumDocs);
+    assertIndexScan({u: 1}, {u: {$gte: 0}}, kNumDocs);
+    assertIndexScan("p_partial", {a: {$gte: 50}, p: {$lte: 0}}, 50);
+    assert.eq(kNumDocs, coll.find({tags: {$gte: 0}}).hint({tags: 1}).itcount());
+
+    const sorted = coll.find({a: {$gte: 0}}, {_id: 0, a: 1}).hint({a: 1}).toArray();
+    for (let i = 0; i < sorted.length; ++i) {
+        assert.eq(i, sorted[i].a, tojson(sorted[i]));
+    }
+
+    // The array field makes its index multikey.
+    const explain = coll.find({tags: 1}).hint({tags: 1}).explain();
+    const ixscan = getPlanStage(explain.queryPlanner.winningPlan, "IXSCAN");
+    assert.neq(null, ixscan, tojson(explain));
+    assert(ixscan.isMultiKey, tojson(ixscan));
+
+    assert.commandWorked(coll.validate(true));
+
+    // A duplicate key within a batch into an empty collection is reported for the right
+    // document, and an ordered batch stops there.
+    coll.drop();
+    assert.commandWorked(coll.createIndex({u: 1}, {unique: true}));
+    const res = coll.insert([{_id: 0, u: 3}, {_id: 1, u: 1}, {_id: 2, u: 3}, {_id: 3, u: 2}]);
+    assert.writeErrorWithCode(res, ErrorCodes.DuplicateKey);
+    assert.eq(2, res.getWriteErrors()[0].index, tojson(res));
+    assert.eq(2, coll.count());
+    assert.commandWorked(coll.validate(true));
+}());
@@ -265,6 +265,7 @@
         },
         getCmdLineOpts: {skip: isUnrelated},
         getDiagnosticData: {skip: isUnrelated},
+        getDiagnosticDataRange: {skip: isUnrelated},
         getFreeMonitoringStatus: {skip: isUnrelated},
         getLastError: {skip: isUnrelated},
         getLog: {skip: isUnrelated},
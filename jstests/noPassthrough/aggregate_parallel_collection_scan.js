@@ -0,0 +1,76 @@
+// Tests that aggregations which begin with a collection scan return the same results when the scan
+// and the stages which follow it are divided between several threads.
+// @tags: [requires_wiredtiger]
+(function() {
+    "use strict";
+
+    load("jstests/aggregation/extras/utils.js");  // For resultsEq.
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.aggregate_parallel_collection_scan;
+    coll.drop();
+
+    const kNumDocs = 5000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < kNumDocs; ++i) {
+        bulk.insert({_id: i, a: i % 7, b: i % 13, tags: ["x" + (i % 3), "y" + (i % 5)]});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Removing a stretch of documents leaves some of the scanned ranges empty.
+    assert.writeOK(coll.remove({_id: {$gte: 1000, $lt: 2000}}));
+
+    const pipelines = [
+        [{$match: {a: {$gte: 3}}}],
+        [{$match: {a: 2}}, {$project: {_id: 0, b: 1}}],
+        [{$addFields: {c: {$add: ["$a", "$b"]}}}, {$match: {c: {$gt: 10}}}],
+        [{$unwind: "$tags"}, {$match: {tags: "y1"}}],
+        [{$group: {_id: "$a", total: {$sum: "$b"}, avg: {$avg: "$b"}, count: {$sum: 1}}}],
+        [
+          {$match: {b: {$lt: 10}}},
+          {$unwind: "$tags"},
+          {$group: {_id: "$tags", max: {$max: "$_id"}, min: {$min: "$a"}}},
+          {$sort: {_id: 1}}
+        ],
+        [{$group: {_id: null, first: {$first: "$_id"}, last: {$last: "$_id"}}}],
+        [{$count: "count"}],
+    ];
+
+    function runPipeline(pipeline) {
+        return coll.aggregate(pipeline, {cursor: {batchSize: 10}}).toArray();
+    }
+
+    function setParallelScanThreads(numThreads) {
+        assert.commandWorked(testDB.adminCommand({
+            setParameter: 1,
+            internalDocumentSourceParallelCursorThreads: numThreads,
+            internalDocumentSourceParallelCursorMinRecords: 1000
+        }));
+    }
+
+    setParallelScanThreads(0);
+    const expected = pipelines.map(runPipeline);
+
+    for (let numThreads of [2, 4, 8]) {
+        setParallelScanThreads(numThreads);
+        pipelines.forEach(function(pipeline, i) {
+            const results = runPipeline(pipeline);
+            assert(resultsEq(expected[i], results), tojson(pipeline));
+        });
+    }
+
+    // A cursor which is killed before it is exhausted stops the scan.
+    setParallelScanThreads(4);
+    const res = assert.commandWorked(testDB.runCommand(
+        {aggregate: coll.getName(), pipeline: [{$match: {a: 1}}], cursor: {batchSize: 2}}));
+    assert.neq(0, res.cursor.id);
+    assert.commandWorked(
+        testDB.runCommand({killCursors: coll.getName(), cursors: [res.cursor.id]}));
+
+    // Queries which match nothing return no results.
+    assert.eq([], runPipeline([{$match: {a: 100}}]));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,59 @@
+// Tests that a blocking sort in a find command can spill to disk when 'allowDiskUse' is set, either
+// explicitly on the command or via the server-wide default, instead of exceeding the memory limit.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    const kMaxBlockingSortBytes = 100 * 1024;
+    const conn = MongoRunner.runMongod(
+        {setParameter: "internalQueryExecMaxBlockingSortBytes=" + kMaxBlockingSortBytes});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.find_sort_allow_disk_use;
+    coll.drop();
+
+    const str = "x".repeat(1024);
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 500; ++i) {
+        bulk.insert({_id: i, a: (i * 7) % 500, str: str});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Without 'allowDiskUse' the sort exceeds the memory limit.
+    assert.commandFailedWithCode(testDB.runCommand({find: coll.getName(), sort: {a: 1}}),
+                                 ErrorCodes.OperationFailed);
+
+    function assertSortedResults(cmdObj, expectedCount) {
+        const res = assert.commandWorked(testDB.runCommand(cmdObj));
+        const docs = new DBCommandCursor(testDB, res).toArray();
+        assert.eq(expectedCount, docs.length);
+        for (let i = 0; i < docs.length; ++i) {
+            assert.eq(i, docs[i].a, docs[i]);
+        }
+    }
+
+    // With 'allowDiskUse' the sort spills and returns every document in order.
+    assertSortedResults({find: coll.getName(), sort: {a: 1}, allowDiskUse: true}, 500);
+    assertSortedResults({find: coll.getName(), sort: {a: 1}, limit: 300, allowDiskUse: true},
+                        300);
+
+    // Explain reports that the sort used disk.
+    const explain = assert.commandWorked(testDB.runCommand({
+        explain: {find: coll.getName(), sort: {a: 1}, allowDiskUse: true},
+        verbosity: "executionStats"
+    }));
+    const sortStage = getPlanStage(explain.executionStats.executionStages, "SORT");
+    assert.neq(null, sortStage, tojson(explain));
+    assert.eq(true, sortStage.usedDisk, tojson(sortStage));
+
+    // The server-wide default applies only when the command does not specify 'allowDiskUse'.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryExecAllowDiskUseByDefault: true}));
+    assertSortedResults({find: coll.getName(), sort: {a: 1}}, 500);
+    assert.commandFailedWithCode(
+        testDB.runCommand({find: coll.getName(), sort: {a: 1}, allowDiskUse: false}),
+        ErrorCodes.OperationFailed);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,66 @@
+// Validate that getDiagnosticDataRange returns the recent FTDC samples held in memory, both from
+// the periodic collectors and from the opt-in high-resolution collectors.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            diagnosticDataCollectionPeriodMillis: 200,
+            diagnosticDataCollectionHighResolutionPeriodMillis: 50,
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+    const adminDb = conn.getDB("admin");
+
+    const startTime = new Date();
+
+    function getRange(cmdObj) {
+        const res = assert.commandWorked(
+            adminDb.runCommand(Object.extend({getDiagnosticDataRange: 1}, cmdObj)));
+        assert.eq(false, res.truncated, tojson(res));
+        for (let i = 1; i < res.data.length; ++i) {
+            assert.lte(res.data[i - 1].start, res.data[i].start, tojson(res.data));
+        }
+        return res.data;
+    }
+
+    // Wait until both kinds of samples have been collected a few times.
+    assert.soon(() => getRange({startTime: startTime}).length >= 5);
+    assert.soon(() => getRange({startTime: startTime, highResolution: true}).length >= 10);
+
+    const periodic = getRange({startTime: startTime});
+    assert(periodic[0].hasOwnProperty("serverStatus"), tojson(periodic[0]));
+    assert(periodic[0].serverStatus.hasOwnProperty("locks"), tojson(periodic[0]));
+
+    // High-resolution samples only contain the cheap serverStatus sections.
+    const highResolution = getRange({startTime: startTime, highResolution: true});
+    assert(highResolution[0].hasOwnProperty("serverStatus"), tojson(highResolution[0]));
+    assert(highResolution[0].serverStatus.hasOwnProperty("opLatencies"),
+           tojson(highResolution[0]));
+    assert(!highResolution[0].serverStatus.hasOwnProperty("locks"),
+           tojson(highResolution[0]));
+
+    // The range is inclusive at both ends.
+    const first = highResolution[0].start;
+    const second = highResolution[1].start;
+    const bounded = getRange({startTime: first, endTime: second, highResolution: true});
+    assert.eq(2, bounded.length, tojson(bounded));
+    assert.eq(first, bounded[0].start);
+    assert.eq(second, bounded[1].start);
+
+    // An empty range returns no samples.
+    assert.eq(0, getRange({startTime: second, endTime: first, highResolution: true}).length);
+
+    assert.commandFailedWithCode(adminDb.runCommand({getDiagnosticDataRange: 1, startTime: 1}),
+                                 ErrorCodes.TypeMismatch);
+
+    // Turning off high-resolution collection stops new high-resolution samples from being taken.
+    assert.commandWorked(adminDb.runCommand(
+        {setParameter: 1, diagnosticDataCollectionHighResolutionPeriodMillis: 0}));
+    assert.commandFailedWithCode(
+        adminDb.runCommand(
+            {setParameter: 1, diagnosticDataCollectionHighResolutionPeriodMillis: 5}),
+        ErrorCodes.BadValue);
+
+    MongoRunner.stopMongod(conn);
+})();
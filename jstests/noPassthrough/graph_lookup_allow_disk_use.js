@@ -0,0 +1,65 @@
+// Tests that a $graphLookup whose search exceeds its memory limit continues the search on disk when
+// 'allowDiskUse' is set, and returns the same results as an in-memory search.
+(function() {
+    "use strict";
+
+    load("jstests/aggregation/extras/utils.js");  // For assertErrorCode and arrayEq.
+
+    const kMaxMemoryBytes = 64 * 1024;
+    const conn = MongoRunner.runMongod(
+        {setParameter: "internalDocumentSourceGraphLookupMaxMemoryBytes=" + kMaxMemoryBytes});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const local = testDB.local;
+    const foreign = testDB.foreign;
+    local.drop();
+    foreign.drop();
+
+    // Build a chain 0 -> 1 -> ... -> 499 whose documents together exceed the memory limit.
+    const kNumNodes = 500;
+    const str = "x".repeat(1024);
+    const bulk = foreign.initializeUnorderedBulkOp();
+    for (let i = 0; i < kNumNodes; ++i) {
+        bulk.insert({_id: i, neighbor: i + 1, str: str});
+    }
+    assert.writeOK(bulk.execute());
+    assert.writeOK(local.insert({_id: 0, start: 0}));
+    assert.writeOK(local.insert({_id: 1, start: kNumNodes - 10}));
+
+    const pipeline = [
+        {
+          $graphLookup: {
+              from: "foreign",
+              startWith: "$start",
+              connectFromField: "neighbor",
+              connectToField: "_id",
+              depthField: "depth",
+              as: "results"
+          }
+        },
+        {$sort: {_id: 1}}
+    ];
+
+    // Without 'allowDiskUse' the search exceeds the memory limit.
+    assertErrorCode(local, pipeline, 40099);
+
+    const results = local.aggregate(pipeline, {allowDiskUse: true}).toArray();
+    assert.eq(2, results.length, tojson(results));
+
+    function assertChainFrom(doc, start) {
+        assert.eq(kNumNodes - start, doc.results.length);
+        const ids = doc.results.map((result) => result._id);
+        const expectedIds = Array.from({length: kNumNodes - start}, (_, i) => start + i);
+        assert(arrayEq(expectedIds, ids));
+        doc.results.forEach((result) => assert.eq(result._id - start, result.depth, result));
+    }
+    assertChainFrom(results[0], 0);
+    assertChainFrom(results[1], kNumNodes - 10);
+
+    // An absorbed $unwind produces one document per visited node.
+    const unwound =
+        local.aggregate([pipeline[0], {$unwind: "$results"}], {allowDiskUse: true}).toArray();
+    assert.eq(kNumNodes + 10, unwound.length);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,57 @@
+// Tests that foreground index builds which generate and sort their keys on several threads produce
+// the same indexes as those built on a single thread.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: {internalIndexBuildKeyGenerationThreads: 4}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.index_build_parallel_key_generation;
+    coll.drop();
+
+    const kNumDocs = 20000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < kNumDocs; ++i) {
+        bulk.insert({_id: i, a: i % 101, b: [i % 7, i % 11], c: "str" + (kNumDocs - i), u: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    function assertIndexMatchesCollectionScan(indexName, keyPattern, query) {
+        const fromIndex = coll.find(query).hint(indexName).sort(keyPattern).toArray();
+        const fromScan = coll.find(query).hint({$natural: 1}).sort(keyPattern).toArray();
+        assert.eq(fromScan.length, fromIndex.length, indexName);
+        assert.eq(fromScan, fromIndex, indexName);
+    }
+
+    // Build several indexes at once, including a multikey index, a partial index and a hashed
+    // index.
+    assert.commandWorked(testDB.runCommand({
+        createIndexes: coll.getName(),
+        indexes: [
+            {key: {a: 1, c: -1}, name: "a_1_c_-1"},
+            {key: {b: 1}, name: "b_1"},
+            {key: {c: 1}, name: "c_1_partial", partialFilterExpression: {a: {$gt: 50}}},
+            {key: {u: "hashed"}, name: "u_hashed"},
+        ]
+    }));
+
+    assertIndexMatchesCollectionScan("a_1_c_-1", {a: 1, c: -1}, {a: {$gte: 10, $lt: 20}});
+    assertIndexMatchesCollectionScan("b_1", {b: 1, _id: 1}, {b: {$in: [3, 5]}});
+    assertIndexMatchesCollectionScan("c_1_partial", {c: 1}, {a: {$gt: 50}, c: {$gte: "str1"}});
+    assert.eq(1, coll.find({u: 12345}).hint("u_hashed").itcount());
+
+    // The multikey index must be marked as such.
+    const explain = coll.find({b: 3}).hint("b_1").explain();
+    assert(tojson(explain).includes('"isMultiKey" : true'), tojson(explain));
+
+    // A unique index build still detects duplicates spread over different threads.
+    assert.commandFailedWithCode(coll.createIndex({a: 1}, {unique: true}),
+                                 ErrorCodes.DuplicateKey);
+    assert.commandWorked(coll.createIndex({u: 1}, {unique: true}));
+
+    const validateRes = assert.commandWorked(coll.validate({full: true}));
+    assert(validateRes.valid, tojson(validateRes));
+
+    MongoRunner.stopMongod(conn);
+}());
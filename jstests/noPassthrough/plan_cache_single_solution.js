@@ -0,0 +1,58 @@
+// Tests that, with 'internalQueryCacheSingleSolutionPlans' enabled, the plan for a query shape with
+// only one candidate solution is cached and reused, and that the time spent planning queries of a
+// cached shape is reported by planCacheListPlans.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: "internalQueryCacheSingleSolutionPlans=true"});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.plan_cache_single_solution;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    for (let i = 0; i < 20; ++i) {
+        assert.writeOK(coll.insert({a: i, b: i, c: i}));
+    }
+
+    function listPlans(query) {
+        return assert.commandWorked(coll.runCommand("planCacheListPlans", {query: query}));
+    }
+
+    // The only index on 'a' yields a single solution, which is cached as an active entry.
+    assert.eq(1, coll.find({a: 3}).itcount());
+    let res = listPlans({a: 3});
+    assert.eq(1, res.plans.length, tojson(res));
+    assert(res.isActive, tojson(res));
+    assert(res.isSingleSolution, tojson(res));
+    assert.eq(1, res.planningTime.timesPlanned, tojson(res));
+
+    // Queries of the same shape with other values reuse the entry and still return the right
+    // results. They use the cached plan, so they are not counted as planning the shape again.
+    assert.eq(1, coll.find({a: 7}).itcount());
+    assert.eq(0, coll.find({a: 100}).itcount());
+    res = listPlans({a: 3});
+    assert.eq(1, res.planningTime.timesPlanned, tojson(res));
+    assert.gte(res.planningTime.totalMicros, res.planningTime.maxMicros, tojson(res));
+
+    // Adding an index clears the cache, and the shape is then planned by the multi-planner.
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+    assert.eq(1, coll.find({a: 3}).itcount());
+    res = listPlans({a: 3});
+    assert.eq(2, res.plans.length, tojson(res));
+    assert(!res.isSingleSolution, tojson(res));
+
+    // Single-solution shapes are not cached when the knob is disabled. The only index on 'c'
+    // yields a single indexed solution.
+    assert.commandWorked(coll.createIndex({c: 1}));
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryCacheSingleSolutionPlans: false}));
+    assert(isIxscan(testDB, coll.find({c: 3}).explain().queryPlanner.winningPlan));
+    assert.eq(1, coll.find({c: 3}).itcount());
+    assert.eq(0, listPlans({c: 3}).plans.length);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,94 @@
+/**
+ * Tests that every document written by a multi-update or a multi-delete on a primary is visible
+ * at exactly the timestamp of its own oplog entry, regardless of how many documents the update
+ * and delete stages are allowed to write together.
+ *
+ * @tags: [requires_replication]
+ */
+(function() {
+    "use strict";
+
+    const dbName = "test";
+    const collName = "coll";
+    const numDocs = 10;
+
+    const rst = new ReplSetTest({
+        nodes: 1,
+        nodeOptions: {setParameter: {internalUpdateDeleteMaxBatchSize: 64}},
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB(dbName);
+    const coll = testDB.getCollection(collName);
+    const oplog = primary.getDB("local").getCollection("oplog.rs");
+
+    if (!testDB.serverStatus().storageEngine.supportsSnapshotReadConcern) {
+        rst.stopSet();
+        return;
+    }
+
+    // Turn off timestamp reaping.
+    assert.commandWorked(testDB.adminCommand({
+        configureFailPoint: "WTPreserveSnapshotHistoryIndefinitely",
+        mode: "alwaysOn",
+    }));
+
+    const session = primary.startSession({causalConsistency: false});
+    const sessionDb = session.getDatabase(dbName);
+    let txnNumber = 0;
+
+    function readAt(atClusterTime) {
+        const res = assert.commandWorked(sessionDb.runCommand({
+            find: collName,
+            sort: {_id: 1},
+            readConcern: {level: "snapshot", atClusterTime: atClusterTime},
+            txnNumber: NumberLong(txnNumber++),
+            singleBatch: true
+        }));
+        return res.cursor.firstBatch;
+    }
+
+    let docs = [];
+    for (let i = 0; i < numDocs; ++i) {
+        docs.push({_id: i, a: 0});
+    }
+    assert.commandWorked(coll.insert(docs));
+
+    // Each oplog entry of the multi-update must have its own timestamp, and a snapshot read at
+    // that timestamp must see exactly the documents whose updates were logged at or before it.
+    assert.commandWorked(coll.updateMany({}, {$set: {a: 1}}));
+    let entries = oplog.find({op: "u", ns: coll.getFullName()}).sort({ts: 1}).toArray();
+    assert.eq(numDocs, entries.length, tojson(entries));
+
+    let updated = new Set();
+    entries.forEach(entry => {
+        updated.add(entry.o2._id);
+        const expected = [];
+        for (let i = 0; i < numDocs; ++i) {
+            expected.push({_id: i, a: updated.has(i) ? 1 : 0});
+        }
+        assert.eq(expected, readAt(entry.ts), tojson(entry));
+    });
+
+    // Likewise for a multi-delete.
+    assert.commandWorked(coll.deleteMany({}));
+    entries = oplog.find({op: "d", ns: coll.getFullName()}).sort({ts: 1}).toArray();
+    assert.eq(numDocs, entries.length, tojson(entries));
+
+    let deleted = new Set();
+    entries.forEach(entry => {
+        deleted.add(entry.o._id);
+        const expected = [];
+        for (let i = 0; i < numDocs; ++i) {
+            if (!deleted.has(i)) {
+                expected.push({_id: i, a: 1});
+            }
+        }
+        assert.eq(expected, readAt(entry.ts), tojson(entry));
+    });
+
+    session.endSession();
+    rst.stopSet();
+}());
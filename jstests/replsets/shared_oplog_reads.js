@@ -0,0 +1,120 @@
+/**
+ * Tests that tailable oplog scans under majority read concern exchange the entries they read
+ * through the shared oplog read buffer when 'internalQueryExecShareOplogReads' is enabled: a scan
+ * which trails another is served from the buffer, continues from the oplog once the buffer runs
+ * out, and reads the oplog itself once it has fallen behind the window the buffer holds.
+ *
+ * @tags: [requires_replication, requires_majority_read_concern]
+ */
+load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+load("jstests/replsets/rslib.js");       // For startSetIfSupportsReadMajority.
+
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({
+        nodes: 1,
+        nodeOptions: {
+            enableMajorityReadConcern: "",
+            setParameter: {internalQueryExecShareOplogReads: true},
+        },
+    });
+    if (!startSetIfSupportsReadMajority(rst)) {
+        jsTest.log("skipping test since storage engine doesn't support committed reads");
+        rst.stopSet();
+        return;
+    }
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const coll = primary.getDB("test").shared_oplog_reads;
+    const localDB = primary.getDB("local");
+
+    // Profile the getMores on the oplog, whose execution stats report the number of entries each
+    // cursor took from the buffer.
+    assert.commandWorked(localDB.setProfilingLevel(2));
+
+    let nextId = 0;
+    function insertDocs(count) {
+        const ids = [];
+        for (let i = 0; i < count; ++i) {
+            assert.writeOK(coll.insert({_id: nextId}, {writeConcern: {w: "majority"}}));
+            ids.push(nextId++);
+        }
+        return ids;
+    }
+
+    function openOplogCursor(startTs) {
+        const res = assert.commandWorked(localDB.runCommand({
+            find: "oplog.rs",
+            filter: {ts: {$gte: startTs}},
+            tailable: true,
+            awaitData: true,
+            oplogReplay: true,
+            batchSize: 1,
+            readConcern: {level: "majority"},
+        }));
+        assert.eq(1, res.cursor.firstBatch.length, tojson(res));
+        return res.cursor.id;
+    }
+
+    // Runs getMores on 'cursorId' until the inserts of every document in 'ids' have been returned,
+    // and asserts that they are returned in order.
+    function readInserts(cursorId, ids) {
+        const seen = [];
+        assert.soon(function() {
+            const res = assert.commandWorked(localDB.runCommand(
+                {getMore: cursorId, collection: "oplog.rs", maxTimeMS: 1000}));
+            for (let entry of res.cursor.nextBatch) {
+                if (entry.op === "i" && entry.ns === coll.getFullName()) {
+                    seen.push(entry.o._id);
+                }
+            }
+            return seen.length >= ids.length;
+        });
+        assert.eq(ids, seen);
+    }
+
+    // Returns the number of oplog entries the cursor 'cursorId' has taken from the buffer so far.
+    function sharedEntriesReturned(cursorId) {
+        const entry = localDB.system.profile.find({"command.getMore": cursorId})
+                          .sort({$natural: -1})
+                          .limit(1)
+                          .next();
+        const collScan = getPlanStage(entry.execStats, "COLLSCAN");
+        assert.neq(null, collScan, tojson(entry));
+        return collScan.sharedOplogEntriesReturned || 0;
+    }
+
+    insertDocs(1);
+    const startTs = localDB.oplog.rs.find().sort({$natural: -1}).limit(1).next().ts;
+    const leader = openOplogCursor(startTs);
+    const follower = openOplogCursor(startTs);
+
+    // The leader reads the new entries from the oplog and publishes them. The follower, positioned
+    // where the window starts, takes them from the buffer.
+    let ids = insertDocs(10);
+    readInserts(leader, ids);
+    assert.eq(0, sharedEntriesReturned(leader));
+    readInserts(follower, ids);
+    assert.gte(sharedEntriesReturned(follower), ids.length);
+
+    // Once the buffer is exhausted, the follower goes back to reading the oplog itself, from where
+    // the buffer left it, and now extends the window for the leader.
+    ids = insertDocs(5);
+    readInserts(follower, ids);
+    readInserts(leader, ids);
+    assert.gte(sharedEntriesReturned(leader), ids.length);
+
+    // A window too small to reach back to the follower's position does not serve it, and the
+    // follower reads the oplog itself without missing any entries.
+    assert.commandWorked(
+        primary.adminCommand({setParameter: 1, internalQueryExecSharedOplogReadBufferBytes: 1}));
+    ids = insertDocs(10);
+    readInserts(leader, ids);
+    const sharedBefore = sharedEntriesReturned(follower);
+    readInserts(follower, ids);
+    assert.eq(sharedBefore, sharedEntriesReturned(follower));
+
+    rst.stopSet();
+})();
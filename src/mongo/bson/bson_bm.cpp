@@ -0,0 +1,214 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * The document shapes exercised by the benchmarks below. Each benchmark takes the shape as its
+ * first argument.
+ */
+enum DocumentShape : int {
+    // A flat document of mixed scalar types, like a typical user or session record.
+    kFlat = 0,
+    // An order with an embedded address subdocument and an array of line item subdocuments.
+    kNested = 1,
+    // A time series bucket holding a long array of numeric samples.
+    kLargeArray = 2,
+};
+
+const char* shapeName(int shape) {
+    switch (shape) {
+        case kFlat:
+            return "flat";
+        case kNested:
+            return "nested";
+        case kLargeArray:
+            return "large array";
+    }
+    MONGO_UNREACHABLE;
+}
+
+void appendFlat(BSONObjBuilder* bob, int i) {
+    bob->append("_id", OID::gen());
+    bob->append("userId", i);
+    bob->append("name", "Firstname Lastname");
+    bob->append("email", "firstname.lastname@example.com");
+    bob->append("active", i % 2 == 0);
+    bob->append("score", i * 1.5);
+    bob->append("visits", static_cast<long long>(i) * 1000);
+    bob->appendDate("createdAt", Date_t::fromMillisSinceEpoch(1500000000000LL + i));
+    bob->appendDate("updatedAt", Date_t::fromMillisSinceEpoch(1500000000000LL + 2 * i));
+    bob->appendNull("deletedAt");
+}
+
+void appendNested(BSONObjBuilder* bob, int i) {
+    bob->append("_id", OID::gen());
+    bob->append("orderId", static_cast<long long>(i));
+    bob->append("status", "shipped");
+    {
+        BSONObjBuilder address(bob->subobjStart("shippingAddress"));
+        address.append("street", "1633 Broadway");
+        address.append("city", "New York");
+        address.append("state", "NY");
+        address.append("zip", "10019");
+        {
+            BSONObjBuilder geo(address.subobjStart("location"));
+            geo.append("type", "Point");
+            geo.append("coordinates", BSON_ARRAY(-73.985 << 40.761));
+        }
+    }
+    {
+        BSONArrayBuilder items(bob->subarrayStart("items"));
+        for (int item = 0; item < 10; ++item) {
+            BSONObjBuilder itemBob(items.subobjStart());
+            itemBob.append("sku", item * 1000 + i % 1000);
+            itemBob.append("description", "An item in the order");
+            itemBob.append("quantity", 1 + item % 3);
+            itemBob.append("price", 9.99 * (item + 1));
+        }
+    }
+    bob->appendDate("orderedAt", Date_t::fromMillisSinceEpoch(1500000000000LL + i));
+}
+
+void appendLargeArray(BSONObjBuilder* bob, int i) {
+    bob->append("_id", OID::gen());
+    bob->append("sensorId", i);
+    bob->appendDate("start", Date_t::fromMillisSinceEpoch(1500000000000LL + i));
+    BSONArrayBuilder samples(bob->subarrayStart("samples"));
+    for (int sample = 0; sample < 1000; ++sample) {
+        samples.append(20.0 + (sample % 100) * 0.1);
+    }
+}
+
+void appendDocument(BSONObjBuilder* bob, int shape, int i) {
+    switch (shape) {
+        case kFlat:
+            appendFlat(bob, i);
+            return;
+        case kNested:
+            appendNested(bob, i);
+            return;
+        case kLargeArray:
+            appendLargeArray(bob, i);
+            return;
+    }
+    MONGO_UNREACHABLE;
+}
+
+BSONObj makeDocument(int shape) {
+    BSONObjBuilder bob;
+    appendDocument(&bob, shape, 0);
+    return bob.obj();
+}
+
+/**
+ * Counts every element in 'obj', descending into subdocuments and arrays.
+ */
+size_t countElements(const BSONObj& obj) {
+    size_t count = 0;
+    for (auto&& elem : obj) {
+        ++count;
+        if (elem.isABSONObj()) {
+            count += countElements(elem.Obj());
+        }
+    }
+    return count;
+}
+
+void BM_BSONObjBuilder(benchmark::State& state) {
+    const int shape = state.range(0);
+    state.SetLabel(shapeName(shape));
+
+    size_t bytes = 0;
+    int i = 0;
+    for (auto keepRunning : state) {
+        BSONObjBuilder bob;
+        appendDocument(&bob, shape, i++);
+        BSONObj obj = bob.obj();
+        bytes += obj.objsize();
+        benchmark::DoNotOptimize(obj.objdata());
+    }
+    state.SetBytesProcessed(bytes);
+}
+
+void BM_BSONObjIterate(benchmark::State& state) {
+    const BSONObj obj = makeDocument(state.range(0));
+    state.SetLabel(shapeName(state.range(0)));
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(countElements(obj));
+    }
+    state.SetBytesProcessed(state.iterations() * obj.objsize());
+}
+
+void BM_BSONObjGetField(benchmark::State& state) {
+    const BSONObj obj = makeDocument(state.range(0));
+    state.SetLabel(shapeName(state.range(0)));
+
+    // Look up the last top-level field, which requires a scan over every other field.
+    StringData lastField;
+    for (auto&& elem : obj) {
+        lastField = elem.fieldNameStringData();
+    }
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(obj.getField(lastField));
+    }
+}
+
+void BM_ValidateBSON(benchmark::State& state) {
+    const BSONObj obj = makeDocument(state.range(0));
+    state.SetLabel(shapeName(state.range(0)));
+
+    for (auto keepRunning : state) {
+        Status status = validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest);
+        if (!status.isOK()) {
+            state.SkipWithError(status.reason().c_str());
+            return;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * obj.objsize());
+}
+
+BENCHMARK(BM_BSONObjBuilder)->ArgName("shape")->DenseRange(kFlat, kLargeArray);
+BENCHMARK(BM_BSONObjIterate)->ArgName("shape")->DenseRange(kFlat, kLargeArray);
+BENCHMARK(BM_BSONObjGetField)->ArgName("shape")->DenseRange(kFlat, kLargeArray);
+BENCHMARK(BM_ValidateBSON)->ArgName("shape")->DenseRange(kFlat, kLargeArray);
+
+}  // namespace
+}  // namespace mongo
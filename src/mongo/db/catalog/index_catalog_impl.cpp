@@ -61,6 +61,7 @@
 #include "mongo/db/query/collation/collation_spec.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
@@ -1371,10 +1372,24 @@ const IndexDescriptor* IndexCatalogImpl::refreshEntry(OperationContext* opCtx,
 Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
                                                IndexCatalogEntry* index,
                                                const std::vector<BsonRecord>& bsonRecords,
+                                               bool insertInKeyOrder,
                                                int64_t* keysInsertedOut) {
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
+    if (insertInKeyOrder && bsonRecords.size() > 1) {
+        int64_t inserted;
+        Status status =
+            index->accessMethod()->insertBatchInKeyOrder(opCtx, bsonRecords, options, &inserted);
+        if (!status.isOK())
+            return status;
+
+        if (keysInsertedOut) {
+            *keysInsertedOut += inserted;
+        }
+        return Status::OK();
+    }
+
     for (auto bsonRecord : bsonRecords) {
         int64_t inserted;
         invariant(bsonRecord.id != RecordId());
@@ -1400,10 +1415,11 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
 Status IndexCatalogImpl::_indexRecords(OperationContext* opCtx,
                                        IndexCatalogEntry* index,
                                        const std::vector<BsonRecord>& bsonRecords,
+                                       bool insertInKeyOrder,
                                        int64_t* keysInsertedOut) {
     const MatchExpression* filter = index->getFilterExpression();
     if (!filter)
-        return _indexFilteredRecords(opCtx, index, bsonRecords, keysInsertedOut);
+        return _indexFilteredRecords(opCtx, index, bsonRecords, insertInKeyOrder, keysInsertedOut);
 
     std::vector<BsonRecord> filteredBsonRecords;
     for (auto bsonRecord : bsonRecords) {
@@ -1411,7 +1427,8 @@ Status IndexCatalogImpl::_indexRecords(OperationContext* opCtx,
             filteredBsonRecords.push_back(bsonRecord);
     }
 
-    return _indexFilteredRecords(opCtx, index, filteredBsonRecords, keysInsertedOut);
+    return _indexFilteredRecords(
+        opCtx, index, filteredBsonRecords, insertInKeyOrder, keysInsertedOut);
 }
 
 Status IndexCatalogImpl::_unindexRecord(OperationContext* opCtx,
@@ -1455,9 +1472,17 @@ Status IndexCatalogImpl::indexRecords(OperationContext* opCtx,
         *keysInsertedOut = 0;
     }
 
+    // When the batch makes up the whole collection, as it does when a restore or a load into a new
+    // collection starts, the indexes are empty and inserting the batch's keys in key order appends
+    // to them rather than inserting at random points. The record count is only a heuristic here,
+    // since concurrent inserts into the collection are not excluded.
+    const bool insertInKeyOrder = bsonRecords.size() > 1 &&
+        internalInsertIndexKeysInOrderWhenEmpty.load() &&
+        _collection->numRecords(opCtx) == bsonRecords.size();
+
     for (IndexCatalogEntryContainer::const_iterator i = _entries.begin(); i != _entries.end();
          ++i) {
-        Status s = _indexRecords(opCtx, i->get(), bsonRecords, keysInsertedOut);
+        Status s = _indexRecords(opCtx, i->get(), bsonRecords, insertInKeyOrder, keysInsertedOut);
         if (!s.isOK())
             return s;
     }
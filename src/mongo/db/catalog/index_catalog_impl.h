@@ -390,11 +390,13 @@ private:
     Status _indexFilteredRecords(OperationContext* opCtx,
                                  IndexCatalogEntry* index,
                                  const std::vector<BsonRecord>& bsonRecords,
+                                 bool insertInKeyOrder,
                                  int64_t* keysInsertedOut);
 
     Status _indexRecords(OperationContext* opCtx,
                          IndexCatalogEntry* index,
                          const std::vector<BsonRecord>& bsonRecords,
+                         bool insertInKeyOrder,
                          int64_t* keysInsertedOut);
 
     Status _unindexRecord(OperationContext* opCtx,
@@ -32,6 +32,8 @@
 
 #include "mongo/db/catalog/index_create_impl.h"
 
+#include <deque>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/base/init.h"
 #include "mongo/client/dbclientinterface.h"
@@ -44,6 +46,7 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/multikey_paths.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/multi_key_path_tracker.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/operation_context.h"
@@ -51,7 +54,10 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -94,6 +100,168 @@ public:
 
 } exportedMaxIndexBuildMemoryUsageParameter;
 
+MONGO_EXPORT_SERVER_PARAMETER(internalIndexBuildKeyGenerationThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "internalIndexBuildKeyGenerationThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
+namespace {
+
+/**
+ * Generates the index keys of the documents scanned by a foreground index build on a set of worker
+ * threads. Documents are handed to the workers in batches, and each worker inserts the keys it
+ * generates into its own partition of the bulk builders, so no two workers share a sorter.
+ */
+class ParallelKeyGenerator {
+    MONGO_DISALLOW_COPYING(ParallelKeyGenerator);
+
+public:
+    using InsertFn =
+        stdx::function<Status(size_t partition, const BSONObj& doc, const RecordId& loc)>;
+
+    ParallelKeyGenerator(size_t numThreads, InsertFn insertFn) : _insertFn(std::move(insertFn)) {
+        for (size_t partition = 0; partition < numThreads; ++partition) {
+            _workers.emplace_back([this, partition] { _run(partition); });
+        }
+    }
+
+    ~ParallelKeyGenerator() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _cancelled = true;
+        }
+        _workAvailable.notify_all();
+        _spaceAvailable.notify_all();
+        _joinWorkers();
+    }
+
+    /**
+     * Queues 'doc' to have its keys generated. Returns the first error encountered by any worker.
+     */
+    Status add(const BSONObj& doc, const RecordId& loc) {
+        _batchBytes += doc.objsize();
+        _batch.emplace_back(doc.getOwned(), loc);
+        if (_batch.size() < kMaxBatchDocuments && _batchBytes < kMaxBatchBytes) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            return _status;
+        }
+        return _flush();
+    }
+
+    /**
+     * Waits until the keys of every document added so far have been generated.
+     */
+    Status finish() {
+        if (!_batch.empty()) {
+            _flush().ignore();
+        }
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _noMoreBatches = true;
+        }
+        _workAvailable.notify_all();
+        _joinWorkers();
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _status;
+    }
+
+private:
+    using Batch = std::vector<std::pair<BSONObj, RecordId>>;
+
+    static constexpr size_t kMaxBatchDocuments = 1000;
+    static constexpr size_t kMaxBatchBytes = 16 * 1024 * 1024;
+    static constexpr size_t kMaxQueuedBatchesPerWorker = 2;
+
+    Status _flush() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _spaceAvailable.wait(lk, [&] {
+            return !_status.isOK() || _queue.size() < _workers.size() * kMaxQueuedBatchesPerWorker;
+        });
+        if (_status.isOK()) {
+            _queue.push_back(std::move(_batch));
+            _workAvailable.notify_one();
+        }
+        _batch = Batch();
+        _batchBytes = 0;
+        return _status;
+    }
+
+    void _run(size_t partition) {
+        while (true) {
+            Batch batch;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _workAvailable.wait(lk, [&] {
+                    return !_queue.empty() || _noMoreBatches || _cancelled || !_status.isOK();
+                });
+                if (_queue.empty() || _cancelled || !_status.isOK()) {
+                    return;
+                }
+                batch = std::move(_queue.front());
+                _queue.pop_front();
+            }
+            _spaceAvailable.notify_one();
+
+            Status status = Status::OK();
+            try {
+                for (auto&& entry : batch) {
+                    status = _insertFn(partition, entry.first, entry.second);
+                    if (!status.isOK()) {
+                        break;
+                    }
+                }
+            } catch (const DBException& ex) {
+                status = ex.toStatus();
+            }
+
+            if (!status.isOK()) {
+                {
+                    stdx::lock_guard<stdx::mutex> lk(_mutex);
+                    if (_status.isOK()) {
+                        _status = status;
+                    }
+                }
+                _workAvailable.notify_all();
+                _spaceAvailable.notify_all();
+                return;
+            }
+        }
+    }
+
+    void _joinWorkers() {
+        for (auto&& worker : _workers) {
+            worker.join();
+        }
+        _workers.clear();
+    }
+
+    const InsertFn _insertFn;
+
+    // Only accessed by the thread which adds documents.
+    Batch _batch;
+    size_t _batchBytes = 0;
+    std::vector<stdx::thread> _workers;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;
+    stdx::condition_variable _spaceAvailable;
+    std::deque<Batch> _queue;
+    bool _noMoreBatches = false;
+    bool _cancelled = false;
+    Status _status = Status::OK();
+};
+
+constexpr size_t ParallelKeyGenerator::kMaxBatchDocuments;
+constexpr size_t ParallelKeyGenerator::kMaxBatchBytes;
+constexpr size_t ParallelKeyGenerator::kMaxQueuedBatchesPerWorker;
+
+}  // namespace
+
 
 /**
  * On rollback sets MultiIndexBlockImpl::_needToCleanup to true.
@@ -219,10 +387,14 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
     if (!status.isOK())
         return status;
 
+    // Key generation for these index types is known to be safe to run on several threads at once.
+    bool canGenerateKeysInParallel = !_collection->getDefaultCollator();
     for (size_t i = 0; i < indexSpecs.size(); i++) {
         BSONObj info = indexSpecs[i];
 
         string pluginName = IndexNames::findPluginName(info["key"].Obj());
+        canGenerateKeysInParallel = canGenerateKeysInParallel && !info.hasField("collation") &&
+            (pluginName == IndexNames::BTREE || pluginName == IndexNames::HASHED);
         if (pluginName.size()) {
             Status s = _collection->getIndexCatalog()->_upgradeDatabaseMinorVersionIfNeeded(
                 _opCtx, pluginName);
@@ -234,6 +406,11 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         _buildInBackground = (_buildInBackground && initBackgroundIndexFromSpec(info));
     }
 
+    if (!_buildInBackground && canGenerateKeysInParallel) {
+        _numKeyGenerationThreads =
+            static_cast<size_t>(std::max(1, internalIndexBuildKeyGenerationThreads.load()));
+    }
+
     std::vector<BSONObj> indexInfoObjs;
     indexInfoObjs.reserve(indexSpecs.size());
     std::size_t eachIndexBuildMaxMemoryUsageBytes = 0;
@@ -267,7 +444,8 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         if (!_buildInBackground) {
             // Bulk build process requires foreground building as it assumes nothing is changing
             // under it.
-            index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes);
+            index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes,
+                                                  _numKeyGenerationThreads);
         }
 
         const IndexDescriptor* descriptor = index.block->getEntry()->descriptor();
@@ -282,6 +460,8 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         if (index.bulk)
             log() << "\t building index using bulk method; build may temporarily use up to "
                   << eachIndexBuildMaxMemoryUsageBytes / 1024 / 1024 << " megabytes of RAM";
+        if (_numKeyGenerationThreads > 1)
+            log() << "\t generating index keys on " << _numKeyGenerationThreads << " threads";
 
         index.filterExpression = index.block->getEntry()->getFilterExpression();
 
@@ -353,6 +533,15 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
     auto exec =
         InternalPlanner::collectionScan(_opCtx, _collection->ns().ns(), _collection, yieldPolicy);
 
+    // Foreground builds may generate and sort keys on other threads while this one scans.
+    boost::optional<ParallelKeyGenerator> keyGenerator;
+    if (_numKeyGenerationThreads > 1) {
+        keyGenerator.emplace(_numKeyGenerationThreads,
+                             [this](size_t partition, const BSONObj& doc, const RecordId& loc) {
+                                 return insertIntoPartition(partition, doc, loc);
+                             });
+    }
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -384,7 +573,8 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
             progress->setTotalWhileRunning(_collection->numRecords(_opCtx));
 
             WriteUnitOfWork wunit(_opCtx);
-            Status ret = insert(objToIndex.value(), loc);
+            Status ret = keyGenerator ? keyGenerator->add(objToIndex.value(), loc)
+                                      : insert(objToIndex.value(), loc);
             if (_buildInBackground)
                 exec->saveState();
             if (ret.isOK()) {
@@ -429,6 +619,13 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
         return WorkingSetCommon::getMemberObjectStatus(objToIndex.value());
     }
 
+    if (keyGenerator) {
+        Status status = keyGenerator->finish();
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
     if (MONGO_FAIL_POINT(hangAfterStartingIndexBuildUnlocked)) {
         // Unlock before hanging so replication recognizes we've completed.
         Locker::LockSnapshot lockInfo;
@@ -481,6 +678,22 @@ Status MultiIndexBlockImpl::insert(const BSONObj& doc, const RecordId& loc) {
     return Status::OK();
 }
 
+Status MultiIndexBlockImpl::insertIntoPartition(size_t partition,
+                                               const BSONObj& doc,
+                                               const RecordId& loc) {
+    for (auto&& index : _indexes) {
+        if (index.filterExpression && !index.filterExpression->matchesBSON(doc)) {
+            continue;
+        }
+
+        Status status = index.bulk->insertIntoPartition(partition, doc, loc, index.options);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    return Status::OK();
+}
+
 Status MultiIndexBlockImpl::doneInserting(std::set<RecordId>* dupsOut) {
     invariant(!_opCtx->lockState()->inAWriteUnitOfWork());
     for (size_t i = 0; i < _indexes.size(); i++) {
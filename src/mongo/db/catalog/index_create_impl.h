@@ -204,6 +204,12 @@ private:
 
     virtual bool initBackgroundIndexFromSpec(const BSONObj& spec) const = 0;
 
+    /**
+     * Inserts the keys of 'doc' into the given partition of every index's bulk builder. May be
+     * called concurrently for different partitions.
+     */
+    Status insertIntoPartition(size_t partition, const BSONObj& doc, const RecordId& loc);
+
     std::vector<IndexToBuild> _indexes;
 
     std::unique_ptr<BackgroundOperation> _backgroundOperation;
@@ -216,6 +222,10 @@ private:
     bool _allowInterruption;
     bool _ignoreUnique;
 
+    // The number of threads which generate and sort index keys while a foreground build scans the
+    // collection. Each has its own partition of every index's bulk builder.
+    size_t _numKeyGenerationThreads = 1;
+
     bool _needToCleanup;
 };
 
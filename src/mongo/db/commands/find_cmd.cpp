@@ -44,6 +44,7 @@
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/server_parameters.h"
@@ -58,6 +59,16 @@ namespace {
 
 const auto kTermField = "term"_sd;
 
+/**
+ * Blocking sorts may spill to disk if the find command asks for it, or, when the command does not
+ * say either way, if 'internalQueryExecAllowDiskUseByDefault' is set.
+ */
+void applyAllowDiskUseDefault(const BSONObj& cmdObj, QueryRequest* qr) {
+    if (!cmdObj.hasField(QueryRequest::kAllowDiskUseField)) {
+        qr->setAllowDiskUse(internalQueryExecAllowDiskUseByDefault.load());
+    }
+}
+
 /**
  * A command for running .find() queries.
  */
@@ -147,6 +158,7 @@ public:
         if (!qrStatus.isOK()) {
             return qrStatus.getStatus();
         }
+        applyAllowDiskUseDefault(cmdObj, qrStatus.getValue().get());
 
         // Finish the parsing step by using the QueryRequest to create a CanonicalQuery.
         const ExtensionsCallbackReal extensionsCallback(opCtx, &nss);
@@ -231,6 +243,7 @@ public:
         auto qrStatus = QueryRequest::makeFromFindCommand(
             NamespaceString(parseNs(dbname, cmdObj)), cmdObj, isExplain);
         uassertStatusOK(qrStatus.getStatus());
+        applyAllowDiskUseDefault(cmdObj, qrStatus.getValue().get());
 
         auto replCoord = repl::ReplicationCoordinator::get(opCtx);
         auto& qr = qrStatus.getValue();
@@ -444,6 +444,14 @@ Status PlanCacheListPlans::list(OperationContext* opCtx,
     // Append whether or not the entry is active.
     bob->append("isActive", entry->isActive);
     bob->append("works", static_cast<long long>(entry->works));
+    bob->append("isSingleSolution", entry->isSingleSolution);
+
+    // Append the time spent planning queries of this shape which offered their plan to the cache.
+    BSONObjBuilder planningTimeBob(bob->subobjStart("planningTime"));
+    planningTimeBob.append("timesPlanned", entry->timesPlanned);
+    planningTimeBob.append("totalMicros", durationCount<Microseconds>(entry->totalPlanningTime));
+    planningTimeBob.append("maxMicros", durationCount<Microseconds>(entry->maxPlanningTime));
+    planningTimeBob.doneFast();
 
     return Status::OK();
 }
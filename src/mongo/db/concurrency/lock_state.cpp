@@ -35,6 +35,7 @@
 #include <vector>
 
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/new.h"
@@ -243,6 +244,38 @@ void CondVarLockGrantNotification::notify(ResourceId resId, LockResult result) {
 
 namespace {
 TicketHolder* ticketHolders[LockModesCount] = {};
+
+// Operations which have yielded their locks at least this many times are treated as long running.
+// When they next take the global lock they first wait up to 'lowPriorityTicketMaxWaitMillis' for
+// more than 'lowPriorityTicketReservePercent' of the tickets to be available, so that shorter
+// operations are admitted ahead of them, and then wait for a ticket like any other operation. A
+// value of 0, the default, treats every operation alike.
+MONGO_EXPORT_SERVER_PARAMETER(lowPriorityTicketYieldThreshold, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "lowPriorityTicketYieldThreshold must not be negative");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(lowPriorityTicketMaxWaitMillis, int, 100)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "lowPriorityTicketMaxWaitMillis must not be negative");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(lowPriorityTicketReservePercent, int, 10)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > 100) {
+            return Status(ErrorCodes::BadValue,
+                          "lowPriorityTicketReservePercent must be between 0 and 100");
+        }
+        return Status::OK();
+    });
 }  // namespace
 
 
@@ -319,14 +352,18 @@ LockResult LockerImpl<IsForMMAPV1>::lockGlobal(OperationContext* opCtx, LockMode
 template <bool IsForMMAPV1>
 void LockerImpl<IsForMMAPV1>::reacquireTicket(OperationContext* opCtx) {
     invariant(_modeForTicket != MODE_NONE);
-    auto acquireTicketResult = _acquireTicket(opCtx, _modeForTicket, Date_t::max());
+    // The operation waiting to reacquire its ticket was already admitted once, so it is never
+    // deprioritized.
+    auto acquireTicketResult =
+        _acquireTicket(opCtx, _modeForTicket, Date_t::max(), false /* mayDeprioritize */);
     invariant(acquireTicketResult == LOCK_OK);
 }
 
 template <bool IsForMMAPV1>
 LockResult LockerImpl<IsForMMAPV1>::_acquireTicket(OperationContext* opCtx,
                                                    LockMode mode,
-                                                   Date_t deadline) {
+                                                   Date_t deadline,
+                                                   bool mayDeprioritize) {
     const bool reader = isSharedLockMode(mode);
     auto holder = shouldAcquireTicket() ? ticketHolders[mode] : nullptr;
     if (holder) {
@@ -334,10 +371,23 @@ LockResult LockerImpl<IsForMMAPV1>::_acquireTicket(OperationContext* opCtx,
 
         // If the ticket wait is interrupted, restore the state of the client.
         auto restoreStateOnErrorGuard = MakeGuard([&] { _clientState.store(kInactive); });
-        if (deadline == Date_t::max()) {
-            holder->waitForTicket(opCtx);
-        } else if (!holder->waitForTicketUntil(opCtx, deadline)) {
-            return LOCK_TIMEOUT;
+        const int lowPriorityThreshold = lowPriorityTicketYieldThreshold.load();
+        bool acquired = false;
+        if (mayDeprioritize && lowPriorityThreshold > 0 && _numYields >= lowPriorityThreshold) {
+            // Bound the time spent at low priority, so that a long running operation cannot be
+            // starved by a steady stream of shorter ones.
+            const int reserved = holder->outof() * lowPriorityTicketReservePercent.load() / 100;
+            const Date_t lowPriorityDeadline = std::min(
+                deadline, Date_t::now() + Milliseconds(lowPriorityTicketMaxWaitMillis.load()));
+            acquired = holder->waitForLowPriorityTicketUntil(opCtx, lowPriorityDeadline, reserved);
+        }
+
+        if (!acquired) {
+            if (deadline == Date_t::max()) {
+                holder->waitForTicket(opCtx);
+            } else if (!holder->waitForTicketUntil(opCtx, deadline)) {
+                return LOCK_TIMEOUT;
+            }
         }
         restoreStateOnErrorGuard.Dismiss();
     }
@@ -351,7 +401,8 @@ LockResult LockerImpl<IsForMMAPV1>::_lockGlobalBegin(OperationContext* opCtx,
                                                      Date_t deadline) {
     dassert(isLocked() == (_modeForTicket != MODE_NONE));
     if (_modeForTicket == MODE_NONE) {
-        auto acquireTicketResult = _acquireTicket(opCtx, mode, deadline);
+        auto acquireTicketResult =
+            _acquireTicket(opCtx, mode, deadline, true /* mayDeprioritize */);
         if (acquireTicketResult != LOCK_OK) {
             return acquireTicketResult;
         }
@@ -692,6 +743,7 @@ bool LockerImpl<IsForMMAPV1>::saveLockStateAndUnlock(Locker::LockSnapshot* state
     // Sort locks by ResourceId. They'll later be acquired in this canonical locking order.
     std::sort(stateOut->locks.begin(), stateOut->locks.end());
 
+    ++_numYields;
     return true;
 }
 
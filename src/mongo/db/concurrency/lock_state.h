@@ -301,9 +301,13 @@ private:
 
     /**
      * Acquires a ticket for the Locker under 'mode'. Returns LOCK_TIMEOUT if it cannot acquire a
-     * ticket within 'deadline'.
+     * ticket within 'deadline'. If 'mayDeprioritize' is true, an operation which has yielded often
+     * first waits at low priority for a bounded time.
      */
-    LockResult _acquireTicket(OperationContext* opCtx, LockMode mode, Date_t deadline);
+    LockResult _acquireTicket(OperationContext* opCtx,
+                              LockMode mode,
+                              Date_t deadline,
+                              bool mayDeprioritize);
 
     // Used to disambiguate different lockers
     const LockerId _id;
@@ -334,6 +338,10 @@ private:
     // Mode for which the Locker acquired a ticket, or MODE_NONE if no ticket was acquired.
     LockMode _modeForTicket = MODE_NONE;
 
+    // The number of times this Locker has released its locks through saveLockStateAndUnlock(), as
+    // operations do each time they yield, so this grows with the running time of the operation.
+    int _numYields = 0;
+
     // Indicates whether the client is active reader/writer or is queued.
     AtomicWord<ClientState> _clientState{kInactive};
 
@@ -101,6 +101,10 @@ public:
     // True if a replan was triggered during the execution of this operation.
     bool replanned{false};
 
+    // Time spent choosing a plan and building its execution tree, including any trial period run
+    // by the multi-planner.
+    long long planningTimeMicros{-1};
+
     long long nMatched{-1};   // number of records that match the query
     long long nModified{-1};  // number of records written (no no-ops)
     long long ninserted{-1};
@@ -38,7 +38,9 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/optime.h"
+#include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
@@ -52,6 +54,13 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+// The maximum number of entries a tailable oplog scan takes from the SharedOplogReadBuffer at once.
+const size_t kMaxSharedOplogEntriesPerRead = 128;
+
+}  // namespace
+
 // static
 const char* CollectionScan::kStageType = "COLLSCAN";
 
@@ -62,6 +71,7 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
     : PlanStage(kStageType, opCtx),
       _workingSet(workingSet),
       _filter(filter),
+      _compiledFilter(CompiledMatchExpression::compile(filter)),
       _params(params),
       _isDead(false),
       _wsidForFetch(_workingSet->allocate()) {
@@ -69,6 +79,12 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
     _specificStats.direction = params.direction;
     _specificStats.maxTs = params.maxTs;
     invariant(!_params.shouldTrackLatestOplogTimestamp || _params.collection->ns().isOplog());
+    invariant(!_params.shareOplogReads ||
+              (_params.tailable && _params.collection->ns().isOplog() &&
+               _params.direction == CollectionScanParams::FORWARD));
+    invariant((_params.minRecord.isNull() && _params.maxRecord.isNull()) ||
+              (_params.direction == CollectionScanParams::FORWARD && !_params.tailable &&
+               _params.start.isNull()));
 
     if (params.maxTs) {
         _endConditionBSON = BSON("$gte" << *(params.maxTs));
@@ -93,6 +109,24 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_params.shareOplogReads && !_lastSeenId.isNull()) {
+        if (_sharedOplogEntries.empty()) {
+            readFromSharedOplogBuffer();
+        }
+
+        if (!_sharedOplogEntries.empty()) {
+            auto entry = std::move(_sharedOplogEntries.front());
+            _sharedOplogEntries.pop_front();
+
+            // Our cursor, if we have one, is still positioned on the last entry we read from the
+            // oplog ourselves. Discard it so that the next read from the oplog seeks to the entry
+            // which follows those taken from the buffer.
+            _cursor.reset();
+            ++_specificStats.sharedOplogEntriesReturned;
+            return returnRecord(entry.id, std::move(entry.obj), out);
+        }
+    }
+
     boost::optional<Record> record;
     const bool needToMakeCursor = !_cursor;
     try {
@@ -144,6 +178,8 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
 
         if (_lastSeenId.isNull() && !_params.start.isNull()) {
             record = _cursor->seekExact(_params.start);
+        } else if (_lastSeenId.isNull() && !_params.minRecord.isNull()) {
+            record = _cursor->seekAtOrAfter(_params.minRecord);
         } else {
             // See if the record we're about to access is in memory. If not, pass a fetch
             // request up.
@@ -178,9 +214,34 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
-    _lastSeenId = record->id;
+    if (!_params.maxRecord.isNull() && record->id > _params.maxRecord) {
+        // We have scanned past the end of the requested range.
+        _commonStats.isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+
+    BSONObj obj = record->data.releaseToBson();
+    if (_params.shareOplogReads && !_lastSeenId.isNull() && canShareOplogReads()) {
+        // This entry immediately follows '_lastSeenId' in the oplog, so it may extend the window
+        // held by the buffer if that window currently ends at '_lastSeenId'. The buffer copies
+        // 'obj' only if it accepts it.
+        SharedOplogReadBuffer::get(getOpCtx()->getServiceContext())
+            ->publish(*_params.collection->uuid(),
+                      _lastSeenId,
+                      record->id,
+                      obj,
+                      static_cast<size_t>(internalQueryExecSharedOplogReadBufferBytes.load()));
+    }
+
+    return returnRecord(record->id, std::move(obj), out);
+}
+
+PlanStage::StageState CollectionScan::returnRecord(const RecordId& recordId,
+                                                   BSONObj obj,
+                                                   WorkingSetID* out) {
+    _lastSeenId = recordId;
     if (_params.shouldTrackLatestOplogTimestamp) {
-        auto status = setLatestOplogEntryTimestamp(*record);
+        auto status = setLatestOplogEntryTimestamp(obj);
         if (!status.isOK()) {
             *out = WorkingSetCommon::allocateStatusMember(_workingSet, status);
             return PlanStage::FAILURE;
@@ -189,34 +250,66 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
 
     WorkingSetID id = _workingSet->allocate();
     WorkingSetMember* member = _workingSet->get(id);
-    member->recordId = record->id;
-    member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), record->data.releaseToBson()};
+    member->recordId = recordId;
+    member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), std::move(obj)};
     _workingSet->transitionToRecordIdAndObj(id);
 
     return returnIfMatches(member, id, out);
 }
 
-Status CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
-    auto tsElem = record.data.toBson()[repl::OpTime::kTimestampFieldName];
+Status CollectionScan::setLatestOplogEntryTimestamp(const BSONObj& obj) {
+    auto tsElem = obj[repl::OpTime::kTimestampFieldName];
     if (tsElem.type() != BSONType::bsonTimestamp) {
         Status status(ErrorCodes::InternalError,
                       str::stream() << "CollectionScan was asked to track latest operation time, "
                                        "but found a result without a valid 'ts' field: "
-                                    << record.data.toBson().toString());
+                                    << obj.toString());
         return status;
     }
     _latestOplogEntryTimestamp = std::max(_latestOplogEntryTimestamp, tsElem.timestamp());
     return Status::OK();
 }
 
+bool CollectionScan::canShareOplogReads() const {
+    // Only majority committed entries may be shared, since they can never be rolled back.
+    return _params.collection->uuid() &&
+        getOpCtx()->recoveryUnit()->getTimestampReadSource() ==
+        RecoveryUnit::ReadSource::kMajorityCommitted;
+}
+
+void CollectionScan::readFromSharedOplogBuffer() {
+    if (!canShareOplogReads()) {
+        return;
+    }
+
+    // Entries in the buffer may have been read by scans with a later snapshot than ours, so only
+    // take those which we would have seen reading from the oplog ourselves.
+    auto readTimestamp = getOpCtx()->recoveryUnit()->getPointInTimeReadTimestamp();
+    if (!readTimestamp) {
+        return;
+    }
+    auto visibleThrough = oploghack::keyForOptime(*readTimestamp);
+    if (!visibleThrough.isOK()) {
+        return;
+    }
+
+    SharedOplogReadBuffer::get(getOpCtx()->getServiceContext())
+        ->readAfter(*_params.collection->uuid(),
+                    _lastSeenId,
+                    visibleThrough.getValue(),
+                    kMaxSharedOplogEntriesPerRead,
+                    &_sharedOplogEntries);
+}
+
 PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID memberID,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _filter, _compiledFilter.get())) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _compiledFilter.reset();
         }
         *out = memberID;
         return PlanStage::ADVANCED;
@@ -28,10 +28,13 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/shared_oplog_read_buffer.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/record_id.h"
 
@@ -86,11 +89,29 @@ private:
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
     /**
-     * Extracts the timestamp from the 'ts' field of 'record', and sets '_latestOplogEntryTimestamp'
+     * Records 'obj', with id 'id', as the last document seen by this scan and places it in a new
+     * working set member which is returned if it passes our filter.
+     */
+    StageState returnRecord(const RecordId& id, BSONObj obj, WorkingSetID* out);
+
+    /**
+     * Extracts the timestamp from the 'ts' field of 'obj', and sets '_latestOplogEntryTimestamp'
      * to that time if it isn't already greater.  Returns an error if the 'ts' field cannot be
      * extracted.
      */
-    Status setLatestOplogEntryTimestamp(const Record& record);
+    Status setLatestOplogEntryTimestamp(const BSONObj& obj);
+
+    /**
+     * Returns whether this scan may exchange oplog entries with the SharedOplogReadBuffer, which
+     * is only the case for tailable oplog scans reading from a majority committed snapshot.
+     */
+    bool canShareOplogReads() const;
+
+    /**
+     * Takes the next batch of entries following '_lastSeenId' which are visible in our snapshot
+     * from the SharedOplogReadBuffer into '_sharedOplogEntries'.
+     */
+    void readFromSharedOplogBuffer();
 
     // WorkingSet is not owned by us.
     WorkingSet* _workingSet;
@@ -98,6 +119,9 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // Compiled form of '_filter', if it has a shape the compiled matcher supports.
+    std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
     // If a document does not pass '_filter' but passes '_endCondition', stop scanning and return
     // IS_EOF.
     BSONObj _endConditionBSON;
@@ -111,6 +135,10 @@ private:
 
     RecordId _lastSeenId;  // Null if nothing has been returned from _cursor yet.
 
+    // Entries taken from the SharedOplogReadBuffer which follow '_lastSeenId' and have yet to be
+    // returned. Only used if '_params.shareOplogReads' is set.
+    std::deque<SharedOplogReadBuffer::Entry> _sharedOplogEntries;
+
     // We allocate a working set member with this id on construction of the stage. It gets used for
     // all fetch requests. This should only be used for passing up the Fetcher for a NEED_YIELD, and
     // should remain in the INVALID state.
@@ -49,6 +49,13 @@ struct CollectionScanParams {
     // not being invalidated before the first call to work(...).
     RecordId start;
 
+    // If set, a forward, non-tailable scan begins at the first record whose id is at least
+    // 'minRecord' and returns EOF once it reaches a record whose id is greater than 'maxRecord'.
+    // Either bound may be left null to leave that end of the scan open. Used to partition a scan
+    // of a collection into disjoint ranges which can be executed independently.
+    RecordId minRecord;
+    RecordId maxRecord;
+
     // If present, the collection scan will stop and return EOF the first time it sees a document
     // that does not pass the filter and has 'ts' greater than 'maxTs'.
     boost::optional<Timestamp> maxTs;
@@ -69,6 +76,11 @@ struct CollectionScanParams {
 
     // Whether or not to wait for oplog visibility on oplog collection scans.
     bool shouldWaitForOplogVisibility = false;
+
+    // Whether a tailable scan of the oplog takes the entries which follow its position from the
+    // SharedOplogReadBuffer when it can, and publishes the entries it reads there for other scans.
+    // Only takes effect when reading from a majority committed snapshot.
+    bool shareOplogReads = false;
 };
 
 }  // namespace mongo
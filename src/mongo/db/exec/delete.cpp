@@ -81,7 +81,9 @@ DeleteStage::DeleteStage(OperationContext* opCtx,
       _ws(ws),
       _collection(collection),
       _idRetrying(WorkingSet::INVALID_ID),
-      _idReturning(WorkingSet::INVALID_ID) {
+      _idReturning(WorkingSet::INVALID_ID),
+      _batch(params.isMulti && !params.returnDeleted && !params.isExplain ? params.batchSize
+                                                                           : 1) {
     _children.emplace_back(child);
 }
 
@@ -93,7 +95,7 @@ bool DeleteStage::isEOF() {
         return true;
     }
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
-        child()->isEOF();
+        _batch.empty() && child()->isEOF();
 }
 
 PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
@@ -116,6 +118,10 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
         return PlanStage::ADVANCED;
     }
 
+    if (_batch.isEnabled()) {
+        return doWorkBatched(out);
+    }
+
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     if (_idRetrying != WorkingSet::INVALID_ID) {
@@ -265,6 +271,117 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     return PlanStage::NEED_TIME;
 }
 
+PlanStage::StageState DeleteStage::doWorkBatched(WorkingSetID* out) {
+    if (!_batchReady) {
+        WorkingSetID id;
+        auto status = child()->work(&id);
+
+        switch (status) {
+            case PlanStage::ADVANCED: {
+                WorkingSetMember* member = _ws->get(id);
+                if (!member->hasRecordId()) {
+                    // We expect to be here because of an invalidation causing a force-fetch.
+                    ++_specificStats.nInvalidateSkips;
+                    _ws->free(id);
+                    return PlanStage::NEED_TIME;
+                }
+                _batch.add(_ws, id);
+                _batchReady = _batch.isFull();
+                return PlanStage::NEED_TIME;
+            }
+
+            case PlanStage::IS_EOF:
+                if (_batch.empty()) {
+                    return status;
+                }
+                _batchReady = true;
+                return PlanStage::NEED_TIME;
+
+            case PlanStage::FAILURE:
+            case PlanStage::DEAD:
+                invariant(WorkingSet::INVALID_ID != id);
+                *out = id;
+                return status;
+
+            case PlanStage::NEED_TIME:
+                return status;
+
+            case PlanStage::NEED_YIELD:
+                *out = id;
+                return status;
+
+            default:
+                MONGO_UNREACHABLE;
+        }
+    }
+
+    return deleteBatch(out);
+}
+
+PlanStage::StageState DeleteStage::deleteBatch(WorkingSetID* out) {
+    _batch.sortByRecordId(_ws);
+
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException&) {
+        std::terminate();
+    }
+
+    size_t numDeleted = 0;
+    size_t numInvalidateSkips = 0;
+    try {
+        WriteUnitOfWork wunit(getOpCtx());
+        for (auto id : _batch.ids()) {
+            WorkingSetMember* member = _ws->get(id);
+            if (!member->hasRecordId()) {
+                // The document was invalidated while the batch was being gathered.
+                ++numInvalidateSkips;
+                continue;
+            }
+
+            // Either the document has already been deleted, or it has been updated such that it
+            // no longer matches the predicate.
+            if (!write_stage_common::ensureStillMatches(
+                    _collection, getOpCtx(), _ws, id, _params.canonicalQuery)) {
+                continue;
+            }
+
+            _collection->deleteDocument(getOpCtx(),
+                                        _params.stmtId,
+                                        member->recordId,
+                                        _params.opDebug,
+                                        _params.fromMigrate,
+                                        false,
+                                        Collection::StoreDeletedDoc::Off);
+            ++numDeleted;
+        }
+        wunit.commit();
+    } catch (const WriteConflictException&) {
+        // None of the deletes in the batch were committed. Keep the batch, and our child's saved
+        // state, so that the whole batch can be retried after yielding.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    _specificStats.docsDeleted += numDeleted;
+    _specificStats.nInvalidateSkips += numInvalidateSkips;
+    _batch.clear(_ws);
+    _batchReady = false;
+
+    // As restoreState may restore (recreate) cursors, make sure to restore the state outside of
+    // the WriteUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException&) {
+        // Note we don't need to retry anything in this case since the deletes were committed.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
 void DeleteStage::doRestoreState() {
     invariant(_collection);
     const NamespaceString& ns(_collection->ns());
@@ -274,6 +391,14 @@ void DeleteStage::doRestoreState() {
                 repl::ReplicationCoordinator::get(getOpCtx())->canAcceptWritesFor(getOpCtx(), ns));
 }
 
+void DeleteStage::doInvalidate(OperationContext* opCtx,
+                               const RecordId& dl,
+                               InvalidationType type) {
+    // Documents we hold in '_batch' are no longer held by our child, so we must handle their
+    // invalidation ourselves.
+    _batch.invalidate(opCtx, _ws, _collection, dl);
+}
+
 unique_ptr<PlanStageStats> DeleteStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_DELETE);
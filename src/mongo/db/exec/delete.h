@@ -29,6 +29,7 @@
 #pragma once
 
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/write_stage_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/logical_session_id.h"
 
@@ -73,6 +74,13 @@ struct DeleteStageParams {
 
     // Optional. When not null, delete metrics are recorded here.
     OpDebug* opDebug;
+
+    // The number of documents a multi delete gathers from its child and deletes together, in
+    // RecordId order and inside a single WriteUnitOfWork. A value of 1 deletes each document as
+    // soon as it is returned by the child. Ignored unless 'isMulti' is set and neither
+    // 'returnDeleted' nor 'isExplain' is. Must be 1 for a namespace whose writes are logged to the
+    // oplog, since each write is timestamped with the optime of its own oplog entry.
+    size_t batchSize = 1;
 };
 
 /**
@@ -97,6 +105,7 @@ public:
     StageState doWork(WorkingSetID* out) final;
 
     void doRestoreState() final;
+    void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) final;
 
     StageType stageType() const final {
         return STAGE_DELETE;
@@ -122,6 +131,19 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Used in place of the body of doWork() when deleting in batches. Adds the documents returned
+     * by our child to '_batch' until it is full or the child is EOF, and then deletes them.
+     */
+    StageState doWorkBatched(WorkingSetID* out);
+
+    /**
+     * Deletes every document in '_batch' which still exists and matches the predicate inside a
+     * single WriteUnitOfWork. If a WriteConflictException is thrown, none of the deletes are
+     * committed and the batch is kept so that it can be retried after yielding.
+     */
+    StageState deleteBatch(WorkingSetID* out);
+
     DeleteStageParams _params;
 
     // Not owned by us.
@@ -138,6 +160,13 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // The documents gathered from our child which have yet to be deleted, when deleting in
+    // batches.
+    write_stage_common::WriteBatch _batch;
+
+    // Set once '_batch' is complete and should be deleted before asking our child for more.
+    bool _batchReady = false;
+
     // Stats
     DeleteStats _specificStats;
 };
@@ -58,6 +58,7 @@ FetchStage::FetchStage(OperationContext* opCtx,
       _collection(collection),
       _ws(ws),
       _filter(filter),
+      _compiledFilter(CompiledMatchExpression::compile(filter)),
       _idRetrying(WorkingSet::INVALID_ID) {
     _children.emplace_back(child);
 }
@@ -195,7 +196,7 @@ PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
     // predicate.
     ++_specificStats.docsExamined;
 
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _filter, _compiledFilter.get())) {
         *out = memberID;
         return PlanStage::ADVANCED;
     } else {
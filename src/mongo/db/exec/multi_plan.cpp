@@ -49,6 +49,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -206,6 +207,7 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // execution work that happens here, so this is needed for the time accounting to
     // make sense.
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    Timer planningTimer;
 
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), _collection);
     size_t numResults = getTrialPeriodNumToReturn(*_query);
@@ -324,6 +326,7 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
         }
 
         if (validSolutions) {
+            ranking->planningTime = Microseconds(planningTimer.micros());
             _collection->infoCache()
                 ->getPlanCache()
                 ->set(*_query,
@@ -193,7 +193,7 @@ struct CachedPlanStats : public SpecificStats {
 };
 
 struct CollectionScanStats : public SpecificStats {
-    CollectionScanStats() : docsTested(0), direction(1) {}
+    CollectionScanStats() : docsTested(0), direction(1), sharedOplogEntriesReturned(0) {}
 
     SpecificStats* clone() const final {
         CollectionScanStats* specific = new CollectionScanStats(*this);
@@ -211,6 +211,10 @@ struct CollectionScanStats : public SpecificStats {
     // sees a document that does not pass the filter and has a "ts" Timestamp field greater than
     // 'maxTs'.
     boost::optional<Timestamp> maxTs;
+
+    // How many oplog entries did we take from the SharedOplogReadBuffer rather than reading them
+    // from the oplog ourselves?
+    size_t sharedOplogEntriesReturned;
 };
 
 struct CountStats : public SpecificStats {
@@ -513,7 +517,7 @@ struct ProjectionStats : public SpecificStats {
 };
 
 struct SortStats : public SpecificStats {
-    SortStats() : forcedFetches(0), memUsage(0), memLimit(0) {}
+    SortStats() : forcedFetches(0), memUsage(0), memLimit(0), usedDisk(false), spills(0) {}
 
     SpecificStats* clone() const final {
         SortStats* specific = new SortStats(*this);
@@ -534,6 +538,12 @@ struct SortStats : public SpecificStats {
 
     // The pattern according to which we are sorting.
     BSONObj sortPattern;
+
+    // Did we switch to external sorting because the buffered data exceeded 'memLimit'?
+    bool usedDisk;
+
+    // How many sorted runs did the external sorter write to disk?
+    size_t spills;
 };
 
 struct MergeSortStats : public SpecificStats {
@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/shared_oplog_read_buffer.h"
+
+#include <algorithm>
+
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getSharedOplogReadBuffer = ServiceContext::declareDecoration<SharedOplogReadBuffer>();
+
+}  // namespace
+
+SharedOplogReadBuffer* SharedOplogReadBuffer::get(ServiceContext* serviceContext) {
+    return &getSharedOplogReadBuffer(serviceContext);
+}
+
+void SharedOplogReadBuffer::publish(const UUID& oplogUUID,
+                                    const RecordId& previousId,
+                                    const RecordId& id,
+                                    const BSONObj& obj,
+                                    size_t maxBytes) {
+    invariant(previousId < id);
+
+    const size_t objSize = static_cast<size_t>(obj.objsize());
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_oplogUUID != oplogUUID) {
+        // The oplog has been recreated since the window was filled, so none of its entries can be
+        // served any longer.
+        _clear(lk);
+        _oplogUUID = oplogUUID;
+    }
+
+    if (!_entries.empty() && previousId > _entries.back().id) {
+        // This scan has already read past the end of the window. Restart the window here so that
+        // it follows the scans nearest the end of the oplog, where most change streams read.
+        _clear(lk);
+        _oplogUUID = oplogUUID;
+    }
+
+    if (_entries.empty()) {
+        _windowStart = previousId;
+    } else if (_entries.back().id != previousId) {
+        return;
+    }
+
+    // Only copy the entry once it is known to extend the window, so that the scans whose entries
+    // are rejected do not pay for a copy.
+    _entries.push_back({id, obj.getOwned()});
+    _numBytes += objSize;
+
+    while (_numBytes > maxBytes) {
+        _windowStart = _entries.front().id;
+        _numBytes -= static_cast<size_t>(_entries.front().obj.objsize());
+        _entries.pop_front();
+    }
+}
+
+size_t SharedOplogReadBuffer::readAfter(const UUID& oplogUUID,
+                                        const RecordId& lastSeenId,
+                                        const RecordId& visibleThrough,
+                                        size_t maxEntries,
+                                        std::deque<Entry>* entries) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_oplogUUID != oplogUUID || _entries.empty() || lastSeenId < _windowStart ||
+        lastSeenId >= _entries.back().id) {
+        return 0;
+    }
+
+    auto it = _entries.begin();
+    if (lastSeenId != _windowStart) {
+        it = std::lower_bound(_entries.begin(),
+                              _entries.end(),
+                              lastSeenId,
+                              [](const Entry& entry, const RecordId& id) { return entry.id < id; });
+        if (it == _entries.end() || it->id != lastSeenId) {
+            // 'lastSeenId' falls between two entries of the window, which means it was not read
+            // from this oplog.
+            return 0;
+        }
+        ++it;
+    }
+
+    size_t numAppended = 0;
+    for (; it != _entries.end() && numAppended < maxEntries && it->id <= visibleThrough; ++it) {
+        entries->push_back(*it);
+        ++numAppended;
+    }
+    return numAppended;
+}
+
+void SharedOplogReadBuffer::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _clear(lk);
+}
+
+void SharedOplogReadBuffer::_clear(WithLock) {
+    _oplogUUID = boost::none;
+    _windowStart = RecordId();
+    _entries.clear();
+    _numBytes = 0;
+}
+
+size_t SharedOplogReadBuffer::getNumEntries() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _entries.size();
+}
+
+size_t SharedOplogReadBuffer::getNumBytes() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _numBytes;
+}
+
+}  // namespace mongo
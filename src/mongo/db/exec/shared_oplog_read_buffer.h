@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * A bounded window of recently read oplog entries, shared by every tailable oplog scan on the
+ * server so that many change streams positioned near the same point in the oplog do not each
+ * read the same entries from the storage engine.
+ *
+ * The window is always gap-free: an entry is only appended by a scan which read it from the
+ * oplog immediately after the entry at the end of the window. A scan positioned anywhere inside
+ * the window can therefore take the entries which follow its position from the buffer in place
+ * of reading them itself. Scans which fall behind the start of the window, because the window
+ * has grown past its size limit, read from the oplog on their own, so a slow scan never holds
+ * back the memory used by the window or the progress of any other scan.
+ *
+ * Only entries read from a majority committed snapshot may be published, since those can never
+ * be rolled back.
+ */
+class SharedOplogReadBuffer {
+    MONGO_DISALLOW_COPYING(SharedOplogReadBuffer);
+
+public:
+    struct Entry {
+        RecordId id;
+        BSONObj obj;
+    };
+
+    SharedOplogReadBuffer() = default;
+
+    static SharedOplogReadBuffer* get(ServiceContext* serviceContext);
+
+    /**
+     * Appends an owned copy of the entry 'obj' with id 'id' if 'previousId' is the id of the last
+     * entry in the window, or starts a new window holding just this entry if the window is empty or
+     * holds entries of a different oplog. Evicts the oldest entries until the window holds no more
+     * than 'maxBytes'. Does nothing if the entry does not continue the window.
+     */
+    void publish(const UUID& oplogUUID,
+                 const RecordId& previousId,
+                 const RecordId& id,
+                 const BSONObj& obj,
+                 size_t maxBytes);
+
+    /**
+     * Appends to 'entries' up to 'maxEntries' entries which immediately follow 'lastSeenId' in the
+     * oplog with UUID 'oplogUUID', stopping before the first entry whose id is greater than
+     * 'visibleThrough'. Returns the number of entries appended, which is 0 if 'lastSeenId' is not
+     * inside the window.
+     */
+    size_t readAfter(const UUID& oplogUUID,
+                     const RecordId& lastSeenId,
+                     const RecordId& visibleThrough,
+                     size_t maxEntries,
+                     std::deque<Entry>* entries) const;
+
+    /**
+     * Discards every entry in the window.
+     */
+    void clear();
+
+    size_t getNumEntries() const;
+    size_t getNumBytes() const;
+
+private:
+    void _clear(WithLock);
+
+    mutable stdx::mutex _mutex;
+
+    boost::optional<UUID> _oplogUUID;
+
+    // The id of the oplog entry which immediately precedes the first entry of '_entries'. A scan
+    // whose last seen id is '_windowStart' may continue with the first entry of the window.
+    RecordId _windowStart;
+
+    std::deque<Entry> _entries;
+
+    size_t _numBytes = 0;
+};
+
+}  // namespace mongo
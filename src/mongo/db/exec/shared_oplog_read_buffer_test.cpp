@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/shared_oplog_read_buffer.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const size_t kNoLimit = std::numeric_limits<size_t>::max();
+
+BSONObj makeEntry(long long id) {
+    return BSON("ts" << Timestamp(id, 0) << "o" << BSON("_id" << id));
+}
+
+/**
+ * Publishes the entries with ids in ['from', 'to'] as if they had been read by one scan in order.
+ */
+void publishRange(SharedOplogReadBuffer* buffer,
+                  const UUID& uuid,
+                  long long from,
+                  long long to,
+                  size_t maxBytes) {
+    for (long long id = from; id <= to; ++id) {
+        buffer->publish(uuid, RecordId(id - 1), RecordId(id), makeEntry(id), maxBytes);
+    }
+}
+
+std::vector<long long> readIds(const SharedOplogReadBuffer& buffer,
+                               const UUID& uuid,
+                               long long lastSeenId,
+                               long long visibleThrough = std::numeric_limits<long long>::max(),
+                               size_t maxEntries = kNoLimit) {
+    std::deque<SharedOplogReadBuffer::Entry> entries;
+    buffer.readAfter(uuid, RecordId(lastSeenId), RecordId(visibleThrough), maxEntries, &entries);
+
+    std::vector<long long> ids;
+    for (auto&& entry : entries) {
+        ASSERT_BSONOBJ_EQ(makeEntry(entry.id.repr()), entry.obj);
+        ids.push_back(entry.id.repr());
+    }
+    return ids;
+}
+
+TEST(SharedOplogReadBufferTest, ReadsEntriesFollowingAnyPositionInTheWindow) {
+    SharedOplogReadBuffer buffer;
+    const auto uuid = UUID::gen();
+    publishRange(&buffer, uuid, 11, 15, kNoLimit);
+    ASSERT_EQ(5U, buffer.getNumEntries());
+
+    ASSERT(readIds(buffer, uuid, 10) == std::vector<long long>({11, 12, 13, 14, 15}));
+    ASSERT(readIds(buffer, uuid, 13) == std::vector<long long>({14, 15}));
+    ASSERT(readIds(buffer, uuid, 15).empty());
+    ASSERT(readIds(buffer, uuid, 9).empty());
+    ASSERT(readIds(buffer, uuid, 20).empty());
+}
+
+TEST(SharedOplogReadBufferTest, ReadStopsAtVisibilityPointAndBatchLimit) {
+    SharedOplogReadBuffer buffer;
+    const auto uuid = UUID::gen();
+    publishRange(&buffer, uuid, 1, 10, kNoLimit);
+
+    ASSERT(readIds(buffer, uuid, 2, 5) == std::vector<long long>({3, 4, 5}));
+    ASSERT(readIds(buffer, uuid, 2, 100, 2) == std::vector<long long>({3, 4}));
+    ASSERT(readIds(buffer, uuid, 5, 5).empty());
+}
+
+TEST(SharedOplogReadBufferTest, IgnoresEntriesWhichDoNotContinueTheWindow) {
+    SharedOplogReadBuffer buffer;
+    const auto uuid = UUID::gen();
+    publishRange(&buffer, uuid, 1, 5, kNoLimit);
+
+    // A second scan behind the end of the window reads an entry the window already holds.
+    buffer.publish(uuid, RecordId(2), RecordId(3), makeEntry(3), kNoLimit);
+    ASSERT_EQ(5U, buffer.getNumEntries());
+
+    // A scan at the end of the window extends it.
+    buffer.publish(uuid, RecordId(5), RecordId(6), makeEntry(6), kNoLimit);
+    ASSERT(readIds(buffer, uuid, 4) == std::vector<long long>({5, 6}));
+}
+
+TEST(SharedOplogReadBufferTest, CopiesUnownedEntriesItAccepts) {
+    SharedOplogReadBuffer buffer;
+    const auto uuid = UUID::gen();
+    const BSONObj owned = makeEntry(1);
+    buffer.publish(uuid, RecordId(0), RecordId(1), BSONObj(owned.objdata()), kNoLimit);
+
+    std::deque<SharedOplogReadBuffer::Entry> entries;
+    ASSERT_EQ(1U, buffer.readAfter(uuid, RecordId(0), RecordId(1), kNoLimit, &entries));
+    ASSERT(entries.front().obj.isOwned());
+    ASSERT_BSONOBJ_EQ(owned, entries.front().obj);
+}
+
+TEST(SharedOplogReadBufferTest, ScanAheadOfTheWindowRestartsIt) {
+    SharedOplogReadBuffer buffer;
+    const auto uuid = UUID::gen();
+    publishRange(&buffer, uuid, 1, 5, kNoLimit);
+
+    buffer.publish(uuid, RecordId(20), RecordId(21), makeEntry(21), kNoLimit);
+    ASSERT_EQ(1U, buffer.getNumEntries());
+    ASSERT(readIds(buffer, uuid, 2).empty());
+    ASSERT(readIds(buffer, uuid, 20) == std::vector<long long>({21}));
+}
+
+TEST(SharedOplogReadBufferTest, EvictsOldestEntriesBeyondSizeLimit) {
+    SharedOplogReadBuffer buffer;
+    const auto uuid = UUID::gen();
+    const size_t entrySize = makeEntry(1).objsize();
+    publishRange(&buffer, uuid, 1, 10, 4 * entrySize);
+
+    ASSERT_EQ(4U, buffer.getNumEntries());
+    ASSERT_EQ(4 * entrySize, buffer.getNumBytes());
+
+    // A scan which has fallen behind the window must read from the oplog itself, while a scan at
+    // the start of the window may still continue from it.
+    ASSERT(readIds(buffer, uuid, 5).empty());
+    ASSERT(readIds(buffer, uuid, 6) == std::vector<long long>({7, 8, 9, 10}));
+}
+
+TEST(SharedOplogReadBufferTest, DoesNotServeEntriesOfAnotherOplog) {
+    SharedOplogReadBuffer buffer;
+    const auto oldUUID = UUID::gen();
+    const auto newUUID = UUID::gen();
+    publishRange(&buffer, oldUUID, 1, 5, kNoLimit);
+    ASSERT(readIds(buffer, newUUID, 2).empty());
+
+    publishRange(&buffer, newUUID, 3, 4, kNoLimit);
+    ASSERT(readIds(buffer, oldUUID, 2).empty());
+    ASSERT(readIds(buffer, newUUID, 2) == std::vector<long long>({3, 4}));
+}
+
+}  // namespace
+}  // namespace mongo
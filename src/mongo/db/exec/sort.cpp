@@ -41,6 +41,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -51,9 +52,79 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+// Field names under which a spilled result's computed data is serialized.
+const char kTextScoreField[] = "textScore";
+const char kGeoDistanceField[] = "geoDistance";
+const char kIndexKeyField[] = "indexKey";
+const char kGeoNearPointField[] = "geoNearPoint";
+
+}  // namespace
+
 // static
 const char* SortStage::kStageType = "SORT";
 
+void SortStage::SpillKey::serializeForSorter(BufBuilder& buf) const {
+    sortKey.serializeForSorter(buf);
+    recordId.serializeForSorter(buf);
+}
+
+SortStage::SpillKey SortStage::SpillKey::deserializeForSorter(BufReader& buf,
+                                                              const SorterDeserializeSettings&) {
+    SpillKey key;
+    key.sortKey = BSONObj::deserializeForSorter(buf, BSONObj::SorterDeserializeSettings());
+    key.recordId = RecordId::deserializeForSorter(buf, RecordId::SorterDeserializeSettings());
+    return key;
+}
+
+int SortStage::SpillKey::memUsageForSorter() const {
+    return sizeof(SpillKey) + sortKey.objsize();
+}
+
+SortStage::SpillKey SortStage::SpillKey::getOwned() const {
+    SpillKey key;
+    key.sortKey = sortKey.getOwned();
+    key.recordId = recordId;
+    return key;
+}
+
+void SortStage::SpillValue::serializeForSorter(BufBuilder& buf) const {
+    obj.serializeForSorter(buf);
+    computed.serializeForSorter(buf);
+}
+
+SortStage::SpillValue SortStage::SpillValue::deserializeForSorter(
+    BufReader& buf, const SorterDeserializeSettings&) {
+    SpillValue value;
+    value.obj = BSONObj::deserializeForSorter(buf, BSONObj::SorterDeserializeSettings());
+    value.computed = BSONObj::deserializeForSorter(buf, BSONObj::SorterDeserializeSettings());
+    return value;
+}
+
+int SortStage::SpillValue::memUsageForSorter() const {
+    return sizeof(SpillValue) + obj.objsize() + computed.objsize();
+}
+
+SortStage::SpillValue SortStage::SpillValue::getOwned() const {
+    SpillValue value;
+    value.obj = obj.getOwned();
+    value.computed = computed.getOwned();
+    return value;
+}
+
+SortStage::SpillComparator::SpillComparator(BSONObj p) : pattern(p) {}
+
+int SortStage::SpillComparator::operator()(const std::pair<SpillKey, SpillValue>& lhs,
+                                           const std::pair<SpillKey, SpillValue>& rhs) const {
+    // False means ignore field names.
+    int result = lhs.first.sortKey.woCompare(rhs.first.sortKey, pattern, false);
+    if (0 != result) {
+        return result;
+    }
+    return lhs.first.recordId.compare(rhs.first.recordId);
+}
+
 SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
 
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
@@ -78,7 +149,8 @@ SortStage::SortStage(OperationContext* opCtx,
       _limit(params.limit),
       _sorted(false),
       _resultIterator(_data.end()),
-      _memUsage(0) {
+      _memUsage(0),
+      _allowDiskUse(params.allowDiskUse) {
     _children.emplace_back(child);
 
     BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
@@ -97,6 +169,9 @@ SortStage::~SortStage() {}
 bool SortStage::isEOF() {
     // We're done when our child has no more results, we've sorted the child's results, and
     // we've returned all sorted results.
+    if (_spillIterator) {
+        return child()->isEOF() && _sorted && !_spillIterator->more();
+    }
     return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
 }
 
@@ -105,7 +180,8 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     if (_memUsage > maxBytes) {
         mongoutils::str::stream ss;
         ss << "Sort operation used more than the maximum " << maxBytes
-           << " bytes of RAM. Add an index, or specify a smaller limit.";
+           << " bytes of RAM. Add an index, specify a smaller limit, or pass allowDiskUse:true"
+           << " to sort using temporary files.";
         Status status(ErrorCodes::OperationFailed, ss);
         *out = WorkingSetCommon::allocateStatusMember(_ws, status);
         return PlanStage::FAILURE;
@@ -150,12 +226,24 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
 
             addToBuffer(item);
 
+            // Rather than fail once the buffered data outgrows the memory limit, hand everything
+            // off to the external sorter if we are allowed to use disk.
+            if (_allowDiskUse && !_spillSorter && _memUsage > maxBytes) {
+                spillBufferToSorter();
+            }
+
             return PlanStage::NEED_TIME;
         } else if (PlanStage::IS_EOF == code) {
             // TODO: We don't need the lock for this.  We could ask for a yield and do this work
             // unlocked.  Also, this is performing a lot of work for one call to work(...)
-            sortBuffer();
-            _resultIterator = _data.begin();
+            if (_spillSorter) {
+                _specificStats.spills = _spillSorter->numFiles();
+                _spillIterator.reset(_spillSorter->done());
+                _spillSorter.reset();
+            } else {
+                sortBuffer();
+                _resultIterator = _data.begin();
+            }
             _sorted = true;
             return PlanStage::NEED_TIME;
         } else if (PlanStage::FAILURE == code || PlanStage::DEAD == code) {
@@ -172,8 +260,15 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     }
 
     // Returning results.
-    verify(_resultIterator != _data.end());
     verify(_sorted);
+    if (_spillIterator) {
+        // Results read back from disk are not tracked for invalidation, since they are already
+        // owned and no longer associated with a RecordId.
+        *out = allocateFromSpilled(_spillIterator->next());
+        return PlanStage::ADVANCED;
+    }
+
+    verify(_resultIterator != _data.end());
     *out = _resultIterator->wsid;
     _resultIterator++;
 
@@ -215,7 +310,7 @@ unique_ptr<PlanStageStats> SortStage::getStats() {
     _commonStats.isEOF = isEOF();
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
     _specificStats.memLimit = maxBytes;
-    _specificStats.memUsage = _memUsage;
+    _specificStats.memUsage = _spillSorter ? _spillSorter->memUsed() : _memUsage;
     _specificStats.limit = _limit;
     _specificStats.sortPattern = _pattern.getOwned();
 
@@ -248,8 +343,17 @@ const SpecificStats* SortStage::getSpecificStats() const {
  *                     If size of set exceeds limit, remove item from set
  *                     with lowest key. Updates memory usage accordingly.
  *     sortBuffer() - Copies items from set to vectors.
+ *
+ * Once we have switched to external sorting, addToBuffer() forwards every
+ * item to the external sorter, which applies the limit itself, and
+ * sortBuffer() is not called.
  */
 void SortStage::addToBuffer(const SortableDataItem& item) {
+    if (_spillSorter) {
+        addToSpillSorter(item);
+        return;
+    }
+
     // Holds ID of working set member to be freed at end of this function.
     WorkingSetID wsidToFree = WorkingSet::INVALID_ID;
 
@@ -317,6 +421,105 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
     }
 }
 
+void SortStage::spillBufferToSorter() {
+    invariant(!_spillSorter);
+    invariant(!_sorted);
+
+    const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
+    _spillSorter.reset(SpillSorter::make(SortOptions()
+                                             .Limit(_limit)
+                                             .MaxMemoryUsageBytes(maxBytes)
+                                             .ExtSortAllowed()
+                                             .TempDir(storageGlobalParams.dbpath + "/_tmp"),
+                                         SpillComparator(_sortKeyComparator->pattern)));
+
+    if (_limit > 1) {
+        for (auto&& item : *_dataSet) {
+            addToSpillSorter(item);
+        }
+        _dataSet->clear();
+    } else {
+        for (auto&& item : _data) {
+            addToSpillSorter(item);
+        }
+        _data.clear();
+    }
+    _resultIterator = _data.end();
+
+    _memUsage = 0;
+    _specificStats.usedDisk = true;
+    LOG(1) << "Sort stage exceeded " << maxBytes << " bytes of RAM, switching to external sort";
+}
+
+void SortStage::addToSpillSorter(const SortableDataItem& item) {
+    WorkingSetMember* member = _ws->get(item.wsid);
+
+    SpillKey key;
+    key.sortKey = item.sortKey;
+    key.recordId = item.recordId;
+
+    SpillValue value;
+    value.obj = member->obj.value().getOwned();
+
+    BSONObjBuilder computed;
+    if (member->hasComputed(WSM_COMPUTED_TEXT_SCORE)) {
+        computed.append(kTextScoreField,
+                        static_cast<const TextScoreComputedData*>(
+                            member->getComputed(WSM_COMPUTED_TEXT_SCORE))
+                            ->getScore());
+    }
+    if (member->hasComputed(WSM_COMPUTED_GEO_DISTANCE)) {
+        computed.append(kGeoDistanceField,
+                        static_cast<const GeoDistanceComputedData*>(
+                            member->getComputed(WSM_COMPUTED_GEO_DISTANCE))
+                            ->getDist());
+    }
+    if (member->hasComputed(WSM_INDEX_KEY)) {
+        computed.append(
+            kIndexKeyField,
+            static_cast<const IndexKeyComputedData*>(member->getComputed(WSM_INDEX_KEY))->getKey());
+    }
+    if (member->hasComputed(WSM_GEO_NEAR_POINT)) {
+        computed.append(kGeoNearPointField,
+                        static_cast<const GeoNearPointComputedData*>(
+                            member->getComputed(WSM_GEO_NEAR_POINT))
+                            ->getPoint());
+    }
+    value.computed = computed.obj();
+
+    _spillSorter->add(key, value);
+
+    if (member->hasRecordId()) {
+        _wsidByRecordId.erase(member->recordId);
+    }
+    _ws->free(item.wsid);
+}
+
+WorkingSetID SortStage::allocateFromSpilled(const SpillSorter::Data& data) {
+    WorkingSetID id = _ws->allocate();
+    WorkingSetMember* member = _ws->get(id);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), data.second.obj.getOwned());
+    _ws->transitionToOwnedObj(id);
+
+    member->addComputed(new SortKeyComputedData(data.first.sortKey));
+
+    const BSONObj& computed = data.second.computed;
+    if (auto elt = computed[kTextScoreField]) {
+        member->addComputed(new TextScoreComputedData(elt.numberDouble()));
+    }
+    if (auto elt = computed[kGeoDistanceField]) {
+        member->addComputed(new GeoDistanceComputedData(elt.numberDouble()));
+    }
+    if (auto elt = computed[kIndexKeyField]) {
+        member->addComputed(new IndexKeyComputedData(elt.Obj()));
+    }
+    if (auto elt = computed[kGeoNearPointField]) {
+        member->addComputed(new GeoNearPointComputedData(elt.Obj()));
+    }
+
+    return id;
+}
+
 void SortStage::sortBuffer() {
     if (_limit == 0) {
         const WorkingSetComparator& cmp = *_sortKeyComparator;
@@ -335,3 +538,6 @@ void SortStage::sortBuffer() {
 }
 
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -37,6 +37,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
@@ -46,7 +47,7 @@ class BtreeKeyGenerator;
 // Parameters that must be provided to a SortStage
 class SortStageParams {
 public:
-    SortStageParams() : collection(NULL), limit(0) {}
+    SortStageParams() : collection(NULL), limit(0), allowDiskUse(false) {}
 
     // Used for resolving RecordIds to BSON
     const Collection* collection;
@@ -56,11 +57,20 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit;
+
+    // Whether the stage may spill sorted runs to disk rather than failing once it exceeds
+    // 'internalQueryExecMaxBlockingSortBytes'.
+    bool allowDiskUse;
 };
 
 /**
  * Sorts the input received from the child according to the sort pattern provided.
  *
+ * If 'allowDiskUse' is set and the buffered data grows beyond the blocking sort memory limit, the
+ * buffered results are handed off to an external Sorter which writes sorted runs to disk and
+ * merges them once the child is exhausted. Results produced from the external sorter are returned
+ * in the OWNED_OBJ state, exactly as if their RecordId had been invalidated.
+ *
  * Preconditions:
  *   -- For each field in 'pattern', all inputs in the child must handle a getFieldDotted for that
  *   field.
@@ -138,12 +148,70 @@ private:
         BSONObj pattern;
     };
 
+    /**
+     * The key under which a result is handed to the external sorter: the sort key, along with the
+     * RecordId which is used to break ties.
+     */
+    struct SpillKey {
+        struct SorterDeserializeSettings {};  // unused
+        void serializeForSorter(BufBuilder& buf) const;
+        static SpillKey deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&);
+        int memUsageForSorter() const;
+        SpillKey getOwned() const;
+
+        BSONObj sortKey;
+        RecordId recordId;
+    };
+
+    /**
+     * The document of a result handed to the external sorter, along with the computed data
+     * attached to its WorkingSetMember (other than the sort key, which is kept in the SpillKey).
+     */
+    struct SpillValue {
+        struct SorterDeserializeSettings {};  // unused
+        void serializeForSorter(BufBuilder& buf) const;
+        static SpillValue deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&);
+        int memUsageForSorter() const;
+        SpillValue getOwned() const;
+
+        BSONObj obj;
+        BSONObj computed;
+    };
+
+    // Orders the external sorter's data exactly as WorkingSetComparator orders buffered items.
+    struct SpillComparator {
+        explicit SpillComparator(BSONObj p);
+
+        int operator()(const std::pair<SpillKey, SpillValue>& lhs,
+                       const std::pair<SpillKey, SpillValue>& rhs) const;
+
+        BSONObj pattern;
+    };
+
+    using SpillSorter = Sorter<SpillKey, SpillValue>;
+
     /**
      * Inserts one item into data buffer (vector or set).
      * If limit is exceeded, remove item with lowest key.
      */
     void addToBuffer(const SortableDataItem& item);
 
+    /**
+     * Switches this stage over to external sorting: creates '_spillSorter' and moves every item
+     * currently buffered in memory into it, freeing the corresponding working set members.
+     */
+    void spillBufferToSorter();
+
+    /**
+     * Adds the working set member referred to by 'item' to '_spillSorter' and frees it.
+     */
+    void addToSpillSorter(const SortableDataItem& item);
+
+    /**
+     * Allocates a working set member for a result read back from the external sorter.
+     */
+    WorkingSetID allocateFromSpilled(const SpillSorter::Data& data);
+
     /**
      * Sorts data buffer.
      * Assumes no more items will be added to buffer.
@@ -178,6 +246,15 @@ private:
 
     // The usage in bytes of all buffered data that we're sorting.
     size_t _memUsage;
+
+    // Whether we may switch to external sorting once '_memUsage' exceeds the memory limit.
+    const bool _allowDiskUse;
+
+    // Set once we have switched to external sorting. All results from the child are added here
+    // rather than to the in-memory buffers, until the child is exhausted and '_spillIterator' is
+    // obtained from the sorter.
+    std::unique_ptr<SpillSorter> _spillSorter;
+    std::unique_ptr<SpillSorter::Iterator> _spillIterator;
 };
 
 }  // namespace mongo
@@ -172,6 +172,7 @@ UpdateStage::UpdateStage(OperationContext* opCtx,
       _collection(collection),
       _idRetrying(WorkingSet::INVALID_ID),
       _idReturning(WorkingSet::INVALID_ID),
+      _batch(params.request->isMulti() && !params.request->isExplain() ? params.batchSize : 1),
       _updatedRecordIds(params.request->isMulti() ? new RecordIdSet() : NULL),
       _doc(params.driver->getDocument()) {
     _children.emplace_back(child);
@@ -350,9 +351,15 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         // it again.  For an example, see the comment above near declaration of
         // updatedRecordIds.
         //
-        // This must be done after the wunit commits so we are sure we won't be rolling back.
+        // This must be done after the wunit commits so we are sure we won't be rolling back. When
+        // updating in batches, the enclosing WriteUnitOfWork of the batch may still roll back, so
+        // the RecordId is only recorded once the batch commits.
         if (_updatedRecordIds && (newRecordId != recordId || driver->modsAffectIndices())) {
-            _updatedRecordIds->insert(newRecordId);
+            if (_batch.isEnabled()) {
+                _batchUpdatedRecordIds.push_back(newRecordId);
+            } else {
+                _updatedRecordIds->insert(newRecordId);
+            }
         }
     }
 
@@ -485,6 +492,7 @@ bool UpdateStage::doneUpdating() {
     // We're done updating if either the child has no more results to give us, or we've
     // already gotten a result back and we're not a multi-update.
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
+        _batch.empty() &&
         (child()->isEOF() || (_specificStats.nMatched > 0 && !_params.request->isMulti()));
 }
 
@@ -554,6 +562,10 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
         return PlanStage::ADVANCED;
     }
 
+    if (_batch.isEnabled()) {
+        return doWorkBatched(out);
+    }
+
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
@@ -710,6 +722,120 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState UpdateStage::doWorkBatched(WorkingSetID* out) {
+    if (_batchReady) {
+        return updateBatch(out);
+    }
+
+    WorkingSetID id;
+    StageState status = child()->work(&id);
+
+    if (PlanStage::ADVANCED == status) {
+        WorkingSetMember* member = _ws->get(id);
+        if (!member->hasRecordId()) {
+            // We expect to be here because of an invalidation causing a force-fetch.
+            ++_specificStats.nInvalidateSkips;
+            _ws->free(id);
+            return PlanStage::NEED_TIME;
+        }
+
+        if (_updatedRecordIds->count(member->recordId) > 0) {
+            // Found a RecordId that refers to a document we had already updated.
+            _ws->free(id);
+            return PlanStage::NEED_TIME;
+        }
+
+        _batch.add(_ws, id);
+        _batchReady = _batch.isFull();
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::IS_EOF == status) {
+        // Update whatever remains in the batch. Once it is empty, we might still have to do an
+        // insert.
+        _batchReady = !_batch.empty();
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::FAILURE == status) {
+        *out = id;
+        if (WorkingSet::INVALID_ID == id) {
+            const std::string errmsg = "update stage failed to read in results from child";
+            *out = WorkingSetCommon::allocateStatusMember(
+                _ws, Status(ErrorCodes::InternalError, errmsg));
+        }
+        return PlanStage::FAILURE;
+    } else if (PlanStage::NEED_YIELD == status) {
+        *out = id;
+    }
+
+    return status;
+}
+
+PlanStage::StageState UpdateStage::updateBatch(WorkingSetID* out) {
+    _batch.sortByRecordId(_ws);
+
+    // Save state before making changes
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException&) {
+        std::terminate();
+    }
+
+    // If the batch does not commit, none of its updates should be counted.
+    const UpdateStats statsBeforeBatch = _specificStats;
+    ScopeGuard statsRestorer = MakeGuard([&] {
+        _specificStats = statsBeforeBatch;
+        _batchUpdatedRecordIds.clear();
+    });
+
+    try {
+        WriteUnitOfWork wunit(getOpCtx());
+        for (auto id : _batch.ids()) {
+            WorkingSetMember* member = _ws->get(id);
+            if (!member->hasRecordId()) {
+                // The document was invalidated while the batch was being gathered.
+                ++_specificStats.nInvalidateSkips;
+                continue;
+            }
+
+            // Either the document has been deleted, or it has been updated such that it no
+            // longer matches the predicate.
+            if (!write_stage_common::ensureStillMatches(
+                    _collection, getOpCtx(), _ws, id, _params.canonicalQuery)) {
+                continue;
+            }
+            member->makeObjOwnedIfNeeded();
+
+            RecordId recordId = member->recordId;
+            transformAndUpdate(member->obj, recordId);
+            ++_specificStats.nMatched;
+        }
+        wunit.commit();
+    } catch (const WriteConflictException&) {
+        // None of the updates in the batch were committed. Keep the batch, and our child's saved
+        // state, so that the whole batch can be retried after yielding.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+    statsRestorer.Dismiss();
+
+    _updatedRecordIds->insert(_batchUpdatedRecordIds.begin(), _batchUpdatedRecordIds.end());
+    _batchUpdatedRecordIds.clear();
+    _batch.clear(_ws);
+    _batchReady = false;
+
+    // As restoreState may restore (recreate) cursors, make sure to restore the
+    // state outside of the WritUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException&) {
+        // Note we don't need to retry updating anything in this case since the updates were
+        // committed.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
 void UpdateStage::doRestoreState() {
     const UpdateRequest& request = *_params.request;
     const NamespaceString& nsString(request.getNamespaceString());
@@ -736,6 +862,14 @@ void UpdateStage::doRestoreState() {
     }
 }
 
+void UpdateStage::doInvalidate(OperationContext* opCtx,
+                               const RecordId& dl,
+                               InvalidationType type) {
+    // Documents we hold in '_batch' are no longer held by our child, so we must handle their
+    // invalidation ourselves.
+    _batch.invalidate(opCtx, _ws, _collection, dl);
+}
+
 unique_ptr<PlanStageStats> UpdateStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_UPDATE);
@@ -31,6 +31,7 @@
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/write_stage_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/ops/update_request.h"
 #include "mongo/db/ops/update_result.h"
@@ -60,6 +61,13 @@ struct UpdateStageParams {
     // Not owned here.
     CanonicalQuery* canonicalQuery;
 
+    // The number of documents a multi update gathers from its child and updates together, in
+    // RecordId order and inside a single WriteUnitOfWork. A value of 1 updates each document as
+    // soon as it is returned by the child. Ignored unless the request is a multi update which is
+    // not being explained. Must be 1 for a namespace whose writes are logged to the oplog, since
+    // each write is timestamped with the optime of its own oplog entry.
+    size_t batchSize = 1;
+
 private:
     // Default constructor not allowed.
     UpdateStageParams();
@@ -87,6 +95,7 @@ public:
     StageState doWork(WorkingSetID* out) final;
 
     void doRestoreState() final;
+    void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) final;
 
     StageType stageType() const final {
         return STAGE_UPDATE;
@@ -176,6 +185,20 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Used in place of the update half of doWork() when updating in batches. Adds the documents
+     * returned by our child to '_batch' until it is full or the child is EOF, and then updates
+     * them.
+     */
+    StageState doWorkBatched(WorkingSetID* out);
+
+    /**
+     * Updates every document in '_batch' which still exists and matches the predicate inside a
+     * single WriteUnitOfWork. If a WriteConflictException is thrown, none of the updates are
+     * committed and the batch is kept so that it can be retried after yielding.
+     */
+    StageState updateBatch(WorkingSetID* out);
+
     UpdateStageParams _params;
 
     // Not owned by us.
@@ -190,6 +213,17 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // The documents gathered from our child which have yet to be updated, when updating in
+    // batches.
+    write_stage_common::WriteBatch _batch;
+
+    // Set once '_batch' is complete and should be updated before asking our child for more.
+    bool _batchReady = false;
+
+    // While a batch is being updated, the RecordIds to add to '_updatedRecordIds' once the batch
+    // has committed.
+    std::vector<RecordId> _batchUpdatedRecordIds;
+
     // Stats
     UpdateStats _specificStats;
 
@@ -29,6 +29,8 @@
 
 #include "mongo/db/exec/write_stage_common.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/working_set.h"
@@ -68,5 +70,46 @@ bool ensureStillMatches(const Collection* collection,
     return true;
 }
 
+void WriteBatch::add(WorkingSet* ws, WorkingSetID id) {
+    WorkingSetMember* member = ws->get(id);
+    invariant(member->hasRecordId() && member->hasObj());
+    member->makeObjOwnedIfNeeded();
+    _ids.push_back(id);
+    _bytes += member->obj.value().objsize();
+}
+
+void WriteBatch::sortByRecordId(WorkingSet* ws) {
+    // Members which have been invalidated no longer hold a RecordId. They are skipped when the
+    // batch is written, so their position does not matter.
+    std::stable_sort(_ids.begin(), _ids.end(), [ws](WorkingSetID lhs, WorkingSetID rhs) {
+        const WorkingSetMember* lhsMember = ws->get(lhs);
+        const WorkingSetMember* rhsMember = ws->get(rhs);
+        if (!lhsMember->hasRecordId() || !rhsMember->hasRecordId()) {
+            return lhsMember->hasRecordId() && !rhsMember->hasRecordId();
+        }
+        return lhsMember->recordId < rhsMember->recordId;
+    });
+}
+
+void WriteBatch::invalidate(OperationContext* opCtx,
+                            WorkingSet* ws,
+                            const Collection* collection,
+                            const RecordId& recordId) {
+    for (auto id : _ids) {
+        WorkingSetMember* member = ws->get(id);
+        if (member->hasRecordId() && member->recordId == recordId) {
+            WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, collection);
+        }
+    }
+}
+
+void WriteBatch::clear(WorkingSet* ws) {
+    for (auto id : _ids) {
+        ws->free(id);
+    }
+    _ids.clear();
+    _bytes = 0;
+}
+
 }  // namespace write_stage_common
 }  // namespace mongo
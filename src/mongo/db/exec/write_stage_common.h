@@ -31,6 +31,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
 #include "mongo/db/exec/working_set.h"
 
 namespace mongo {
@@ -41,6 +43,73 @@ class OperationContext;
 
 namespace write_stage_common {
 
+/**
+ * The documents a multi-update or multi-delete has gathered from its child so that it can write
+ * them to the collection together, inside a single WriteUnitOfWork, rather than one at a time.
+ *
+ * The batch owns the working set members it holds until they are released by clear().
+ */
+class WriteBatch {
+public:
+    // The maximum total size of the documents held by a batch, regardless of 'maxDocs'.
+    static const size_t kMaxBytes = 16 * 1024 * 1024;
+
+    /**
+     * Creates a batch holding up to 'maxDocs' documents. A 'maxDocs' of 1 or less disables
+     * batching.
+     */
+    explicit WriteBatch(size_t maxDocs) : _maxDocs(maxDocs) {}
+
+    bool isEnabled() const {
+        return _maxDocs > 1;
+    }
+
+    bool empty() const {
+        return _ids.empty();
+    }
+
+    bool isFull() const {
+        return _ids.size() >= _maxDocs || _bytes >= kMaxBytes;
+    }
+
+    const std::vector<WorkingSetID>& ids() const {
+        return _ids;
+    }
+
+    /**
+     * Adds the member 'id', which must hold a RecordId and a document, to the batch. The document
+     * is made owned since the child stage may free its memory once it advances.
+     */
+    void add(WorkingSet* ws, WorkingSetID id);
+
+    /**
+     * Orders the batch by RecordId, so that the documents are written in the order in which they
+     * are stored.
+     */
+    void sortByRecordId(WorkingSet* ws);
+
+    /**
+     * Detaches any member of the batch which refers to 'recordId' from it, keeping an owned copy of
+     * its document. Should be called when 'recordId' is invalidated.
+     */
+    void invalidate(OperationContext* opCtx,
+                    WorkingSet* ws,
+                    const Collection* collection,
+                    const RecordId& recordId);
+
+    /**
+     * Frees every member of the batch and empties it.
+     */
+    void clear(WorkingSet* ws);
+
+private:
+    const size_t _maxDocs;
+
+    std::vector<WorkingSetID> _ids;
+
+    size_t _bytes = 0;
+};
+
 /**
  * Returns true if the document referred to by 'id' still exists and matches the query predicate
  * given by 'cq'. Returns true if the document still exists and 'cq' is null. Returns false
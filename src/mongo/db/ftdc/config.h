@@ -46,7 +46,9 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          highResolutionPeriod(kHighResolutionPeriodMillisDefault),
+          maxRecentSamplesBytes(kMaxRecentSamplesBytesDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -83,6 +85,20 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * Period at which to run the high-resolution collectors, or zero to not run them.
+     *
+     * High-resolution samples are only kept in memory, for getDiagnosticDataRange, and are never
+     * written to the FTDC files.
+     */
+    Milliseconds highResolutionPeriod;
+
+    /**
+     * Max size in bytes of the compressed recent samples kept in memory for getDiagnosticDataRange.
+     * Applies separately to the periodic and the high-resolution samples.
+     */
+    std::uint64_t maxRecentSamplesBytes;
+
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
@@ -93,6 +109,9 @@ struct FTDCConfig {
 
     static const std::uint32_t kMaxSamplesPerArchiveMetricChunkDefault = 300;
     static const std::uint32_t kMaxSamplesPerInterimMetricChunkDefault = 10;
+
+    static const std::int64_t kHighResolutionPeriodMillisDefault = 0;
+    static const std::uint64_t kMaxRecentSamplesBytesDefault = 10 * 1024 * 1024;
 };
 
 }  // namespace mongo
@@ -92,6 +92,18 @@ void FTDCController::setMaxSamplesPerInterimMetricChunk(size_t size) {
     _condvar.notify_one();
 }
 
+void FTDCController::setHighResolutionPeriod(Milliseconds millis) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.highResolutionPeriod = millis;
+    _condvar.notify_one();
+}
+
+void FTDCController::setMaxRecentSamplesBytes(std::uint64_t size) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.maxRecentSamplesBytes = size;
+    _condvar.notify_one();
+}
+
 Status FTDCController::setDirectory(const boost::filesystem::path& path) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
 
@@ -118,6 +130,16 @@ void FTDCController::addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface
     }
 }
 
+void FTDCController::addHighResolutionCollector(
+    std::unique_ptr<FTDCCollectorInterface> collector) {
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        invariant(_state == State::kNotStarted);
+
+        _highResolutionCollectors.add(std::move(collector));
+    }
+}
+
 void FTDCController::addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
@@ -134,6 +156,13 @@ BSONObj FTDCController::getMostRecentPeriodicDocument() {
     }
 }
 
+StatusWith<std::vector<BSONObj>> FTDCController::getRecentDocuments(
+    Resolution resolution, Date_t from, Date_t to, size_t maxBytes, bool* truncated) {
+    auto& samples = resolution == Resolution::kHighResolution ? _recentHighResolutionSamples
+                                                              : _recentPeriodicSamples;
+    return samples.getSamples(from, to, maxBytes, truncated);
+}
+
 void FTDCController::start() {
     log() << "Initializing full-time diagnostic data capture with directory '"
           << _path.generic_string() << "'";
@@ -199,8 +228,17 @@ void FTDCController::doLoop() {
             // Skipping an interval due to a race condition with a config signal is harmless.
             auto now = getGlobalServiceContext()->getPreciseClockSource()->now();
 
-            // Get next time to run at
-            auto next_time = FTDCUtil::roundTime(now, _config.period);
+            // Get next time to run at. When high-resolution collection is enabled, we also wake
+            // up on its period, and only run the periodic collectors on their own period.
+            auto next_periodic_time = FTDCUtil::roundTime(now, _config.period);
+            auto next_time = next_periodic_time;
+
+            const bool collectHighResolution =
+                _config.enabled && _config.highResolutionPeriod > Milliseconds(0);
+            if (collectHighResolution) {
+                next_time = std::min(next_time,
+                                     FTDCUtil::roundTime(now, _config.highResolutionPeriod));
+            }
 
             // Wait for the next run or signal to shutdown
             {
@@ -229,6 +267,24 @@ void FTDCController::doLoop() {
                 }
             }
 
+            if (collectHighResolution) {
+                auto collectSample = _highResolutionCollectors.collect(client);
+
+                // The recent samples only serve getDiagnosticDataRange, so a failure to keep one
+                // must not stop collection.
+                Status s = _recentHighResolutionSamples.addSample(std::get<0>(collectSample),
+                                                                  std::get<1>(collectSample));
+                if (!s.isOK()) {
+                    warning() << "Failed to keep a high-resolution diagnostic data sample in "
+                                 "memory: "
+                              << s;
+                }
+            }
+
+            if (next_time != next_periodic_time) {
+                continue;
+            }
+
             // TODO: consider only running this thread if we are enabled
             // for now, we just keep an idle thread as it is simpler
             if (_config.enabled) {
@@ -248,6 +304,12 @@ void FTDCController::doLoop() {
 
                 uassertStatusOK(s);
 
+                s = _recentPeriodicSamples.addSample(std::get<0>(collectSample),
+                                                     std::get<1>(collectSample));
+                if (!s.isOK()) {
+                    warning() << "Failed to keep a diagnostic data sample in memory: " << s;
+                }
+
                 // Store a reference to the most recent document from the periodic collectors
                 {
                     stdx::lock_guard<stdx::mutex> lock(_mutex);
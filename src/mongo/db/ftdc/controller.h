@@ -31,11 +31,13 @@
 #include <boost/filesystem/path.hpp>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/file_manager.h"
+#include "mongo/db/ftdc/recent_samples.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -98,6 +100,16 @@ public:
      */
     void setMaxSamplesPerInterimMetricChunk(size_t size);
 
+    /**
+     * Set the period for high-resolution data collection. Zero disables it.
+     */
+    void setHighResolutionPeriod(Milliseconds millis);
+
+    /**
+     * Set the maximum size in bytes of the recent samples kept in memory for each resolution.
+     */
+    void setMaxRecentSamplesBytes(std::uint64_t size);
+
     /*
      * Set the path to store FTDC files if not already set.
      *
@@ -110,6 +122,14 @@ public:
      */
     void addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector);
 
+    /**
+     * Add a metric collector to collect on the high-resolution period, if one is set. i.e., a
+     * subset of serverStatus
+     *
+     * High-resolution samples are kept in memory only.
+     */
+    void addHighResolutionCollector(std::unique_ptr<FTDCCollectorInterface> collector);
+
     /**
      * Add a collector to collect on server start, and file rotation. i.e. hostInfo
      *
@@ -141,6 +161,19 @@ public:
      */
     BSONObj getMostRecentPeriodicDocument();
 
+    /**
+     * Which collectors to query recent samples of.
+     */
+    enum class Resolution { kPeriodic, kHighResolution };
+
+    /**
+     * Get the recent samples, still held in memory, which the periodic or high-resolution
+     * collectors started collecting in [from, to], oldest first, up to 'maxBytes' of them. Sets
+     * 'truncated' if any samples in the range were left out.
+     */
+    StatusWith<std::vector<BSONObj>> getRecentDocuments(
+        Resolution resolution, Date_t from, Date_t to, size_t maxBytes, bool* truncated);
+
 private:
     /**
      * Do periodic statistics collection, and all other work on the background thread.
@@ -203,6 +236,13 @@ private:
     // Owned
     BSONObj _mostRecentPeriodicDocument;
 
+    // Set of high-resolution collectors
+    FTDCCollectorCollection _highResolutionCollectors;
+
+    // Recent samples from the periodic and high-resolution collectors. Internally synchronized.
+    FTDCRecentSamples _recentPeriodicSamples{&_config};
+    FTDCRecentSamples _recentHighResolutionSamples{&_config};
+
     // Set of file rotation collectors
     FTDCCollectorCollection _rotateCollectors;
 
@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/init.h"
+#include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/auth/action_type.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/client.h"
@@ -40,6 +41,31 @@
 namespace mongo {
 namespace {
 
+/**
+ * Checks that 'client' may read every kind of data which the FTDC collectors gather.
+ *
+ * NOTE: For each command run by a collector, there must be an equivalent privilege check here.
+ */
+Status checkAuthForDiagnosticData(Client* client) {
+    if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+            ResourcePattern::forClusterResource(), ActionType::serverStatus)) {
+        return Status(ErrorCodes::Unauthorized, "Unauthorized");
+    }
+
+    if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+            ResourcePattern::forClusterResource(), ActionType::replSetGetStatus)) {
+        return Status(ErrorCodes::Unauthorized, "Unauthorized");
+    }
+
+    if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+            ResourcePattern::forExactNamespace(NamespaceString("local", "oplog.rs")),
+            ActionType::collStats)) {
+        return Status(ErrorCodes::Unauthorized, "Unauthorized");
+    }
+
+    return Status::OK();
+}
+
 /**
  * Get the most recent document FTDC collected from its periodic collectors.
  *
@@ -68,24 +94,7 @@ public:
     Status checkAuthForCommand(Client* client,
                                const std::string& dbname,
                                const BSONObj& cmdObj) const override {
-
-        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
-                ResourcePattern::forClusterResource(), ActionType::serverStatus)) {
-            return Status(ErrorCodes::Unauthorized, "Unauthorized");
-        }
-
-        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
-                ResourcePattern::forClusterResource(), ActionType::replSetGetStatus)) {
-            return Status(ErrorCodes::Unauthorized, "Unauthorized");
-        }
-
-        if (!AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
-                ResourcePattern::forExactNamespace(NamespaceString("local", "oplog.rs")),
-                ActionType::collStats)) {
-            return Status(ErrorCodes::Unauthorized, "Unauthorized");
-        }
-
-        return Status::OK();
+        return checkAuthForDiagnosticData(client);
     }
 
     bool run(OperationContext* opCtx,
@@ -101,10 +110,115 @@ public:
     }
 };
 
+/**
+ * Get the samples FTDC collected in a range of time, decoded from the recent metric chunks which
+ * are still held in memory, rather than from the diagnostic.data files.
+ *
+ * {
+ *     getDiagnosticDataRange: 1,
+ *     startTime: <Date>,         // Optional, defaults to the oldest sample in memory.
+ *     endTime: <Date>,           // Optional, defaults to the newest sample in memory.
+ *     highResolution: <bool>     // Optional, defaults to false.
+ * }
+ *
+ * Replies with the matching samples in 'data', oldest first. If they do not all fit in the reply,
+ * the newest are left out and 'truncated' is set, so that the caller can ask again starting from
+ * the last sample returned.
+ */
+class GetDiagnosticDataRangeCommand final : public BasicCommand {
+public:
+    GetDiagnosticDataRangeCommand() : BasicCommand("getDiagnosticDataRange") {}
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    std::string help() const override {
+        return "get the recent diagnostic data collection samples in a range of time\n"
+               "{ getDiagnosticDataRange: 1, startTime: <Date>, endTime: <Date>, "
+               "highResolution: <bool> }";
+    }
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        return checkAuthForDiagnosticData(client);
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& db,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const Date_t from = extractDate(cmdObj, kStartTimeField, Date_t());
+        const Date_t to = extractDate(cmdObj, kEndTimeField, Date_t::max());
+
+        bool highResolution;
+        uassertStatusOK(bsonExtractBooleanFieldWithDefault(
+            cmdObj, kHighResolutionField, false, &highResolution));
+
+        // Leave room in the reply for the command's other fields.
+        const int kMaxDataBytes = BSONObjMaxUserSize - 16 * 1024;
+
+        bool truncated;
+        auto samples = uassertStatusOK(
+            FTDCController::get(opCtx->getServiceContext())
+                ->getRecentDocuments(highResolution
+                                         ? FTDCController::Resolution::kHighResolution
+                                         : FTDCController::Resolution::kPeriodic,
+                                     from,
+                                     to,
+                                     kMaxDataBytes,
+                                     &truncated));
+
+        // The array's field names add a few bytes per sample to the samples themselves.
+        BSONArrayBuilder data(result.subarrayStart("data"));
+        for (const auto& sample : samples) {
+            if (data.len() + sample.objsize() > kMaxDataBytes) {
+                truncated = true;
+                break;
+            }
+            data.append(sample);
+        }
+        data.doneFast();
+
+        result.append("truncated", truncated);
+        return true;
+    }
+
+private:
+    static constexpr StringData kStartTimeField = "startTime"_sd;
+    static constexpr StringData kEndTimeField = "endTime"_sd;
+    static constexpr StringData kHighResolutionField = "highResolution"_sd;
+
+    static Date_t extractDate(const BSONObj& cmdObj, StringData fieldName, Date_t defaultValue) {
+        BSONElement elem;
+        auto status = bsonExtractTypedField(cmdObj, fieldName, BSONType::Date, &elem);
+        if (status == ErrorCodes::NoSuchKey) {
+            return defaultValue;
+        }
+        uassertStatusOK(status);
+        return elem.Date();
+    }
+};
+
+constexpr StringData GetDiagnosticDataRangeCommand::kStartTimeField;
+constexpr StringData GetDiagnosticDataRangeCommand::kEndTimeField;
+constexpr StringData GetDiagnosticDataRangeCommand::kHighResolutionField;
+
 Command* ftdcCommand;
+Command* ftdcRangeCommand;
 
 MONGO_INITIALIZER(CreateDiagnosticDataCommand)(InitializerContext* context) {
     ftdcCommand = new GetDiagnosticDataCommand();
+    ftdcRangeCommand = new GetDiagnosticDataRangeCommand();
 
     return Status::OK();
 }
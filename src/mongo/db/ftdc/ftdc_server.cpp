@@ -241,6 +241,62 @@ public:
     }
 
 } exportedFTDCInterimChunkSizeParameter;
+
+AtomicInt32 localHighResolutionPeriodMillis(FTDCConfig::kHighResolutionPeriodMillisDefault);
+
+class ExportedFTDCHighResolutionPeriodParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCHighResolutionPeriodParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionHighResolutionPeriodMillis",
+              &localHighResolutionPeriodMillis) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue != 0 && potentialNewValue < 10) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionHighResolutionPeriodMillis must be 0, to "
+                          "disable high-resolution collection, or greater than or equal to 10ms");
+        }
+
+        auto controller = getGlobalFTDCController();
+        if (controller) {
+            controller->setHighResolutionPeriod(Milliseconds(potentialNewValue));
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCHighResolutionPeriodParameter;
+
+AtomicInt32 localMaxRecentSamplesMB(FTDCConfig::kMaxRecentSamplesBytesDefault / (1024 * 1024));
+
+class ExportedFTDCRecentSamplesSizeParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCRecentSamplesSizeParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionRecentSamplesSizeMB",
+              &localMaxRecentSamplesMB) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < 1) {
+            return Status(
+                ErrorCodes::BadValue,
+                "diagnosticDataCollectionRecentSamplesSizeMB must be greater than or equal to 1");
+        }
+
+        auto controller = getGlobalFTDCController();
+        if (controller) {
+            controller->setMaxRecentSamplesBytes(potentialNewValue * 1024 * 1024);
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCRecentSamplesSizeParameter;
 }  // namespace
 
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
@@ -278,6 +334,8 @@ void startFTDC(boost::filesystem::path& path,
     config.maxDirectorySizeBytes = localMaxDirectorySizeMB.load() * 1024 * 1024;
     config.maxSamplesPerArchiveMetricChunk = localMaxSamplesPerArchiveMetricChunk.load();
     config.maxSamplesPerInterimMetricChunk = localMaxSamplesPerInterimMetricChunk.load();
+    config.highResolutionPeriod = Milliseconds(localHighResolutionPeriodMillis.load());
+    config.maxRecentSamplesBytes = localMaxRecentSamplesMB.load() * 1024 * 1024;
 
     auto controller = stdx::make_unique<FTDCController>(path, config);
 
@@ -298,6 +356,22 @@ void startFTDC(boost::filesystem::path& path,
         "",
         BSON("serverStatus" << 1 << "tcMalloc" << true << "sharding" << false)));
 
+    // Install high-resolution collectors
+    // These are collected on the high-resolution period in FTDCConfig, if one is set, and are only
+    // kept in memory for getDiagnosticDataRange. They are limited to the cheap serverStatus
+    // sections which show latency spikes, since they may run many times per second.
+    controller->addHighResolutionCollector(stdx::make_unique<FTDCSimpleInternalCommandCollector>(
+        "serverStatus",
+        "serverStatus",
+        "",
+        BSON("serverStatus" << 1 << "sharding" << false << "metrics" << false << "locks" << false
+                            << "wiredTiger"
+                            << false
+                            << "repl"
+                            << false
+                            << "storageEngine"
+                            << false)));
+
     registerCollectors(controller.get());
 
     // Install System Metric Collector as a periodic collector
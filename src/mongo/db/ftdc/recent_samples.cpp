@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/recent_samples.h"
+
+#include "mongo/db/ftdc/decompressor.h"
+
+namespace mongo {
+
+Status FTDCRecentSamples::addSample(const BSONObj& sample, Date_t date) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    auto swChunk = _compressor.addSample(sample, date);
+    if (!swChunk.isOK()) {
+        return swChunk.getStatus();
+    }
+
+    if (swChunk.getValue().is_initialized()) {
+        ConstDataRange buf = std::get<0>(swChunk.getValue().get());
+        _chunks.push_back({std::get<2>(swChunk.getValue().get()),
+                           std::vector<char>(buf.data(), buf.data() + buf.length())});
+        _chunksBytes += buf.length();
+
+        while (_chunksBytes > _config->maxRecentSamplesBytes && !_chunks.empty()) {
+            _chunksBytes -= _chunks.front().data.size();
+            _chunks.pop_front();
+        }
+    }
+
+    return Status::OK();
+}
+
+StatusWith<std::vector<BSONObj>> FTDCRecentSamples::getSamples(Date_t from,
+                                                                Date_t to,
+                                                                size_t maxBytes,
+                                                                bool* truncated) {
+    *truncated = false;
+    std::vector<BSONObj> samples;
+    if (from > to) {
+        return samples;
+    }
+
+    std::vector<std::vector<char>> chunks;
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+        bool pastRange = false;
+        for (size_t i = 0; i < _chunks.size(); ++i) {
+            // A chunk ends where the next one starts, or where the samples still in the
+            // compressor start.
+            if (_chunks[i].start > to) {
+                pastRange = true;
+                break;
+            }
+            if (i + 1 < _chunks.size() && _chunks[i + 1].start < from) {
+                continue;
+            }
+
+            chunks.push_back(_chunks[i].data);
+        }
+
+        if (!pastRange && _compressor.hasDataToFlush()) {
+            auto swBuf = _compressor.getCompressedSamples();
+            if (!swBuf.isOK()) {
+                return swBuf.getStatus();
+            }
+
+            if (std::get<1>(swBuf.getValue()) <= to) {
+                ConstDataRange buf = std::get<0>(swBuf.getValue());
+                chunks.emplace_back(buf.data(), buf.data() + buf.length());
+            }
+        }
+    }
+
+    size_t numBytes = 0;
+    for (const auto& chunk : chunks) {
+        auto status = _appendSamplesInRange(
+            {chunk.data(), chunk.size()}, from, to, maxBytes, &numBytes, &samples, truncated);
+        if (!status.isOK()) {
+            return status;
+        }
+        if (*truncated) {
+            break;
+        }
+    }
+
+    return samples;
+}
+
+Status FTDCRecentSamples::_appendSamplesInRange(ConstDataRange buf,
+                                                Date_t from,
+                                                Date_t to,
+                                                size_t maxBytes,
+                                                size_t* numBytes,
+                                                std::vector<BSONObj>* samples,
+                                                bool* truncated) {
+    FTDCDecompressor decompressor;
+    auto swDocs = decompressor.uncompress(buf);
+    if (!swDocs.isOK()) {
+        return swDocs.getStatus();
+    }
+
+    for (auto&& doc : swDocs.getValue()) {
+        auto start = doc["start"];
+        if (start.type() != BSONType::Date) {
+            continue;
+        }
+
+        if (start.Date() >= from && start.Date() <= to) {
+            const size_t docBytes = static_cast<size_t>(doc.objsize());
+            if (*numBytes + docBytes > maxBytes) {
+                *truncated = true;
+                return Status::OK();
+            }
+            *numBytes += docBytes;
+            samples->push_back(std::move(doc));
+        }
+    }
+
+    return Status::OK();
+}
+
+}  // namespace mongo
@@ -0,0 +1,123 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/db/ftdc/compressor.h"
+#include "mongo/db/ftdc/config.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Keeps the most recent samples from a set of FTDC collectors in memory so that they can be
+ * queried in-process, without reading the diagnostic.data files.
+ *
+ * Samples are stored as compressed metric chunks, in the same format as the archive files, and are
+ * decompressed only when queried. The oldest chunks are discarded once the total size of the
+ * chunks exceeds FTDCConfig::maxRecentSamplesBytes.
+ *
+ * Samples are addressed by the "start" date which FTDCCollectorCollection::collect() stamps on
+ * every sample.
+ *
+ * Thread-safe.
+ */
+class FTDCRecentSamples {
+    MONGO_DISALLOW_COPYING(FTDCRecentSamples);
+
+public:
+    /**
+     * 'config' must outlive this object. It is only read by addSample().
+     */
+    explicit FTDCRecentSamples(const FTDCConfig* config) : _config(config), _compressor(config) {}
+
+    /**
+     * Adds a sample whose collection started at 'date'.
+     */
+    Status addSample(const BSONObj& sample, Date_t date);
+
+    /**
+     * Returns the buffered samples whose "start" date is in [from, to], oldest first, stopping
+     * before the first sample which would take the total size of the samples past 'maxBytes'.
+     * Sets 'truncated' to whether any samples in the range were left out.
+     *
+     * Only the chunks which may contain samples in the range are decompressed, after copying them
+     * out so that addSample() is not blocked while they are.
+     */
+    StatusWith<std::vector<BSONObj>> getSamples(Date_t from,
+                                                Date_t to,
+                                                size_t maxBytes,
+                                                bool* truncated);
+
+private:
+    /**
+     * A compressed metric chunk, holding samples collected from 'start' until the start of the
+     * next chunk.
+     */
+    struct Chunk {
+        Date_t start;
+        std::vector<char> data;
+    };
+
+    /**
+     * Decompresses 'buf' and appends the samples in [from, to] to 'samples', adding their sizes to
+     * 'numBytes'. Sets 'truncated' and stops at the first sample which would take 'numBytes' past
+     * 'maxBytes'.
+     */
+    static Status _appendSamplesInRange(ConstDataRange buf,
+                                        Date_t from,
+                                        Date_t to,
+                                        size_t maxBytes,
+                                        size_t* numBytes,
+                                        std::vector<BSONObj>* samples,
+                                        bool* truncated);
+
+    const FTDCConfig* const _config;
+
+    // Protects all members below.
+    stdx::mutex _mutex;
+
+    // Compresses the samples which have not yet filled a chunk.
+    FTDCCompressor _compressor;
+
+    // Completed chunks, oldest first.
+    std::deque<Chunk> _chunks;
+
+    // Sum of the sizes of the chunks in '_chunks'.
+    std::uint64_t _chunksBytes{0};
+};
+
+}  // namespace mongo
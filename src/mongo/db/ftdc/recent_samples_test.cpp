@@ -0,0 +1,170 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/recent_samples.h"
+
+#include <limits>
+
+#include "mongo/db/ftdc/config.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeSample(long long millis, int value) {
+    return BSON("start" << Date_t::fromMillisSinceEpoch(millis) << "value" << value << "end"
+                        << Date_t::fromMillisSinceEpoch(millis + 1));
+}
+
+void addSamples(FTDCRecentSamples* recentSamples, long long firstMillis, int count) {
+    for (int i = 0; i < count; ++i) {
+        const long long millis = firstMillis + i * 100;
+        ASSERT_OK(recentSamples->addSample(makeSample(millis, i),
+                                           Date_t::fromMillisSinceEpoch(millis)));
+    }
+}
+
+void assertSamples(const std::vector<BSONObj>& samples, long long firstMillis, int firstValue) {
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const int offset = static_cast<int>(i);
+        ASSERT_BSONOBJ_EQ(samples[i], makeSample(firstMillis + offset * 100, firstValue + offset));
+    }
+}
+
+/**
+ * Returns every buffered sample in [from, to], which must fit in an unlimited budget.
+ */
+std::vector<BSONObj> getSamples(FTDCRecentSamples* recentSamples, Date_t from, Date_t to) {
+    bool truncated;
+    auto samples = unittest::assertGet(
+        recentSamples->getSamples(from, to, std::numeric_limits<size_t>::max(), &truncated));
+    ASSERT_FALSE(truncated);
+    return samples;
+}
+
+// Samples are returned from both the completed chunks and the chunk still being compressed.
+TEST(FTDCRecentSamplesTest, ReturnsSamplesInRange) {
+    FTDCConfig config;
+    config.maxSamplesPerArchiveMetricChunk = 5;
+    FTDCRecentSamples recentSamples(&config);
+
+    addSamples(&recentSamples, 1000, 23);
+
+    auto all = getSamples(&recentSamples, Date_t(), Date_t::max());
+    ASSERT_EQ(all.size(), 23u);
+    assertSamples(all, 1000, 0);
+
+    // The range is inclusive, and may start and end in the middle of a chunk.
+    auto some = getSamples(&recentSamples,
+                           Date_t::fromMillisSinceEpoch(1300),
+                           Date_t::fromMillisSinceEpoch(2100));
+    ASSERT_EQ(some.size(), 9u);
+    assertSamples(some, 1300, 3);
+
+    // Only the samples still being compressed.
+    auto newest = getSamples(&recentSamples, Date_t::fromMillisSinceEpoch(3150), Date_t::max());
+    ASSERT_EQ(newest.size(), 1u);
+    assertSamples(newest, 3200, 22);
+
+    // Ranges which contain no samples.
+    auto none = getSamples(&recentSamples,
+                           Date_t::fromMillisSinceEpoch(3300),
+                           Date_t::fromMillisSinceEpoch(4000));
+    ASSERT_EQ(none.size(), 0u);
+    none = getSamples(&recentSamples,
+                      Date_t::fromMillisSinceEpoch(2000),
+                      Date_t::fromMillisSinceEpoch(1000));
+    ASSERT_EQ(none.size(), 0u);
+}
+
+// A change in the schema of the samples starts a new chunk.
+TEST(FTDCRecentSamplesTest, SchemaChange) {
+    FTDCConfig config;
+    FTDCRecentSamples recentSamples(&config);
+
+    addSamples(&recentSamples, 1000, 3);
+    BSONObj changed = BSON("start" << Date_t::fromMillisSinceEpoch(1300) << "other" << 1);
+    ASSERT_OK(recentSamples.addSample(changed, Date_t::fromMillisSinceEpoch(1300)));
+
+    auto all = getSamples(&recentSamples, Date_t(), Date_t::max());
+    ASSERT_EQ(all.size(), 4u);
+    all.pop_back();
+    assertSamples(all, 1000, 0);
+
+    auto last = getSamples(&recentSamples,
+                           Date_t::fromMillisSinceEpoch(1300),
+                           Date_t::fromMillisSinceEpoch(1300));
+    ASSERT_EQ(last.size(), 1u);
+    ASSERT_BSONOBJ_EQ(last[0], changed);
+}
+
+// The oldest chunks are discarded once the chunks outgrow the configured size.
+TEST(FTDCRecentSamplesTest, EvictsOldestChunks) {
+    FTDCConfig config;
+    config.maxSamplesPerArchiveMetricChunk = 5;
+    config.maxRecentSamplesBytes = 1;
+    FTDCRecentSamples recentSamples(&config);
+
+    addSamples(&recentSamples, 1000, 12);
+
+    // Only the two samples which have not yet filled a chunk are left.
+    auto all = getSamples(&recentSamples, Date_t(), Date_t::max());
+    ASSERT_EQ(all.size(), 2u);
+    assertSamples(all, 2000, 10);
+}
+
+// Samples past the byte budget are left out, however many chunks the range spans.
+TEST(FTDCRecentSamplesTest, StopsAtByteBudget) {
+    FTDCConfig config;
+    config.maxSamplesPerArchiveMetricChunk = 5;
+    FTDCRecentSamples recentSamples(&config);
+
+    addSamples(&recentSamples, 1000, 23);
+
+    // The samples are decompressed with the same types, and so the same size, as one another.
+    const Date_t first = Date_t::fromMillisSinceEpoch(1000);
+    const size_t sampleBytes = getSamples(&recentSamples, first, first)[0].objsize();
+    bool truncated;
+    auto some = unittest::assertGet(
+        recentSamples.getSamples(Date_t(), Date_t::max(), 7 * sampleBytes + 1, &truncated));
+    ASSERT_TRUE(truncated);
+    ASSERT_EQ(some.size(), 7u);
+    assertSamples(some, 1000, 0);
+
+    // A budget which fits the range exactly does not truncate it.
+    auto all = unittest::assertGet(
+        recentSamples.getSamples(Date_t(), Date_t::max(), 23 * sampleBytes, &truncated));
+    ASSERT_FALSE(truncated);
+    ASSERT_EQ(all.size(), 23u);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -32,6 +32,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -181,6 +182,98 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
     return ret;
 }
 
+Status IndexAccessMethod::insertBatchInKeyOrder(OperationContext* opCtx,
+                                                const std::vector<BsonRecord>& bsonRecords,
+                                                const InsertDeleteOptions& options,
+                                                int64_t* numInserted) {
+    invariant(numInserted);
+    *numInserted = 0;
+    if (bsonRecords.empty()) {
+        return Status::OK();
+    }
+
+    struct KeyToInsert {
+        BSONObj key;
+        const BsonRecord* record;
+    };
+    std::vector<KeyToInsert> keysToInsert;
+    keysToInsert.reserve(bsonRecords.size());
+
+    bool isMultikey = false;
+    MultikeyPaths indexMultikeyPaths;
+    for (const auto& bsonRecord : bsonRecords) {
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths multikeyPaths;
+        getKeys(*bsonRecord.docPtr, options.getKeysMode, &keys, &multikeyPaths);
+
+        isMultikey = isMultikey || keys.size() > 1 || isMultikeyFromPaths(multikeyPaths);
+        if (indexMultikeyPaths.empty()) {
+            indexMultikeyPaths = multikeyPaths;
+        } else if (!multikeyPaths.empty()) {
+            invariant(indexMultikeyPaths.size() == multikeyPaths.size());
+            for (size_t i = 0; i < multikeyPaths.size(); ++i) {
+                indexMultikeyPaths[i].insert(multikeyPaths[i].begin(), multikeyPaths[i].end());
+            }
+        }
+
+        for (const auto& key : keys) {
+            keysToInsert.push_back({key, &bsonRecord});
+        }
+    }
+
+    const Ordering ordering = Ordering::make(_descriptor->keyPattern());
+    std::sort(keysToInsert.begin(),
+              keysToInsert.end(),
+              [&](const KeyToInsert& lhs, const KeyToInsert& rhs) {
+                  const int cmp = lhs.key.woCompare(rhs.key, ordering, false);
+                  return cmp != 0 ? cmp < 0 : lhs.record->id < rhs.record->id;
+              });
+
+    Timestamp lastTimestampSet;
+    for (const auto& keyToInsert : keysToInsert) {
+        const BsonRecord& bsonRecord = *keyToInsert.record;
+        if (!bsonRecord.ts.isNull() && bsonRecord.ts != lastTimestampSet) {
+            Status status = opCtx->recoveryUnit()->setTimestamp(bsonRecord.ts);
+            if (!status.isOK())
+                return status;
+            lastTimestampSet = bsonRecord.ts;
+        }
+
+        Status status =
+            _newInterface->insert(opCtx, keyToInsert.key, bsonRecord.id, options.dupsAllowed);
+        if (status.isOK()) {
+            ++*numInserted;
+            continue;
+        }
+
+        if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(opCtx)) {
+            continue;
+        }
+
+        if (status.code() == ErrorCodes::DuplicateKeyValue && !_btreeState->isReady(opCtx)) {
+            LOG(3) << "key " << keyToInsert.key
+                   << " already in index during background indexing (ok)";
+            continue;
+        }
+
+        return status;
+    }
+
+    // Leave the write timestamp where inserting the documents one at a time would have left it.
+    const Timestamp& finalTimestamp = bsonRecords.back().ts;
+    if (!finalTimestamp.isNull() && finalTimestamp != lastTimestampSet) {
+        Status status = opCtx->recoveryUnit()->setTimestamp(finalTimestamp);
+        if (!status.isOK())
+            return status;
+    }
+
+    if (isMultikey) {
+        _btreeState->setMultikey(opCtx, indexMultikeyPaths);
+    }
+
+    return Status::OK();
+}
+
 void IndexAccessMethod::removeOneKey(OperationContext* opCtx,
                                      const BSONObj& key,
                                      const RecordId& loc,
@@ -420,51 +513,74 @@ Status IndexAccessMethod::compact(OperationContext* opCtx) {
 }
 
 std::unique_ptr<IndexAccessMethod::BulkBuilder> IndexAccessMethod::initiateBulk(
-    size_t maxMemoryUsageBytes) {
-    return std::unique_ptr<BulkBuilder>(new BulkBuilder(this, _descriptor, maxMemoryUsageBytes));
+    size_t maxMemoryUsageBytes, size_t numPartitions) {
+    return std::unique_ptr<BulkBuilder>(
+        new BulkBuilder(this, _descriptor, maxMemoryUsageBytes, numPartitions));
 }
 
 IndexAccessMethod::BulkBuilder::BulkBuilder(const IndexAccessMethod* index,
                                             const IndexDescriptor* descriptor,
-                                            size_t maxMemoryUsageBytes)
-    : _sorter(Sorter::make(
-          SortOptions()
-              .TempDir(storageGlobalParams.dbpath + "/_tmp")
-              .ExtSortAllowed()
-              .MaxMemoryUsageBytes(maxMemoryUsageBytes),
-          BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
-      _real(index) {}
+                                            size_t maxMemoryUsageBytes,
+                                            size_t numPartitions)
+    : _partitions(numPartitions), _real(index) {
+    invariant(numPartitions > 0);
+    for (auto&& partition : _partitions) {
+        partition.sorter.reset(
+            Sorter::make(SortOptions()
+                             .TempDir(storageGlobalParams.dbpath + "/_tmp")
+                             .ExtSortAllowed()
+                             .MaxMemoryUsageBytes(maxMemoryUsageBytes / numPartitions),
+                         BtreeExternalSortComparison(descriptor->keyPattern(),
+                                                     descriptor->version())));
+    }
+}
 
 Status IndexAccessMethod::BulkBuilder::insert(OperationContext* opCtx,
                                               const BSONObj& obj,
                                               const RecordId& loc,
                                               const InsertDeleteOptions& options,
                                               int64_t* numInserted) {
+    // Spread the keys over every partition so that each partition's share of the memory is used.
+    const size_t partition = _nextInsertPartition;
+    _nextInsertPartition = (_nextInsertPartition + 1) % _partitions.size();
+
+    const int64_t keysInsertedBefore = _partitions[partition].keysInserted;
+    Status status = insertIntoPartition(partition, obj, loc, options);
+
+    if (NULL != numInserted) {
+        *numInserted += _partitions[partition].keysInserted - keysInsertedBefore;
+    }
+
+    return status;
+}
+
+Status IndexAccessMethod::BulkBuilder::insertIntoPartition(size_t partitionIndex,
+                                                           const BSONObj& obj,
+                                                           const RecordId& loc,
+                                                           const InsertDeleteOptions& options) {
+    Partition& partition = _partitions[partitionIndex];
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     MultikeyPaths multikeyPaths;
 
     _real->getKeys(obj, options.getKeysMode, &keys, &multikeyPaths);
 
-    _everGeneratedMultipleKeys = _everGeneratedMultipleKeys || (keys.size() > 1);
+    partition.everGeneratedMultipleKeys = partition.everGeneratedMultipleKeys || (keys.size() > 1);
 
     if (!multikeyPaths.empty()) {
-        if (_indexMultikeyPaths.empty()) {
-            _indexMultikeyPaths = multikeyPaths;
+        if (partition.multikeyPaths.empty()) {
+            partition.multikeyPaths = multikeyPaths;
         } else {
-            invariant(_indexMultikeyPaths.size() == multikeyPaths.size());
+            invariant(partition.multikeyPaths.size() == multikeyPaths.size());
             for (size_t i = 0; i < multikeyPaths.size(); ++i) {
-                _indexMultikeyPaths[i].insert(multikeyPaths[i].begin(), multikeyPaths[i].end());
+                partition.multikeyPaths[i].insert(multikeyPaths[i].begin(),
+                                                  multikeyPaths[i].end());
             }
         }
     }
 
     for (BSONObjSet::iterator it = keys.begin(); it != keys.end(); ++it) {
-        _sorter->add(*it, loc);
-        _keysInserted++;
-    }
-
-    if (NULL != numInserted) {
-        *numInserted += keys.size();
+        partition.sorter->add(*it, loc);
+        partition.keysInserted++;
     }
 
     return Status::OK();
@@ -478,13 +594,29 @@ Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
                                      set<RecordId>* dupsToDrop) {
     Timer timer;
 
-    std::unique_ptr<BulkBuilder::Sorter::Iterator> it(bulk->_sorter->done());
+    int64_t keysInserted = 0;
+    std::vector<std::shared_ptr<BulkBuilder::Sorter::Iterator>> partitionIterators;
+    for (auto&& partition : bulk->_partitions) {
+        keysInserted += partition.keysInserted;
+        partitionIterators.emplace_back(partition.sorter->done());
+    }
+
+    // Each partition was sorted on its own, so their keys are merged into a single sorted stream.
+    std::shared_ptr<BulkBuilder::Sorter::Iterator> it;
+    if (partitionIterators.size() == 1) {
+        it = std::move(partitionIterators.front());
+    } else {
+        it.reset(BulkBuilder::Sorter::Iterator::merge(
+            partitionIterators,
+            SortOptions(),
+            BtreeExternalSortComparison(_descriptor->keyPattern(), _descriptor->version())));
+    }
 
     stdx::unique_lock<Client> lk(*opCtx->getClient());
     ProgressMeterHolder pm(
         CurOp::get(opCtx)->setMessage_inlock("Index Bulk Build: (2/3) btree bottom up",
                                              "Index: (2/3) BTree Bottom Up Progress",
-                                             bulk->_keysInserted,
+                                             keysInserted,
                                              10));
     lk.unlock();
 
@@ -608,8 +740,32 @@ void IndexAccessMethod::getKeys(const BSONObj& obj,
     }
 }
 
+MultikeyPaths IndexAccessMethod::BulkBuilder::getMultikeyPaths() const {
+    MultikeyPaths indexMultikeyPaths;
+    for (auto&& partition : _partitions) {
+        if (partition.multikeyPaths.empty()) {
+            continue;
+        }
+        if (indexMultikeyPaths.empty()) {
+            indexMultikeyPaths = partition.multikeyPaths;
+            continue;
+        }
+        invariant(indexMultikeyPaths.size() == partition.multikeyPaths.size());
+        for (size_t i = 0; i < indexMultikeyPaths.size(); ++i) {
+            indexMultikeyPaths[i].insert(partition.multikeyPaths[i].begin(),
+                                         partition.multikeyPaths[i].end());
+        }
+    }
+    return indexMultikeyPaths;
+}
+
 bool IndexAccessMethod::BulkBuilder::isMultikey() const {
-    return _everGeneratedMultipleKeys || isMultikeyFromPaths(_indexMultikeyPaths);
+    for (auto&& partition : _partitions) {
+        if (partition.everGeneratedMultipleKeys || isMultikeyFromPaths(partition.multikeyPaths)) {
+            return true;
+        }
+    }
+    return false;
 }
 
 }  // namespace mongo
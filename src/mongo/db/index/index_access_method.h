@@ -47,6 +47,7 @@ extern AtomicBool failIndexKeyTooLong;
 class BSONObjBuilder;
 class MatchExpression;
 class UpdateTicket;
+struct BsonRecord;
 struct InsertDeleteOptions;
 
 /**
@@ -84,6 +85,21 @@ public:
                   const InsertDeleteOptions& options,
                   int64_t* numInserted);
 
+    /**
+     * Internally generate the keys for every document in 'bsonRecords' and insert them into the
+     * index in key order, rather than document by document, so that a batch loaded into an empty
+     * index is appended to it instead of being inserted at random points. Each key is written at
+     * the timestamp of the document it was generated from.
+     *
+     * 'numInserted' will be set to the number of keys added to the index. Unlike insert(), the
+     * keys already inserted are not removed on failure; the caller is expected to roll back the
+     * whole batch.
+     */
+    Status insertBatchInKeyOrder(OperationContext* opCtx,
+                                 const std::vector<BsonRecord>& bsonRecords,
+                                 const InsertDeleteOptions& options,
+                                 int64_t* numInserted);
+
     /**
      * Analogous to above, but remove the records instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the document.
@@ -202,7 +218,8 @@ public:
     class BulkBuilder {
     public:
         /**
-         * Insert into the BulkBuilder as-if inserting into an IndexAccessMethod.
+         * Insert into the BulkBuilder as-if inserting into an IndexAccessMethod. Must not be called
+         * concurrently with any other insertion.
          */
         Status insert(OperationContext* opCtx,
                       const BSONObj& obj,
@@ -210,10 +227,22 @@ public:
                       const InsertDeleteOptions& options,
                       int64_t* numInserted);
 
-        const MultikeyPaths& getMultikeyPaths() const {
-            return _indexMultikeyPaths;
+        /**
+         * Generates the keys of 'obj' and adds them to the given partition, whose keys are sorted
+         * separately from those of the other partitions and merged with them by commitBulk().
+         * Concurrent calls are allowed as long as each uses a different partition.
+         */
+        Status insertIntoPartition(size_t partition,
+                                   const BSONObj& obj,
+                                   const RecordId& loc,
+                                   const InsertDeleteOptions& options);
+
+        size_t getNumPartitions() const {
+            return _partitions.size();
         }
 
+        MultikeyPaths getMultikeyPaths() const;
+
         bool isMultikey() const;
 
     private:
@@ -223,19 +252,31 @@ public:
 
         BulkBuilder(const IndexAccessMethod* index,
                     const IndexDescriptor* descriptor,
-                    size_t maxMemoryUsageBytes);
+                    size_t maxMemoryUsageBytes,
+                    size_t numPartitions);
 
-        std::unique_ptr<Sorter> _sorter;
-        const IndexAccessMethod* _real;
-        int64_t _keysInserted = 0;
+        /**
+         * The keys of the documents inserted into one partition, along with what they reveal about
+         * whether the index is multikey.
+         */
+        struct Partition {
+            std::unique_ptr<Sorter> sorter;
+            int64_t keysInserted = 0;
 
-        // Set to true if at least one document causes IndexAccessMethod::getKeys() to return a
-        // BSONObjSet with size strictly greater than one.
-        bool _everGeneratedMultipleKeys = false;
+            // Set to true if at least one document causes IndexAccessMethod::getKeys() to return a
+            // BSONObjSet with size strictly greater than one.
+            bool everGeneratedMultipleKeys = false;
+
+            // Holds the path components that cause this index to be multikey. The 'multikeyPaths'
+            // vector remains empty if this index doesn't support path-level multikey tracking.
+            MultikeyPaths multikeyPaths;
+        };
+
+        std::vector<Partition> _partitions;
+        const IndexAccessMethod* _real;
 
-        // Holds the path components that cause this index to be multikey. The '_indexMultikeyPaths'
-        // vector remains empty if this index doesn't support path-level multikey tracking.
-        MultikeyPaths _indexMultikeyPaths;
+        // The partition which the next call to insert() uses.
+        size_t _nextInsertPartition = 0;
     };
 
     /**
@@ -246,9 +287,11 @@ public:
      * It is only legal to initiate bulk when the index is new and empty.
      *
      * maxMemoryUsageBytes: amount of memory consumed before the external sorter starts spilling to
-     *                      disk
+     *                      disk, shared evenly between the partitions
+     * numPartitions: number of independently sorted partitions which keys can be inserted into
+     *                concurrently
      */
-    std::unique_ptr<BulkBuilder> initiateBulk(size_t maxMemoryUsageBytes);
+    std::unique_ptr<BulkBuilder> initiateBulk(size_t maxMemoryUsageBytes, size_t numPartitions = 1);
 
     /**
      * Call this when you are ready to finish your bulk work.
@@ -51,8 +51,11 @@
 #include "mongo/db/auth/internal_user_auth.h"
 #include "mongo/db/auth/sasl_command_constants.h"
 #include "mongo/db/auth/security_key.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/logger/async_log_buffer.h"
+#include "mongo/logger/async_rotatable_file_appender.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/logger.h"
 #include "mongo/logger/message_event.h"
@@ -63,6 +66,7 @@
 #include "mongo/logger/rotatable_file_writer.h"
 #include "mongo/logger/syslog_appender.h"
 #include "mongo/platform/process_id.h"
+#include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/ssl_manager.h"
@@ -212,6 +216,38 @@ void forkServerOrDie() {
 }
 
 MONGO_EXPORT_SERVER_PARAMETER(maxLogSizeKB, int, logger::LogContext::kDefaultMaxLogSizeKB);
+
+// When logging to a file, whether log lines are written by a background thread rather than by the
+// threads which log them.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(asyncLogging, bool, false);
+
+// The number of log lines which may wait to be written when asyncLogging is enabled.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(asyncLoggingBufferSize, int, 16 * 1024)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue, "asyncLoggingBufferSize must be at least 1");
+        }
+        return Status::OK();
+    });
+
+// Whether log lines below severity Error are dropped, rather than waited on, when the buffer of
+// lines waiting to be written is full.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(asyncLoggingDropWhenFull, bool, false);
+
+namespace {
+
+logger::AsyncLogBuffer::Stats asyncLogStats;
+ServerStatusMetricField<Counter64> displayAsyncLogEnqueued("logging.async.enqueued",
+                                                           &asyncLogStats.enqueued);
+ServerStatusMetricField<Counter64> displayAsyncLogWritten("logging.async.written",
+                                                          &asyncLogStats.written);
+ServerStatusMetricField<Counter64> displayAsyncLogDropped("logging.async.dropped",
+                                                          &asyncLogStats.dropped);
+ServerStatusMetricField<Counter64> displayAsyncLogBlocked("logging.async.blocked",
+                                                          &asyncLogStats.blocked);
+
+}  // namespace
+
 MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
                           ("GlobalLogManager", "EndStartupOptionHandling", "ForkServer"),
                           ("default"))
@@ -299,12 +335,38 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
 
         LogManager* manager = logger::globalLogManager();
         manager->getGlobalDomain()->clearAppenders();
-        manager->getGlobalDomain()->attachAppender(
-            std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
-                std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
-        manager->getNamedDomain("javascriptOutput")
-            ->attachAppender(std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
-                std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
+        if (asyncLogging) {
+            using logger::AsyncLogBuffer;
+            using logger::AsyncRotatableFileAppender;
+
+            AsyncLogBuffer::Options options;
+            options.capacity = asyncLoggingBufferSize;
+            if (asyncLoggingDropWhenFull) {
+                options.fullPolicy = AsyncLogBuffer::FullPolicy::kDrop;
+            }
+
+            // Intentionally leaked, since threads may log until the process exits. Shutdown tasks
+            // run in the reverse of the order they were registered in, so this one runs after the
+            // tasks registered once startup completes. Anything logged after it is written
+            // synchronously.
+            auto buffer = new AsyncLogBuffer(writer.getValue(), options, &asyncLogStats);
+            registerShutdownTask([buffer] { buffer->shutdown(); });
+
+            manager->getGlobalDomain()->attachAppender(
+                std::make_unique<AsyncRotatableFileAppender<MessageEventEphemeral>>(
+                    std::make_unique<MessageEventDetailsEncoder>(), buffer));
+            manager->getNamedDomain("javascriptOutput")
+                ->attachAppender(
+                    std::make_unique<AsyncRotatableFileAppender<MessageEventEphemeral>>(
+                        std::make_unique<MessageEventDetailsEncoder>(), buffer));
+        } else {
+            manager->getGlobalDomain()->attachAppender(
+                std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
+                    std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
+            manager->getNamedDomain("javascriptOutput")
+                ->attachAppender(std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
+                    std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
+        }
 
         if (serverGlobalParams.logAppend && exists) {
             log() << "***** SERVER RESTARTED *****";
@@ -0,0 +1,332 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_path.h"
+#include "mongo/db/query/query_knobs.h"
+
+namespace mongo {
+namespace {
+
+template <typename T>
+int compareValues(T lhs, T rhs) {
+    if (lhs < rhs) {
+        return -1;
+    }
+    return lhs == rhs ? 0 : 1;
+}
+
+/**
+ * Interprets the result of comparing a document value against the operand of a comparison
+ * predicate of type 'matchType'.
+ */
+bool comparisonMatches(MatchExpression::MatchType matchType, int cmp) {
+    switch (matchType) {
+        case MatchExpression::LT:
+            return cmp < 0;
+        case MatchExpression::LTE:
+            return cmp <= 0;
+        case MatchExpression::EQ:
+            return cmp == 0;
+        case MatchExpression::GT:
+            return cmp > 0;
+        case MatchExpression::GTE:
+            return cmp >= 0;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+}  // namespace
+
+constexpr size_t CompiledMatchExpression::kMaxFields;
+
+std::unique_ptr<CompiledMatchExpression> CompiledMatchExpression::compile(
+    const MatchExpression* expr) {
+    if (!expr || !internalQueryExecEnableCompiledMatchExpression.load()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<CompiledMatchExpression> compiled(new CompiledMatchExpression(expr));
+    if (!compiled->_addPredicates(expr, false)) {
+        return nullptr;
+    }
+
+    return compiled;
+}
+
+bool CompiledMatchExpression::_addPredicates(const MatchExpression* expr, bool negated) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+            if (negated) {
+                return false;
+            }
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                if (!_addPredicates(expr->getChild(i), false)) {
+                    return false;
+                }
+            }
+            return true;
+
+        case MatchExpression::NOT:
+            // Only leaves may be negated, since the negation of a conjunction is a disjunction.
+            if (negated) {
+                return false;
+            }
+            return _addPredicates(expr->getChild(0), true);
+
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::MATCH_IN:
+        case MatchExpression::EXISTS:
+        case MatchExpression::TYPE_OPERATOR:
+        case MatchExpression::REGEX:
+            return _addLeaf(static_cast<const PathMatchExpression*>(expr), negated);
+
+        default:
+            return false;
+    }
+}
+
+bool CompiledMatchExpression::_addLeaf(const PathMatchExpression* expr, bool negated) {
+    Predicate pred;
+    pred.expr = expr;
+    pred.negated = negated;
+
+    const StringData path = expr->path();
+    size_t start = 0;
+    StringData firstPart;
+    while (true) {
+        const size_t dot = path.find('.', start);
+        const StringData part =
+            path.substr(start, dot == std::string::npos ? std::string::npos : dot - start);
+        if (part.empty()) {
+            return false;
+        }
+
+        if (start == 0) {
+            firstPart = part;
+        } else {
+            pred.subPath.push_back(part);
+        }
+
+        if (dot == std::string::npos) {
+            break;
+        }
+        start = dot + 1;
+    }
+
+    auto it = std::find(_fields.begin(), _fields.end(), firstPart);
+    if (it == _fields.end()) {
+        if (_fields.size() == kMaxFields) {
+            return false;
+        }
+        it = _fields.insert(_fields.end(), firstPart);
+    }
+    pred.field = it - _fields.begin();
+
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE: {
+            auto cmpExpr = static_cast<const ComparisonMatchExpressionBase*>(expr);
+            pred.rhs = cmpExpr->getData();
+            switch (pred.rhs.type()) {
+                case NumberInt:
+                    pred.kernel = Kernel::kCompareInt;
+                    break;
+                case NumberLong:
+                    pred.kernel = Kernel::kCompareLong;
+                    break;
+                case NumberDouble:
+                    if (!std::isnan(pred.rhs._numberDouble())) {
+                        pred.kernel = Kernel::kCompareDouble;
+                    }
+                    break;
+                case String:
+                    if (!cmpExpr->getCollator()) {
+                        pred.kernel = Kernel::kCompareString;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            break;
+        }
+
+        case MatchExpression::MATCH_IN: {
+            auto inExpr = static_cast<const InMatchExpression*>(expr);
+            if (!inExpr->getRegexes().empty()) {
+                break;
+            }
+
+            const auto& equalities = inExpr->getEqualities();
+            const bool allIntegers =
+                std::all_of(equalities.begin(), equalities.end(), [](const BSONElement& elem) {
+                    return elem.type() == NumberInt || elem.type() == NumberLong;
+                });
+            const bool allStrings = !inExpr->getCollator() &&
+                std::all_of(equalities.begin(), equalities.end(), [](const BSONElement& elem) {
+                    return elem.type() == String;
+                });
+
+            if (allIntegers) {
+                pred.kernel = Kernel::kInIntegers;
+                for (auto&& elem : equalities) {
+                    pred.integers.insert(elem.numberLong());
+                }
+            } else if (allStrings) {
+                pred.kernel = Kernel::kInStrings;
+                for (auto&& elem : equalities) {
+                    pred.strings[elem.valueStringData()] = true;
+                }
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    _predicates.push_back(std::move(pred));
+    return true;
+}
+
+bool CompiledMatchExpression::_evaluate(const Predicate& pred, const BSONElement& elem) {
+    switch (pred.kernel) {
+        case Kernel::kGeneric:
+            break;
+
+        case Kernel::kCompareInt:
+            if (elem.type() == NumberInt) {
+                return comparisonMatches(
+                    pred.expr->matchType(),
+                    compareValues(elem._numberInt(), pred.rhs._numberInt()));
+            }
+            break;
+
+        case Kernel::kCompareLong:
+            if (elem.type() == NumberLong) {
+                return comparisonMatches(
+                    pred.expr->matchType(),
+                    compareValues(elem._numberLong(), pred.rhs._numberLong()));
+            }
+            break;
+
+        case Kernel::kCompareDouble:
+            if (elem.type() == NumberDouble && !std::isnan(elem._numberDouble())) {
+                return comparisonMatches(
+                    pred.expr->matchType(),
+                    compareValues(elem._numberDouble(), pred.rhs._numberDouble()));
+            }
+            break;
+
+        case Kernel::kCompareString:
+            if (elem.type() == String) {
+                return comparisonMatches(
+                    pred.expr->matchType(),
+                    elem.valueStringData().compare(pred.rhs.valueStringData()));
+            }
+            break;
+
+        case Kernel::kInIntegers:
+            if (elem.type() == NumberInt || elem.type() == NumberLong) {
+                return pred.integers.count(elem.numberLong());
+            }
+            break;
+
+        case Kernel::kInStrings:
+            if (elem.type() == String) {
+                return pred.strings.find(elem.valueStringData()) != pred.strings.end();
+            }
+            break;
+    }
+
+    // Values of other types go through the general matcher, which handles comparisons across
+    // numeric types, null and missing values, NaN, and collations.
+    return pred.expr->matchesSingleElement(elem, nullptr);
+}
+
+bool CompiledMatchExpression::matchesBSON(const BSONObj& doc) const {
+    // Resolve the first component of every path in a single pass over the document. Like
+    // BSONObj::getField(), the first occurrence of a duplicated field name wins.
+    std::array<BSONElement, kMaxFields> fields;
+    size_t numResolved = 0;
+    BSONObjIterator it(doc);
+    while (numResolved < _fields.size() && it.more()) {
+        const BSONElement elem = it.next();
+        const StringData fieldName = elem.fieldNameStringData();
+        for (size_t i = 0; i < _fields.size(); ++i) {
+            if (fields[i].eoo() && _fields[i] == fieldName) {
+                fields[i] = elem;
+                ++numResolved;
+                break;
+            }
+        }
+    }
+
+    for (auto&& pred : _predicates) {
+        BSONElement elem = fields[pred.field];
+        for (auto&& part : pred.subPath) {
+            if (elem.type() == Object) {
+                elem = elem.embeddedObject().getField(part);
+            } else if (elem.type() == Array) {
+                return _expr->matchesBSON(doc);
+            } else {
+                // A path through a scalar or a missing field resolves to a missing value.
+                elem = BSONElement();
+                break;
+            }
+        }
+
+        if (elem.type() == Array) {
+            return _expr->matchesBSON(doc);
+        }
+
+        if (_evaluate(pred, elem) == pred.negated) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace mongo
@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class PathMatchExpression;
+
+/**
+ * A flattened form of a MatchExpression for the filter shapes which dominate unindexed scans: a
+ * conjunction of (possibly negated) $eq, $lt, $lte, $gt, $gte, $in, $exists, $type and $regex
+ * predicates.
+ *
+ * Rather than walking the expression tree and resolving each path on its own, matchesBSON() makes
+ * a single pass over the top-level fields of the document to resolve the paths of all predicates at
+ * once, and evaluates comparisons and $in against numbers and strings with kernels specialized for
+ * the type of the operand. Any other predicate is evaluated with matchesSingleElement().
+ *
+ * Array traversal is left to the original expression: a document in which the path of any
+ * predicate reaches an array is matched with 'expr->matchesBSON()' instead.
+ */
+class CompiledMatchExpression {
+    MONGO_DISALLOW_COPYING(CompiledMatchExpression);
+
+public:
+    /**
+     * Maximum number of distinct top-level fields referenced by a compiled filter.
+     */
+    static constexpr size_t kMaxFields = 16;
+
+    /**
+     * Returns the compiled form of 'expr', or nullptr if 'expr' has an unsupported shape or
+     * compiled filters are disabled. The compiled form refers to 'expr', which must outlive it and
+     * must not be modified while it is in use.
+     */
+    static std::unique_ptr<CompiledMatchExpression> compile(const MatchExpression* expr);
+
+    /**
+     * Returns the same result as 'expr->matchesBSON(doc)'.
+     */
+    bool matchesBSON(const BSONObj& doc) const;
+
+private:
+    // How a predicate is evaluated against the element its path resolves to.
+    enum class Kernel {
+        kGeneric,
+        kCompareInt,
+        kCompareLong,
+        kCompareDouble,
+        kCompareString,
+        kInIntegers,
+        kInStrings,
+    };
+
+    struct Predicate {
+        const PathMatchExpression* expr;
+        bool negated;
+
+        // Index in '_fields' of the first component of the path, followed by the remaining ones.
+        size_t field;
+        std::vector<StringData> subPath;
+
+        Kernel kernel = Kernel::kGeneric;
+
+        // Operands of the specialized kernels.
+        BSONElement rhs;
+        std::unordered_set<long long> integers;
+        StringMap<bool> strings;
+    };
+
+    explicit CompiledMatchExpression(const MatchExpression* expr) : _expr(expr) {}
+
+    /**
+     * Adds the predicates of 'expr' to this filter. Returns false if 'expr' cannot be compiled.
+     */
+    bool _addPredicates(const MatchExpression* expr, bool negated);
+
+    bool _addLeaf(const PathMatchExpression* expr, bool negated);
+
+    /**
+     * Evaluates 'pred' against 'elem', which is the value its path resolves to.
+     */
+    static bool _evaluate(const Predicate& pred, const BSONElement& elem);
+
+    const MatchExpression* const _expr;
+
+    // Distinct top-level field names referenced by the predicates.
+    std::vector<StringData> _fields;
+
+    std::vector<Predicate> _predicates;
+};
+
+}  // namespace mongo
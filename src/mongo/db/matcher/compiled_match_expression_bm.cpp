@@ -0,0 +1,122 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/platform/random.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+const int kNumDocuments = 1000;
+const int kNumFields = 20;
+
+/**
+ * Documents shaped like the rows of a tenant-isolated collection: a tenant id, a status string,
+ * a handful of numeric fields and a small subdocument, followed by padding fields which the
+ * filters never look at.
+ */
+std::vector<BSONObj> makeDocuments() {
+    PseudoRandom random(1);
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < kNumDocuments; ++i) {
+        BSONObjBuilder builder;
+        builder.append("_id", i);
+        builder.append("tenant", static_cast<long long>(random.nextInt32(50)));
+        builder.append("status", str::stream() << "status" << random.nextInt32(8));
+        builder.append("price", random.nextInt32(1000) / 10.0);
+        builder.append("qty", random.nextInt32(100));
+        builder.append("meta", BSON("region" << random.nextInt32(4) << "flag" << (i % 2 == 0)));
+        for (int field = 0; field < kNumFields; ++field) {
+            builder.append(str::stream() << "pad" << field, "padding");
+        }
+        docs.push_back(builder.obj());
+    }
+    return docs;
+}
+
+const std::vector<BSONObj>& documents() {
+    static const std::vector<BSONObj> docs = makeDocuments();
+    return docs;
+}
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& filter) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    return uassertStatusOK(MatchExpressionParser::parse(filter, expCtx));
+}
+
+void BM_MatchInterpreted(benchmark::State& state, const char* filterJson) {
+    const BSONObj filter = fromjson(filterJson);
+    auto expr = parse(filter);
+    const auto& docs = documents();
+
+    for (auto keepRunning : state) {
+        for (auto&& doc : docs) {
+            benchmark::DoNotOptimize(expr->matchesBSON(doc));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+void BM_MatchCompiled(benchmark::State& state, const char* filterJson) {
+    const BSONObj filter = fromjson(filterJson);
+    auto expr = parse(filter);
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    invariant(compiled);
+    const auto& docs = documents();
+
+    for (auto keepRunning : state) {
+        for (auto&& doc : docs) {
+            benchmark::DoNotOptimize(compiled->matchesBSON(doc));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+#define MATCH_BENCHMARKS(name, filterJson)                    \
+    BENCHMARK_CAPTURE(BM_MatchInterpreted, name, filterJson); \
+    BENCHMARK_CAPTURE(BM_MatchCompiled, name, filterJson)
+
+MATCH_BENCHMARKS(Eq, "{tenant: NumberLong(7)}");
+MATCH_BENCHMARKS(StringEq, "{status: 'status3'}");
+MATCH_BENCHMARKS(Range, "{price: {$gte: 25.0, $lt: 75.0}}");
+MATCH_BENCHMARKS(In, "{status: {$in: ['status1', 'status4', 'status6']}}");
+MATCH_BENCHMARKS(TenantAndRange, "{tenant: NumberLong(7), qty: {$gt: 10, $lte: 90}}");
+MATCH_BENCHMARKS(Dotted, "{tenant: {$in: [3, 7, 11]}, 'meta.region': 2, status: {$ne: 'status0'}}");
+MATCH_BENCHMARKS(MissingField, "{tenant: NumberLong(7), missing: null}");
+
+}  // namespace
+}  // namespace mongo
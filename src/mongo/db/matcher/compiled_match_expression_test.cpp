@@ -0,0 +1,168 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& filter,
+                                       const CollatorInterface* collator = nullptr) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    expCtx->setCollator(collator);
+    return uassertStatusOK(MatchExpressionParser::parse(
+        filter, expCtx, ExtensionsCallbackNoop(), MatchExpressionParser::kAllowAllSpecialFeatures));
+}
+
+const std::vector<BSONObj>& documents() {
+    static const std::vector<BSONObj> docs = {
+        fromjson("{}"),
+        fromjson("{a: 1}"),
+        fromjson("{a: 2, b: 'abc'}"),
+        fromjson("{a: NumberLong(2), b: 'abd'}"),
+        fromjson("{a: 2.0, b: 'ab'}"),
+        fromjson("{a: 2.5, b: 'b'}"),
+        fromjson("{a: NumberDecimal('2'), b: 'ABC'}"),
+        fromjson("{a: NaN, b: null}"),
+        BSON("a" << BSONNULL << "b" << BSONSymbol("abc")),
+        fromjson("{a: 'abc', b: 3}"),
+        fromjson("{a: [1, 2], b: 'abc'}"),
+        fromjson("{a: [], b: ['abc']}"),
+        fromjson("{a: {b: 2}, c: 5}"),
+        fromjson("{a: {b: [1, 2]}, c: 5}"),
+        fromjson("{a: {b: {c: 'x'}}}"),
+        fromjson("{a: [{b: 2}, {b: 3}]}"),
+        fromjson("{a: 5, b: 'abc', a: 2}"),
+        fromjson("{c: 5, b: 'abc', a: 2}"),
+        fromjson("{a: {$minKey: 1}, b: {$maxKey: 1}}"),
+    };
+    return docs;
+}
+
+/**
+ * Asserts that 'filter' compiles and that the compiled form agrees with the original expression on
+ * every test document.
+ */
+void assertCompiledMatchesOriginal(const BSONObj& filter,
+                                   const CollatorInterface* collator = nullptr) {
+    auto expr = parse(filter, collator);
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled) << filter;
+
+    for (auto&& doc : documents()) {
+        ASSERT_EQ(expr->matchesBSON(doc), compiled->matchesBSON(doc)) << filter << " " << doc;
+    }
+}
+
+TEST(CompiledMatchExpressionTest, ComparisonsAgreeWithMatcher) {
+    for (auto&& op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        for (auto&& operand : {BSON("" << 2),
+                               BSON("" << 2LL),
+                               BSON("" << 2.0),
+                               BSON("" << std::numeric_limits<double>::quiet_NaN()),
+                               BSON("" << "abc"),
+                               BSON("" << BSONNULL),
+                               BSON("" << MINKEY),
+                               BSON("" << BSON("b" << 2))}) {
+            for (auto&& path : {"a", "b", "a.b", "a.b.c", "c", "missing"}) {
+                assertCompiledMatchesOriginal(BSON(path << BSON(op << operand.firstElement())));
+            }
+        }
+    }
+}
+
+TEST(CompiledMatchExpressionTest, InAgreesWithMatcher) {
+    for (auto&& filter : {fromjson("{a: {$in: [1, NumberLong(2)]}}"),
+                          fromjson("{a: {$in: [1, 2.5]}}"),
+                          fromjson("{a: {$in: []}}"),
+                          fromjson("{a: {$in: [null, 1]}}"),
+                          fromjson("{b: {$in: ['abc', 'b']}}"),
+                          fromjson("{b: {$in: ['abc', 3]}}"),
+                          fromjson("{b: {$in: [/^ab/, 3]}}"),
+                          fromjson("{'a.b': {$in: [2, 3]}}")}) {
+        assertCompiledMatchesOriginal(filter);
+    }
+}
+
+TEST(CompiledMatchExpressionTest, ConjunctionsAndNegationsAgreeWithMatcher) {
+    for (auto&& filter : {fromjson("{}"),
+                          fromjson("{a: {$gt: 1, $lt: 3}, b: 'abc'}"),
+                          fromjson("{a: {$ne: 2}}"),
+                          fromjson("{a: {$nin: [1, 2]}}"),
+                          fromjson("{a: {$exists: true}, b: {$exists: false}}"),
+                          fromjson("{a: {$type: 'number'}, b: {$not: {$type: 'string'}}}"),
+                          fromjson("{b: /^ab/}"),
+                          fromjson("{b: {$not: /^ab/}}"),
+                          fromjson("{$and: [{a: {$gte: 1}}, {$and: [{c: 5}, {'a.b': 2}]}]}"),
+                          fromjson("{a: null}"),
+                          fromjson("{'a.b': null}")}) {
+        assertCompiledMatchesOriginal(filter);
+    }
+}
+
+TEST(CompiledMatchExpressionTest, StringComparisonsUseCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    assertCompiledMatchesOriginal(fromjson("{b: 'abc'}"), &collator);
+    assertCompiledMatchesOriginal(fromjson("{b: {$gt: 'abc'}}"), &collator);
+    assertCompiledMatchesOriginal(fromjson("{b: {$in: ['abc', 'b']}}"), &collator);
+}
+
+TEST(CompiledMatchExpressionTest, UnsupportedShapesDoNotCompile) {
+    for (auto&& filter : {fromjson("{$or: [{a: 1}, {b: 1}]}"),
+                          fromjson("{$nor: [{a: 1}]}"),
+                          fromjson("{a: {$elemMatch: {$gt: 1}}}"),
+                          fromjson("{a: {$size: 2}}"),
+                          fromjson("{a: {$mod: [2, 0]}}"),
+                          fromjson("{$expr: {$eq: ['$a', 1]}}"),
+                          fromjson("{a: {$not: {$gt: 1, $lt: 3}}}")}) {
+        auto expr = parse(filter);
+        ASSERT_FALSE(CompiledMatchExpression::compile(expr.get())) << filter;
+    }
+}
+
+TEST(CompiledMatchExpressionTest, TooManyFieldsDoNotCompile) {
+    BSONObjBuilder filterBuilder;
+    for (size_t i = 0; i <= CompiledMatchExpression::kMaxFields; ++i) {
+        filterBuilder.append(str::stream() << "f" << i, 1);
+    }
+    const BSONObj filter = filterBuilder.obj();
+    auto expr = parse(filter);
+    ASSERT_FALSE(CompiledMatchExpression::compile(expr.get()));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -128,6 +128,18 @@ private:
 
 class AccumulatorFirst final : public Accumulator {
 public:
+    /**
+     * The state of a $first. $group keeps this inline for each of its groups, so accumulate() and
+     * finalize() implement the accumulator for both it and AccumulatorFirst.
+     */
+    struct State {
+        bool haveFirst = false;
+        Value first;
+    };
+
+    static void accumulate(State* state, const Value& input);
+    static Value finalize(const State& state);
+
     explicit AccumulatorFirst(const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
     void processInternal(const Value& input, bool merging) final;
@@ -139,8 +151,7 @@ public:
         const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
 private:
-    bool _haveFirst;
-    Value _first;
+    State _state;
 };
 
 
@@ -163,6 +174,19 @@ private:
 
 class AccumulatorSum final : public Accumulator {
 public:
+    /**
+     * The state of a $sum. $group keeps this inline for each of its groups, so accumulate() and
+     * finalize() implement the accumulator for both it and AccumulatorSum.
+     */
+    struct State {
+        BSONType totalType = NumberInt;
+        DoubleDoubleSummation nonDecimalTotal;
+        Decimal128 decimalTotal;
+    };
+
+    static void accumulate(State* state, const Value& input, bool merging);
+    static Value finalize(const State& state, bool toBeMerged);
+
     explicit AccumulatorSum(const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
     void processInternal(const Value& input, bool merging) final;
@@ -182,9 +206,7 @@ public:
     }
 
 private:
-    BSONType totalType = NumberInt;
-    DoubleDoubleSummation nonDecimalTotal;
-    Decimal128 decimalTotal;
+    State _state;
 };
 
 
@@ -195,6 +217,17 @@ public:
         MAX = -1,  // Used to "scale" comparison.
     };
 
+    /**
+     * Updates 'val', the state of a $min or $max, with 'input'. $group keeps this state inline for
+     * each of its groups, so accumulate() and finalize() implement the accumulator for both it and
+     * AccumulatorMinMax.
+     */
+    static void accumulate(Value* val,
+                           const Value& input,
+                           Sense sense,
+                           const ValueComparator& comparator);
+    static Value finalize(const Value& val);
+
     AccumulatorMinMax(const boost::intrusive_ptr<ExpressionContext>& expCtx, Sense sense);
 
     void processInternal(const Value& input, bool merging) final;
@@ -251,6 +284,26 @@ private:
 
 class AccumulatorAvg final : public Accumulator {
 public:
+    /**
+     * The state of an $avg. $group keeps this inline for each of its groups, so accumulate() and
+     * finalize() implement the accumulator for both it and AccumulatorAvg.
+     */
+    struct State {
+        /**
+         * The total of all values is partitioned between those that are decimals, and those that
+         * are not decimals, so the decimal total needs to add the non-decimal.
+         */
+        Decimal128 getDecimalTotal() const;
+
+        bool isDecimal = false;
+        DoubleDoubleSummation nonDecimalTotal;
+        Decimal128 decimalTotal;
+        long long count = 0;
+    };
+
+    static void accumulate(State* state, const Value& input, bool merging);
+    static Value finalize(const State& state, bool toBeMerged);
+
     explicit AccumulatorAvg(const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
     void processInternal(const Value& input, bool merging) final;
@@ -262,16 +315,7 @@ public:
         const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
 private:
-    /**
-     * The total of all values is partitioned between those that are decimals, and those that are
-     * not decimals, so the decimal total needs to add the non-decimal.
-     */
-    Decimal128 _getDecimalTotal() const;
-
-    bool _isDecimal;
-    DoubleDoubleSummation _nonDecimalTotal;
-    Decimal128 _decimalTotal;
-    long long _count;
+    State _state;
 };
 
 
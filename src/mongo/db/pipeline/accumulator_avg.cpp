@@ -54,42 +54,47 @@ const char subTotalErrorName[] = "subTotalError";  // Used for extra precision
 const char countName[] = "count";
 }  // namespace
 
-void AccumulatorAvg::processInternal(const Value& input, bool merging) {
+void AccumulatorAvg::accumulate(State* state, const Value& input, bool merging) {
     if (merging) {
         // We expect an object that contains both a subtotal and a count. Additionally there may
         // be an error value, that allows for additional precision.
-        // 'input' is what getValue(true) produced below.
+        // 'input' is what finalize(state, true) produced below.
         verify(input.getType() == Object);
         // We're recursively adding the subtotal to get the proper type treatment, but this only
         // increments the count by one, so adjust the count afterwards. Similarly for 'error'.
-        processInternal(input[subTotalName], false);
-        _count += input[countName].getLong() - 1;
+        accumulate(state, input[subTotalName], false);
+        state->count += input[countName].getLong() - 1;
         Value error = input[subTotalErrorName];
         if (!error.missing()) {
-            processInternal(error, false);
-            _count--;  // The error correction only adjusts the total, not the number of items.
+            accumulate(state, error, false);
+            // The error correction only adjusts the total, not the number of items.
+            state->count--;
         }
         return;
     }
 
     switch (input.getType()) {
         case NumberDecimal:
-            _decimalTotal = _decimalTotal.add(input.getDecimal());
-            _isDecimal = true;
+            state->decimalTotal = state->decimalTotal.add(input.getDecimal());
+            state->isDecimal = true;
             break;
         case NumberLong:
             // Avoid summation using double as that loses precision.
-            _nonDecimalTotal.addLong(input.getLong());
+            state->nonDecimalTotal.addLong(input.getLong());
             break;
         case NumberInt:
         case NumberDouble:
-            _nonDecimalTotal.addDouble(input.getDouble());
+            state->nonDecimalTotal.addDouble(input.getDouble());
             break;
         default:
             dassert(!input.numeric());
             return;
     }
-    _count++;
+    state->count++;
+}
+
+void AccumulatorAvg::processInternal(const Value& input, bool merging) {
+    accumulate(&_state, input, merging);
 }
 
 intrusive_ptr<Accumulator> AccumulatorAvg::create(
@@ -97,40 +102,42 @@ intrusive_ptr<Accumulator> AccumulatorAvg::create(
     return new AccumulatorAvg(expCtx);
 }
 
-Decimal128 AccumulatorAvg::_getDecimalTotal() const {
-    return _decimalTotal.add(_nonDecimalTotal.getDecimal());
+Decimal128 AccumulatorAvg::State::getDecimalTotal() const {
+    return decimalTotal.add(nonDecimalTotal.getDecimal());
 }
 
-Value AccumulatorAvg::getValue(bool toBeMerged) {
+Value AccumulatorAvg::finalize(const State& state, bool toBeMerged) {
     if (toBeMerged) {
-        if (_isDecimal)
-            return Value(Document{{subTotalName, _getDecimalTotal()}, {countName, _count}});
+        if (state.isDecimal)
+            return Value(
+                Document{{subTotalName, state.getDecimalTotal()}, {countName, state.count}});
 
         double total, error;
-        std::tie(total, error) = _nonDecimalTotal.getDoubleDouble();
+        std::tie(total, error) = state.nonDecimalTotal.getDoubleDouble();
         return Value(
-            Document{{subTotalName, total}, {countName, _count}, {subTotalErrorName, error}});
+            Document{{subTotalName, total}, {countName, state.count}, {subTotalErrorName, error}});
     }
 
-    if (_count == 0)
+    if (state.count == 0)
         return Value(BSONNULL);
 
-    if (_isDecimal)
-        return Value(_getDecimalTotal().divide(Decimal128(static_cast<int64_t>(_count))));
+    if (state.isDecimal)
+        return Value(state.getDecimalTotal().divide(Decimal128(static_cast<int64_t>(state.count))));
+
+    return Value(state.nonDecimalTotal.getDouble() / static_cast<double>(state.count));
+}
 
-    return Value(_nonDecimalTotal.getDouble() / static_cast<double>(_count));
+Value AccumulatorAvg::getValue(bool toBeMerged) {
+    return finalize(_state, toBeMerged);
 }
 
 AccumulatorAvg::AccumulatorAvg(const boost::intrusive_ptr<ExpressionContext>& expCtx)
-    : Accumulator(expCtx), _isDecimal(false), _count(0) {
+    : Accumulator(expCtx) {
     // This is a fixed size Accumulator so we never need to update this
     _memUsageBytes = sizeof(*this);
 }
 
 void AccumulatorAvg::reset() {
-    _isDecimal = false;
-    _nonDecimalTotal = {};
-    _decimalTotal = {};
-    _count = 0;
+    _state = {};
 }
 }
@@ -43,28 +43,35 @@ const char* AccumulatorFirst::getOpName() const {
     return "$first";
 }
 
-void AccumulatorFirst::processInternal(const Value& input, bool merging) {
+void AccumulatorFirst::accumulate(State* state, const Value& input) {
     /* only remember the first value seen */
-    if (!_haveFirst) {
+    if (!state->haveFirst) {
         // can't use pValue.missing() since we want the first value even if missing
-        _haveFirst = true;
-        _first = input;
-        _memUsageBytes = sizeof(*this) + input.getApproximateSize() - sizeof(Value);
+        state->haveFirst = true;
+        state->first = input;
     }
 }
 
+Value AccumulatorFirst::finalize(const State& state) {
+    return state.first;
+}
+
+void AccumulatorFirst::processInternal(const Value& input, bool merging) {
+    accumulate(&_state, input);
+    _memUsageBytes = sizeof(*this) + _state.first.getApproximateSize() - sizeof(Value);
+}
+
 Value AccumulatorFirst::getValue(bool toBeMerged) {
-    return _first;
+    return finalize(_state);
 }
 
 AccumulatorFirst::AccumulatorFirst(const boost::intrusive_ptr<ExpressionContext>& expCtx)
-    : Accumulator(expCtx), _haveFirst(false) {
+    : Accumulator(expCtx) {
     _memUsageBytes = sizeof(*this);
 }
 
 void AccumulatorFirst::reset() {
-    _haveFirst = false;
-    _first = Value();
+    _state = {};
     _memUsageBytes = sizeof(*this);
 }
 
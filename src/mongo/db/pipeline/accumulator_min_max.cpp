@@ -49,23 +49,34 @@ const char* AccumulatorMinMax::getOpName() const {
     return "$max";
 }
 
-void AccumulatorMinMax::processInternal(const Value& input, bool merging) {
+void AccumulatorMinMax::accumulate(Value* val,
+                                   const Value& input,
+                                   Sense sense,
+                                   const ValueComparator& comparator) {
     // nullish values should have no impact on result
     if (!input.nullish()) {
         /* compare with the current value; swap if appropriate */
-        int cmp = getExpressionContext()->getValueComparator().compare(_val, input) * _sense;
-        if (cmp > 0 || _val.missing()) {  // missing is lower than all other values
-            _val = input;
-            _memUsageBytes = sizeof(*this) + input.getApproximateSize() - sizeof(Value);
+        int cmp = comparator.compare(*val, input) * sense;
+        if (cmp > 0 || val->missing()) {  // missing is lower than all other values
+            *val = input;
         }
     }
 }
 
-Value AccumulatorMinMax::getValue(bool toBeMerged) {
-    if (_val.missing()) {
+Value AccumulatorMinMax::finalize(const Value& val) {
+    if (val.missing()) {
         return Value(BSONNULL);
     }
-    return _val;
+    return val;
+}
+
+void AccumulatorMinMax::processInternal(const Value& input, bool merging) {
+    accumulate(&_val, input, _sense, getExpressionContext()->getValueComparator());
+    _memUsageBytes = sizeof(*this) + _val.getApproximateSize() - sizeof(Value);
+}
+
+Value AccumulatorMinMax::getValue(bool toBeMerged) {
+    return finalize(_val);
 }
 
 AccumulatorMinMax::AccumulatorMinMax(const boost::intrusive_ptr<ExpressionContext>& expCtx,
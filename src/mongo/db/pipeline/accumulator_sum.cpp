@@ -55,42 +55,47 @@ const char subTotalErrorName[] = "subTotalError";  // Used for extra precision.
 }  // namespace
 
 
-void AccumulatorSum::processInternal(const Value& input, bool merging) {
+void AccumulatorSum::accumulate(State* state, const Value& input, bool merging) {
     if (!input.numeric()) {
         if (merging && input.getType() == Object) {
-            // Process merge document, see getValue() below.
-            nonDecimalTotal.addDouble(
-                input[subTotalName].getDouble());              // Sum without adjusting type.
-            processInternal(input[subTotalErrorName], false);  // Sum adjusting for type of error.
+            // Process merge document, see finalize() below.
+            state->nonDecimalTotal.addDouble(
+                input[subTotalName].getDouble());  // Sum without adjusting type.
+            accumulate(state, input[subTotalErrorName], false);  // Sum adjusting for type of error.
         }
         return;
     }
 
     // Upgrade to the widest type required to hold the result.
-    totalType = Value::getWidestNumeric(totalType, input.getType());
+    state->totalType = Value::getWidestNumeric(state->totalType, input.getType());
     switch (input.getType()) {
         case NumberInt:
         case NumberLong:
-            nonDecimalTotal.addLong(input.coerceToLong());
+            state->nonDecimalTotal.addLong(input.coerceToLong());
             break;
         case NumberDouble:
-            nonDecimalTotal.addDouble(input.getDouble());
+            state->nonDecimalTotal.addDouble(input.getDouble());
             break;
         case NumberDecimal:
-            decimalTotal = decimalTotal.add(input.coerceToDecimal());
+            state->decimalTotal = state->decimalTotal.add(input.coerceToDecimal());
             break;
         default:
             MONGO_UNREACHABLE;
     }
 }
 
+void AccumulatorSum::processInternal(const Value& input, bool merging) {
+    accumulate(&_state, input, merging);
+}
+
 intrusive_ptr<Accumulator> AccumulatorSum::create(
     const boost::intrusive_ptr<ExpressionContext>& expCtx) {
     return new AccumulatorSum(expCtx);
 }
 
-Value AccumulatorSum::getValue(bool toBeMerged) {
-    switch (totalType) {
+Value AccumulatorSum::finalize(const State& state, bool toBeMerged) {
+    const auto& nonDecimalTotal = state.nonDecimalTotal;
+    switch (state.totalType) {
         case NumberInt:
             if (nonDecimalTotal.fitsLong())
                 return Value::createIntOrLong(nonDecimalTotal.getLong());
@@ -126,7 +131,7 @@ Value AccumulatorSum::getValue(bool toBeMerged) {
                 total = total.add(Decimal128(sum, Decimal128::kRoundTo34Digits));
                 total = total.add(Decimal128(error, Decimal128::kRoundTo34Digits));
             }
-            total = total.add(decimalTotal);
+            total = total.add(state.decimalTotal);
             return Value(total);
         }
         default:
@@ -134,6 +139,10 @@ Value AccumulatorSum::getValue(bool toBeMerged) {
     }
 }
 
+Value AccumulatorSum::getValue(bool toBeMerged) {
+    return finalize(_state, toBeMerged);
+}
+
 AccumulatorSum::AccumulatorSum(const boost::intrusive_ptr<ExpressionContext>& expCtx)
     : Accumulator(expCtx) {
     // This is a fixed size Accumulator so we never need to update this.
@@ -141,8 +150,6 @@ AccumulatorSum::AccumulatorSum(const boost::intrusive_ptr<ExpressionContext>& ex
 }
 
 void AccumulatorSum::reset() {
-    totalType = NumberInt;
-    nonDecimalTotal = {};
-    decimalTotal = {};
+    _state = {};
 }
 }  // namespace mongo
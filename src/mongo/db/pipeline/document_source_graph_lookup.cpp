@@ -39,6 +39,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/stdx/memory.h"
 
@@ -48,6 +49,38 @@ using boost::intrusive_ptr;
 
 namespace dps = ::mongo::dotted_path_support;
 
+namespace {
+
+// When searching on disk, the frontier is queried in batches whose $in lists are approximately this
+// many bytes.
+const size_t kMaxFrontierBatchBytes = 1024 * 1024;
+
+/**
+ * Orders the data of a sorter used by a search on disk by its key alone.
+ */
+template <typename Payload>
+class KeyComparator {
+public:
+    KeyComparator(ValueComparator valueComparator) : _valueComparator(valueComparator) {}
+
+    int operator()(const std::pair<Value, Payload>& lhs,
+                   const std::pair<Value, Payload>& rhs) const {
+        return _valueComparator.compare(lhs.first, rhs.first);
+    }
+
+private:
+    ValueComparator _valueComparator;
+};
+
+void assertHasId(const NamespaceString& from, const Document& doc) {
+    uassert(40271,
+            str::stream() << "Documents in the '" << from.ns()
+                          << "' namespace must contain an _id for de-duplication in $graphLookup",
+            !doc["_id"].missing());
+}
+
+}  // namespace
+
 std::unique_ptr<LiteParsedDocumentSourceForeignCollections> DocumentSourceGraphLookUp::liteParse(
     const AggregationRequest& request, const BSONElement& spec) {
     uassert(ErrorCodes::FailedToParse,
@@ -104,11 +137,9 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNext() {
     performSearch();
 
     std::vector<Value> results;
-    while (!_visited.empty()) {
+    while (haveVisitedResults()) {
         // Remove elements one at a time to avoid consuming more memory.
-        auto it = _visited.begin();
-        results.push_back(Value(it->second));
-        _visited.erase(it);
+        results.push_back(Value(popVisitedResult()));
     }
 
     MutableDocument output(*_input);
@@ -117,6 +148,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNext() {
     _visitedUsageBytes = 0;
 
     invariant(_visited.empty());
+    _visitedIterator.reset();
 
     return output.freeze();
 }
@@ -127,7 +159,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
     // If the unwind is not preserving empty arrays, we might have to process multiple inputs before
     // we get one that will produce an output.
     while (true) {
-        if (_visited.empty()) {
+        if (!haveVisitedResults()) {
             // No results are left for the current input, so we should move on to the next one and
             // perform a new search.
 
@@ -143,7 +175,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
         }
         MutableDocument unwound(*_input);
 
-        if (_visited.empty()) {
+        if (!haveVisitedResults()) {
             if ((*_unwind)->preserveNullAndEmptyArrays()) {
                 // Since "preserveNullAndEmptyArrays" was specified, output a document even though
                 // we had no result.
@@ -157,13 +189,11 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
                 continue;
             }
         } else {
-            auto it = _visited.begin();
-            unwound.setNestedField(_as, Value(it->second));
+            unwound.setNestedField(_as, Value(popVisitedResult()));
             if (indexPath) {
                 unwound.setNestedField(*indexPath, Value(_outputIndex));
                 ++_outputIndex;
             }
-            _visited.erase(it);
         }
 
         return unwound.freeze();
@@ -174,9 +204,25 @@ void DocumentSourceGraphLookUp::doDispose() {
     _cache.clear();
     _frontier.clear();
     _visited.clear();
+    _visitedIterator.reset();
+}
+
+bool DocumentSourceGraphLookUp::haveVisitedResults() {
+    return _visitedIterator ? _visitedIterator->more() : !_visited.empty();
+}
+
+Document DocumentSourceGraphLookUp::popVisitedResult() {
+    if (_visitedIterator) {
+        return _visitedIterator->next().second;
+    }
+
+    auto it = _visited.begin();
+    Document result = std::move(it->second);
+    _visited.erase(it);
+    return result;
 }
 
-void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
+bool DocumentSourceGraphLookUp::doBreadthFirstSearch() {
     long long depth = 0;
     bool shouldPerformAnotherQuery;
     do {
@@ -196,7 +242,9 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
             cached.erase(cached.begin());
             shouldPerformAnotherQuery =
                 addToVisitedAndFrontier(std::move(doc), depth) || shouldPerformAnotherQuery;
-            checkMemoryUsage();
+            if (!checkMemoryUsage()) {
+                return false;
+            }
         }
 
         if (matchStage) {
@@ -208,18 +256,15 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
             auto pipeline = uassertStatusOK(
                 pExpCtx->mongoProcessInterface->makePipeline(_fromPipeline, _fromExpCtx));
             while (auto next = pipeline->getNext()) {
-                uassert(40271,
-                        str::stream()
-                            << "Documents in the '"
-                            << _from.ns()
-                            << "' namespace must contain an _id for de-duplication in $graphLookup",
-                        !(*next)["_id"].missing());
+                assertHasId(_from, *next);
 
                 shouldPerformAnotherQuery =
                     addToVisitedAndFrontier(*next, depth) || shouldPerformAnotherQuery;
                 addToCache(std::move(*next), queried);
             }
-            checkMemoryUsage();
+            if (!checkMemoryUsage()) {
+                return false;
+            }
         }
 
         ++depth;
@@ -228,6 +273,146 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 
     _frontier.clear();
     _frontierUsageBytes = 0;
+    return true;
+}
+
+void DocumentSourceGraphLookUp::doBreadthFirstSearchOnDisk(const Value& startingValue) {
+    using FrontierSorter = Sorter<Value, Value>;
+    using VisitedSorter = Sorter<Value, Document>;
+
+    // The frontier is de-duplicated using the collation, as '_frontier' is, while documents are
+    // de-duplicated on their _id using the simple collation, as '_visited' is.
+    const ValueComparator& frontierValueComparator = pExpCtx->getValueComparator();
+    const KeyComparator<Value> frontierComparator(frontierValueComparator);
+    const KeyComparator<Document> idComparator(ValueComparator::kInstance);
+
+    // The frontier and the documents found at each depth are both accumulated in a sorter, each of
+    // which may use half of our memory budget before spilling.
+    const SortOptions opts = SortOptions()
+                                 .MaxMemoryUsageBytes(_maxMemoryUsageBytes / 2)
+                                 .ExtSortAllowed()
+                                 .TempDir(pExpCtx->tempDir);
+
+    std::unique_ptr<FrontierSorter> frontier(FrontierSorter::make(opts, frontierComparator));
+    if (startingValue.isArray()) {
+        for (auto&& value : startingValue.getArray()) {
+            frontier->add(value, Value());
+        }
+    } else {
+        frontier->add(startingValue, Value());
+    }
+
+    std::unique_ptr<VisitedSorter::Iterator> visited;
+    long long depth = 0;
+    bool shouldPerformAnotherQuery;
+    do {
+        shouldPerformAnotherQuery = false;
+
+        std::unique_ptr<FrontierSorter::Iterator> frontierIt(frontier->done());
+        frontier.reset(FrontierSorter::make(opts, frontierComparator));
+
+        // Query for every distinct value on the frontier, in batches, collecting the documents
+        // found at this depth sorted by _id.
+        std::unique_ptr<VisitedSorter> found(VisitedSorter::make(opts, idComparator));
+        std::vector<Value> batch;
+        size_t batchBytes = 0;
+        auto queryForBatch = [&]() {
+            _fromPipeline.back() = makeMatchStage(batch);
+            auto pipeline = uassertStatusOK(
+                pExpCtx->mongoProcessInterface->makePipeline(_fromPipeline, _fromExpCtx));
+            while (auto next = pipeline->getNext()) {
+                assertHasId(_from, *next);
+                found->add(next->getField("_id"), *next);
+            }
+            batch.clear();
+            batchBytes = 0;
+        };
+
+        while (frontierIt->more()) {
+            Value value = frontierIt->next().first;
+            if (!batch.empty() && frontierValueComparator.evaluate(batch.back() == value)) {
+                continue;
+            }
+            batchBytes += value.getApproximateSize();
+            batch.push_back(std::move(value));
+            if (batchBytes >= kMaxFrontierBatchBytes) {
+                queryForBatch();
+            }
+        }
+        if (!batch.empty()) {
+            queryForBatch();
+        }
+
+        // Merge the documents found at this depth into the sorted run of visited documents. Any
+        // document not already visited is new at this depth, and its 'connectFromField' values
+        // make up the frontier for the next depth.
+        std::unique_ptr<VisitedSorter::Iterator> foundIt(found->done());
+        found.reset();
+        if (!foundIt->more()) {
+            break;
+        }
+
+        SortedFileWriter<Value, Document> writer(opts);
+        boost::optional<VisitedSorter::Data> nextVisited;
+        auto advanceVisited = [&]() {
+            if (visited && visited->more()) {
+                nextVisited = visited->next();
+            } else {
+                nextVisited = boost::none;
+            }
+        };
+        advanceVisited();
+
+        boost::optional<Value> lastFoundId;
+        while (foundIt->more()) {
+            auto candidate = foundIt->next();
+
+            // The same document may have been found by several frontier values.
+            if (lastFoundId && idComparator({*lastFoundId, Document()}, candidate) == 0) {
+                continue;
+            }
+            lastFoundId = candidate.first;
+
+            while (nextVisited && idComparator(*nextVisited, candidate) < 0) {
+                writer.addAlreadySorted(nextVisited->first, nextVisited->second);
+                advanceVisited();
+            }
+
+            if (nextVisited && idComparator(*nextVisited, candidate) == 0) {
+                // We've already seen this object, don't repeat any work.
+                continue;
+            }
+
+            Document result = std::move(candidate.second);
+            if (_depthField) {
+                MutableDocument mutableDoc(std::move(result));
+                mutableDoc.setNestedField(*_depthField, Value(depth));
+                result = mutableDoc.freeze();
+            }
+
+            document_path_support::visitAllValuesAtPath(
+                result, _connectFromField, [&frontier](const Value& nextFrontierValue) {
+                    frontier->add(nextFrontierValue, Value());
+                });
+
+            writer.addAlreadySorted(candidate.first, result);
+            shouldPerformAnotherQuery = true;
+        }
+
+        while (nextVisited) {
+            writer.addAlreadySorted(nextVisited->first, nextVisited->second);
+            advanceVisited();
+        }
+
+        // Every document found at this depth is either newly visited or was already visited, so
+        // the run we wrote cannot be empty.
+        visited.reset(writer.done());
+
+        ++depth;
+    } while (shouldPerformAnotherQuery && depth < std::numeric_limits<long long>::max() &&
+             (!_maxDepth || depth <= *_maxDepth));
+
+    _visitedIterator = std::move(visited);
 }
 
 bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long long depth) {
@@ -280,24 +465,8 @@ void DocumentSourceGraphLookUp::addToCache(const Document& result,
         });
 }
 
-boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
-    DocumentUnorderedSet* cached) {
-    // Add any cached values to 'cached' and remove them from '_frontier'.
-    for (auto it = _frontier.begin(); it != _frontier.end();) {
-        if (auto entry = _cache[*it]) {
-            cached->insert(entry->begin(), entry->end());
-            size_t valueSize = it->getApproximateSize();
-            it = _frontier.erase(it);
-
-            // If the cached value increased in size while in the cache, we don't want to underflow
-            // '_frontierUsageBytes'.
-            invariant(valueSize <= _frontierUsageBytes);
-            _frontierUsageBytes -= valueSize;
-        } else {
-            ++it;
-        }
-    }
-
+template <typename Container>
+BSONObj DocumentSourceGraphLookUp::makeMatchStage(const Container& values) const {
     // Create a query of the form {$and: [_additionalFilter, {_connectToField: {$in: [...]}}]}.
     //
     // We wrap the query in a $match so that it can be parsed into a DocumentSourceMatch when
@@ -317,7 +486,7 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
                     BSONObjBuilder subObj(connectToObj.subobjStart(_connectToField.fullPath()));
                     {
                         BSONArrayBuilder in(subObj.subarrayStart("$in"));
-                        for (auto&& value : _frontier) {
+                        for (auto&& value : values) {
                             in << value;
                         }
                     }
@@ -325,8 +494,28 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
             }
         }
     }
+    return match.obj();
+}
+
+boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
+    DocumentUnorderedSet* cached) {
+    // Add any cached values to 'cached' and remove them from '_frontier'.
+    for (auto it = _frontier.begin(); it != _frontier.end();) {
+        if (auto entry = _cache[*it]) {
+            cached->insert(entry->begin(), entry->end());
+            size_t valueSize = it->getApproximateSize();
+            it = _frontier.erase(it);
+
+            // If the cached value increased in size while in the cache, we don't want to underflow
+            // '_frontierUsageBytes'.
+            invariant(valueSize <= _frontierUsageBytes);
+            _frontierUsageBytes -= valueSize;
+        } else {
+            ++it;
+        }
+    }
 
-    return _frontier.empty() ? boost::none : boost::optional<BSONObj>(match.obj());
+    return _frontier.empty() ? boost::none : boost::optional<BSONObj>(makeMatchStage(_frontier));
 }
 
 void DocumentSourceGraphLookUp::performSearch() {
@@ -335,18 +524,32 @@ void DocumentSourceGraphLookUp::performSearch() {
 
     Value startingValue = _startWith->evaluate(*_input);
 
-    // If _startWith evaluates to an array, treat each value as a separate starting point.
-    if (startingValue.isArray()) {
-        for (auto value : startingValue.getArray()) {
-            _frontier.insert(value);
-            _frontierUsageBytes += value.getApproximateSize();
+    if (!_searchOnDisk) {
+        // If _startWith evaluates to an array, treat each value as a separate starting point.
+        if (startingValue.isArray()) {
+            for (auto value : startingValue.getArray()) {
+                _frontier.insert(value);
+                _frontierUsageBytes += value.getApproximateSize();
+            }
+        } else {
+            _frontier.insert(startingValue);
+            _frontierUsageBytes += startingValue.getApproximateSize();
         }
-    } else {
-        _frontier.insert(startingValue);
-        _frontierUsageBytes += startingValue.getApproximateSize();
+
+        if (doBreadthFirstSearch()) {
+            return;
+        }
+
+        // The search outgrew the memory limit. Discard what we have found so far and start over on
+        // disk.
+        _frontier.clear();
+        _frontierUsageBytes = 0;
+        _visited.clear();
+        _visitedUsageBytes = 0;
+        _searchOnDisk = true;
     }
 
-    doBreadthFirstSearch();
+    doBreadthFirstSearchOnDisk(startingValue);
 }
 
 DocumentSource::GetModPathsReturn DocumentSourceGraphLookUp::getModifiedPaths() const {
@@ -387,12 +590,16 @@ BSONObjSet DocumentSourceGraphLookUp::getOutputSorts() {
     return DocumentSource::truncateSortSet(pSource->getOutputSorts(), fields);
 }
 
-void DocumentSourceGraphLookUp::checkMemoryUsage() {
-    // TODO SERVER-23980: Implement spilling to disk if allowDiskUse is specified.
-    uassert(40099,
-            "$graphLookup reached maximum memory consumption",
-            (_visitedUsageBytes + _frontierUsageBytes) < _maxMemoryUsageBytes);
+bool DocumentSourceGraphLookUp::checkMemoryUsage() {
+    if ((_visitedUsageBytes + _frontierUsageBytes) >= _maxMemoryUsageBytes) {
+        uassert(40099,
+                "$graphLookup reached maximum memory consumption; pass allowDiskUse:true to "
+                "continue the search on disk",
+                _allowDiskUse);
+        return false;
+    }
     _cache.evictDownTo(_maxMemoryUsageBytes - _frontierUsageBytes - _visitedUsageBytes);
+    return true;
 }
 
 void DocumentSourceGraphLookUp::serializeToArray(
@@ -464,10 +671,12 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
       _additionalFilter(additionalFilter),
       _depthField(depthField),
       _maxDepth(maxDepth),
+      _maxMemoryUsageBytes(internalDocumentSourceGraphLookupMaxMemoryBytes.load()),
       _frontier(pExpCtx->getValueComparator().makeUnorderedValueSet()),
       _visited(ValueComparator::kInstance.makeUnorderedValueMap<Document>()),
       _cache(pExpCtx->getValueComparator()),
-      _unwind(unwindSrc) {
+      _unwind(unwindSrc),
+      _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos) {
     const auto& resolvedNamespace = pExpCtx->getResolvedNamespace(_from);
     _fromExpCtx = pExpCtx->copyWith(resolvedNamespace.ns);
     _fromPipeline = resolvedNamespace.pipeline;
@@ -602,3 +811,6 @@ intrusive_ptr<DocumentSource> DocumentSourceGraphLookUp::createFromBson(
     return std::move(newSource);
 }
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
@@ -57,7 +58,7 @@ public:
         StageConstraints constraints(StreamType::kStreaming,
                                      PositionRequirement::kNone,
                                      HostTypeRequirement::kPrimaryShard,
-                                     DiskUseRequirement::kNoDiskUse,
+                                     DiskUseRequirement::kWritesTmpData,
                                      FacetRequirement::kAllowed,
                                      TransactionRequirement::kAllowed);
 
@@ -131,6 +132,13 @@ private:
      */
     boost::optional<BSONObj> makeMatchStageFromFrontier(DocumentUnorderedSet* cached);
 
+    /**
+     * Builds the $match stage to execute on the 'from' collection to find the documents whose
+     * 'connectToField' matches any of 'values'.
+     */
+    template <typename Container>
+    BSONObj makeMatchStage(const Container& values) const;
+
     /**
      * If we have internalized a $unwind, getNext() dispatches to this function.
      */
@@ -140,15 +148,42 @@ private:
      * Perform a breadth-first search of the 'from' collection. '_frontier' should already be
      * populated with the values for the initial query. Populates '_discovered' with the result(s)
      * of the query.
+     *
+     * Returns false if the search was abandoned because it exceeded '_maxMemoryUsageBytes' and
+     * we are allowed to continue the search on disk instead.
+     */
+    bool doBreadthFirstSearch();
+
+    /**
+     * Performs the same breadth-first search as doBreadthFirstSearch(), starting from
+     * 'startingValue', but keeps the frontier and the set of visited documents on disk so that
+     * the search is not bounded by '_maxMemoryUsageBytes'.
+     *
+     * Each level of the search sorts and de-duplicates the frontier, queries for it in batches,
+     * and merges the documents found into the sorted run of visited documents, which is rewritten
+     * once per level. Populates '_visitedIterator' with the visited documents in _id order.
      */
-    void doBreadthFirstSearch();
+    void doBreadthFirstSearchOnDisk(const Value& startingValue);
 
     /**
      * Populates '_frontier' with the '_startWith' value(s) from '_input' and then performs a
      * breadth-first search. Caller should check that _input is not boost::none.
+     *
+     * If the search outgrows the memory limit and allowDiskUse is enabled, the search is restarted
+     * on disk, and every later search is performed on disk as well.
      */
     void performSearch();
 
+    /**
+     * Returns whether any documents visited by the last search have yet to be returned.
+     */
+    bool haveVisitedResults();
+
+    /**
+     * Removes and returns one document visited by the last search.
+     */
+    Document popVisitedResult();
+
     /**
      * Updates '_cache' with 'result' appropriately, given that 'result' was retrieved when querying
      * for 'queried'.
@@ -158,8 +193,11 @@ private:
     /**
      * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, and then
      * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'.
+     *
+     * If allowDiskUse is enabled, returns false rather than asserting when the maximum memory usage
+     * has been exceeded.
      */
-    void checkMemoryUsage();
+    bool checkMemoryUsage();
 
     /**
      * Process 'result', adding it to '_visited' with the given 'depth', and updating '_frontier'
@@ -186,7 +224,7 @@ private:
     // The aggregation pipeline to perform against the '_from' namespace.
     std::vector<BSONObj> _fromPipeline;
 
-    size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
+    size_t _maxMemoryUsageBytes;
 
     // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
     size_t _visitedUsageBytes = 0;
@@ -214,6 +252,18 @@ private:
     // If we absorbed a $unwind that specified 'includeArrayIndex', this is used to populate that
     // field, tracking how many results we've returned so far for the current input document.
     long long _outputIndex;
+
+    // Whether we may fall back to searching on disk once a search exceeds '_maxMemoryUsageBytes'.
+    const bool _allowDiskUse;
+
+    // Set once a search has exceeded '_maxMemoryUsageBytes' with allowDiskUse enabled. Since later
+    // inputs are likely to produce similarly large searches, every subsequent search is performed
+    // on disk from the start.
+    bool _searchOnDisk = false;
+
+    // When searching on disk, iterates over the documents visited by the last search in place of
+    // '_visited'.
+    std::unique_ptr<Sorter<Value, Document>::Iterator> _visitedIterator;
 };
 
 }  // namespace mongo
@@ -37,9 +37,12 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -615,5 +618,136 @@ TEST_F(DocumentSourceGraphLookUpTest, ShouldNotExpandArraysWithinArraysAtEndOfCo
     ASSERT(graphLookupStage->getNext().isEOF());
 }
 
+/**
+ * Makes a chain of 'length' documents in which the document with _id 'i' connects to the document
+ * with _id 'i + 1'.
+ */
+std::deque<DocumentSource::GetNextResult> makeChain(int length) {
+    std::deque<DocumentSource::GetNextResult> chain;
+    for (int i = 0; i < length; ++i) {
+        chain.push_back(Document{{"_id", i}, {"to", i + 1}, {"pad", std::string(100, 'x')}});
+    }
+    return chain;
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldErrorWhenMemoryLimitExceededWithoutAllowDiskUse) {
+    auto expCtx = getExpCtx();
+    const auto oldMaxMemoryBytes = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(oldMaxMemoryBytes); });
+
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}}};
+    auto inputMock = DocumentSourceMock::create(std::move(inputs));
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(makeChain(100));
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "to",
+                                          "_id",
+                                          ExpressionFieldPath::create(expCtx, "_id"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+    ASSERT_THROWS_CODE(graphLookupStage->getNext(), AssertionException, 40099);
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSearchOnDiskWhenMemoryLimitExceededWithAllowDiskUse) {
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    const auto oldMaxMemoryBytes = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(oldMaxMemoryBytes); });
+
+    // The first input exceeds the memory limit in memory and restarts its search on disk. The
+    // second input is searched on disk from the start.
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}, {"start", 0}},
+                                                     Document{{"_id", 1}, {"start", 90}}};
+    auto inputMock = DocumentSourceMock::create(std::move(inputs));
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(makeChain(100));
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "to",
+                                          "_id",
+                                          ExpressionFieldPath::create(expCtx, "start"),
+                                          boost::none,
+                                          FieldPath("depth"),
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+
+    auto assertChainFrom = [](const Document& output, int start) {
+        auto results = output.getField("results").getArray();
+        ASSERT_EQ(static_cast<size_t>(100 - start), results.size());
+        for (auto&& result : results) {
+            int id = result.getDocument().getField("_id").getInt();
+            ASSERT_GTE(id, start);
+            ASSERT_VALUE_EQ(Value(static_cast<long long>(id - start)),
+                            result.getDocument().getField("depth"));
+        }
+    };
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    assertChainFrom(next.getDocument(), 0);
+
+    next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    assertChainFrom(next.getDocument(), 90);
+
+    ASSERT_TRUE(graphLookupStage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldRespectMaxDepthWhenSearchingOnDisk) {
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    const auto oldMaxMemoryBytes = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(1024);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(oldMaxMemoryBytes); });
+
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}}};
+    auto inputMock = DocumentSourceMock::create(std::move(inputs));
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(makeChain(100));
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "to",
+                                          "_id",
+                                          ExpressionFieldPath::create(expCtx, "_id"),
+                                          boost::none,
+                                          boost::none,
+                                          50LL,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_EQ(51U, next.getDocument().getField("results").getArray().size());
+    ASSERT_TRUE(graphLookupStage->getNext().isEOF());
+}
+
 }  // namespace
 }  // namespace mongo
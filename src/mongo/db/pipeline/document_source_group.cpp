@@ -28,6 +28,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <set>
+
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
@@ -115,12 +117,12 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
 
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     // Not spilled, and not streaming.
-    if (_groups->empty())
+    if (!_groups || _groups->empty())
         return GetNextResult::makeEOF();
 
-    Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
+    Document out = makeDocumentForGroup(_groupsPosition, pExpCtx->needsMerge);
 
-    if (++groupsIterator == _groups->end())
+    if (++_groupsPosition == _groups->size())
         dispose();
 
     return std::move(out);
@@ -165,13 +167,10 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
 }
 
 void DocumentSourceGroup::doDispose() {
-    // Free our resources.
-    _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+    // Free our resources, which also makes us look done.
+    _groups.reset();
     _sorterIterator.reset();
 
-    // Make us look done.
-    groupsIterator = _groups->end();
-
     _firstDocOfNextGroup = boost::none;
 }
 
@@ -264,7 +263,6 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _inputSort(BSONObj()),
       _streaming(false),
       _initialized(false),
-      _groups(pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
       _spilled(false),
       _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos) {}
 
@@ -357,8 +355,6 @@ intrusive_ptr<DocumentSource> DocumentSourceGroup::createFromBson(
 
 namespace {
 
-using GroupsMap = DocumentSourceGroup::GroupsMap;
-
 class SorterComparator {
 public:
     typedef pair<Value, Value> Data;
@@ -375,14 +371,16 @@ private:
 
 class SpillSTLComparator {
 public:
-    SpillSTLComparator(ValueComparator valueComparator) : _valueComparator(valueComparator) {}
+    SpillSTLComparator(ValueComparator valueComparator, const GroupTable* groups)
+        : _valueComparator(valueComparator), _groups(groups) {}
 
-    bool operator()(const GroupsMap::value_type* lhs, const GroupsMap::value_type* rhs) const {
-        return _valueComparator.evaluate(lhs->first < rhs->first);
+    bool operator()(size_t lhs, size_t rhs) const {
+        return _valueComparator.evaluate(_groups->getId(lhs) < _groups->getId(rhs));
     }
 
 private:
     ValueComparator _valueComparator;
+    const GroupTable* _groups;
 };
 
 bool containsOnlyFieldPathsAndConstants(ExpressionObject* expressionObj) {
@@ -478,16 +476,19 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     }
 
 
+    if (!_groups) {
+        _groups = stdx::make_unique<GroupTable>(pExpCtx, _accumulatedFields);
+    }
+
     // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
     GetNextResult input = pSource->getNext();
     for (; input.isAdvanced(); input = pSource->getNext()) {
-        if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+        if (_groups->getMemoryUsageBytes() > _maxMemoryUsageBytes) {
             uassert(16945,
                     "Exceeded memory limit for $group, but didn't allow external sort."
                     " Pass allowDiskUse:true to opt in.",
                     _allowDiskUse);
             _sortedFiles.push_back(spill());
-            _memoryUsageBytes = 0;
         }
 
         // We release the result document here so that it does not outlive the end of this loop
@@ -495,36 +496,15 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
         auto rootDocument = input.releaseDocument();
         Value id = computeId(rootDocument);
 
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
-
-        if (inserted) {
-            _memoryUsageBytes += id.getApproximateSize();
-
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
-            }
-        } else {
-            for (auto&& groupObj : group) {
-                // subtract old mem usage. New usage added back after processing.
-                _memoryUsageBytes -= groupObj->memUsageForSorter();
-            }
-        }
+        // Look for the _id value in the table, adding a group with fresh accumulators if it's not
+        // there.
+        bool inserted;
+        const size_t group = _groups->findOrInsert(id, &inserted);
 
         /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
-
         for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument),
-                              _doingMerge);
-
-            _memoryUsageBytes += group[i]->memUsageForSorter();
+            _groups->process(
+                group, i, _accumulatedFields[i].expression->evaluate(rootDocument), _doingMerge);
         }
 
         if (kDebugBuild && !storageGlobalParams.readOnly) {
@@ -555,7 +535,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                 }
 
                 // We won't be using groups again so free its memory.
-                _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+                _groups.reset();
 
                 _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
                     _sortedFiles, SortOptions(), SorterComparator(pExpCtx->getValueComparator())));
@@ -569,8 +549,8 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                 verify(_sorterIterator->more());  // we put data in, we should get something out.
                 _firstPartOfNextGroup = _sorterIterator->next();
             } else {
-                // start the group iterator
-                groupsIterator = _groups->begin();
+                // start returning groups from the first
+                _groupsPosition = 0;
             }
 
             // This must happen last so that, unless control gets here, we will re-enter
@@ -583,36 +563,38 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
 }
 
 shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
-    vector<const GroupsMap::value_type*> ptrs;  // using pointers to speed sorting
-    ptrs.reserve(_groups->size());
-    for (GroupsMap::const_iterator it = _groups->begin(), end = _groups->end(); it != end; ++it) {
-        ptrs.push_back(&*it);
+    vector<size_t> groups(_groups->size());  // using group numbers to speed sorting
+    for (size_t i = 0; i < groups.size(); i++) {
+        groups[i] = i;
     }
 
-    stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator(pExpCtx->getValueComparator()));
+    stable_sort(groups.begin(),
+                groups.end(),
+                SpillSTLComparator(pExpCtx->getValueComparator(), _groups.get()));
 
     SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir));
-    switch (_accumulatedFields.size()) {  // same as ptrs[i]->second.size() for all i.
-        case 0:                           // no values, essentially a distinct
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first, Value());
+    const size_t numAccumulators = _accumulatedFields.size();
+    switch (numAccumulators) {
+        case 0:  // no values, essentially a distinct
+            for (size_t i = 0; i < groups.size(); i++) {
+                writer.addAlreadySorted(_groups->getId(groups[i]), Value());
             }
             break;
 
         case 1:  // just one value, use optimized serialization as single Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first,
-                                        ptrs[i]->second[0]->getValue(/*toBeMerged=*/true));
+            for (size_t i = 0; i < groups.size(); i++) {
+                writer.addAlreadySorted(_groups->getId(groups[i]),
+                                        _groups->getValue(groups[i], 0, /*toBeMerged=*/true));
             }
             break;
 
         default:  // multiple values, serialize as array-typed Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
+            for (size_t i = 0; i < groups.size(); i++) {
                 vector<Value> accums;
-                for (size_t j = 0; j < ptrs[i]->second.size(); j++) {
-                    accums.push_back(ptrs[i]->second[j]->getValue(/*toBeMerged=*/true));
+                for (size_t j = 0; j < numAccumulators; j++) {
+                    accums.push_back(_groups->getValue(groups[i], j, /*toBeMerged=*/true));
                 }
-                writer.addAlreadySorted(ptrs[i]->first, Value(std::move(accums)));
+                writer.addAlreadySorted(_groups->getId(groups[i]), Value(std::move(accums)));
             }
             break;
     }
@@ -808,6 +790,16 @@ Value DocumentSourceGroup::expandId(const Value& val) {
 Document DocumentSourceGroup::makeDocument(const Value& id,
                                            const Accumulators& accums,
                                            bool mergeableOutput) {
+    return makeDocument(id, [&](size_t i) { return accums[i]->getValue(mergeableOutput); });
+}
+
+Document DocumentSourceGroup::makeDocumentForGroup(size_t group, bool mergeableOutput) {
+    return makeDocument(_groups->getId(group),
+                        [&](size_t i) { return _groups->getValue(group, i, mergeableOutput); });
+}
+
+Document DocumentSourceGroup::makeDocument(
+    const Value& id, const stdx::function<Value(size_t)>& getAccumulatedValue) {
     const size_t n = _accumulatedFields.size();
     MutableDocument out(1 + n);
 
@@ -816,7 +808,7 @@ Document DocumentSourceGroup::makeDocument(const Value& id,
 
     /* add the rest of the fields */
     for (size_t i = 0; i < n; ++i) {
-        Value val = accums[i]->getValue(mergeableOutput);
+        Value val = getAccumulatedValue(i);
         if (val.missing()) {
             // we return null in this case so return objects are predictable
             out.addField(_accumulatedFields[i].fieldName, Value(BSONNULL));
@@ -828,6 +820,22 @@ Document DocumentSourceGroup::makeDocument(const Value& id,
     return out.freeze();
 }
 
+bool DocumentSourceGroup::isInputOrderIndependent() const {
+    if (_doingMerge || _streaming) {
+        return false;
+    }
+
+    static const std::set<StringData> kOrderIndependentAccumulators{
+        "$addToSet", "$avg", "$max", "$min", "$stdDevPop", "$stdDevSamp", "$sum"};
+    for (auto&& accumulatedField : _accumulatedFields) {
+        auto accumulator = accumulatedField.makeAccumulator(pExpCtx);
+        if (!kOrderIndependentAccumulators.count(accumulator->getOpName())) {
+            return false;
+        }
+    }
+    return true;
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceGroup::getShardSource() {
     return this;  // No modifications necessary when on shard
 }
@@ -34,14 +34,15 @@
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/group_table.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/stdx/functional.h"
 
 namespace mongo {
 
 class DocumentSourceGroup final : public DocumentSource, public NeedsMergerDocumentSource {
 public:
     using Accumulators = std::vector<boost::intrusive_ptr<Accumulator>>;
-    using GroupsMap = ValueUnorderedMap<Accumulators>;
 
     static const size_t kDefaultMaxMemoryUsageBytes = 100 * 1024 * 1024;
 
@@ -99,6 +100,13 @@ public:
         return _streaming;
     }
 
+    /**
+     * Returns true if this stage's output does not depend on the order of its input, that is, if it
+     * is not merging partial results and none of its accumulators (such as $first or $push) observe
+     * the order in which documents arrive.
+     */
+    bool isInputOrderIndependent() const;
+
     // Virtuals for NeedsMergerDocumentSource.
     boost::intrusive_ptr<DocumentSource> getShardSource() final;
     std::list<boost::intrusive_ptr<DocumentSource>> getMergeSources() final;
@@ -146,6 +154,18 @@ private:
 
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
+    /**
+     * Makes the output document for group number 'group' of '_groups'.
+     */
+    Document makeDocumentForGroup(size_t group, bool mergeableOutput);
+
+    /**
+     * Makes an output document with the given _id, taking the value of each accumulated field from
+     * 'getAccumulatedValue', which is passed the index of the field.
+     */
+    Document makeDocument(const Value& id,
+                          const stdx::function<Value(size_t)>& getAccumulatedValue);
+
     /**
      * Computes the internal representation of the group key.
      */
@@ -160,7 +180,6 @@ private:
     std::vector<AccumulationStatement> _accumulatedFields;
 
     bool _doingMerge;
-    size_t _memoryUsageBytes = 0;
     size_t _maxMemoryUsageBytes;
     std::vector<std::string> _idFieldNames;  // used when id is a document
     std::vector<boost::intrusive_ptr<Expression>> _idExpressions;
@@ -172,16 +191,16 @@ private:
     Value _currentId;
     Accumulators _currentAccumulators;
 
-    // We use boost::optional to defer initialization until the ExpressionContext containing the
-    // correct comparator is injected, since the groups must be built using the comparator's
-    // definition of equality.
-    boost::optional<GroupsMap> _groups;
+    // Created by initialize(), once the accumulated fields are known and the ExpressionContext
+    // containing the correct comparator has been injected, since the groups must be built using
+    // the comparator's definition of equality. Reset once the groups are no longer needed.
+    std::unique_ptr<GroupTable> _groups;
 
     std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> _sortedFiles;
     bool _spilled;
 
-    // Only used when '_spilled' is false.
-    GroupsMap::iterator groupsIterator;
+    // The number of the next group to return. Only used when '_spilled' is false.
+    size_t _groupsPosition = 0;
 
     // Only used when '_spilled' is true.
     std::unique_ptr<Sorter<Value, Value>::Iterator> _sorterIterator;
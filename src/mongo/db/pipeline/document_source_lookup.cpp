@@ -33,6 +33,7 @@
 #include "mongo/base/init.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_algo.h"
+#include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/expression.h"
@@ -228,20 +229,29 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
         _resolvedPipeline.back() = matchStage;
     }
 
-    auto pipeline = buildPipeline(inputDoc);
-
     std::vector<Value> results;
     int objsize = 0;
 
-    while (auto result = pipeline->getNext()) {
-        objsize += result->getApproximateSize();
+    auto appendResult = [&](Document result) {
+        objsize += result.getApproximateSize();
         uassert(4568,
                 str::stream() << "Total size of documents in " << _fromNs.coll()
                               << " matching pipeline "
                               << getUserPipelineDefinition()
                               << " exceeds maximum document size",
                 objsize <= BSONObjMaxInternalSize);
-        results.emplace_back(std::move(*result));
+        results.emplace_back(std::move(result));
+    };
+
+    if (useHashJoin()) {
+        for (auto&& result : probeHashTable(inputDoc)) {
+            appendResult(std::move(result));
+        }
+    } else {
+        auto pipeline = buildPipeline(inputDoc);
+        while (auto result = pipeline->getNext()) {
+            appendResult(std::move(*result));
+        }
     }
 
     MutableDocument output(std::move(inputDoc));
@@ -249,6 +259,125 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     return output.freeze();
 }
 
+bool DocumentSourceLookUp::useHashJoin() {
+    if (_joinStrategy == JoinStrategy::kUndecided) {
+        // Join the first input documents with a query each. If a selective stage precedes the
+        // $lookup, those few queries cost less than scanning the foreign collection into a table.
+        if (_numUndecidedInputs < internalDocumentSourceLookupHashJoinMinInputDocs.load()) {
+            ++_numUndecidedInputs;
+            return false;
+        }
+        _joinStrategy = chooseJoinStrategy();
+    }
+    return _joinStrategy == JoinStrategy::kHashJoin;
+}
+
+DocumentSourceLookUp::JoinStrategy DocumentSourceLookUp::chooseJoinStrategy() {
+    const long long maxHashTableBytes = internalDocumentSourceLookupHashJoinMaxBytes.load();
+    if (wasConstructedWithPipelineSyntax() || maxHashTableBytes <= 0 || pExpCtx->inMongos ||
+        !LookupHashTable::canIndexPath(*_foreignField)) {
+        return JoinStrategy::kNestedLoop;
+    }
+
+    // A query per input document which can use an index on 'foreignField' reads only the matching
+    // foreign documents, whereas the hash table holds all of them.
+    for (auto&& index :
+         pExpCtx->mongoProcessInterface->getIndexStats(pExpCtx->opCtx, _resolvedNs)) {
+        if (index.second.indexKey.firstElementFieldName() == _foreignField->fullPath()) {
+            return JoinStrategy::kNestedLoop;
+        }
+    }
+
+    // Only attempt a hash join when the foreign collection is small enough to fit in the hash
+    // table. If the foreign collection is large, a query per input document reads less data than a
+    // scan of the entire collection.
+    BSONObjBuilder storageStats;
+    auto status = pExpCtx->mongoProcessInterface->appendStorageStats(
+        pExpCtx->opCtx, _resolvedNs, BSONObj(), &storageStats);
+    if (!status.isOK() || storageStats.done()["size"].safeNumberLong() > maxHashTableBytes) {
+        return JoinStrategy::kNestedLoop;
+    }
+
+    // Scan the foreign collection through any view pipeline and absorbed $match, omitting the
+    // trailing $match on 'foreignField' which depends on the input document.
+    std::vector<BSONObj> scanPipeline(_resolvedPipeline.begin(),
+                                      std::prev(_resolvedPipeline.end()));
+    if (_additionalFilter) {
+        scanPipeline.push_back(BSON("$match" << *_additionalFilter));
+    }
+    auto pipeline = uassertStatusOK(
+        pExpCtx->mongoProcessInterface->makePipeline(scanPipeline, _fromExpCtx));
+
+    _hashTable.emplace(*_foreignField, pExpCtx->getValueComparator());
+    while (auto next = pipeline->getNext()) {
+        _hashTable->add(std::move(*next));
+
+        // The foreign documents may still exceed the limit, for instance if the collection grew
+        // or a view pipeline expands them.
+        if (_hashTable->getApproximateSize() > static_cast<size_t>(maxHashTableBytes)) {
+            _hashTable.reset();
+            return JoinStrategy::kNestedLoop;
+        }
+    }
+    return JoinStrategy::kHashJoin;
+}
+
+std::vector<Document> DocumentSourceLookUp::probeHashTable(const Document& inputDoc) {
+    invariant(_hashTable);
+
+    std::vector<Value> localValues;
+    document_path_support::visitAllValuesAtPath(
+        inputDoc, *_localField, [&](const Value& nextValue) { localValues.push_back(nextValue); });
+    if (localValues.empty()) {
+        // Missing values are treated as null.
+        localValues.push_back(Value(BSONNULL));
+    }
+
+    auto probeResult = _hashTable->probe(localValues);
+    if (probeResult.exact) {
+        return std::move(probeResult.documents);
+    }
+
+    // Apply the same query we would have run against the foreign collection to the candidates.
+    // Every candidate already passed '_additionalFilter' when the table was built, so only the
+    // condition on 'foreignField' remains, which is an $in of the local values unless one of them
+    // is a regex.
+    BSONArrayBuilder localValuesBuilder;
+    bool containsRegex = false;
+    for (auto&& value : localValues) {
+        localValuesBuilder << value;
+        containsRegex = containsRegex || value.getType() == BSONType::RegEx;
+    }
+    const BSONArray localValuesArr = localValuesBuilder.arr();
+
+    std::unique_ptr<MatchExpression> regexMatchExpression;
+    const MatchExpression* matchExpression;
+    if (containsRegex) {
+        regexMatchExpression = uassertStatusOK(MatchExpressionParser::parse(
+            _resolvedPipeline.back().firstElement().embeddedObject(), _fromExpCtx));
+        matchExpression = regexMatchExpression.get();
+    } else {
+        if (!_hashJoinFilter) {
+            _hashJoinFilter = stdx::make_unique<InMatchExpression>(_foreignField->fullPath());
+            _hashJoinFilter->setCollator(_fromExpCtx->getCollator());
+        }
+        std::vector<BSONElement> equalities;
+        for (auto&& elem : localValuesArr) {
+            equalities.push_back(elem);
+        }
+        uassertStatusOK(_hashJoinFilter->setEqualities(std::move(equalities)));
+        matchExpression = _hashJoinFilter.get();
+    }
+
+    std::vector<Document> results;
+    for (auto&& candidate : probeResult.documents) {
+        if (matchExpression->matchesBSON(candidate.toBson())) {
+            results.push_back(std::move(candidate));
+        }
+    }
+    return results;
+}
+
 std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipeline(
     const Document& inputDoc) {
     // Copy all 'let' variables into the foreign pipeline's expression context.
@@ -433,6 +562,9 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _hashTable.reset();
+    _hashJoinFilter.reset();
+    _hashJoinResults.clear();
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -525,7 +657,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     // Loop until we get a document that has at least one match.
     // Note we may return early from this loop if our source stage is exhausted or if the unwind
     // source was asked to return empty arrays and we get a document without a match.
-    while (!_pipeline || !_nextValue) {
+    while (!_nextValue) {
         auto nextInput = pSource->getNext();
         if (!nextInput.isAdvanced()) {
             return nextInput;
@@ -541,19 +673,24 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
             _resolvedPipeline.back() = matchStage;
         }
 
-        if (_pipeline) {
-            _pipeline->dispose(pExpCtx->opCtx);
-        }
+        if (useHashJoin()) {
+            _hashJoinResults = probeHashTable(*_input);
+            _hashJoinResultIndex = 0;
+        } else {
+            if (_pipeline) {
+                _pipeline->dispose(pExpCtx->opCtx);
+            }
 
-        _pipeline = buildPipeline(*_input);
+            _pipeline = buildPipeline(*_input);
 
-        // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
-        // potentially be used by multiple OperationContexts, and the $lookup stage is part of an
-        // outer Pipeline that will propagate dispose() calls before being destroyed.
-        _pipeline.get_deleter().dismissDisposal();
+            // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
+            // potentially be used by multiple OperationContexts, and the $lookup stage is part of
+            // an outer Pipeline that will propagate dispose() calls before being destroyed.
+            _pipeline.get_deleter().dismissDisposal();
+        }
 
         _cursorIndex = 0;
-        _nextValue = _pipeline->getNext();
+        _nextValue = getNextForeignResult();
 
         if (_unwindSrc->preserveNullAndEmptyArrays() && !_nextValue) {
             // There were no results for this cursor, but the $unwind was asked to preserve empty
@@ -571,7 +708,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
     invariant(bool(_input) && bool(_nextValue));
     auto currentValue = *_nextValue;
-    _nextValue = _pipeline->getNext();
+    _nextValue = getNextForeignResult();
 
     // Move input document into output if this is the last or only result, otherwise perform a copy.
     MutableDocument output(_nextValue ? *_input : std::move(*_input));
@@ -585,6 +722,16 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     return output.freeze();
 }
 
+boost::optional<Document> DocumentSourceLookUp::getNextForeignResult() {
+    if (_joinStrategy == JoinStrategy::kHashJoin) {
+        if (_hashJoinResultIndex == _hashJoinResults.size()) {
+            return boost::none;
+        }
+        return std::move(_hashJoinResults[_hashJoinResultIndex++]);
+    }
+    return _pipeline->getNext();
+}
+
 void DocumentSourceLookUp::copyVariablesToExpCtx(const Variables& vars,
                                                  const VariablesParseState& vps,
                                                  ExpressionContext* expCtx) {
@@ -30,12 +30,14 @@
 
 #include <boost/optional.hpp>
 
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_sequential_document_cache.h"
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
+#include "mongo/db/pipeline/lookup_hash_table.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
 
@@ -187,6 +189,14 @@ public:
         return buildPipeline(inputDoc);
     }
 
+    /**
+     * Returns true if this stage has joined its input with the foreign collection using a hash
+     * table rather than a query per input document.
+     */
+    bool usedHashJoin_forTest() const {
+        return _joinStrategy == JoinStrategy::kHashJoin;
+    }
+
 protected:
     void doDispose() final;
 
@@ -198,6 +208,19 @@ protected:
                                                      Pipeline::SourceContainer* container) final;
 
 private:
+    /**
+     * How a $lookup specified with localField/foreignField syntax finds the foreign documents for
+     * each input document. The strategy is chosen once the nested loop strategy has joined
+     * internalDocumentSourceLookupHashJoinMinInputDocs input documents.
+     */
+    enum class JoinStrategy {
+        kUndecided,
+        // Run the foreign pipeline with an equality $match for each input document.
+        kNestedLoop,
+        // Scan the foreign pipeline once into '_hashTable', and probe it for each input document.
+        kHashJoin,
+    };
+
     struct LetVariable {
         LetVariable(std::string name, boost::intrusive_ptr<Expression> expression, Variables::Id id)
             : name(std::move(name)), expression(std::move(expression)), id(id) {}
@@ -244,6 +267,31 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Returns true if the foreign documents for the next input document should be found by probing
+     * '_hashTable', choosing the join strategy if it has not yet been chosen.
+     */
+    bool useHashJoin();
+
+    /**
+     * Decides whether the foreign collection is small enough to hash join with and has no index on
+     * 'foreignField', and if so, builds '_hashTable' from it. Falls back to the nested loop
+     * strategy if the hash table outgrows internalDocumentSourceLookupHashJoinMaxBytes.
+     */
+    JoinStrategy chooseJoinStrategy();
+
+    /**
+     * Returns the foreign documents which match 'inputDoc'. The trailing $match stage of
+     * '_resolvedPipeline' must already have been built from 'inputDoc'.
+     */
+    std::vector<Document> probeHashTable(const Document& inputDoc);
+
+    /**
+     * Returns the next foreign document matching '_input' when we have absorbed a $unwind, from
+     * either '_pipeline' or '_hashJoinResults' depending on the join strategy.
+     */
+    boost::optional<Document> getNextForeignResult();
+
     /**
      * Copies 'vars' and 'vps' to the Variables and VariablesParseState objects in 'expCtx'. These
      * copies provide access to 'let' defined variables in sub-pipeline execution.
@@ -323,6 +371,18 @@ private:
 
     std::vector<LetVariable> _letVariables;
 
+    JoinStrategy _joinStrategy = JoinStrategy::kUndecided;
+
+    // The number of input documents joined while '_joinStrategy' was undecided.
+    int _numUndecidedInputs = 0;
+
+    // The foreign documents, indexed by 'foreignField', when using the hash join strategy.
+    boost::optional<LookupHashTable> _hashTable;
+
+    // Filters the candidates of an inexact probe of '_hashTable'. Parsed on the first such probe,
+    // and given the local values of each subsequent one.
+    std::unique_ptr<InMatchExpression> _hashJoinFilter;
+
     boost::intrusive_ptr<DocumentSourceMatch> _matchSrc;
     boost::intrusive_ptr<DocumentSourceUnwind> _unwindSrc;
 
@@ -332,6 +392,10 @@ private:
     std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
+
+    // Used in place of '_pipeline' when using the hash join strategy.
+    std::vector<Document> _hashJoinResults;
+    size_t _hashJoinResultIndex = 0;
 };
 
 }  // namespace mongo
@@ -47,6 +47,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -498,6 +499,37 @@ public:
         return false;
     }
 
+    /**
+     * Adds an index with key pattern 'keyPattern' to the mocked foreign collection.
+     */
+    void addIndex(const BSONObj& keyPattern) {
+        _indexKeys.push_back(keyPattern.getOwned());
+    }
+
+    CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
+                                          const NamespaceString& ns) final {
+        CollectionIndexUsageMap indexStats;
+        for (auto&& keyPattern : _indexKeys) {
+            indexStats[keyPattern.toString()] =
+                CollectionIndexUsageTracker::IndexUsageStats(Date_t::now(), keyPattern);
+        }
+        return indexStats;
+    }
+
+    Status appendStorageStats(OperationContext* opCtx,
+                              const NamespaceString& nss,
+                              const BSONObj& param,
+                              BSONObjBuilder* builder) const final {
+        long long size = 0;
+        for (auto&& result : _mockResults) {
+            if (result.isAdvanced()) {
+                size += result.getDocument().toBson().objsize();
+            }
+        }
+        builder->appendNumber("size", size);
+        return Status::OK();
+    }
+
     StatusWith<std::unique_ptr<Pipeline, PipelineDeleter>> makePipeline(
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
@@ -535,6 +567,7 @@ public:
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
     bool _removeLeadingQueryStages = false;
+    std::vector<BSONObj> _indexKeys;
 };
 
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
@@ -1105,5 +1138,236 @@ TEST_F(DocumentSourceLookUpTest, ShouldNotCacheIfCorrelatedStageIsAbsorbedIntoPl
     ASSERT_VALUE_EQ(Value(subPipeline->writeExplainOps(kExplain)), Value(BSONArray(expectedPipe)));
 }
 
+/**
+ * Runs a $lookup from 'inputs' into 'foreignContents' on 'localField' and 'foreignField',
+ * optionally absorbing an $unwind of the 'as' field, and returns the output. The foreign collection
+ * has an index on each of 'foreignIndexes'. Sets 'usedHashJoin' to whether the stage chose the
+ * hash join strategy.
+ */
+std::vector<Document> runLookup(const boost::intrusive_ptr<ExpressionContextForTest>& expCtx,
+                                StringData localField,
+                                StringData foreignField,
+                                deque<DocumentSource::GetNextResult> inputs,
+                                deque<DocumentSource::GetNextResult> foreignContents,
+                                bool unwind,
+                                bool* usedHashJoin,
+                                const std::vector<BSONObj>& foreignIndexes = {}) {
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    auto mongoProcessInterface = std::make_shared<MockMongoInterface>(std::move(foreignContents));
+    for (auto&& keyPattern : foreignIndexes) {
+        mongoProcessInterface->addIndex(keyPattern);
+    }
+    expCtx->mongoProcessInterface = std::move(mongoProcessInterface);
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", localField},
+                                         {"foreignField", foreignField},
+                                         {"as", "results"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+    if (unwind) {
+        lookup->setUnwindStage(DocumentSourceUnwind::create(expCtx, "results", false, boost::none));
+    }
+
+    auto mockLocalSource = DocumentSourceMock::create(std::move(inputs));
+    lookup->setSource(mockLocalSource.get());
+
+    std::vector<Document> outputs;
+    for (auto next = lookup->getNext(); next.isAdvanced(); next = lookup->getNext()) {
+        outputs.push_back(next.releaseDocument());
+    }
+    *usedHashJoin = lookup->usedHashJoin_forTest();
+    lookup->dispose();
+    return outputs;
+}
+
+/**
+ * Asserts that $lookup produces the same output whether it hash joins or queries the foreign
+ * collection once per input document, and returns the output.
+ */
+std::vector<Document> assertHashJoinMatchesNestedLoop(
+    const boost::intrusive_ptr<ExpressionContextForTest>& expCtx,
+    StringData localField,
+    StringData foreignField,
+    const deque<DocumentSource::GetNextResult>& inputs,
+    const deque<DocumentSource::GetNextResult>& foreignContents,
+    bool unwind = false) {
+    const auto oldMinInputDocs = internalDocumentSourceLookupHashJoinMinInputDocs.load();
+    internalDocumentSourceLookupHashJoinMinInputDocs.store(0);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupHashJoinMinInputDocs.store(oldMinInputDocs); });
+
+    bool usedHashJoin;
+    auto hashJoinOutputs =
+        runLookup(expCtx, localField, foreignField, inputs, foreignContents, unwind, &usedHashJoin);
+    ASSERT_TRUE(usedHashJoin);
+
+    const auto oldMaxBytes = internalDocumentSourceLookupHashJoinMaxBytes.load();
+    internalDocumentSourceLookupHashJoinMaxBytes.store(0);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupHashJoinMaxBytes.store(oldMaxBytes); });
+    auto nestedLoopOutputs =
+        runLookup(expCtx, localField, foreignField, inputs, foreignContents, unwind, &usedHashJoin);
+    ASSERT_FALSE(usedHashJoin);
+
+    ASSERT_EQ(nestedLoopOutputs.size(), hashJoinOutputs.size());
+    for (size_t i = 0; i < nestedLoopOutputs.size(); ++i) {
+        ASSERT_DOCUMENT_EQ(nestedLoopOutputs[i], hashJoinOutputs[i]);
+    }
+    return hashJoinOutputs;
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinShouldMatchScalarsArraysAndNulls) {
+    deque<DocumentSource::GetNextResult> inputs{Document(fromjson("{_id: 0, a: 1}")),
+                                                Document(fromjson("{_id: 1, a: [1, 2]}")),
+                                                Document(fromjson("{_id: 2}")),
+                                                Document(fromjson("{_id: 3, a: null}")),
+                                                Document(fromjson("{_id: 4, a: 5}")),
+                                                Document(fromjson("{_id: 5, a: [[2, 3]]}"))};
+    deque<DocumentSource::GetNextResult> foreignContents{Document(fromjson("{_id: 10, b: 1}")),
+                                                         Document(fromjson("{_id: 11, b: [2, 3]}")),
+                                                         Document(fromjson("{_id: 12, b: null}")),
+                                                         Document(fromjson("{_id: 13}")),
+                                                         Document(fromjson("{_id: 14, b: 1.0}"))};
+
+    auto outputs = assertHashJoinMatchesNestedLoop(getExpCtx(), "a", "b", inputs, foreignContents);
+    ASSERT_EQ(6U, outputs.size());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 0, a: 1, results: [{_id: 10, b: 1}, {_id: 14, "
+                                         "b: 1.0}]}")),
+                       outputs[0]);
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 1, a: [1, 2], results: [{_id: 10, b: 1}, {_id: "
+                                         "11, b: [2, 3]}, {_id: 14, b: 1.0}]}")),
+                       outputs[1]);
+    ASSERT_DOCUMENT_EQ(
+        Document(fromjson("{_id: 2, results: [{_id: 12, b: null}, {_id: 13}]}")), outputs[2]);
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 4, a: 5, results: []}")), outputs[4]);
+    ASSERT_DOCUMENT_EQ(
+        Document(fromjson("{_id: 5, a: [[2, 3]], results: [{_id: 11, b: [2, 3]}]}")), outputs[5]);
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinShouldMatchDottedForeignFieldThroughArrays) {
+    deque<DocumentSource::GetNextResult> inputs{Document(fromjson("{_id: 0, a: 1}")),
+                                                Document(fromjson("{_id: 1, a: null}")),
+                                                Document(fromjson("{_id: 2, a: {z: 1}}"))};
+    deque<DocumentSource::GetNextResult> foreignContents{
+        Document(fromjson("{_id: 10, x: [{y: 1}, {z: 1}]}")),
+        Document(fromjson("{_id: 11, x: {y: [1, 2]}}")),
+        Document(fromjson("{_id: 12, x: 5}")),
+        Document(fromjson("{_id: 13, x: [1, {y: {z: 1}}]}"))};
+
+    assertHashJoinMatchesNestedLoop(getExpCtx(), "a", "x.y", inputs, foreignContents);
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinShouldProduceSameResultsWhenUnwinding) {
+    deque<DocumentSource::GetNextResult> inputs{Document(fromjson("{_id: 0, a: 1}")),
+                                                Document(fromjson("{_id: 1, a: 7}")),
+                                                Document(fromjson("{_id: 2, a: [1, 2]}"))};
+    deque<DocumentSource::GetNextResult> foreignContents{Document(fromjson("{_id: 10, b: 1}")),
+                                                         Document(fromjson("{_id: 11, b: 2}")),
+                                                         Document(fromjson("{_id: 12, b: 1}"))};
+
+    const bool unwind = true;
+    auto outputs =
+        assertHashJoinMatchesNestedLoop(getExpCtx(), "a", "b", inputs, foreignContents, unwind);
+    ASSERT_EQ(5U, outputs.size());
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldNotHashJoinWhenForeignCollectionExceedsLimit) {
+    const auto oldMaxBytes = internalDocumentSourceLookupHashJoinMaxBytes.load();
+    internalDocumentSourceLookupHashJoinMaxBytes.store(16);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupHashJoinMaxBytes.store(oldMaxBytes); });
+    const auto oldMinInputDocs = internalDocumentSourceLookupHashJoinMinInputDocs.load();
+    internalDocumentSourceLookupHashJoinMinInputDocs.store(0);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupHashJoinMinInputDocs.store(oldMinInputDocs); });
+
+    deque<DocumentSource::GetNextResult> inputs{Document(fromjson("{_id: 0, a: 1}"))};
+    deque<DocumentSource::GetNextResult> foreignContents{Document(fromjson("{_id: 10, b: 1}")),
+                                                         Document(fromjson("{_id: 11, b: 2}"))};
+
+    bool usedHashJoin;
+    auto outputs = runLookup(getExpCtx(), "a", "b", inputs, foreignContents, false, &usedHashJoin);
+    ASSERT_FALSE(usedHashJoin);
+    ASSERT_EQ(1U, outputs.size());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 0, a: 1, results: [{_id: 10, b: 1}]}")),
+                       outputs[0]);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldNotHashJoinOnPositionalForeignField) {
+    const auto oldMinInputDocs = internalDocumentSourceLookupHashJoinMinInputDocs.load();
+    internalDocumentSourceLookupHashJoinMinInputDocs.store(0);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupHashJoinMinInputDocs.store(oldMinInputDocs); });
+
+    deque<DocumentSource::GetNextResult> inputs{Document(fromjson("{_id: 0, a: 1}"))};
+    deque<DocumentSource::GetNextResult> foreignContents{Document(fromjson("{_id: 10, b: [1]}"))};
+
+    bool usedHashJoin;
+    auto outputs =
+        runLookup(getExpCtx(), "a", "b.0", inputs, foreignContents, false, &usedHashJoin);
+    ASSERT_FALSE(usedHashJoin);
+    ASSERT_EQ(1U, outputs.size());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 0, a: 1, results: [{_id: 10, b: [1]}]}")),
+                       outputs[0]);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldNotHashJoinWhenForeignFieldIsIndexed) {
+    const auto oldMinInputDocs = internalDocumentSourceLookupHashJoinMinInputDocs.load();
+    internalDocumentSourceLookupHashJoinMinInputDocs.store(0);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupHashJoinMinInputDocs.store(oldMinInputDocs); });
+
+    deque<DocumentSource::GetNextResult> inputs{Document(fromjson("{_id: 0, a: 1}"))};
+    deque<DocumentSource::GetNextResult> foreignContents{Document(fromjson("{_id: 10, b: 1}")),
+                                                         Document(fromjson("{_id: 11, b: 2}"))};
+
+    bool usedHashJoin;
+    auto outputs = runLookup(
+        getExpCtx(), "a", "b", inputs, foreignContents, false, &usedHashJoin, {BSON("b" << 1)});
+    ASSERT_FALSE(usedHashJoin);
+    ASSERT_EQ(1U, outputs.size());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 0, a: 1, results: [{_id: 10, b: 1}]}")),
+                       outputs[0]);
+
+    // An index which does not lead with 'foreignField' cannot serve the per-document queries.
+    outputs = runLookup(getExpCtx(),
+                        "a",
+                        "b",
+                        inputs,
+                        foreignContents,
+                        false,
+                        &usedHashJoin,
+                        {BSON("c" << 1 << "b" << 1)});
+    ASSERT_TRUE(usedHashJoin);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldHashJoinOnlyAfterMinInputDocs) {
+    const auto oldMinInputDocs = internalDocumentSourceLookupHashJoinMinInputDocs.load();
+    internalDocumentSourceLookupHashJoinMinInputDocs.store(2);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupHashJoinMinInputDocs.store(oldMinInputDocs); });
+
+    deque<DocumentSource::GetNextResult> inputs{Document(fromjson("{_id: 0, a: 1}")),
+                                                Document(fromjson("{_id: 1, a: 2}"))};
+    deque<DocumentSource::GetNextResult> foreignContents{Document(fromjson("{_id: 10, b: 1}")),
+                                                         Document(fromjson("{_id: 11, b: 2}"))};
+
+    bool usedHashJoin;
+    auto outputs =
+        runLookup(getExpCtx(), "a", "b", inputs, foreignContents, false, &usedHashJoin);
+    ASSERT_FALSE(usedHashJoin);
+    ASSERT_EQ(2U, outputs.size());
+
+    // The third input document is joined by probing the hash table, with the same results.
+    inputs.push_back(Document(fromjson("{_id: 2, a: [1, 2]}")));
+    outputs = runLookup(getExpCtx(), "a", "b", inputs, foreignContents, false, &usedHashJoin);
+    ASSERT_TRUE(usedHashJoin);
+    ASSERT_EQ(3U, outputs.size());
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 0, a: 1, results: [{_id: 10, b: 1}]}")),
+                       outputs[0]);
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 1, a: 2, results: [{_id: 11, b: 2}]}")),
+                       outputs[1]);
+    ASSERT_DOCUMENT_EQ(Document(fromjson("{_id: 2, a: [1, 2], results: [{_id: 10, b: 1}, {_id: 11, "
+                                         "b: 2}]}")),
+                       outputs[2]);
+}
+
 }  // namespace
 }  // namespace mongo
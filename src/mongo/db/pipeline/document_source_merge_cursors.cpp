@@ -41,6 +41,13 @@ REGISTER_DOCUMENT_SOURCE(mergeCursors,
 
 constexpr StringData DocumentSourceMergeCursors::kStageName;
 
+namespace {
+
+// The maximum number of merged results to take from the ARM at once.
+const size_t kMaxMergedResultsPerBatch = 128;
+
+}  // namespace
+
 DocumentSourceMergeCursors::DocumentSourceMergeCursors(
     executor::TaskExecutor* executor,
     AsyncResultsMergerParams armParams,
@@ -58,7 +65,11 @@ DocumentSource::GetNextResult DocumentSourceMergeCursors::getNext() {
         _arm.emplace(pExpCtx->opCtx, _executor, std::move(*_armParams));
         _armParams = boost::none;
     }
-    auto next = uassertStatusOK(_arm->blockingNext());
+    if (_mergedResults.empty()) {
+        uassertStatusOK(_arm->blockingNextBatch(kMaxMergedResultsPerBatch, &_mergedResults));
+    }
+    auto next = std::move(_mergedResults.front());
+    _mergedResults.pop_front();
     if (next.isEOF()) {
         return GetNextResult::makeEOF();
     }
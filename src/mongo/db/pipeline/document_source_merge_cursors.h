@@ -118,6 +118,10 @@ private:
     // it goes out of scope on mongos.
     boost::optional<AsyncResultsMergerParams> _armParams;
     boost::optional<AsyncResultsMerger> _arm;
+
+    // Results which have been merged by '_arm' but not yet returned from getNext(). They are taken
+    // from the ARM in batches, so that its mutex is acquired once per batch rather than per result.
+    std::deque<ClusterQueryResult> _mergedResults;
 };
 
 }  // namespace mongo
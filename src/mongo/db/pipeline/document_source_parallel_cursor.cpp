@@ -0,0 +1,357 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_parallel_cursor.h"
+
+#include <algorithm>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/pipeline/document_source_cursor.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_request.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+constexpr StringData DocumentSourceParallelCursor::kStageName;
+constexpr size_t DocumentSourceParallelCursor::kDocumentsPerBatch;
+constexpr size_t DocumentSourceParallelCursor::kMaxQueuedBatchesPerWorker;
+
+namespace {
+
+/**
+ * Builds a yielding executor which scans the records of 'collection' within 'range' and returns
+ * those which match 'query'. The executor is returned in a saved state.
+ */
+std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> makeRangeScanExecutor(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    Collection* collection,
+    const BSONObj& query,
+    const DocumentSourceParallelCursor::RecordIdRange& range) {
+    auto qr = stdx::make_unique<QueryRequest>(collection->ns());
+    qr->setFilter(query);
+    qr->setCollation(expCtx->getCollator() ? expCtx->getCollator()->getSpec().toBSON()
+                                           : expCtx->collation);
+
+    const ExtensionsCallbackReal extensionsCallback(expCtx->opCtx, &collection->ns());
+    auto cq = uassertStatusOK(CanonicalQuery::canonicalize(expCtx->opCtx,
+                                                           std::move(qr),
+                                                           expCtx,
+                                                           extensionsCallback,
+                                                           Pipeline::kAllowedMatcherFeatures));
+
+    CollectionScanParams params;
+    params.collection = collection;
+    params.minRecord = range.min;
+    params.maxRecord = range.max;
+
+    auto ws = stdx::make_unique<WorkingSet>();
+    auto root = stdx::make_unique<CollectionScan>(expCtx->opCtx, params, ws.get(), cq->root());
+    auto exec = uassertStatusOK(PlanExecutor::make(expCtx->opCtx,
+                                                   std::move(ws),
+                                                   std::move(root),
+                                                   std::move(cq),
+                                                   collection,
+                                                   PlanExecutor::YIELD_AUTO));
+    exec->saveState();
+    return exec;
+}
+
+}  // namespace
+
+DocumentSourceParallelCursor::DocumentSourceParallelCursor(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    NamespaceString nss,
+    boost::optional<UUID> uuid,
+    std::vector<RecordIdRange> ranges,
+    size_t numWorkers,
+    BSONObj query,
+    DepsTracker deps,
+    std::vector<BSONObj> rangePipeline)
+    : DocumentSource(expCtx),
+      _nss(std::move(nss)),
+      _uuid(std::move(uuid)),
+      _ranges(std::move(ranges)),
+      _numWorkers(numWorkers),
+      _query(query.getOwned()),
+      _deps(std::move(deps)),
+      _rangePipeline(std::move(rangePipeline)) {
+    invariant(_numWorkers > 0);
+}
+
+intrusive_ptr<DocumentSourceParallelCursor> DocumentSourceParallelCursor::create(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    NamespaceString nss,
+    boost::optional<UUID> uuid,
+    std::vector<RecordIdRange> ranges,
+    size_t numWorkers,
+    BSONObj query,
+    DepsTracker deps,
+    std::vector<BSONObj> rangePipeline) {
+    return new DocumentSourceParallelCursor(expCtx,
+                                            std::move(nss),
+                                            std::move(uuid),
+                                            std::move(ranges),
+                                            numWorkers,
+                                            std::move(query),
+                                            std::move(deps),
+                                            std::move(rangePipeline));
+}
+
+DocumentSourceParallelCursor::~DocumentSourceParallelCursor() {
+    stopWorkers();
+}
+
+const char* DocumentSourceParallelCursor::getSourceName() const {
+    return kStageName.rawData();
+}
+
+DocumentSource::GetNextResult DocumentSourceParallelCursor::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (_currentBatchPos == _currentBatch.size()) {
+        if (!_workersStarted) {
+            startWorkers();
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        pExpCtx->opCtx->waitForConditionOrInterrupt(_batchQueued, lk, [&] {
+            return !_queue.empty() || !_workerStatus.isOK() || _activeWorkers == 0;
+        });
+        uassertStatusOK(_workerStatus);
+
+        if (_queue.empty()) {
+            return GetNextResult::makeEOF();
+        }
+
+        _currentBatch = std::move(_queue.front());
+        _currentBatchPos = 0;
+        _queue.pop_front();
+        _batchDequeued.notify_one();
+    }
+
+    return std::move(_currentBatch[_currentBatchPos++]);
+}
+
+void DocumentSourceParallelCursor::startWorkers() {
+    invariant(!_workersStarted);
+    _workersStarted = true;
+
+    // The copies are made here rather than by the workers, since copying reads state which belongs
+    // to this operation. The workers produce partial results, such as those of a $group, which are
+    // combined by the stages which follow this one.
+    std::vector<intrusive_ptr<ExpressionContext>> workerExpCtxs;
+    for (size_t i = 0; i < _numWorkers; ++i) {
+        workerExpCtxs.push_back(pExpCtx->copyWith(_nss, _uuid));
+        workerExpCtxs.back()->needsMerge = true;
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _activeWorkers = _numWorkers;
+    }
+
+    for (auto&& expCtx : workerExpCtxs) {
+        _workers.emplace_back([this, expCtx] { runWorker(expCtx); });
+    }
+}
+
+void DocumentSourceParallelCursor::stopWorkers() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _stopped = true;
+        _batchDequeued.notify_all();
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_workerOpCtxsMutex);
+        for (auto opCtx : _workerOpCtxs) {
+            stdx::lock_guard<Client> clientLock(*opCtx->getClient());
+            opCtx->getServiceContext()->killOperation(opCtx, ErrorCodes::Interrupted);
+        }
+    }
+
+    for (auto&& worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+}
+
+void DocumentSourceParallelCursor::doDispose() {
+    stopWorkers();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _queue.clear();
+    _currentBatch.clear();
+    _currentBatchPos = 0;
+}
+
+void DocumentSourceParallelCursor::runWorker(intrusive_ptr<ExpressionContext> expCtx) {
+    Client::initThread("parallelCollectionScan");
+    ON_BLOCK_EXIT([] { Client::destroy(); });
+
+    auto opCtx = cc().makeOperationContext();
+    expCtx->opCtx = opCtx.get();
+    {
+        stdx::lock_guard<stdx::mutex> lk(_workerOpCtxsMutex);
+        _workerOpCtxs.push_back(opCtx.get());
+    }
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<stdx::mutex> lk(_workerOpCtxsMutex);
+        _workerOpCtxs.erase(std::find(_workerOpCtxs.begin(), _workerOpCtxs.end(), opCtx.get()));
+    });
+
+    Status status = Status::OK();
+    try {
+        while (auto range = claimNextRange()) {
+            if (!scanRange(expCtx, *range)) {
+                break;
+            }
+        }
+    } catch (const DBException& ex) {
+        status = ex.toStatus();
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!status.isOK() && !_stopped) {
+        LOG(1) << "parallel collection scan of " << _nss << " failed: " << redact(status);
+        _workerStatus = status.withContext("Error in $parallelCursor stage");
+        _stopped = true;
+        _batchDequeued.notify_all();
+    }
+    --_activeWorkers;
+    _batchQueued.notify_all();
+}
+
+boost::optional<DocumentSourceParallelCursor::RecordIdRange>
+DocumentSourceParallelCursor::claimNextRange() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_stopped || _nextRange == _ranges.size()) {
+        return boost::none;
+    }
+    return _ranges[_nextRange++];
+}
+
+bool DocumentSourceParallelCursor::scanRange(const intrusive_ptr<ExpressionContext>& expCtx,
+                                             const RecordIdRange& range) {
+    auto pipeline = uassertStatusOK(Pipeline::parse(_rangePipeline, expCtx));
+
+    intrusive_ptr<DocumentSourceCursor> cursor;
+    {
+        AutoGetCollectionForRead autoColl(expCtx->opCtx, _nss);
+        Collection* collection = autoColl.getCollection();
+        uassert(ErrorCodes::QueryPlanKilled,
+                str::stream() << "collection " << _nss.ns()
+                              << " was dropped or renamed during a parallel collection scan",
+                collection && collection->uuid() == _uuid);
+
+        cursor = DocumentSourceCursor::create(
+            collection, makeRangeScanExecutor(expCtx, collection, _query, range), expCtx);
+    }
+
+    // The scan is configured as PipelineD configures the $cursor stage it replaces.
+    cursor->setQuery(_query);
+    if (_deps.hasNoRequirements()) {
+        cursor->shouldProduceEmptyDocs();
+    }
+    cursor->setProjection(_deps.toProjection(), _deps.toParsedDeps());
+    pipeline->addInitialSource(cursor);
+
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _docsExamined += cursor->getPlanSummaryStats().totalDocsExamined;
+    });
+
+    std::vector<Document> batch;
+    batch.reserve(kDocumentsPerBatch);
+    while (auto next = pipeline->getNext()) {
+        batch.push_back(std::move(*next));
+        if (batch.size() == kDocumentsPerBatch) {
+            if (!pushBatch(std::move(batch))) {
+                return false;
+            }
+            batch = std::vector<Document>();
+            batch.reserve(kDocumentsPerBatch);
+        }
+    }
+
+    return batch.empty() || pushBatch(std::move(batch));
+}
+
+bool DocumentSourceParallelCursor::pushBatch(std::vector<Document> batch) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _batchDequeued.wait(lk, [&] {
+        return _stopped || _queue.size() < _numWorkers * kMaxQueuedBatchesPerWorker;
+    });
+    if (_stopped) {
+        return false;
+    }
+
+    _queue.push_back(std::move(batch));
+    _batchQueued.notify_one();
+    return true;
+}
+
+long long DocumentSourceParallelCursor::getDocsExamined() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _docsExamined;
+}
+
+Value DocumentSourceParallelCursor::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    std::vector<Value> rangePipeline;
+    for (auto&& stage : _rangePipeline) {
+        rangePipeline.push_back(Value(stage));
+    }
+
+    return Value(DOC(getSourceName() << DOC("query" << _query << "workers"
+                                                    << static_cast<long long>(_numWorkers)
+                                                    << "ranges"
+                                                    << static_cast<long long>(_ranges.size())
+                                                    << "pipeline"
+                                                    << Value(std::move(rangePipeline)))));
+}
+
+}  // namespace mongo
@@ -0,0 +1,197 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "mongo/db/pipeline/dependencies.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+/**
+ * Scans a collection with several worker threads, each of which repeatedly claims a range of
+ * RecordIds, scans it, and runs the result through its own copy of a prefix of the pipeline. The
+ * documents produced by the workers are returned in no particular order, so this stage stands in
+ * for a $cursor stage followed by stages which do not depend on the order of their input, in the
+ * same way that the shards part of a split pipeline does in a sharded cluster.
+ *
+ * Each range is read in its own storage snapshot, which gives the same guarantees as a collection
+ * scan which yields.
+ */
+class DocumentSourceParallelCursor final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$parallelCursor"_sd;
+
+    /**
+     * An inclusive range of RecordIds to be scanned by a single worker. A null bound leaves that
+     * end of the range open.
+     */
+    struct RecordIdRange {
+        RecordId min;
+        RecordId max;
+    };
+
+    /**
+     * Creates a stage which scans 'ranges' of the collection 'nss' with 'numWorkers' threads. The
+     * collection must still have the UUID 'uuid' when each range is scanned. Each scan applies the
+     * filter 'query' and returns the fields described by 'deps', and its results are passed through
+     * the stages of 'rangePipeline', which must not depend on the order of their input.
+     */
+    static boost::intrusive_ptr<DocumentSourceParallelCursor> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        NamespaceString nss,
+        boost::optional<UUID> uuid,
+        std::vector<RecordIdRange> ranges,
+        size_t numWorkers,
+        BSONObj query,
+        DepsTracker deps,
+        std::vector<BSONObj> rangePipeline);
+
+    ~DocumentSourceParallelCursor();
+
+    GetNextResult getNext() final;
+    const char* getSourceName() const final;
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kAnyShard,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed);
+
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    /**
+     * Returns the number of documents examined by the ranges which have been scanned so far.
+     */
+    long long getDocsExamined() const;
+
+protected:
+    void doDispose() final;
+
+private:
+    static constexpr size_t kDocumentsPerBatch = 128;
+    static constexpr size_t kMaxQueuedBatchesPerWorker = 4;
+
+    DocumentSourceParallelCursor(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                 NamespaceString nss,
+                                 boost::optional<UUID> uuid,
+                                 std::vector<RecordIdRange> ranges,
+                                 size_t numWorkers,
+                                 BSONObj query,
+                                 DepsTracker deps,
+                                 std::vector<BSONObj> rangePipeline);
+
+    /**
+     * Starts the worker threads. Each worker is given its own copy of the ExpressionContext.
+     */
+    void startWorkers();
+
+    /**
+     * Signals the worker threads to stop, interrupts any scans in progress and waits for the
+     * workers to exit.
+     */
+    void stopWorkers();
+
+    /**
+     * The body of a worker thread, which scans ranges until none are left or the stage is stopped.
+     */
+    void runWorker(boost::intrusive_ptr<ExpressionContext> expCtx);
+
+    /**
+     * Scans 'range' and runs its documents through the range pipeline, handing the results to the
+     * consumer in batches. Returns false if the stage was stopped before the range was finished.
+     */
+    bool scanRange(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                   const RecordIdRange& range);
+
+    /**
+     * Claims the next range to scan, or returns boost::none if there are no ranges left.
+     */
+    boost::optional<RecordIdRange> claimNextRange();
+
+    /**
+     * Waits until there is room in the queue and appends 'batch' to it. Returns false if the stage
+     * was stopped in the meantime.
+     */
+    bool pushBatch(std::vector<Document> batch);
+
+    const NamespaceString _nss;
+    const boost::optional<UUID> _uuid;
+    const std::vector<RecordIdRange> _ranges;
+    const size_t _numWorkers;
+    const BSONObj _query;
+    const DepsTracker _deps;
+    const std::vector<BSONObj> _rangePipeline;
+
+    // Protects the members below, which are shared between the consumer and the workers.
+    mutable stdx::mutex _mutex;
+
+    // Signalled when a batch is queued, and when a worker exits.
+    stdx::condition_variable _batchQueued;
+
+    // Signalled when a batch is dequeued, and when the stage is stopped.
+    stdx::condition_variable _batchDequeued;
+
+    std::deque<std::vector<Document>> _queue;
+    size_t _nextRange = 0;
+    size_t _activeWorkers = 0;
+    long long _docsExamined = 0;
+
+    // Set when the stage is disposed of or any worker fails. Workers stop at their next batch.
+    bool _stopped = false;
+
+    // The first error encountered by a worker, which is rethrown to the consumer.
+    Status _workerStatus = Status::OK();
+
+    // The operations of the running workers, so that they can be interrupted. Guarded by its own
+    // mutex, since killing an operation may need to acquire the mutex that operation is waiting
+    // on.
+    stdx::mutex _workerOpCtxsMutex;
+    std::vector<OperationContext*> _workerOpCtxs;
+
+    // Only accessed by the consumer.
+    std::vector<stdx::thread> _workers;
+    bool _workersStarted = false;
+    std::vector<Document> _currentBatch;
+    size_t _currentBatchPos = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,310 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/group_table.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+constexpr uint32_t GroupTable::kEmptyBucket;
+constexpr size_t GroupTable::kBlockBytes;
+
+namespace {
+size_t roundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Computes the 32-bit hash of an _id used by the table from the hash computed by a
+// ValueComparator. Multiplying by a large odd constant and keeping the upper bits spreads
+// differences in any bit of the hash over the bits used to choose a bucket.
+uint32_t mixHash(size_t hash) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+}  // namespace
+
+GroupTable::GroupTable(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                       std::vector<AccumulationStatement> accumulatedFields)
+    : _expCtx(expCtx),
+      _valueComparator(expCtx->getValueComparator()),
+      _accumulatedFields(std::move(accumulatedFields)) {
+    size_t offset = 0;
+    auto addSlot = [&](AccumulatorKind kind, size_t size, size_t alignment) {
+        invariant(alignment <= alignof(std::max_align_t));
+        offset = roundUp(offset, alignment);
+        _slots.push_back({kind, offset});
+        offset += size;
+    };
+
+    for (auto&& accumulatedField : _accumulatedFields) {
+        const StringData opName = accumulatedField.makeAccumulator(_expCtx)->getOpName();
+        if (opName == "$sum") {
+            addSlot(AccumulatorKind::kSum,
+                    sizeof(AccumulatorSum::State),
+                    alignof(AccumulatorSum::State));
+        } else if (opName == "$avg") {
+            addSlot(AccumulatorKind::kAvg,
+                    sizeof(AccumulatorAvg::State),
+                    alignof(AccumulatorAvg::State));
+        } else if (opName == "$min") {
+            addSlot(AccumulatorKind::kMin, sizeof(Value), alignof(Value));
+        } else if (opName == "$max") {
+            addSlot(AccumulatorKind::kMax, sizeof(Value), alignof(Value));
+        } else if (opName == "$first") {
+            addSlot(AccumulatorKind::kFirst,
+                    sizeof(AccumulatorFirst::State),
+                    alignof(AccumulatorFirst::State));
+        } else {
+            addSlot(AccumulatorKind::kOther,
+                    sizeof(boost::intrusive_ptr<Accumulator>),
+                    alignof(boost::intrusive_ptr<Accumulator>));
+        }
+    }
+
+    // Blocks are allocated by operator new[], so they are aligned for any of the slots.
+    _recordBytes = roundUp(offset, alignof(std::max_align_t));
+    if (_recordBytes > 0) {
+        _recordsPerBlock = std::max<size_t>(1, kBlockBytes / _recordBytes);
+    }
+
+    _buckets.assign(16, Bucket{0, kEmptyBucket});
+}
+
+GroupTable::~GroupTable() {
+    clear();
+}
+
+size_t GroupTable::findOrInsert(const Value& id, bool* inserted) {
+    const uint32_t hash = mixHash(_valueComparator.hash(id));
+    const size_t mask = _buckets.size() - 1;
+
+    size_t index = hash & mask;
+    for (; _buckets[index].group != kEmptyBucket; index = (index + 1) & mask) {
+        const Bucket& bucket = _buckets[index];
+        if (bucket.hashBits == hash && _valueComparator.evaluate(_ids[bucket.group] == id)) {
+            *inserted = false;
+            return bucket.group;
+        }
+    }
+
+    const size_t group = _ids.size();
+    invariant(group < kEmptyBucket);
+    _constructRecord(group);
+    _ids.push_back(id);
+    _buckets[index] = {hash, static_cast<uint32_t>(group)};
+
+    _memoryUsageBytes += id.getApproximateSize() + _recordBytes;
+    for (size_t i = 0; i < _slots.size(); ++i) {
+        _memoryUsageBytes += _getVariableSize(group, i);
+    }
+
+    // Keep the table at most three quarters full, so that probe sequences stay short.
+    if (_ids.size() * 4 > _buckets.size() * 3) {
+        _grow();
+    }
+
+    *inserted = true;
+    return group;
+}
+
+void GroupTable::process(size_t group,
+                         size_t accumulatorIndex,
+                         const Value& input,
+                         bool merging) {
+    switch (_slots[accumulatorIndex].kind) {
+        case AccumulatorKind::kSum:
+            AccumulatorSum::accumulate(
+                _getSlot<AccumulatorSum::State>(group, accumulatorIndex), input, merging);
+            return;
+        case AccumulatorKind::kAvg:
+            AccumulatorAvg::accumulate(
+                _getSlot<AccumulatorAvg::State>(group, accumulatorIndex), input, merging);
+            return;
+        case AccumulatorKind::kMin:
+        case AccumulatorKind::kMax: {
+            const auto sense = _slots[accumulatorIndex].kind == AccumulatorKind::kMin
+                ? AccumulatorMinMax::MIN
+                : AccumulatorMinMax::MAX;
+            const size_t oldSize = _getVariableSize(group, accumulatorIndex);
+            AccumulatorMinMax::accumulate(
+                _getSlot<Value>(group, accumulatorIndex), input, sense, _valueComparator);
+            _memoryUsageBytes += _getVariableSize(group, accumulatorIndex) - oldSize;
+            return;
+        }
+        case AccumulatorKind::kFirst: {
+            const size_t oldSize = _getVariableSize(group, accumulatorIndex);
+            AccumulatorFirst::accumulate(_getSlot<AccumulatorFirst::State>(group, accumulatorIndex),
+                                         input);
+            _memoryUsageBytes += _getVariableSize(group, accumulatorIndex) - oldSize;
+            return;
+        }
+        case AccumulatorKind::kOther: {
+            const size_t oldSize = _getVariableSize(group, accumulatorIndex);
+            (*_getSlot<boost::intrusive_ptr<Accumulator>>(group, accumulatorIndex))
+                ->process(input, merging);
+            _memoryUsageBytes += _getVariableSize(group, accumulatorIndex) - oldSize;
+            return;
+        }
+    }
+    MONGO_UNREACHABLE;
+}
+
+Value GroupTable::getValue(size_t group, size_t accumulatorIndex, bool toBeMerged) const {
+    switch (_slots[accumulatorIndex].kind) {
+        case AccumulatorKind::kSum:
+            return AccumulatorSum::finalize(
+                *_getSlot<AccumulatorSum::State>(group, accumulatorIndex), toBeMerged);
+        case AccumulatorKind::kAvg:
+            return AccumulatorAvg::finalize(
+                *_getSlot<AccumulatorAvg::State>(group, accumulatorIndex), toBeMerged);
+        case AccumulatorKind::kMin:
+        case AccumulatorKind::kMax:
+            return AccumulatorMinMax::finalize(*_getSlot<Value>(group, accumulatorIndex));
+        case AccumulatorKind::kFirst:
+            return AccumulatorFirst::finalize(
+                *_getSlot<AccumulatorFirst::State>(group, accumulatorIndex));
+        case AccumulatorKind::kOther:
+            return (*_getSlot<boost::intrusive_ptr<Accumulator>>(group, accumulatorIndex))
+                ->getValue(toBeMerged);
+    }
+    MONGO_UNREACHABLE;
+}
+
+void GroupTable::clear() {
+    for (size_t group = 0; group < _ids.size(); ++group) {
+        _destroyRecord(group);
+    }
+    _ids.clear();
+    std::fill(_buckets.begin(), _buckets.end(), Bucket{0, kEmptyBucket});
+    _memoryUsageBytes = 0;
+}
+
+size_t GroupTable::_getVariableSize(size_t group, size_t accumulatorIndex) const {
+    switch (_slots[accumulatorIndex].kind) {
+        case AccumulatorKind::kSum:
+        case AccumulatorKind::kAvg:
+            return 0;
+        case AccumulatorKind::kMin:
+        case AccumulatorKind::kMax:
+            return _getSlot<Value>(group, accumulatorIndex)->getApproximateSize() - sizeof(Value);
+        case AccumulatorKind::kFirst:
+            return _getSlot<AccumulatorFirst::State>(group, accumulatorIndex)
+                       ->first.getApproximateSize() -
+                sizeof(Value);
+        case AccumulatorKind::kOther:
+            return (*_getSlot<boost::intrusive_ptr<Accumulator>>(group, accumulatorIndex))
+                ->memUsageForSorter();
+    }
+    MONGO_UNREACHABLE;
+}
+
+void GroupTable::_constructRecord(size_t group) {
+    if (_recordBytes == 0) {
+        return;
+    }
+
+    // Groups are added in order, so a group either falls within an existing block or is the first
+    // group of a new one.
+    if (group / _recordsPerBlock == _blocks.size()) {
+        _blocks.emplace_back(new char[_recordsPerBlock * _recordBytes]);
+    }
+
+    char* record = _getRecord(group);
+    for (size_t i = 0; i < _slots.size(); ++i) {
+        char* slot = record + _slots[i].offset;
+        switch (_slots[i].kind) {
+            case AccumulatorKind::kSum:
+                new (slot) AccumulatorSum::State();
+                break;
+            case AccumulatorKind::kAvg:
+                new (slot) AccumulatorAvg::State();
+                break;
+            case AccumulatorKind::kMin:
+            case AccumulatorKind::kMax:
+                new (slot) Value();
+                break;
+            case AccumulatorKind::kFirst:
+                new (slot) AccumulatorFirst::State();
+                break;
+            case AccumulatorKind::kOther:
+                new (slot) boost::intrusive_ptr<Accumulator>(
+                    _accumulatedFields[i].makeAccumulator(_expCtx));
+                break;
+        }
+    }
+}
+
+void GroupTable::_destroyRecord(size_t group) {
+    for (size_t i = 0; i < _slots.size(); ++i) {
+        switch (_slots[i].kind) {
+            case AccumulatorKind::kSum:
+                _getSlot<AccumulatorSum::State>(group, i)->~State();
+                break;
+            case AccumulatorKind::kAvg:
+                _getSlot<AccumulatorAvg::State>(group, i)->~State();
+                break;
+            case AccumulatorKind::kMin:
+            case AccumulatorKind::kMax:
+                _getSlot<Value>(group, i)->~Value();
+                break;
+            case AccumulatorKind::kFirst:
+                _getSlot<AccumulatorFirst::State>(group, i)->~State();
+                break;
+            case AccumulatorKind::kOther: {
+                using AccumulatorPtr = boost::intrusive_ptr<Accumulator>;
+                _getSlot<AccumulatorPtr>(group, i)->~AccumulatorPtr();
+                break;
+            }
+        }
+    }
+}
+
+void GroupTable::_grow() {
+    std::vector<Bucket> buckets(_buckets.size() * 2, Bucket{0, kEmptyBucket});
+    const size_t mask = buckets.size() - 1;
+    for (auto&& bucket : _buckets) {
+        if (bucket.group == kEmptyBucket) {
+            continue;
+        }
+
+        size_t index = bucket.hashBits & mask;
+        while (buckets[index].group != kEmptyBucket) {
+            index = (index + 1) & mask;
+        }
+        buckets[index] = bucket;
+    }
+    _buckets = std::move(buckets);
+}
+
+}  // namespace mongo
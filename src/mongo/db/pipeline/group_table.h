@@ -0,0 +1,168 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/pipeline/value_comparator.h"
+
+namespace mongo {
+
+/**
+ * The groups built by a $group stage, each identified by its _id and holding the state of one
+ * accumulator per accumulated field.
+ *
+ * Groups are numbered from 0 in the order in which they were added. An open-addressing hash table
+ * with linear probing maps each _id to its group number, and the accumulator state of each group
+ * is kept in a fixed-size record within large, shared blocks of memory. Adding a group therefore
+ * does not allocate in the common case. The state of $sum, $avg, $min, $max and $first is laid out
+ * inline in the record and updated without a virtual call; any other accumulator is allocated as
+ * an Accumulator and referenced from the record.
+ */
+class GroupTable {
+    MONGO_DISALLOW_COPYING(GroupTable);
+
+public:
+    GroupTable(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+               std::vector<AccumulationStatement> accumulatedFields);
+
+    ~GroupTable();
+
+    /**
+     * Returns the number of the group whose _id is equal to 'id' under the ValueComparator of the
+     * ExpressionContext, adding a group with fresh accumulators if there is none. Sets 'inserted'
+     * to whether the group was added.
+     */
+    size_t findOrInsert(const Value& id, bool* inserted);
+
+    /**
+     * Updates accumulator 'accumulatorIndex' of group 'group' with 'input', as
+     * Accumulator::process() would.
+     */
+    void process(size_t group, size_t accumulatorIndex, const Value& input, bool merging);
+
+    /**
+     * Returns the result of accumulator 'accumulatorIndex' of group 'group', as
+     * Accumulator::getValue() would.
+     */
+    Value getValue(size_t group, size_t accumulatorIndex, bool toBeMerged) const;
+
+    const Value& getId(size_t group) const {
+        return _ids[group];
+    }
+
+    size_t size() const {
+        return _ids.size();
+    }
+
+    bool empty() const {
+        return _ids.empty();
+    }
+
+    /**
+     * Returns the approximate number of bytes used by the _ids and accumulators of the groups.
+     */
+    size_t getMemoryUsageBytes() const {
+        return _memoryUsageBytes;
+    }
+
+    /**
+     * Removes every group. Memory allocated for the groups is kept to be reused by later groups.
+     */
+    void clear();
+
+private:
+    enum class AccumulatorKind { kSum, kAvg, kMin, kMax, kFirst, kOther };
+
+    // Describes where the state of one accumulated field lives within a group's record.
+    struct Slot {
+        AccumulatorKind kind;
+        size_t offset;
+    };
+
+    // An entry of the hash table. 'group' is kEmptyBucket for an unused entry. The upper bits of
+    // the hash are kept alongside the group number so that most mismatches are rejected without
+    // comparing _ids.
+    struct Bucket {
+        uint32_t hashBits;
+        uint32_t group;
+    };
+
+    static constexpr uint32_t kEmptyBucket = UINT32_MAX;
+
+    // Records are allocated in blocks of at least this many bytes.
+    static constexpr size_t kBlockBytes = 64 * 1024;
+
+    char* _getRecord(size_t group) const {
+        return _blocks[group / _recordsPerBlock].get() + (group % _recordsPerBlock) * _recordBytes;
+    }
+
+    template <typename T>
+    T* _getSlot(size_t group, size_t accumulatorIndex) const {
+        return reinterpret_cast<T*>(_getRecord(group) + _slots[accumulatorIndex].offset);
+    }
+
+    /**
+     * Returns the bytes used by accumulator 'accumulatorIndex' of group 'group' beyond the space
+     * for it in the group's record.
+     */
+    size_t _getVariableSize(size_t group, size_t accumulatorIndex) const;
+
+    void _constructRecord(size_t group);
+    void _destroyRecord(size_t group);
+
+    void _grow();
+
+    const boost::intrusive_ptr<ExpressionContext> _expCtx;
+    const ValueComparator _valueComparator;
+    const std::vector<AccumulationStatement> _accumulatedFields;
+
+    std::vector<Slot> _slots;
+    size_t _recordBytes = 0;
+    size_t _recordsPerBlock = 0;
+    std::vector<std::unique_ptr<char[]>> _blocks;
+
+    std::vector<Value> _ids;
+
+    // The number of buckets is a power of two, and is kept at least a third larger than the number
+    // of groups.
+    std::vector<Bucket> _buckets;
+
+    size_t _memoryUsageBytes = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,169 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/group_table.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using boost::intrusive_ptr;
+
+std::vector<AccumulationStatement> makeAccumulationStatements(
+    const intrusive_ptr<ExpressionContext>& expCtx, const std::vector<std::string>& opNames) {
+    std::vector<AccumulationStatement> statements;
+    for (auto&& opName : opNames) {
+        statements.emplace_back(opName.substr(1),
+                                ExpressionConstant::create(expCtx, Value()),
+                                AccumulationStatement::getFactory(opName));
+    }
+    return statements;
+}
+
+TEST(GroupTableTest, NumbersGroupsInOrderOfInsertion) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    GroupTable groups(expCtx, makeAccumulationStatements(expCtx, {"$sum"}));
+    ASSERT(groups.empty());
+
+    // Add enough groups for the table to grow several times.
+    const int kNumGroups = 1000;
+    bool inserted;
+    for (int i = 0; i < kNumGroups; ++i) {
+        ASSERT_EQ(static_cast<size_t>(i), groups.findOrInsert(Value(i), &inserted));
+        ASSERT(inserted);
+    }
+    ASSERT_EQ(static_cast<size_t>(kNumGroups), groups.size());
+
+    for (int i = 0; i < kNumGroups; ++i) {
+        // Values which compare equal belong to the same group, whatever their type.
+        ASSERT_EQ(static_cast<size_t>(i), groups.findOrInsert(Value(double(i)), &inserted));
+        ASSERT_FALSE(inserted);
+        ASSERT_VALUE_EQ(Value(i), groups.getId(i));
+    }
+    ASSERT_EQ(static_cast<size_t>(kNumGroups), groups.size());
+}
+
+TEST(GroupTableTest, MatchesResultsOfAccumulators) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const std::vector<std::string> opNames{
+        "$sum", "$avg", "$min", "$max", "$first", "$last", "$push"};
+    GroupTable groups(expCtx, makeAccumulationStatements(expCtx, opNames));
+
+    const std::vector<std::vector<Value>> inputs{
+        {},
+        {Value(1), Value(2LL), Value(3.5)},
+        {Value(), Value(BSONNULL), Value("abc"_sd), Value(4)},
+        {Value(std::numeric_limits<long long>::max()), Value(1), Value(Decimal128("1.5"))},
+    };
+
+    bool inserted;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const size_t group = groups.findOrInsert(Value(static_cast<int>(i)), &inserted);
+        for (size_t j = 0; j < opNames.size(); ++j) {
+            for (auto&& input : inputs[i]) {
+                groups.process(group, j, input, false);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        for (size_t j = 0; j < opNames.size(); ++j) {
+            auto accumulator = AccumulationStatement::getFactory(opNames[j])(expCtx);
+            for (auto&& input : inputs[i]) {
+                accumulator->process(input, false);
+            }
+            for (bool toBeMerged : {false, true}) {
+                ASSERT_VALUE_EQ(accumulator->getValue(toBeMerged),
+                                groups.getValue(i, j, toBeMerged));
+            }
+
+            // Merging the partial result of a group gives the same result as the accumulator.
+            GroupTable merged(expCtx, makeAccumulationStatements(expCtx, {opNames[j]}));
+            const size_t group = merged.findOrInsert(Value(0), &inserted);
+            merged.process(group, 0, groups.getValue(i, j, true), true);
+            ASSERT_VALUE_EQ(accumulator->getValue(false), merged.getValue(group, 0, false));
+        }
+    }
+}
+
+TEST(GroupTableTest, RespectsCollation) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    expCtx->setCollator(&collator);
+    GroupTable groups(expCtx, makeAccumulationStatements(expCtx, {"$min"}));
+
+    bool inserted;
+    const size_t group = groups.findOrInsert(Value("abc"_sd), &inserted);
+    ASSERT(inserted);
+    ASSERT_EQ(group, groups.findOrInsert(Value("ABC"_sd), &inserted));
+    ASSERT_FALSE(inserted);
+    ASSERT_EQ(1U, groups.size());
+}
+
+TEST(GroupTableTest, TracksMemoryUsage) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    GroupTable groups(expCtx, makeAccumulationStatements(expCtx, {"$sum", "$first", "$push"}));
+    ASSERT_EQ(0U, groups.getMemoryUsageBytes());
+
+    bool inserted;
+    const size_t group = groups.findOrInsert(Value(1), &inserted);
+    const size_t emptyGroupBytes = groups.getMemoryUsageBytes();
+    ASSERT_GT(emptyGroupBytes, 0U);
+
+    // The fixed-size state of $sum does not grow, but the values held by $first and $push do.
+    const Value input(std::string(1000, 'x'));
+    groups.process(group, 0, Value(1), false);
+    ASSERT_EQ(emptyGroupBytes, groups.getMemoryUsageBytes());
+    groups.process(group, 1, input, false);
+    ASSERT_GT(groups.getMemoryUsageBytes(), emptyGroupBytes + 1000);
+    const size_t withFirstBytes = groups.getMemoryUsageBytes();
+    groups.process(group, 2, input, false);
+    ASSERT_GT(groups.getMemoryUsageBytes(), withFirstBytes + 1000);
+
+    groups.clear();
+    ASSERT(groups.empty());
+    ASSERT_EQ(0U, groups.getMemoryUsageBytes());
+
+    // The table may be reused after being cleared.
+    ASSERT_EQ(0U, groups.findOrInsert(Value(2), &inserted));
+    ASSERT(inserted);
+    ASSERT_EQ(emptyGroupBytes, groups.getMemoryUsageBytes());
+}
+
+}  // namespace
+}  // namespace mongo
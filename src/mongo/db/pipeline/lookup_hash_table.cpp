@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_hash_table.h"
+
+#include <algorithm>
+
+#include "mongo/db/matcher/path_internal.h"
+
+namespace mongo {
+
+LookupHashTable::LookupHashTable(FieldPath foreignField, const ValueComparator& comparator)
+    : _foreignField(std::move(foreignField)),
+      _index(comparator.makeUnorderedValueMap<std::vector<size_t>>()) {}
+
+bool LookupHashTable::canIndexPath(const FieldPath& foreignField) {
+    for (size_t i = 0; i < foreignField.getPathLength(); ++i) {
+        if (isAllDigits(foreignField.getFieldName(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LookupHashTable::add(Document doc) {
+    const size_t docIndex = _documents.size();
+    _approximateSize += doc.getApproximateSize() + sizeof(Entry);
+
+    bool exact = true;
+    addKeys(Value(doc), 0, docIndex, &exact);
+    _documents.push_back({std::move(doc), exact});
+}
+
+void LookupHashTable::addKeys(const Value& value,
+                              size_t pathIndex,
+                              size_t docIndex,
+                              bool* exact) {
+    if (pathIndex == _foreignField.getPathLength()) {
+        if (value.missing() || value.getType() == BSONType::Undefined) {
+            // {$eq: null} matches documents in which the field is missing.
+            addKey(Value(BSONNULL), docIndex);
+            return;
+        }
+
+        // An array matches an equality predicate on either the whole array or any of its elements.
+        addKey(value, docIndex);
+        if (value.isArray()) {
+            *exact = false;
+            for (auto&& elem : value.getArray()) {
+                addKey(elem, docIndex);
+            }
+        }
+        return;
+    }
+
+    if (value.isArray()) {
+        // The remainder of the path is applied to each element of the array. Any element which
+        // cannot contain the remainder of the path makes the field missing along that branch.
+        *exact = false;
+        addKey(Value(BSONNULL), docIndex);
+        for (auto&& elem : value.getArray()) {
+            if (elem.getType() == BSONType::Object) {
+                addKeys(elem, pathIndex, docIndex, exact);
+            }
+        }
+        return;
+    }
+
+    if (value.getType() == BSONType::Object) {
+        addKeys(value.getDocument()[_foreignField.getFieldName(pathIndex)],
+                pathIndex + 1,
+                docIndex,
+                exact);
+        return;
+    }
+
+    // A missing or scalar value before the end of the path means the field is missing.
+    addKey(Value(BSONNULL), docIndex);
+}
+
+void LookupHashTable::addKey(const Value& key, size_t docIndex) {
+    auto inserted = _index.emplace(key, std::vector<size_t>());
+    if (inserted.second) {
+        _approximateSize += key.getApproximateSize();
+    }
+
+    // A document may be reached through the same key more than once, e.g. when an array contains
+    // duplicate values. Since documents are added in order, any duplicate is at the back.
+    auto& docIndexes = inserted.first->second;
+    if (docIndexes.empty() || docIndexes.back() != docIndex) {
+        docIndexes.push_back(docIndex);
+        _approximateSize += sizeof(size_t);
+    }
+}
+
+LookupHashTable::ProbeResult LookupHashTable::probe(const std::vector<Value>& values) const {
+    ProbeResult result;
+
+    std::vector<size_t> docIndexes;
+    for (auto&& value : values) {
+        // Null matches missing fields, and an array matches arrays containing it as an element, in
+        // ways that the keys of a document do not capture exactly.
+        if (value.nullish() || value.isArray()) {
+            result.exact = false;
+        }
+
+        auto it = _index.find(value);
+        if (it != _index.end()) {
+            docIndexes.insert(docIndexes.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    std::sort(docIndexes.begin(), docIndexes.end());
+    docIndexes.erase(std::unique(docIndexes.begin(), docIndexes.end()), docIndexes.end());
+
+    result.documents.reserve(docIndexes.size());
+    for (auto docIndex : docIndexes) {
+        const auto& entry = _documents[docIndex];
+        result.documents.push_back(entry.doc);
+        result.exact = result.exact && entry.exact;
+    }
+    return result;
+}
+
+}  // namespace mongo
@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/pipeline/value_comparator.h"
+
+namespace mongo {
+
+/**
+ * An in-memory hash table over the documents of a $lookup's foreign collection, which lets $lookup
+ * replace a query against the foreign collection per input document with a single scan of the
+ * foreign collection followed by a probe per input document.
+ *
+ * Each document is indexed under every value that a {<foreignField>: {$eq: <value>}} predicate
+ * could match in it. Values are hashed and compared using the ValueComparator provided at
+ * construction, so that lookups respect the collation of the aggregation.
+ */
+class LookupHashTable {
+public:
+    struct ProbeResult {
+        // The documents found, in the order in which they were added to the table.
+        std::vector<Document> documents;
+
+        // Whether 'documents' is exactly the set of documents matching the equality predicate. If
+        // false, 'documents' is a superset of the matching documents, and must be filtered by the
+        // equivalent match expression.
+        bool exact = true;
+    };
+
+    LookupHashTable(FieldPath foreignField, const ValueComparator& comparator);
+
+    /**
+     * Returns whether a $lookup on 'foreignField' can be answered by a LookupHashTable. Paths
+     * containing positional components cannot, since they may refer to array elements by index.
+     */
+    static bool canIndexPath(const FieldPath& foreignField);
+
+    /**
+     * Adds 'doc' to the table.
+     */
+    void add(Document doc);
+
+    /**
+     * Returns the documents whose 'foreignField' may equal any of 'values'.
+     */
+    ProbeResult probe(const std::vector<Value>& values) const;
+
+    /**
+     * Returns the approximate number of bytes used by the documents and keys in the table.
+     */
+    size_t getApproximateSize() const {
+        return _approximateSize;
+    }
+
+    size_t size() const {
+        return _documents.size();
+    }
+
+private:
+    struct Entry {
+        Document doc;
+
+        // Whether every key of 'doc' was reached without traversing an array, so that matching the
+        // key implies matching the equality predicate.
+        bool exact;
+    };
+
+    /**
+     * Indexes the document at 'docIndex' under each value reachable from 'value' along the
+     * remainder of '_foreignField', starting with the path component at 'pathIndex'.
+     */
+    void addKeys(const Value& value, size_t pathIndex, size_t docIndex, bool* exact);
+
+    void addKey(const Value& key, size_t docIndex);
+
+    const FieldPath _foreignField;
+    std::vector<Entry> _documents;
+    ValueUnorderedMap<std::vector<size_t>> _index;
+    size_t _approximateSize = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/lookup_hash_table.h"
+
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const ValueComparator kSimpleComparator{nullptr};
+
+/**
+ * Returns the '_id' values of the documents found in 'result', in order.
+ */
+BSONArray getIds(const LookupHashTable::ProbeResult& result) {
+    BSONArrayBuilder ids;
+    for (auto&& doc : result.documents) {
+        ids.append(doc["_id"].getInt());
+    }
+    return ids.arr();
+}
+
+TEST(LookupHashTableTest, CanIndexPathRejectsPositionalComponents) {
+    ASSERT_TRUE(LookupHashTable::canIndexPath(FieldPath("a")));
+    ASSERT_TRUE(LookupHashTable::canIndexPath(FieldPath("a.b")));
+    ASSERT_TRUE(LookupHashTable::canIndexPath(FieldPath("a.b1")));
+    ASSERT_FALSE(LookupHashTable::canIndexPath(FieldPath("a.0")));
+    ASSERT_FALSE(LookupHashTable::canIndexPath(FieldPath("a.0.b")));
+}
+
+TEST(LookupHashTableTest, ProbeFindsScalarMatchesExactly) {
+    LookupHashTable table(FieldPath("a"), kSimpleComparator);
+    table.add(Document(fromjson("{_id: 0, a: 1}")));
+    table.add(Document(fromjson("{_id: 1, a: 2}")));
+    table.add(Document(fromjson("{_id: 2, a: 1.0}")));
+    ASSERT_EQ(3U, table.size());
+
+    auto result = table.probe({Value(1)});
+    ASSERT_TRUE(result.exact);
+    ASSERT_BSONOBJ_EQ(BSON_ARRAY(0 << 2), getIds(result));
+
+    result = table.probe({Value(3)});
+    ASSERT_TRUE(result.exact);
+    ASSERT_TRUE(result.documents.empty());
+}
+
+TEST(LookupHashTableTest, ProbeReturnsEachDocumentOnceInInsertionOrder) {
+    LookupHashTable table(FieldPath("a"), kSimpleComparator);
+    table.add(Document(fromjson("{_id: 0, a: 3}")));
+    table.add(Document(fromjson("{_id: 1, a: 2}")));
+    table.add(Document(fromjson("{_id: 2, a: 1}")));
+
+    auto result = table.probe({Value(1), Value(2), Value(3), Value(1)});
+    ASSERT_TRUE(result.exact);
+    ASSERT_BSONOBJ_EQ(BSON_ARRAY(0 << 1 << 2), getIds(result));
+}
+
+TEST(LookupHashTableTest, ArrayValuesAreIndexedByElementAndAsAWhole) {
+    LookupHashTable table(FieldPath("a"), kSimpleComparator);
+    table.add(Document(fromjson("{_id: 0, a: [1, 2, 2]}")));
+
+    ASSERT_BSONOBJ_EQ(BSON_ARRAY(0), getIds(table.probe({Value(1)})));
+    ASSERT_BSONOBJ_EQ(BSON_ARRAY(0), getIds(table.probe({Value(2)})));
+    const Value wholeArray(std::vector<Value>{Value(1), Value(2), Value(2)});
+    ASSERT_BSONOBJ_EQ(BSON_ARRAY(0), getIds(table.probe({wholeArray})));
+    ASSERT_TRUE(table.probe({Value(3)}).documents.empty());
+}
+
+TEST(LookupHashTableTest, MissingAndNullValuesAreIndexedUnderNull) {
+    LookupHashTable table(FieldPath("a.b"), kSimpleComparator);
+    table.add(Document(fromjson("{_id: 0}")));
+    table.add(Document(fromjson("{_id: 1, a: null}")));
+    table.add(Document(fromjson("{_id: 2, a: {b: null}}")));
+    table.add(Document(fromjson("{_id: 3, a: 5}")));
+    table.add(Document(fromjson("{_id: 4, a: {b: 1}}")));
+
+    auto result = table.probe({Value(BSONNULL)});
+    ASSERT_FALSE(result.exact);
+    ASSERT_BSONOBJ_EQ(BSON_ARRAY(0 << 1 << 2 << 3), getIds(result));
+}
+
+TEST(LookupHashTableTest, TraversingArraysMarksResultInexact) {
+    LookupHashTable table(FieldPath("a.b"), kSimpleComparator);
+    table.add(Document(fromjson("{_id: 0, a: [{b: 1}, {c: 1}]}")));
+    table.add(Document(fromjson("{_id: 1, a: {b: 1}}")));
+
+    auto result = table.probe({Value(1)});
+    ASSERT_FALSE(result.exact);
+    ASSERT_BSONOBJ_EQ(BSON_ARRAY(0 << 1), getIds(result));
+
+    result = table.probe({Value(BSONNULL)});
+    ASSERT_FALSE(result.exact);
+    ASSERT_BSONOBJ_EQ(BSON_ARRAY(0), getIds(result));
+}
+
+TEST(LookupHashTableTest, ProbeRespectsCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    ValueComparator comparator(&collator);
+    LookupHashTable table(FieldPath("a"), comparator);
+    table.add(Document(fromjson("{_id: 0, a: 'FOO'}")));
+    table.add(Document(fromjson("{_id: 1, a: 'bar'}")));
+
+    ASSERT_BSONOBJ_EQ(BSON_ARRAY(0), getIds(table.probe({Value("foo"_sd)})));
+    ASSERT_BSONOBJ_EQ(BSON_ARRAY(1), getIds(table.probe({Value("BaR"_sd)})));
+}
+
+TEST(LookupHashTableTest, ApproximateSizeGrowsWithContents) {
+    LookupHashTable table(FieldPath("a"), kSimpleComparator);
+    ASSERT_EQ(0U, table.getApproximateSize());
+    table.add(Document(fromjson("{_id: 0, a: 1}")));
+    const auto sizeAfterOne = table.getApproximateSize();
+    ASSERT_GT(sizeAfterOne, 0U);
+    table.add(Document(fromjson("{_id: 1, a: [1, 2, 3]}")));
+    ASSERT_GT(table.getApproximateSize(), sizeAfterOne);
+}
+
+}  // namespace
+}  // namespace mongo
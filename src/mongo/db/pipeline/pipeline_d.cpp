@@ -58,8 +58,10 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_merge_cursors.h"
+#include "mongo/db/pipeline/document_source_parallel_cursor.h"
 #include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
@@ -68,7 +70,9 @@
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/metadata_manager.h"
@@ -98,6 +102,9 @@ using std::unique_ptr;
 
 namespace {
 
+// The number of ranges into which a parallel collection scan is divided for each worker.
+const int kParallelCursorRangesPerWorker = 4;
+
 /**
  * Returns a PlanExecutor which uses a random cursor to sample documents if successful. Returns {}
  * if the storage engine doesn't support random cursors, or if 'sampleSize' is a large enough
@@ -335,10 +342,113 @@ void PipelineD::prepareCursorSource(Collection* collection,
         }
     }
 
+    if (sortObj.isEmpty() && projForQuery.isEmpty() &&
+        attemptToAddParallelCursorSource(collection, pipeline, expCtx, *exec, deps, queryObj)) {
+        return;
+    }
+
     addCursorSource(
         collection, pipeline, expCtx, std::move(exec), deps, queryObj, sortObj, projForQuery);
 }
 
+bool PipelineD::attemptToAddParallelCursorSource(Collection* collection,
+                                                 Pipeline* pipeline,
+                                                 const intrusive_ptr<ExpressionContext>& expCtx,
+                                                 const PlanExecutor& exec,
+                                                 const DepsTracker& deps,
+                                                 const BSONObj& queryObj) {
+    const int numWorkers = internalDocumentSourceParallelCursorThreads.load();
+    if (numWorkers <= 1 || !collection || !collection->uuid() || collection->isCapped() ||
+        exec.getRootStage()->stageType() != STAGE_COLLSCAN) {
+        return false;
+    }
+
+    // Each range is scanned by its own operation in its own snapshot, which can only reproduce the
+    // semantics of a local read outside of a transaction. Explain and nested pipelines keep the
+    // serial plan.
+    const auto readConcernLevel = repl::ReadConcernArgs::get(expCtx->opCtx).getLevel();
+    if (expCtx->explain || expCtx->inSnapshotReadOrMultiDocumentTransaction ||
+        expCtx->tailableMode != TailableModeEnum::kNormal || expCtx->subPipelineDepth > 0 ||
+        (readConcernLevel != repl::ReadConcernLevel::kLocalReadConcern &&
+         readConcernLevel != repl::ReadConcernLevel::kAvailableReadConcern) ||
+        expCtx->opCtx->getServiceContext()->getStorageEngine()->isMmapV1()) {
+        return false;
+    }
+
+    if (collection->numRecords(expCtx->opCtx) <
+        internalDocumentSourceParallelCursorMinRecords.load()) {
+        return false;
+    }
+
+    // Move the leading stages which transform or filter one document at a time into the workers.
+    Pipeline::SourceContainer& sources = pipeline->_sources;
+    std::vector<Value> serializedStages;
+    auto stageIt = sources.begin();
+    for (; stageIt != sources.end(); ++stageIt) {
+        const StringData stageName = (*stageIt)->getSourceName();
+        if (stageName != "$match"_sd && stageName != "$project"_sd &&
+            stageName != "$addFields"_sd && stageName != "$replaceRoot"_sd &&
+            stageName != "$unwind"_sd) {
+            break;
+        }
+        (*stageIt)->serializeToArray(serializedStages);
+    }
+
+    // A $group which may be split is computed partially by each worker, and merged by the stages
+    // which replace it, just as the shards and merging parts of a split pipeline are.
+    std::list<intrusive_ptr<DocumentSource>> mergeSources;
+    if (stageIt != sources.end()) {
+        auto groupStage = dynamic_cast<DocumentSourceGroup*>(stageIt->get());
+        if (groupStage && groupStage->isInputOrderIndependent()) {
+            groupStage->getShardSource()->serializeToArray(serializedStages);
+            mergeSources = groupStage->getMergeSources();
+            ++stageIt;
+        }
+    }
+
+    if (queryObj.isEmpty() && serializedStages.empty()) {
+        // There would be nothing for the workers to do but read documents.
+        return false;
+    }
+
+    std::vector<BSONObj> rangePipeline;
+    for (auto&& stage : serializedStages) {
+        rangePipeline.push_back(stage.getDocument().toBson());
+    }
+
+    // Divide the span of RecordIds currently in the collection into several ranges per worker, so
+    // that a worker which finishes early can take over some of the remaining work. The outermost
+    // ranges are left open so that records inserted at either end are not missed.
+    auto firstRecord = collection->getCursor(expCtx->opCtx, true)->next();
+    auto lastRecord = collection->getCursor(expCtx->opCtx, false)->next();
+    if (!firstRecord || !lastRecord) {
+        return false;
+    }
+    const int64_t first = firstRecord->id.repr();
+    const int64_t span = lastRecord->id.repr() - first;
+    const size_t numRanges = std::max<size_t>(
+        1, std::min<int64_t>(numWorkers * kParallelCursorRangesPerWorker, span));
+
+    std::vector<DocumentSourceParallelCursor::RecordIdRange> ranges(numRanges);
+    for (size_t i = 1; i < numRanges; ++i) {
+        const RecordId boundary(first + span / static_cast<int64_t>(numRanges) * i);
+        ranges[i - 1].max = RecordId(boundary.repr() - 1);
+        ranges[i].min = boundary;
+    }
+
+    sources.erase(sources.begin(), stageIt);
+    sources.insert(sources.begin(), mergeSources.begin(), mergeSources.end());
+    pipeline->addInitialSource(DocumentSourceParallelCursor::create(expCtx,
+                                                                    collection->ns(),
+                                                                    collection->uuid(),
+                                                                    std::move(ranges),
+                                                                    numWorkers,
+                                                                    queryObj,
+                                                                    deps,
+                                                                    std::move(rangePipeline)));
+    return true;
+}
+
 StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prepareExecutor(
     OperationContext* opCtx,
     Collection* collection,
@@ -554,6 +664,10 @@ std::string PipelineD::getPlanSummaryStr(const Pipeline* pPipeline) {
         return docSourceCursor->getPlanSummaryStr();
     }
 
+    if (dynamic_cast<DocumentSourceParallelCursor*>(pPipeline->_sources.front().get())) {
+        return "COLLSCAN";
+    }
+
     return "";
 }
 
@@ -563,6 +677,9 @@ void PipelineD::getPlanSummaryStats(const Pipeline* pPipeline, PlanSummaryStats*
     if (auto docSourceCursor =
             dynamic_cast<DocumentSourceCursor*>(pPipeline->_sources.front().get())) {
         *statsOut = docSourceCursor->getPlanSummaryStats();
+    } else if (auto parallelCursor = dynamic_cast<DocumentSourceParallelCursor*>(
+                   pPipeline->_sources.front().get())) {
+        statsOut->totalDocsExamined = parallelCursor->getDocsExamined();
     }
 
     bool hasSortStage{false};
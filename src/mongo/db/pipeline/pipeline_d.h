@@ -190,6 +190,21 @@ private:
         BSONObj* sortObj,
         BSONObj* projectionObj);
 
+    /**
+     * If 'exec' is a plain collection scan over a large enough collection and parallel scans are
+     * enabled, replaces it with a DocumentSourceParallelCursor. The stages at the front of the
+     * Pipeline which do not depend on the order of their input, possibly up to and including the
+     * shards part of a $group, are moved into the scan's workers. Returns false, leaving the
+     * Pipeline untouched, if the scan cannot be performed in parallel.
+     */
+    static bool attemptToAddParallelCursorSource(
+        Collection* collection,
+        Pipeline* pipeline,
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const PlanExecutor& exec,
+        const DepsTracker& deps,
+        const BSONObj& queryObj);
+
     /**
      * Creates a DocumentSourceCursor from the given PlanExecutor and adds it to the front of the
      * Pipeline.
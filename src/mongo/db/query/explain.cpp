@@ -364,6 +364,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         }
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->docsTested);
+            if (spec->sharedOplogEntriesReturned > 0) {
+                bob->appendNumber("sharedOplogEntriesReturned", spec->sharedOplogEntriesReturned);
+            }
         }
     } else if (STAGE_COUNT == stats.stageType) {
         CountStats* spec = static_cast<CountStats*>(stats.specific.get());
@@ -538,6 +541,10 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            bob->appendBool("usedDisk", spec->usedDisk);
+            if (spec->usedDisk) {
+                bob->appendNumber("spills", spec->spills);
+            }
         }
 
         if (spec->limit > 0) {
@@ -40,6 +40,7 @@
 #include "mongo/base/parse_number.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/count.h"
 #include "mongo/db/exec/delete.h"
@@ -85,6 +86,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stringutils.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -273,6 +275,7 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
                                                     unique_ptr<CanonicalQuery> canonicalQuery,
                                                     size_t plannerOptions) {
     invariant(canonicalQuery);
+    Timer planningTimer;
 
     unique_ptr<PlanStage> root;
 
@@ -375,6 +378,14 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
             verify(StageBuilder::build(
                 opCtx, collection, *canonicalQuery, *querySolution, ws, &rawRoot));
 
+            // A plan cached for a shape with only one solution has nothing to be replanned
+            // against, so there is no need for a trial period.
+            if (cs->isSingleSolution) {
+                root.reset(rawRoot);
+                return PrepareExecutionResult(
+                    std::move(canonicalQuery), std::move(querySolution), std::move(root));
+            }
+
             // Add a CachedPlanStage on top of the previous root.
             //
             // 'decisionWorks' is used to determine whether the existing cache entry should
@@ -442,9 +453,28 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
             StageBuilder::build(opCtx, collection, *canonicalQuery, *solutions[0], ws, &rawRoot));
         root.reset(rawRoot);
 
-        LOG(2) << "Only one plan is available; it will be run but will not be cached. "
-               << redact(canonicalQuery->toStringShort())
-               << ", planSummary: " << redact(Explain::getPlanSummary(root.get()));
+        // Caching the solution lets later queries of the same shape bind their values into it
+        // rather than enumerating plans again.
+        if (internalQueryCacheSingleSolutionPlans.load() && solutions[0]->cacheData &&
+            PlanCache::shouldCacheQuery(*canonicalQuery)) {
+            solutions[0]->cacheData->indexFilterApplied = plannerParams.indexFiltersApplied;
+            collection->infoCache()
+                ->getPlanCache()
+                ->setSingleSolution(*canonicalQuery,
+                                    solutions[0].get(),
+                                    root->getStats(),
+                                    Microseconds(planningTimer.micros()),
+                                    opCtx->getServiceContext()->getPreciseClockSource()->now())
+                .transitional_ignore();
+
+            LOG(2) << "Only one plan is available; it will be run and cached. "
+                   << redact(canonicalQuery->toStringShort())
+                   << ", planSummary: " << redact(Explain::getPlanSummary(root.get()));
+        } else {
+            LOG(2) << "Only one plan is available; it will be run but will not be cached. "
+                   << redact(canonicalQuery->toStringShort())
+                   << ", planSummary: " << redact(Explain::getPlanSummary(root.get()));
+        }
 
         return PrepareExecutionResult(
             std::move(canonicalQuery), std::move(solutions[0]), std::move(root));
@@ -480,6 +510,9 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutor(
     unique_ptr<CanonicalQuery> canonicalQuery,
     PlanExecutor::YieldPolicy yieldPolicy,
     size_t plannerOptions) {
+    // Planning includes the trial period of the multi-planner, which runs when the PlanExecutor
+    // is made.
+    Timer planningTimer;
     unique_ptr<WorkingSet> ws = make_unique<WorkingSet>();
     StatusWith<PrepareExecutionResult> executionResult =
         prepareExecution(opCtx, collection, ws.get(), std::move(canonicalQuery), plannerOptions);
@@ -489,13 +522,20 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutor(
     invariant(executionResult.getValue().root);
     // We must have a tree of stages in order to have a valid plan executor, but the query
     // solution may be null.
-    return PlanExecutor::make(opCtx,
-                              std::move(ws),
-                              std::move(executionResult.getValue().root),
-                              std::move(executionResult.getValue().querySolution),
-                              std::move(executionResult.getValue().canonicalQuery),
-                              collection,
-                              yieldPolicy);
+    auto exec = PlanExecutor::make(opCtx,
+                                   std::move(ws),
+                                   std::move(executionResult.getValue().root),
+                                   std::move(executionResult.getValue().querySolution),
+                                   std::move(executionResult.getValue().canonicalQuery),
+                                   collection,
+                                   yieldPolicy);
+    if (!exec.isOK()) {
+        return exec;
+    }
+
+    auto& opDebug = CurOp::get(opCtx)->debug();
+    opDebug.planningTimeMicros = std::max(opDebug.planningTimeMicros, 0LL) + planningTimer.micros();
+    return exec;
 }
 
 //
@@ -648,6 +688,8 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getOplogStartHack(
         plannerOptions & QueryPlannerParams::TRACK_LATEST_OPLOG_TS;
     params.shouldWaitForOplogVisibility =
         shouldWaitForOplogVisibility(opCtx, collection, params.tailable);
+    params.shareOplogReads = params.tailable && collection->ns().isOplog() &&
+        internalQueryExecShareOplogReads.load();
 
     // If the query is just a lower bound on "ts", we know that every document in the collection
     // after the first matching one must also match. To avoid wasting time running the match
@@ -799,6 +841,11 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDelete(
     deleteStageParams.sort = request->getSort();
     deleteStageParams.opDebug = opDebug;
     deleteStageParams.stmtId = request->getStmtId();
+    if (repl::ReplicationCoordinator::get(opCtx)->isOplogDisabledFor(opCtx, nss)) {
+        // Each replicated delete is timestamped with the optime of its own oplog entry, which
+        // requires it to commit in a WriteUnitOfWork of its own.
+        deleteStageParams.batchSize = internalUpdateDeleteMaxBatchSize.load();
+    }
 
     unique_ptr<WorkingSet> ws = make_unique<WorkingSet>();
     const PlanExecutor::YieldPolicy policy = parsedDelete->yieldPolicy();
@@ -950,6 +997,11 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorUpdate(
 
     unique_ptr<WorkingSet> ws = make_unique<WorkingSet>();
     UpdateStageParams updateStageParams(request, driver, opDebug);
+    if (repl::ReplicationCoordinator::get(opCtx)->isOplogDisabledFor(opCtx, nss)) {
+        // Each replicated update is timestamped with the optime of its own oplog entry, which
+        // requires it to commit in a WriteUnitOfWork of its own.
+        updateStageParams.batchSize = internalUpdateDeleteMaxBatchSize.load();
+    }
 
     if (!parsedUpdate->hasParsedQuery()) {
         // This is the idhack fast-path for getting a PlanExecutor without doing the work
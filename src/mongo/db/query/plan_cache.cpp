@@ -369,7 +369,8 @@ CachedSolution::CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& en
       sort(entry.sort.getOwned()),
       projection(entry.projection.getOwned()),
       collation(entry.collation.getOwned()),
-      decisionWorks(entry.works) {
+      decisionWorks(entry.works),
+      isSingleSolution(entry.isSingleSolution) {
     // CachedSolution should not having any references into
     // cache entry. All relevant data should be cloned/copied.
     for (size_t i = 0; i < entry.plannerData.size(); ++i) {
@@ -434,6 +435,10 @@ PlanCacheEntry* PlanCacheEntry::clone() const {
     entry->timeOfCreation = timeOfCreation;
     entry->isActive = isActive;
     entry->works = works;
+    entry->isSingleSolution = isSingleSolution;
+    entry->timesPlanned = timesPlanned;
+    entry->totalPlanningTime = totalPlanningTime;
+    entry->maxPlanningTime = maxPlanningTime;
 
     // Copy performance stats.
     for (size_t i = 0; i < feedback.size(); ++i) {
@@ -796,6 +801,51 @@ PlanCache::NewEntryState PlanCache::getNewEntryState(const CanonicalQuery& query
 }
 
 
+namespace {
+
+/**
+ * Creates a cache entry for 'query' from 'solns', copying the parts of the query which the plan
+ * cache commands display.
+ */
+std::unique_ptr<PlanCacheEntry> makeEntry(const CanonicalQuery& query,
+                                          const std::vector<QuerySolution*>& solns,
+                                          std::unique_ptr<PlanRankingDecision> why,
+                                          Date_t now) {
+    auto newEntry = std::make_unique<PlanCacheEntry>(solns, why.release());
+    const QueryRequest& qr = query.getQueryRequest();
+    newEntry->query = qr.getFilter().getOwned();
+    newEntry->sort = qr.getSort().getOwned();
+    if (query.getCollator()) {
+        newEntry->collation = query.getCollator()->getSpec().toBSON();
+    }
+    newEntry->timeOfCreation = now;
+
+    // Strip projections on $-prefixed fields, as these are added by internal callers of the query
+    // system and are not considered part of the user projection.
+    BSONObjBuilder projBuilder;
+    for (auto elem : qr.getProj()) {
+        if (elem.fieldName()[0] == '$') {
+            continue;
+        }
+        projBuilder.append(elem);
+    }
+    newEntry->projection = projBuilder.obj();
+    return newEntry;
+}
+
+/**
+ * Adds 'planningTime' to the planning statistics of 'entry'. Planning time is only recorded when
+ * a plan is offered to the cache, so that queries answered from the cache do not take the cache
+ * mutex a second time.
+ */
+void addPlanningTime(PlanCacheEntry* entry, Microseconds planningTime) {
+    ++entry->timesPlanned;
+    entry->totalPlanningTime += planningTime;
+    entry->maxPlanningTime = std::max(entry->maxPlanningTime, planningTime);
+}
+
+}  // namespace
+
 Status PlanCache::set(const CanonicalQuery& query,
                       const std::vector<QuerySolution*>& solns,
                       std::unique_ptr<PlanRankingDecision> why,
@@ -822,15 +872,16 @@ Status PlanCache::set(const CanonicalQuery& query,
 
     const auto key = computeKey(query);
     const size_t newWorks = why->stats[0]->common.works;
+    const Microseconds planningTime = why->planningTime;
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    PlanCacheEntry* oldEntry = nullptr;
+    Status cacheStatus = _cache.get(key, &oldEntry);
+    invariant(cacheStatus.isOK() || cacheStatus == ErrorCodes::NoSuchKey);
     bool isNewEntryActive = false;
     if (internalQueryCacheDisableInactiveEntries.load()) {
         // All entries are always active.
         isNewEntryActive = true;
     } else {
-        PlanCacheEntry* oldEntry = nullptr;
-        Status cacheStatus = _cache.get(key, &oldEntry);
-        invariant(cacheStatus.isOK() || cacheStatus == ErrorCodes::NoSuchKey);
         auto newState = getNewEntryState(
             query,
             oldEntry,
@@ -838,42 +889,68 @@ Status PlanCache::set(const CanonicalQuery& query,
             worksGrowthCoefficient.get_value_or(internalQueryCacheWorksGrowthCoefficient));
 
         if (!newState.shouldBeCreated) {
+            addPlanningTime(oldEntry, planningTime);
             return Status::OK();
         }
         isNewEntryActive = newState.shouldBeActive;
     }
 
-    auto newEntry = std::make_unique<PlanCacheEntry>(solns, why.release());
-    const QueryRequest& qr = query.getQueryRequest();
-    newEntry->query = qr.getFilter().getOwned();
-    newEntry->sort = qr.getSort().getOwned();
+    auto newEntry = makeEntry(query, solns, std::move(why), now);
     newEntry->isActive = isNewEntryActive;
     newEntry->works = newWorks;
-    if (query.getCollator()) {
-        newEntry->collation = query.getCollator()->getSpec().toBSON();
+    if (oldEntry) {
+        // The planning statistics describe the query shape rather than any one of its plans.
+        newEntry->timesPlanned = oldEntry->timesPlanned;
+        newEntry->totalPlanningTime = oldEntry->totalPlanningTime;
+        newEntry->maxPlanningTime = oldEntry->maxPlanningTime;
     }
-    newEntry->timeOfCreation = now;
+    addPlanningTime(newEntry.get(), planningTime);
+    addEntry_inlock(key, std::move(newEntry));
+    return Status::OK();
+}
 
+Status PlanCache::setSingleSolution(const CanonicalQuery& query,
+                                    QuerySolution* soln,
+                                    std::unique_ptr<PlanStageStats> stats,
+                                    Microseconds planningTime,
+                                    Date_t now) {
+    invariant(soln);
+    invariant(stats);
 
-    // Strip projections on $-prefixed fields, as these are added by internal callers of the query
-    // system and are not considered part of the user projection.
-    BSONObjBuilder projBuilder;
-    for (auto elem : qr.getProj()) {
-        if (elem.fieldName()[0] == '$') {
-            continue;
-        }
-        projBuilder.append(elem);
+    if (!soln->cacheData) {
+        return Status(ErrorCodes::BadValue, "solution has no cache data");
+    }
+
+    // The plan was not ranked against any other, so the decision records only its stats.
+    auto why = std::make_unique<PlanRankingDecision>();
+    why->stats.push_back(std::move(stats));
+    why->scores.push_back(0);
+    why->candidateOrder.push_back(0);
+    why->planningTime = planningTime;
+
+    const auto key = computeKey(query);
+    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    PlanCacheEntry* oldEntry = nullptr;
+    if (_cache.get(key, &oldEntry).isOK()) {
+        addPlanningTime(oldEntry, planningTime);
+        return Status::OK();
     }
-    newEntry->projection = projBuilder.obj();
 
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, newEntry.release());
+    auto newEntry = makeEntry(query, {soln}, std::move(why), now);
+    newEntry->isActive = true;
+    newEntry->isSingleSolution = true;
+    addPlanningTime(newEntry.get(), planningTime);
+    addEntry_inlock(key, std::move(newEntry));
+    return Status::OK();
+}
+
+void PlanCache::addEntry_inlock(const PlanCacheKey& key, std::unique_ptr<PlanCacheEntry> entry) {
+    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, entry.release());
 
     if (NULL != evictedEntry.get()) {
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
                << "removed least recently used entry " << redact(evictedEntry->toString());
     }
-
-    return Status::OK();
 }
 
 void PlanCache::deactivate(const CanonicalQuery& query) {
@@ -221,6 +221,10 @@ public:
     // The number of work cycles taken to decide on a winning plan when the plan was first
     // cached.
     size_t decisionWorks;
+
+    // Whether the cached plan is the only candidate plan for its query shape, in which case it
+    // should be used without a trial period.
+    bool isSingleSolution;
 };
 
 /**
@@ -290,6 +294,17 @@ public:
     // trigger a replan. Running a query of the same shape while this cache entry is inactive may
     // cause this value to be increased.
     size_t works = 0;
+
+    // Whether the entry was created for a query shape with only one candidate plan. Such an entry
+    // is used without a trial period, since there is no other plan to replan to.
+    bool isSingleSolution = false;
+
+    // Time spent choosing a plan for queries of this shape which offered their plan to the
+    // cache, including the query which created the entry. Carried over when the entry is
+    // replaced. Queries which use the cached plan are not counted.
+    long long timesPlanned = 0;
+    Microseconds totalPlanningTime{0};
+    Microseconds maxPlanningTime{0};
 };
 
 /**
@@ -359,6 +374,9 @@ public:
      * an inactive cache entry.  If boost::none is provided, the function will use
      * 'internalQueryCacheWorksGrowthCoefficient'.
      *
+     * The 'planningTime' of 'why' is added to the planning statistics of the shape, whether or
+     * not a new entry is created.
+     *
      * If the mapping was set successfully, returns Status::OK(), even if it evicted another entry.
      */
     Status set(const CanonicalQuery& query,
@@ -367,6 +385,20 @@ public:
                Date_t now,
                boost::optional<double> worksGrowthCoefficient = boost::none);
 
+    /**
+     * Record the plan for a query whose shape the planner can answer with only one solution, so
+     * that later queries of the same shape can bind their values into the cached plan through
+     * QueryPlanner::planFromCache() instead of being planned from scratch. 'stats' describes the
+     * execution tree built for 'soln', and 'planningTime' is the time spent planning 'query'.
+     *
+     * The entry is created active, and does not replace an existing entry for the shape.
+     */
+    Status setSingleSolution(const CanonicalQuery& query,
+                             QuerySolution* soln,
+                             std::unique_ptr<PlanStageStats> stats,
+                             Microseconds planningTime,
+                             Date_t now);
+
     /**
      * Set a cache entry back to the 'inactive' state. Rather than completely evicting an entry
      * when the associated plan starts to perform poorly, we deactivate it, so that plans which
@@ -468,6 +500,12 @@ private:
                                    size_t newWorks,
                                    double growthCoefficient);
 
+    /**
+     * Adds 'entry' to the cache under 'key', evicting the least recently used entry if the cache
+     * is full. Callers must hold '_cacheMutex'.
+     */
+    void addEntry_inlock(const PlanCacheKey& key, std::unique_ptr<PlanCacheEntry> entry);
+
     void encodeKeyForMatch(const MatchExpression* tree, StringBuilder* keyBuilder) const;
     void encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const;
     void encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuilder) const;
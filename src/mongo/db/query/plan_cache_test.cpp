@@ -762,6 +762,96 @@ TEST(PlanCacheTest, DeactivateCacheEntry) {
     ASSERT_EQ(entry->works, 20U);
 }
 
+TEST(PlanCacheTest, SetSingleSolutionCreatesActiveEntry) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    auto qs = getQuerySolutionForCaching();
+
+    auto stats = std::move(createDecision(1U)->stats[0]);
+    ASSERT_OK(
+        planCache.setSingleSolution(*cq, qs.get(), std::move(stats), Microseconds(0), Date_t{}));
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentActive);
+    ASSERT_TRUE(planCache.get(*cq).cachedSolution->isSingleSolution);
+
+    auto entry = assertGet(planCache.getEntry(*cq));
+    ASSERT_TRUE(entry->isSingleSolution);
+    ASSERT_EQ(entry->plannerData.size(), 1U);
+    ASSERT_EQ(entry->decision->stats.size(), 1U);
+    ASSERT_EQ(entry->decision->scores.size(), 1U);
+}
+
+TEST(PlanCacheTest, SetSingleSolutionDoesNotReplaceExistingEntry) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    auto qs = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {qs.get()};
+
+    QueryTestServiceContext serviceContext;
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(1U, 50), Date_t{}));
+
+    auto stats = std::move(createDecision(1U)->stats[0]);
+    ASSERT_OK(
+        planCache.setSingleSolution(*cq, qs.get(), std::move(stats), Microseconds(0), Date_t{}));
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+
+    auto entry = assertGet(planCache.getEntry(*cq));
+    ASSERT_FALSE(entry->isSingleSolution);
+    ASSERT_EQ(entry->works, 50U);
+}
+
+TEST(PlanCacheTest, SetSingleSolutionFailsWithoutCacheData) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    QuerySolution qs;
+
+    auto stats = std::move(createDecision(1U)->stats[0]);
+    ASSERT_NOT_OK(
+        planCache.setSingleSolution(*cq, &qs, std::move(stats), Microseconds(0), Date_t{}));
+    ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kNotPresent);
+}
+
+TEST(PlanCacheTest, PlanningTimeAccumulatesPerShapeOnSet) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    unique_ptr<CanonicalQuery> sameShapeCq(canonicalize("{a: 5}"));
+    unique_ptr<CanonicalQuery> otherShapeCq(canonicalize("{b: 1}"));
+    auto qs = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {qs.get()};
+
+    auto decisionWithPlanningTime = [](size_t works, Microseconds planningTime) {
+        auto decision = createDecision(1U, works);
+        decision->planningTime = planningTime;
+        return decision;
+    };
+
+    QueryTestServiceContext serviceContext;
+    ASSERT_OK(planCache.set(*cq, solns, decisionWithPlanningTime(10, Microseconds(30)), Date_t{}));
+    auto entry = assertGet(planCache.getEntry(*cq));
+    ASSERT_EQ(entry->timesPlanned, 1);
+    ASSERT_EQ(entry->totalPlanningTime, Microseconds(30));
+
+    // An offer which leaves the inactive entry in place is still counted against the shape.
+    ASSERT_OK(planCache.set(
+        *sameShapeCq, solns, decisionWithPlanningTime(20, Microseconds(50)), Date_t{}));
+    entry = assertGet(planCache.getEntry(*cq));
+    ASSERT_FALSE(entry->isActive);
+    ASSERT_EQ(entry->timesPlanned, 2);
+
+    // Replacing the entry carries its planning statistics over.
+    ASSERT_OK(planCache.set(
+        *sameShapeCq, solns, decisionWithPlanningTime(5, Microseconds(20)), Date_t{}));
+    entry = assertGet(planCache.getEntry(*cq));
+    ASSERT_TRUE(entry->isActive);
+    ASSERT_EQ(entry->timesPlanned, 3);
+    ASSERT_EQ(entry->totalPlanningTime, Microseconds(100));
+    ASSERT_EQ(entry->maxPlanningTime, Microseconds(50));
+
+    ASSERT_OK(planCache.set(
+        *otherShapeCq, solns, decisionWithPlanningTime(10, Microseconds(1000)), Date_t{}));
+    entry = assertGet(planCache.getEntry(*cq));
+    ASSERT_EQ(entry->timesPlanned, 3);
+}
+
 
 /**
  * Each test in the CachePlanSelectionTest suite goes through
@@ -37,6 +37,7 @@
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/query/query_solution.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -101,6 +102,7 @@ struct PlanRankingDecision {
         }
         decision->scores = scores;
         decision->candidateOrder = candidateOrder;
+        decision->planningTime = planningTime;
         return decision;
     }
 
@@ -125,6 +127,9 @@ struct PlanRankingDecision {
     // Reading this flag is the only reliable way for callers to determine if there was a tie,
     // because the scores kept inside the PlanRankingDecision do not incorporate the EOF bonus.
     bool tieForBest = false;
+
+    // The time spent reaching this decision, which the plan cache accumulates per query shape.
+    Microseconds planningTime{0};
 };
 
 }  // namespace mongo
@@ -55,6 +55,8 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheWorksGrowthCoefficient, double,
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheDisableInactiveEntries, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheSingleSolutionPlans, bool, false);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerMaxIndexedSolutions, int, 64);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnumerationMaxOrSolutions, int, 10);
@@ -73,6 +75,21 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxScansToExplode, int, 200);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecAllowDiskUseByDefault, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecEnableCompiledMatchExpression, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecShareOplogReads, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecSharedOplogReadBufferBytes, int, 32 * 1024 * 1024)
+    ->withValidator([](const int& newVal) {
+        if (newVal <= 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryExecSharedOplogReadBufferBytes must be greater than 0");
+        }
+        return Status::OK();
+    });
+
 // Yield every 128 cycles or 10ms.
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
@@ -83,10 +100,49 @@ MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchSize,
                               int,
                               internalQueryExecYieldIterations.load() / 2);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalUpdateDeleteMaxBatchSize, int, 64)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "internalUpdateDeleteMaxBatchSize must be at least 1");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalInsertIndexKeysInOrderWhenEmpty, bool, true);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceCursorBatchSizeBytes, int, 4 * 1024 * 1024);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupCacheSizeBytes, int, 100 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupHashJoinMaxBytes,
+                              int,
+                              16 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupHashJoinMinInputDocs, int, 16)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceLookupHashJoinMinInputDocs must not be negative");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGraphLookupMaxMemoryBytes,
+                              int,
+                              100 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceParallelCursorThreads, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceParallelCursorThreads must be between 0 and 64");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceParallelCursorMinRecords, int, 100000);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerGenerateCoveredWholeIndexScans, bool, false);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryIgnoreUnknownJSONSchemaKeywords, bool, false);
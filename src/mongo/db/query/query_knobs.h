@@ -79,6 +79,10 @@ extern AtomicDouble internalQueryCacheWorksGrowthCoefficient;
 // Whether or not cache entries can be marked as "inactive."
 extern AtomicBool internalQueryCacheDisableInactiveEntries;
 
+// Whether to cache the plan for query shapes with only one candidate solution, so that later
+// queries of the same shape are not planned from scratch.
+extern AtomicBool internalQueryCacheSingleSolutionPlans;
+
 //
 // Planning and enumeration.
 //
@@ -111,6 +115,20 @@ extern AtomicBool internalQueryIgnoreUnknownJSONSchemaKeywords;
 
 extern AtomicInt32 internalQueryExecMaxBlockingSortBytes;
 
+// Whether find commands which do not specify 'allowDiskUse' may spill blocking sorts to disk.
+extern AtomicBool internalQueryExecAllowDiskUseByDefault;
+
+// Whether collection scans and fetches evaluate supported filters with a compiled matcher.
+extern AtomicBool internalQueryExecEnableCompiledMatchExpression;
+
+// Whether tailable scans of the oplog under majority read concern share the entries they read
+// through the SharedOplogReadBuffer. Off by default, since every such scan then takes the
+// buffer's single mutex for each entry it reads.
+extern AtomicBool internalQueryExecShareOplogReads;
+
+// The maximum size of the window of recent oplog entries held by the SharedOplogReadBuffer.
+extern AtomicInt32 internalQueryExecSharedOplogReadBufferBytes;
+
 // Yield after this many "should yield?" checks.
 extern AtomicInt32 internalQueryExecYieldIterations;
 
@@ -125,9 +143,37 @@ extern AtomicInt32 internalQueryFacetBufferSizeBytes;
 
 extern AtomicInt32 internalInsertMaxBatchSize;
 
+// The number of documents a multi-update or multi-delete gathers from its query and writes
+// together inside a single WriteUnitOfWork. A value of 1 writes each document on its own. Only
+// applies to namespaces whose writes are not logged to the oplog.
+extern AtomicInt32 internalUpdateDeleteMaxBatchSize;
+
+// Whether a batch of inserts which makes up the whole of its collection has its index keys
+// inserted in key order rather than document by document.
+extern AtomicBool internalInsertIndexKeysInOrderWhenEmpty;
+
 extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
 extern AtomicInt32 internalDocumentSourceLookupCacheSizeBytes;
 
+// The maximum size of a foreign collection which $lookup will hash join with, rather than querying
+// once per input document. A value of 0 disables hash joins.
+extern AtomicInt32 internalDocumentSourceLookupHashJoinMaxBytes;
+
+// The number of input documents $lookup joins by querying the foreign collection before it
+// considers a hash join, so that a $lookup which sees only a few documents never builds a table.
+extern AtomicInt32 internalDocumentSourceLookupHashJoinMinInputDocs;
+
+// The maximum memory a $graphLookup search may use before it fails, or continues on disk if
+// allowDiskUse is enabled.
+extern AtomicInt32 internalDocumentSourceGraphLookupMaxMemoryBytes;
+
+// The number of threads over which an aggregation beginning with a full collection scan divides
+// the scan and its leading stages. A value of 0 or 1 disables parallel collection scans.
+extern AtomicInt32 internalDocumentSourceParallelCursorThreads;
+
+// The minimum number of records a collection must hold for its scan to be performed in parallel.
+extern AtomicInt32 internalDocumentSourceParallelCursorMinRecords;
+
 extern AtomicBool internalQueryProhibitBlockingMergeOnMongoS;
 }  // namespace mongo
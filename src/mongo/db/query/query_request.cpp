@@ -108,6 +108,7 @@ const char kNaturalSortField[] = "$natural";
 
 const char QueryRequest::kFindCommandName[] = "find";
 const char QueryRequest::kShardVersionField[] = "shardVersion";
+const char QueryRequest::kAllowDiskUseField[] = "allowDiskUse";
 
 QueryRequest::QueryRequest(NamespaceString nss) : _nss(std::move(nss)) {}
 QueryRequest::QueryRequest(CollectionUUID uuid) : _uuid(std::move(uuid)) {}
@@ -327,6 +328,13 @@ StatusWith<unique_ptr<QueryRequest>> QueryRequest::parseFromFindCommand(unique_p
             }
 
             awaitData = el.boolean();
+        } else if (fieldName == kAllowDiskUseField) {
+            Status status = checkFieldType(el, Bool);
+            if (!status.isOK()) {
+                return status;
+            }
+
+            qr->_allowDiskUse = el.boolean();
         } else if (fieldName == kPartialResultsField) {
             Status status = checkFieldType(el, Bool);
             if (!status.isOK()) {
@@ -507,6 +515,10 @@ void QueryRequest::asFindCommand(BSONObjBuilder* cmdBuilder) const {
         cmdBuilder->append(kPartialResultsField, true);
     }
 
+    if (_allowDiskUse) {
+        cmdBuilder->append(kAllowDiskUseField, true);
+    }
+
     if (_replicationTerm) {
         cmdBuilder->append(kTermField, *_replicationTerm);
     }
@@ -1048,6 +1060,9 @@ StatusWith<BSONObj> QueryRequest::asAggregationCommand() const {
     if (!_readConcern.isEmpty()) {
         aggregationBuilder.append("readConcern", _readConcern);
     }
+    if (_allowDiskUse) {
+        aggregationBuilder.append(kAllowDiskUseField, true);
+    }
     if (!_unwrappedReadPref.isEmpty()) {
         aggregationBuilder.append(QueryRequest::kUnwrappedReadPrefField, _unwrappedReadPref);
     }
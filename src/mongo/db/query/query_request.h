@@ -52,6 +52,7 @@ class QueryRequest {
 public:
     static const char kFindCommandName[];
     static const char kShardVersionField[];
+    static const char kAllowDiskUseField[];
 
     QueryRequest(NamespaceString nss);
 
@@ -335,6 +336,14 @@ public:
         _slaveOk = slaveOk;
     }
 
+    bool allowDiskUse() const {
+        return _allowDiskUse;
+    }
+
+    void setAllowDiskUse(bool allowDiskUse) {
+        _allowDiskUse = allowDiskUse;
+    }
+
     bool isOplogReplay() const {
         return _oplogReplay;
     }
@@ -487,6 +496,10 @@ private:
     bool _showRecordId = false;
     bool _hasReadPref = false;
 
+    // Whether blocking sorts may spill to disk rather than failing once they exceed the memory
+    // limit.
+    bool _allowDiskUse = false;
+
     // Options that can be specified in the OP_QUERY 'flags' header.
     TailableModeEnum _tailableMode = TailableModeEnum::kNormal;
     bool _slaveOk = false;
@@ -415,6 +415,30 @@ TEST(QueryRequestTest, ParseFromCommandAllFlagsTrue) {
     ASSERT(qr->isAllowPartialResults());
 }
 
+TEST(QueryRequestTest, ParseFromCommandAllowDiskUse) {
+    BSONObj cmdObj = fromjson(
+        "{find: 'testns',"
+        "sort: {a: 1},"
+        "allowDiskUse: true}");
+    const NamespaceString nss("test.testns");
+    bool isExplain = false;
+    unique_ptr<QueryRequest> qr(
+        assertGet(QueryRequest::makeFromFindCommand(nss, cmdObj, isExplain)));
+
+    ASSERT(qr->allowDiskUse());
+    ASSERT_BSONOBJ_EQ(cmdObj, qr->asFindCommand());
+}
+
+TEST(QueryRequestTest, ParseFromCommandAllowDiskUseDefaultsToFalse) {
+    BSONObj cmdObj = fromjson("{find: 'testns', sort: {a: 1}}");
+    const NamespaceString nss("test.testns");
+    bool isExplain = false;
+    unique_ptr<QueryRequest> qr(
+        assertGet(QueryRequest::makeFromFindCommand(nss, cmdObj, isExplain)));
+
+    ASSERT(!qr->allowDiskUse());
+}
+
 TEST(QueryRequestTest, ParseFromCommandCommentWithValidMinMax) {
     BSONObj cmdObj = fromjson(
         "{find: 'testns',"
@@ -731,6 +755,17 @@ TEST(QueryRequestTest, ParseFromCommandExhaustWrongType) {
     ASSERT_NOT_OK(result.getStatus());
 }
 
+TEST(QueryRequestTest, ParseFromCommandAllowDiskUseWrongType) {
+    BSONObj cmdObj = fromjson(
+        "{find: 'testns',"
+        "sort: {a: 1},"
+        "allowDiskUse: 1}");
+    const NamespaceString nss("test.testns");
+    bool isExplain = false;
+    auto result = QueryRequest::makeFromFindCommand(nss, cmdObj, isExplain);
+    ASSERT_NOT_OK(result.getStatus());
+}
+
 TEST(QueryRequestTest, ParseFromCommandPartialWrongType) {
     BSONObj cmdObj = fromjson(
         "{find: 'testns',"
@@ -1204,6 +1239,19 @@ TEST(QueryRequestTest, ConvertToAggregationWithBatchSize) {
     ASSERT_BSONOBJ_EQ(ar.getValue().getCollation(), BSONObj());
 }
 
+TEST(QueryRequestTest, ConvertToAggregationWithAllowDiskUse) {
+    QueryRequest qr(testns);
+    qr.setSort(BSON("y" << -1));
+    qr.setAllowDiskUse(true);
+
+    auto agg = qr.asAggregationCommand();
+    ASSERT_OK(agg);
+
+    auto ar = AggregationRequest::parseFromBSON(testns, agg.getValue());
+    ASSERT_OK(ar.getStatus());
+    ASSERT(ar.getValue().shouldAllowDiskUse());
+}
+
 TEST(QueryRequestTest, ConvertToAggregationWithMaxTimeMS) {
     QueryRequest qr(testns);
     qr.setMaxTimeMS(9);
@@ -121,6 +121,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.collection = collection;
             params.pattern = sn->pattern;
             params.limit = sn->limit;
+            params.allowDiskUse = cq.getQueryRequest().allowDiskUse();
             return new SortStage(opCtx, params, ws, childStage);
         }
         case STAGE_SORT_KEY_GENERATOR: {
@@ -33,8 +33,10 @@
 #include "mongo/db/repl/sync_tail.h"
 
 #include "third_party/murmurhash3/MurmurHash3.h"
+#include <algorithm>
 #include <boost/functional/hash.hpp>
 #include <memory>
+#include <queue>
 
 #include "mongo/base/counter.h"
 #include "mongo/bson/bsonelement_comparator.h"
@@ -72,6 +74,7 @@
 #include "mongo/db/session_txn_record_gen.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -400,6 +403,11 @@ void applyOps(std::vector<MultiApplier::OperationPtrs>& writerVectors,
                 &workerMultikeyPathInfo = workerMultikeyPathInfo->at(i)
             ] {
                 auto opCtx = cc().makeOperationContext();
+
+                // Oplog application is internal work whose concurrency is already bounded by the
+                // size of the writer pool, so it is admitted ahead of client operations rather
+                // than queueing with them for storage engine tickets.
+                opCtx->lockState()->setShouldAcquireTicket(false);
                 status = func(opCtx.get(), &writer, st, &workerMultikeyPathInfo);
             }));
         }
@@ -419,6 +427,7 @@ void scheduleWritesToOplog(OperationContext* opCtx,
         // guarantees that 'ops' will stay in scope until the spawned threads complete.
         return [storageInterface, &ops, begin, end] {
             auto opCtx = cc().makeOperationContext();
+            opCtx->lockState()->setShouldAcquireTicket(false);
             UnreplicatedWritesBlock uwb(opCtx.get());
             ShouldNotConflictWithSecondaryBatchApplicationBlock shouldNotConflictBlock(
                 opCtx->lockState());
@@ -512,24 +521,33 @@ private:
     StringMap<CollectionProperties> _cache;
 };
 
+/**
+ * An operation to apply, along with a hash of the state it conflicts on. Operations with the same
+ * conflict hash must be applied by the same writer thread in oplog order, while operations with
+ * different conflict hashes may be applied concurrently by any writer threads.
+ */
+struct ConflictHashedOp {
+    uint32_t conflictHash;
+    OplogEntry* op;
+};
+
 /**
  * ops - This only modifies the isForCappedCollection field on each op. It does not alter the ops
  *      vector in any other way.
- * writerVectors - Set of operations for each worker thread to apply.
+ * hashedOps - Operations to apply, in oplog order, along with their conflict hashes.
  * derivedOps - If provided, this function inserts a decomposition of applyOps operations
  *      and instructions for updating the transactions table.
  * sessionUpdateTracker - if provided, keeps track of session info from ops.
  */
-void fillWriterVectors(OperationContext* opCtx,
+void hashOpsByConflict(OperationContext* opCtx,
                        MultiApplier::Operations* ops,
-                       std::vector<MultiApplier::OperationPtrs>* writerVectors,
+                       std::vector<ConflictHashedOp>* hashedOps,
                        std::vector<MultiApplier::Operations>* derivedOps,
                        SessionUpdateTracker* sessionUpdateTracker) {
     const auto serviceContext = opCtx->getServiceContext();
     const auto storageEngine = serviceContext->getStorageEngine();
 
     const bool supportsDocLocking = storageEngine->supportsDocLocking();
-    const uint32_t numWriters = writerVectors->size();
 
     CachedCollectionProperties collPropertiesCache;
 
@@ -542,7 +560,7 @@ void fillWriterVectors(OperationContext* opCtx,
         if (sessionUpdateTracker) {
             if (auto newOplogWrites = sessionUpdateTracker->updateOrFlush(op)) {
                 derivedOps->emplace_back(std::move(*newOplogWrites));
-                fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+                hashOpsByConflict(opCtx, &derivedOps->back(), hashedOps, derivedOps, nullptr);
             }
         }
 
@@ -578,8 +596,8 @@ void fillWriterVectors(OperationContext* opCtx,
             }
             try {
                 derivedOps->emplace_back(ApplyOps::extractOperations(op));
-                fillWriterVectors(
-                    opCtx, &derivedOps->back(), writerVectors, derivedOps, sessionUpdateTracker);
+                hashOpsByConflict(
+                    opCtx, &derivedOps->back(), hashedOps, derivedOps, sessionUpdateTracker);
             } catch (...) {
                 fassertFailedWithStatusNoTrace(
                     50711,
@@ -590,26 +608,90 @@ void fillWriterVectors(OperationContext* opCtx,
             continue;
         }
 
-        auto& writer = (*writerVectors)[hash % numWriters];
+        hashedOps->push_back({hash, &op});
+    }
+}
+
+/**
+ * Distributes 'hashedOps' across 'writerVectors' so that each set of conflicting operations is
+ * applied by a single writer, in oplog order, while the writers are given as even a share of the
+ * batch as possible.
+ *
+ * Conflict sets are assigned largest first to the writer with the fewest operations so far. Unlike
+ * assigning each set to the writer chosen by its hash, this never places two large conflict sets on
+ * the same writer while another writer is idle, so a single hot document or collection delays the
+ * batch by no more than its own operations.
+ */
+void assignOpsToWriters(const std::vector<ConflictHashedOp>& hashedOps,
+                        std::vector<MultiApplier::OperationPtrs>* writerVectors) {
+    // Maps each conflict hash to the number of operations in its set, and later to the index of
+    // the writer assigned to apply them.
+    stdx::unordered_map<uint32_t, size_t> conflictSets;
+    for (auto&& hashedOp : hashedOps) {
+        ++conflictSets[hashedOp.conflictHash];
+    }
+
+    // Order the conflict sets by decreasing size, breaking ties by hash so that the assignment is
+    // deterministic for a given batch.
+    std::vector<std::pair<size_t, uint32_t>> setsBySize;
+    setsBySize.reserve(conflictSets.size());
+    for (auto&& conflictSet : conflictSets) {
+        setsBySize.emplace_back(conflictSet.second, conflictSet.first);
+    }
+    std::sort(setsBySize.begin(),
+              setsBySize.end(),
+              [](const std::pair<size_t, uint32_t>& lhs, const std::pair<size_t, uint32_t>& rhs) {
+                  return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+              });
+
+    // A min-heap of (number of operations assigned, writer index).
+    using WriterLoad = std::pair<size_t, size_t>;
+    std::priority_queue<WriterLoad, std::vector<WriterLoad>, std::greater<WriterLoad>> writers;
+    for (size_t i = 0; i < writerVectors->size(); ++i) {
+        writers.emplace(0, i);
+    }
+
+    for (auto&& conflictSet : setsBySize) {
+        auto writer = writers.top();
+        writers.pop();
+        conflictSets[conflictSet.second] = writer.second;
+        writer.first += conflictSet.first;
+        writers.push(writer);
+    }
+
+    for (auto&& hashedOp : hashedOps) {
+        auto& writer = (*writerVectors)[conflictSets[hashedOp.conflictHash]];
         if (writer.empty()) {
             writer.reserve(8);  // Skip a few growth rounds
         }
-        writer.push_back(&op);
+        writer.push_back(hashedOp.op);
     }
 }
 
+/**
+ * ops - This only modifies the isForCappedCollection field on each op. It does not alter the ops
+ *      vector in any other way.
+ * writerVectors - Set of operations for each worker thread to apply.
+ * derivedOps - Receives a decomposition of applyOps operations and instructions for updating the
+ *      transactions table.
+ */
 void fillWriterVectors(OperationContext* opCtx,
                        MultiApplier::Operations* ops,
                        std::vector<MultiApplier::OperationPtrs>* writerVectors,
                        std::vector<MultiApplier::Operations>* derivedOps) {
+    std::vector<ConflictHashedOp> hashedOps;
+    hashedOps.reserve(ops->size());
+
     SessionUpdateTracker sessionUpdateTracker;
-    fillWriterVectors(opCtx, ops, writerVectors, derivedOps, &sessionUpdateTracker);
+    hashOpsByConflict(opCtx, ops, &hashedOps, derivedOps, &sessionUpdateTracker);
 
     auto newOplogWrites = sessionUpdateTracker.flushAll();
     if (!newOplogWrites.empty()) {
         derivedOps->emplace_back(std::move(newOplogWrites));
-        fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+        hashOpsByConflict(opCtx, &derivedOps->back(), &hashedOps, derivedOps, nullptr);
     }
+
+    assignOpsToWriters(hashedOps, writerVectors);
 }
 
 }  // namespace
@@ -449,10 +449,8 @@ TEST_F(SyncTailTest,
 }
 
 TEST_F(SyncTailTest, MultiApplyAssignsOperationsToWriterThreadsBasedOnNamespaceHash) {
-    // This test relies on implementation details of how multiApply uses hashing to distribute ops
-    // to threads. It is possible for this test to fail, even if the implementation of multiApply is
-    // correct. If it fails, consider adjusting the namespace names (to adjust the hash values) or
-    // the number of threads in the pool.
+    // Operations on different namespaces do not conflict, so multiApply should give each of them to
+    // a different writer thread when there are enough threads to go around.
     NamespaceString nss1("test.t0");
     NamespaceString nss2("test.t1");
     auto writerPool = OplogApplier::makeWriterPool(2);
@@ -518,6 +516,103 @@ TEST_F(SyncTailTest, MultiApplyAssignsOperationsToWriterThreadsBasedOnNamespaceH
     ASSERT_EQUALS(op2, lastEntry);
 }
 
+/**
+ * Applies 'ops' with a pool of 'numWriters' writer threads and returns the operations given to
+ * each writer thread that was scheduled, in the order in which each writer received them.
+ */
+std::vector<MultiApplier::Operations> _applyAndGetOpsByWriter(
+    OperationContext* opCtx,
+    ReplicationConsistencyMarkers* const consistencyMarkers,
+    StorageInterface* const storageInterface,
+    const MultiApplier::Operations& ops,
+    int numWriters) {
+    auto writerPool = OplogApplier::makeWriterPool(numWriters);
+
+    stdx::mutex mutex;
+    std::vector<MultiApplier::Operations> operationsApplied;
+    auto applyOperationFn =
+        [&mutex, &operationsApplied](OperationContext* opCtx,
+                                     MultiApplier::OperationPtrs* operationsForWriterThreadToApply,
+                                     SyncTail* st,
+                                     WorkerMultikeyPathInfo*) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsApplied.emplace_back();
+        for (auto&& opPtr : *operationsForWriterThreadToApply) {
+            operationsApplied.back().push_back(*opPtr);
+        }
+        return Status::OK();
+    };
+
+    SyncTail syncTail(
+        nullptr, consistencyMarkers, storageInterface, applyOperationFn, writerPool.get());
+    auto lastOpTime = unittest::assertGet(syncTail.multiApply(opCtx, ops));
+    ASSERT_EQUALS(ops.back().getOpTime(), lastOpTime);
+
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    std::sort(operationsApplied.begin(),
+              operationsApplied.end(),
+              [](const MultiApplier::Operations& lhs, const MultiApplier::Operations& rhs) {
+                  return lhs.size() > rhs.size();
+              });
+    return operationsApplied;
+}
+
+TEST_F(SyncTailTest, MultiApplyBalancesNonConflictingOperationsAcrossWriterThreads) {
+    // Operations on different namespaces do not conflict, so each writer thread should be given an
+    // equal share, regardless of how the namespaces hash.
+    MultiApplier::Operations ops;
+    for (int i = 0; i < 8; ++i) {
+        NamespaceString nss("test.t" + std::to_string(i % 4));
+        ops.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(i + 1), 0), 1LL}, nss, BSON("_id" << i)));
+    }
+
+    auto opsByWriter = _applyAndGetOpsByWriter(
+        _opCtx.get(), getConsistencyMarkers(), getStorageInterface(), ops, 4);
+    ASSERT_EQUALS(4U, opsByWriter.size());
+    for (auto&& writerOps : opsByWriter) {
+        ASSERT_EQUALS(2U, writerOps.size());
+        ASSERT_EQUALS(writerOps[0].getNamespace(), writerOps[1].getNamespace());
+        ASSERT_LESS_THAN(writerOps[0].getOpTime(), writerOps[1].getOpTime());
+    }
+}
+
+TEST_F(SyncTailTest, MultiApplyGivesLargestConflictingSetItsOwnWriterThread) {
+    // All operations on "test.hot" conflict, since the storage engine does not support document
+    // locking. They must be applied in order by one writer thread, and the remaining operations
+    // should be given to the other writer thread rather than queued behind them.
+    NamespaceString hotNss("test.hot");
+    MultiApplier::Operations ops;
+    for (int i = 0; i < 4; ++i) {
+        ops.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(2 * i + 1), 0), 1LL}, hotNss, BSON("_id" << i)));
+        if (i < 3) {
+            NamespaceString nss("test.cold" + std::to_string(i));
+            ops.push_back(makeInsertDocumentOplogEntry(
+                {Timestamp(Seconds(2 * i + 2), 0), 1LL}, nss, BSON("_id" << i)));
+        }
+    }
+
+    auto opsByWriter = _applyAndGetOpsByWriter(
+        _opCtx.get(), getConsistencyMarkers(), getStorageInterface(), ops, 2);
+    ASSERT_EQUALS(2U, opsByWriter.size());
+
+    const auto& hotOps = opsByWriter[0];
+    ASSERT_EQUALS(4U, hotOps.size());
+    for (size_t i = 0; i < hotOps.size(); ++i) {
+        ASSERT_EQUALS(hotNss, hotOps[i].getNamespace());
+        if (i > 0) {
+            ASSERT_LESS_THAN(hotOps[i - 1].getOpTime(), hotOps[i].getOpTime());
+        }
+    }
+
+    const auto& coldOps = opsByWriter[1];
+    ASSERT_EQUALS(3U, coldOps.size());
+    for (auto&& op : coldOps) {
+        ASSERT_NOT_EQUALS(hotNss, op.getNamespace());
+    }
+}
+
 TEST_F(SyncTailTest, MultiSyncApplyUsesSyncApplyToApplyOperation) {
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
     auto op = makeCreateCollectionOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss);
@@ -471,7 +471,29 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
         }
     }
 
-    return BalancerPolicy::balance(shardStats, distribution, aggressiveBalanceHint, usedShards);
+    const auto policy = Grid::get(opCtx)->getBalancerConfiguration()->getBalancingPolicy();
+
+    // The policies which take data size into account need the size of the collection on each
+    // shard, which only the shards that own chunks of it can have
+    ClusterStatistics::CollectionStatisticsMap collectionStats;
+    if (policy != BalancerSettingsType::kChunkCount) {
+        std::vector<ShardId> shardIds;
+        for (const auto& stat : shardStats) {
+            if (distribution.numberOfChunksInShard(stat.shardId)) {
+                shardIds.push_back(stat.shardId);
+            }
+        }
+
+        auto collectionStatsStatus = _clusterStats->getCollectionStats(opCtx, nss, shardIds);
+        if (!collectionStatsStatus.isOK()) {
+            return collectionStatsStatus.getStatus();
+        }
+
+        collectionStats = std::move(collectionStatsStatus.getValue());
+    }
+
+    return BalancerPolicy::balance(
+        shardStats, distribution, policy, collectionStats, aggressiveBalanceHint, usedShards);
 }
 
 }  // namespace mongo
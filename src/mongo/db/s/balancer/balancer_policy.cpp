@@ -52,6 +52,12 @@ namespace {
 const size_t kDefaultImbalanceThreshold = 2;
 const size_t kAggressiveImbalanceThreshold = 1;
 
+// These values indicate the minimum difference between the loads of two shards in a zone, as a
+// fraction of the zone's average load, for a rebalancing migration to be initiated when balancing
+// on data size.
+const double kDefaultLoadImbalanceThreshold = 0.2;
+const double kAggressiveLoadImbalanceThreshold = 0.1;
+
 }  // namespace
 
 DistributionStatus::DistributionStatus(NamespaceString nss, ShardToChunksMap shardToChunksMap)
@@ -290,6 +296,9 @@ ShardId BalancerPolicy::_getMostOverloadedShard(const ShardStatisticsVector& sha
 
 vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardStats,
                                             const DistributionStatus& distribution,
+                                            BalancerSettingsType::BalancingPolicy policy,
+                                            const ClusterStatistics::CollectionStatisticsMap&
+                                                collectionStats,
                                             bool shouldAggressivelyBalance,
                                             std::set<ShardId>* usedShards) {
     vector<MigrateInfo> migrations;
@@ -388,6 +397,32 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
     }
 
     // 3) for each tag balance
+    if (policy != BalancerSettingsType::kChunkCount) {
+        const double loadImbalanceThreshold = shouldAggressivelyBalance
+            ? kAggressiveLoadImbalanceThreshold
+            : kDefaultLoadImbalanceThreshold;
+
+        vector<string> tagsPlusEmpty(distribution.tags().begin(), distribution.tags().end());
+        tagsPlusEmpty.push_back("");
+
+        for (const auto& tag : tagsPlusEmpty) {
+            auto shardLoads =
+                _getShardLoadsForTag(shardStats, distribution, tag, collectionStats);
+
+            while (_singleZoneBalanceByLoad(shardStats,
+                                            distribution,
+                                            tag,
+                                            policy,
+                                            loadImbalanceThreshold,
+                                            &shardLoads,
+                                            &migrations,
+                                            usedShards))
+                ;
+        }
+
+        return migrations;
+    }
+
     const size_t imbalanceThreshold = (shouldAggressivelyBalance || distribution.totalChunks() < 20)
         ? kAggressiveImbalanceThreshold
         : kDefaultImbalanceThreshold;
@@ -524,6 +559,173 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     return false;
 }
 
+BalancerPolicy::ShardLoadMap BalancerPolicy::_getShardLoadsForTag(
+    const ShardStatisticsVector& shardStats,
+    const DistributionStatus& distribution,
+    const string& tag,
+    const ClusterStatistics::CollectionStatisticsMap& collectionStats) {
+    ShardLoadMap shardLoads;
+
+    for (const auto& stat : shardStats) {
+        if (!tag.empty() && !stat.shardTags.count(tag)) {
+            continue;
+        }
+
+        auto& load = shardLoads[stat.shardId];
+        load.numChunks = distribution.numberOfChunksInShardWithTag(stat.shardId, tag);
+
+        const auto statsIt = collectionStats.find(stat.shardId);
+        if (!load.numChunks || statsIt == collectionStats.end()) {
+            continue;
+        }
+
+        // The statistics cover all of the collection's chunks on the shard, so attribute to the
+        // zone the share of them which its chunks make up
+        const double zoneFraction = static_cast<double>(load.numChunks) /
+            distribution.numberOfChunksInShard(stat.shardId);
+        load.dataSizeBytes = statsIt->second.dataSizeBytes * zoneFraction;
+        load.opsPerSecond = statsIt->second.opsPerSecond * zoneFraction;
+    }
+
+    return shardLoads;
+}
+
+bool BalancerPolicy::_singleZoneBalanceByLoad(const ShardStatisticsVector& shardStats,
+                                              const DistributionStatus& distribution,
+                                              const string& tag,
+                                              BalancerSettingsType::BalancingPolicy policy,
+                                              double imbalanceThreshold,
+                                              ShardLoadMap* shardLoads,
+                                              vector<MigrateInfo>* migrations,
+                                              set<ShardId>* usedShards) {
+    if (shardLoads->empty())
+        return false;
+
+    double totalDataSizeBytes = 0;
+    double totalOpsPerSecond = 0;
+    for (const auto& shardLoad : *shardLoads) {
+        totalDataSizeBytes += shardLoad.second.dataSizeBytes;
+        totalOpsPerSecond += shardLoad.second.opsPerSecond;
+    }
+
+    const double avgDataSizeBytes = totalDataSizeBytes / shardLoads->size();
+    const double avgOpsPerSecond = totalOpsPerSecond / shardLoads->size();
+
+    // The load of a shard, or of a chunk, relative to the average shard in the zone. It is linear
+    // in the data size and operation rate, so moving a chunk changes the loads of its donor and
+    // receiver by the load of the chunk.
+    const auto loadOf = [&](const ShardLoad& load) {
+        const double sizeLoad = avgDataSizeBytes > 0 ? load.dataSizeBytes / avgDataSizeBytes : 0;
+        if (policy != BalancerSettingsType::kDataSizeAndOpRate) {
+            return sizeLoad;
+        }
+
+        const double opsLoad = avgOpsPerSecond > 0 ? load.opsPerSecond / avgOpsPerSecond : 0;
+        return (sizeLoad + opsLoad) / 2;
+    };
+
+    // The donor is the most loaded shard which has chunks in this zone and the receiver is the
+    // least loaded shard which may accept them
+    const ClusterStatistics::ShardStatistics* from = nullptr;
+    const ClusterStatistics::ShardStatistics* to = nullptr;
+    double fromLoad = 0;
+    double toLoad = 0;
+
+    for (const auto& stat : shardStats) {
+        const auto loadIt = shardLoads->find(stat.shardId);
+        if (loadIt == shardLoads->end() || usedShards->count(stat.shardId))
+            continue;
+
+        const double load = loadOf(loadIt->second);
+
+        if ((!from || load > fromLoad) && loadIt->second.numChunks) {
+            from = &stat;
+            fromLoad = load;
+        }
+
+        if ((!to || load < toLoad) && isShardSuitableReceiver(stat, tag).isOK()) {
+            to = &stat;
+            toLoad = load;
+        }
+    }
+
+    if (!from)
+        return false;
+
+    if (!to) {
+        if (migrations->empty()) {
+            log() << "No available shards to take chunks for zone [" << tag << "]";
+        }
+        return false;
+    }
+
+    if (from == to)
+        return false;
+
+    ShardLoad& fromShardLoad = shardLoads->at(from->shardId);
+    ShardLoad& toShardLoad = shardLoads->at(to->shardId);
+
+    // The config metadata does not record the size of individual chunks, so each chunk is assumed
+    // to hold an even share of the data and operations of the donor in this zone
+    ShardLoad chunkLoad;
+    chunkLoad.dataSizeBytes = fromShardLoad.dataSizeBytes / fromShardLoad.numChunks;
+    chunkLoad.opsPerSecond = fromShardLoad.opsPerSecond / fromShardLoad.numChunks;
+    chunkLoad.numChunks = 1;
+
+    LOG(1) << "collection : " << distribution.nss().ns();
+    LOG(1) << "zone       : " << tag;
+    LOG(1) << "donor      : " << from->shardId << " load " << fromLoad << " size "
+           << fromShardLoad.dataSizeBytes << " ops/s " << fromShardLoad.opsPerSecond;
+    LOG(1) << "receiver   : " << to->shardId << " load " << toLoad << " size "
+           << toShardLoad.dataSizeBytes << " ops/s " << toShardLoad.opsPerSecond;
+    LOG(1) << "chunk load : " << loadOf(chunkLoad);
+    LOG(1) << "threshold  : " << imbalanceThreshold;
+
+    // Check whether it is necessary to balance within this zone
+    if (fromLoad - toLoad < imbalanceThreshold)
+        return false;
+
+    // A migration must not leave the receiver more loaded than the donor, or chunks would move
+    // back and forth between them
+    if (loadOf(chunkLoad) > (fromLoad - toLoad) / 2)
+        return false;
+
+    const vector<ChunkType>& chunks = distribution.getChunks(from->shardId);
+
+    unsigned numJumboChunks = 0;
+
+    for (const auto& chunk : chunks) {
+        if (distribution.getTagForChunk(chunk) != tag)
+            continue;
+
+        if (chunk.getJumbo()) {
+            numJumboChunks++;
+            continue;
+        }
+
+        migrations->emplace_back(to->shardId, chunk);
+        invariant(usedShards->insert(chunk.getShard()).second);
+        invariant(usedShards->insert(to->shardId).second);
+
+        // Account for the migration, so that the loads reflect it when choosing the next one
+        fromShardLoad.dataSizeBytes -= chunkLoad.dataSizeBytes;
+        fromShardLoad.opsPerSecond -= chunkLoad.opsPerSecond;
+        fromShardLoad.numChunks--;
+        toShardLoad.dataSizeBytes += chunkLoad.dataSizeBytes;
+        toShardLoad.opsPerSecond += chunkLoad.opsPerSecond;
+        toShardLoad.numChunks++;
+        return true;
+    }
+
+    if (numJumboChunks) {
+        warning() << "Shard: " << from->shardId << ", collection: " << distribution.nss().ns()
+                  << " has only jumbo chunks for zone \'" << tag
+                  << "\' and cannot be balanced. Jumbo chunks count: " << numJumboChunks;
+    }
+
+    return false;
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <map>
 #include <set>
 #include <vector>
 
@@ -36,6 +37,7 @@
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/shard_id.h"
 
@@ -177,9 +179,15 @@ public:
      * entries in the vector do are all for separate source/destination shards and as such do not
      * need to be done serially and can be scheduled in parallel.
      *
-     * The balancing logic calculates the optimum number of chunks per shard for each zone and if
-     * any of the shards have chunks, which are sufficiently higher than this number, suggests
-     * moving chunks to shards, which are under this number.
+     * With the kChunkCount policy, the balancing logic calculates the optimum number of chunks
+     * per shard for each zone and if any of the shards have chunks, which are sufficiently higher
+     * than this number, suggests moving chunks to shards, which are under this number.
+     *
+     * With the other policies, the balancing logic compares the load of the collection on the
+     * shards in each zone, as given by its data size and optionally its operation rate on each
+     * shard in 'collectionStats' relative to the average for the zone, and suggests moving chunks
+     * from the most loaded shards to the least loaded ones while the difference between them is
+     * sufficiently large and a migration cannot reverse it.
      *
      * The shouldAggressivelyBalance parameter causes the threshold for chunk could disparity
      * between shards to be lowered.
@@ -190,6 +198,9 @@ public:
      */
     static std::vector<MigrateInfo> balance(const ShardStatisticsVector& shardStats,
                                             const DistributionStatus& distribution,
+                                            BalancerSettingsType::BalancingPolicy policy,
+                                            const ClusterStatistics::CollectionStatisticsMap&
+                                                collectionStats,
                                             bool shouldAggressivelyBalance,
                                             std::set<ShardId>* usedShards);
 
@@ -229,8 +240,8 @@ private:
      * each shard must have and is used to determine the imbalance and also to prevent chunks from
      * moving when not necessary.
      *
-     * Returns true if a migration was suggested, false otherwise. This method is intented to be
-     * called multiple times until all posible migrations for a zone have been selected.
+     * Returns true if a migration was suggested, false otherwise. This method is intended to be
+     * called multiple times until all possible migrations for a zone have been selected.
      */
     static bool _singleZoneBalance(const ShardStatisticsVector& shardStats,
                                    const DistributionStatus& distribution,
@@ -239,6 +250,50 @@ private:
                                    size_t imbalanceThreshold,
                                    std::vector<MigrateInfo>* migrations,
                                    std::set<ShardId>* usedShards);
+
+    /**
+     * The data and operations of a collection which a shard holds in one zone, as used by the
+     * balancing policies which take data size into account.
+     */
+    struct ShardLoad {
+        double dataSizeBytes{0};
+        double opsPerSecond{0};
+        size_t numChunks{0};
+    };
+
+    using ShardLoadMap = std::map<ShardId, ShardLoad>;
+
+    /**
+     * Returns the load of the collection on each shard in the specified zone, or on all shards if
+     * the tag is empty. The collection's statistics on a shard are divided between the zones in
+     * proportion to the number of chunks the shard holds in each of them.
+     */
+    static ShardLoadMap _getShardLoadsForTag(
+        const ShardStatisticsVector& shardStats,
+        const DistributionStatus& distribution,
+        const std::string& tag,
+        const ClusterStatistics::CollectionStatisticsMap& collectionStats);
+
+    /**
+     * Selects one chunk for the specified zone to be moved from the most loaded to the least
+     * loaded of its shards according to 'shardLoads', if their loads relative to the average
+     * shard of the zone differ by at least 'imbalanceThreshold', and moving the chunk would not
+     * leave the receiver more loaded than the donor. A shard's load is its data size and, for the
+     * kDataSizeAndOpRate policy, its operation rate. Takes into account and updates the shards,
+     * which have already been used for migrations, and updates 'shardLoads' to reflect the
+     * suggested migration.
+     *
+     * Returns true if a migration was suggested, false otherwise. This method is intended to be
+     * called multiple times until all possible migrations for a zone have been selected.
+     */
+    static bool _singleZoneBalanceByLoad(const ShardStatisticsVector& shardStats,
+                                         const DistributionStatus& distribution,
+                                         const std::string& tag,
+                                         BalancerSettingsType::BalancingPolicy policy,
+                                         double imbalanceThreshold,
+                                         ShardLoadMap* shardLoads,
+                                         std::vector<MigrateInfo>* migrations,
+                                         std::set<ShardId>* usedShards);
 };
 
 }  // namespace mongo
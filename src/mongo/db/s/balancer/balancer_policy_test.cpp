@@ -114,8 +114,33 @@ std::vector<MigrateInfo> balanceChunks(const ShardStatisticsVector& shardStats,
                                        const DistributionStatus& distribution,
                                        bool shouldAggressivelyBalance) {
     std::set<ShardId> usedShards;
+    return BalancerPolicy::balance(shardStats,
+                                   distribution,
+                                   BalancerSettingsType::kChunkCount,
+                                   {},
+                                   shouldAggressivelyBalance,
+                                   &usedShards);
+}
+
+std::vector<MigrateInfo> balanceChunksByLoad(
+    const ShardStatisticsVector& shardStats,
+    const DistributionStatus& distribution,
+    BalancerSettingsType::BalancingPolicy policy,
+    const ClusterStatistics::CollectionStatisticsMap& collectionStats) {
+    std::set<ShardId> usedShards;
     return BalancerPolicy::balance(
-        shardStats, distribution, shouldAggressivelyBalance, &usedShards);
+        shardStats, distribution, policy, collectionStats, false, &usedShards);
+}
+
+/**
+ * Returns the statistics of a collection on a shard, given its data size in MB.
+ */
+ClusterStatistics::CollectionStatistics collectionStatsMB(uint64_t dataSizeMB,
+                                                          uint64_t opsPerSecond = 0) {
+    ClusterStatistics::CollectionStatistics stats;
+    stats.dataSizeBytes = dataSizeMB * 1024 * 1024;
+    stats.opsPerSecond = opsPerSecond;
+    return stats;
 }
 
 TEST(BalancerPolicy, Basic) {
@@ -244,8 +269,12 @@ TEST(BalancerPolicy, ParallelBalancingNotSchedulingOnInUseSourceShardsWithMoveNe
 
     // Here kShardId0 would have been selected as a donor
     std::set<ShardId> usedShards{kShardId0};
-    const auto migrations(BalancerPolicy::balance(
-        cluster.first, DistributionStatus(kNamespace, cluster.second), false, &usedShards));
+    const auto migrations(BalancerPolicy::balance(cluster.first,
+                                                  DistributionStatus(kNamespace, cluster.second),
+                                                  BalancerSettingsType::kChunkCount,
+                                                  {},
+                                                  false,
+                                                  &usedShards));
     ASSERT_EQ(1U, migrations.size());
 
     ASSERT_EQ(kShardId1, migrations[0].from);
@@ -263,8 +292,12 @@ TEST(BalancerPolicy, ParallelBalancingNotSchedulingOnInUseSourceShardsWithMoveNo
 
     // Here kShardId0 would have been selected as a donor
     std::set<ShardId> usedShards{kShardId0};
-    const auto migrations(BalancerPolicy::balance(
-        cluster.first, DistributionStatus(kNamespace, cluster.second), false, &usedShards));
+    const auto migrations(BalancerPolicy::balance(cluster.first,
+                                                  DistributionStatus(kNamespace, cluster.second),
+                                                  BalancerSettingsType::kChunkCount,
+                                                  {},
+                                                  false,
+                                                  &usedShards));
     ASSERT_EQ(0U, migrations.size());
 }
 
@@ -277,8 +310,12 @@ TEST(BalancerPolicy, ParallelBalancingNotSchedulingOnInUseDestinationShards) {
 
     // Here kShardId2 would have been selected as a recipient
     std::set<ShardId> usedShards{kShardId2};
-    const auto migrations(BalancerPolicy::balance(
-        cluster.first, DistributionStatus(kNamespace, cluster.second), false, &usedShards));
+    const auto migrations(BalancerPolicy::balance(cluster.first,
+                                                  DistributionStatus(kNamespace, cluster.second),
+                                                  BalancerSettingsType::kChunkCount,
+                                                  {},
+                                                  false,
+                                                  &usedShards));
     ASSERT_EQ(1U, migrations.size());
 
     ASSERT_EQ(kShardId0, migrations[0].from);
@@ -609,6 +646,138 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithTag) {
     ASSERT(balanceChunks(cluster.first, distribution, false).empty());
 }
 
+TEST(BalancerPolicy, DataSizeBalancingMovesChunkOffLargestShard) {
+    // The chunk counts are even, but shard0 holds three times as much of the collection as the
+    // other shards
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId2, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 4}});
+
+    const DistributionStatus distribution(kNamespace, cluster.second);
+    ASSERT(balanceChunks(cluster.first, distribution, false).empty());
+
+    const auto migrations(balanceChunksByLoad(cluster.first,
+                                              distribution,
+                                              BalancerSettingsType::kDataSize,
+                                              {{kShardId0, collectionStatsMB(3000)},
+                                               {kShardId1, collectionStatsMB(1000)},
+                                               {kShardId2, collectionStatsMB(900)}}));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId2, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][0].getMin(), migrations[0].minKey);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][0].getMax(), migrations[0].maxKey);
+}
+
+TEST(BalancerPolicy, DataSizeBalancingIgnoresDataOutsideTheCollection) {
+    // The shards' total sizes differ greatly, but the collection is evenly spread across them
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 50000, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 1000, false, emptyTagSet, emptyShardVersion), 4}});
+
+    ASSERT(balanceChunksByLoad(cluster.first,
+                               DistributionStatus(kNamespace, cluster.second),
+                               BalancerSettingsType::kDataSize,
+                               {{kShardId0, collectionStatsMB(1000)},
+                                {kShardId1, collectionStatsMB(1000)}})
+               .empty());
+}
+
+TEST(BalancerPolicy, DataSizeBalancingIgnoresSmallDifferences) {
+    // The relative difference is below the threshold
+    {
+        auto cluster = generateCluster(
+            {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 4},
+             {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+              4}});
+
+        ASSERT(balanceChunksByLoad(cluster.first,
+                                   DistributionStatus(kNamespace, cluster.second),
+                                   BalancerSettingsType::kDataSize,
+                                   {{kShardId0, collectionStatsMB(1000)},
+                                    {kShardId1, collectionStatsMB(900)}})
+                   .empty());
+    }
+
+    // Moving one of the donor's chunks would make the receiver the larger shard
+    {
+        auto cluster = generateCluster(
+            {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 2},
+             {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+              4}});
+
+        ASSERT(balanceChunksByLoad(cluster.first,
+                                   DistributionStatus(kNamespace, cluster.second),
+                                   BalancerSettingsType::kDataSize,
+                                   {{kShardId0, collectionStatsMB(1000)},
+                                    {kShardId1, collectionStatsMB(700)}})
+                   .empty());
+    }
+}
+
+TEST(BalancerPolicy, DataSizeBalancingSchedulesParallelMigrations) {
+    // Each shard takes part in at most one migration per round, so once shard0 has been chosen to
+    // donate to shard3, shard1 is the most loaded shard left and donates to shard2
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 10},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 10},
+         {ShardStatistics(kShardId2, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 10},
+         {ShardStatistics(kShardId3, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 10}});
+
+    const auto migrations(balanceChunksByLoad(cluster.first,
+                                              DistributionStatus(kNamespace, cluster.second),
+                                              BalancerSettingsType::kDataSize,
+                                              {{kShardId0, collectionStatsMB(5000)},
+                                               {kShardId1, collectionStatsMB(2000)},
+                                               {kShardId2, collectionStatsMB(500)},
+                                               {kShardId3, collectionStatsMB(400)}}));
+    ASSERT_EQ(2U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId3, migrations[0].to);
+    ASSERT_EQ(kShardId1, migrations[1].from);
+    ASSERT_EQ(kShardId2, migrations[1].to);
+}
+
+TEST(BalancerPolicy, DataSizeAndOpRateBalancingMovesChunkOffBusiestShard) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 4}});
+
+    const ClusterStatistics::CollectionStatisticsMap collectionStats{
+        {kShardId0, collectionStatsMB(1000, 900)}, {kShardId1, collectionStatsMB(1000, 100)}};
+
+    const DistributionStatus distribution(kNamespace, cluster.second);
+    ASSERT(balanceChunksByLoad(
+               cluster.first, distribution, BalancerSettingsType::kDataSize, collectionStats)
+               .empty());
+
+    const auto migrations(balanceChunksByLoad(
+        cluster.first, distribution, BalancerSettingsType::kDataSizeAndOpRate, collectionStats));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+}
+
+TEST(BalancerPolicy, DataSizeBalancingRespectsTags) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, {"a"}, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, {"a"}, emptyShardVersion), 4},
+         {ShardStatistics(kShardId2, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0}});
+
+    DistributionStatus distribution(kNamespace, cluster.second);
+    ASSERT_OK(distribution.addRangeToZone(ZoneRange(kMinBSONKey, kMaxBSONKey, "a")));
+
+    const auto migrations(balanceChunksByLoad(cluster.first,
+                                              distribution,
+                                              BalancerSettingsType::kDataSize,
+                                              {{kShardId0, collectionStatsMB(3000)},
+                                               {kShardId1, collectionStatsMB(1000)}}));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+}
+
 TEST(DistributionStatus, AddTagRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -39,6 +40,7 @@
 namespace mongo {
 
 class BSONObj;
+class NamespaceString;
 class OperationContext;
 template <typename T>
 class StatusWith;
@@ -94,6 +96,20 @@ public:
         std::string mongoVersion;
     };
 
+    /**
+     * Structure, which describes the statistics of a single sharded collection on one shard.
+     */
+    struct CollectionStatistics {
+        // The size of the collection's documents on the shard, including any orphaned documents
+        uint64_t dataSizeBytes{0};
+
+        // The rate of operations on the collection served by the shard's primary since the
+        // previous statistics snapshot. Zero if there was no previous snapshot.
+        uint64_t opsPerSecond{0};
+    };
+
+    using CollectionStatisticsMap = std::map<ShardId, CollectionStatistics>;
+
     virtual ~ClusterStatistics();
 
     /**
@@ -102,6 +118,15 @@ public:
      */
     virtual StatusWith<std::vector<ShardStatistics>> getStats(OperationContext* opCtx) = 0;
 
+    /**
+     * Retrieves the statistics of the specified collection on each of the shards in 'shardIds'.
+     * Used by the balancing policies, which take data size into account.
+     */
+    virtual StatusWith<CollectionStatisticsMap> getCollectionStats(
+        OperationContext* opCtx,
+        const NamespaceString& nss,
+        const std::vector<ShardId>& shardIds) = 0;
+
 protected:
     ClusterStatistics();
 };
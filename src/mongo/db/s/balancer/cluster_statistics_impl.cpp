@@ -48,6 +48,8 @@ namespace mongo {
 namespace {
 
 const char kVersionField[] = "version";
+const char kStorageStatsField[] = "storageStats";
+const char kLatencyStatsField[] = "latencyStats";
 
 /**
  * Executes the serverStatus command against the specified shard and obtains the version of the
@@ -89,6 +91,54 @@ StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, Shar
     return version;
 }
 
+/**
+ * Runs a $collStats aggregation against the primary of the specified shard and returns the single
+ * document it produces for the collection, with the 'storageStats' and 'latencyStats' sections.
+ *
+ * Known error codes are:
+ *  ShardNotFound if shard by that id is not available on the registry
+ *  NoSuchKey if the aggregation did not return the statistics
+ */
+StatusWith<BSONObj> retrieveShardCollectionStats(OperationContext* opCtx,
+                                                 const ShardId& shardId,
+                                                 const NamespaceString& nss) {
+    auto shardStatus = Grid::get(opCtx)->shardRegistry()->getShard(opCtx, shardId);
+    if (!shardStatus.isOK()) {
+        return shardStatus.getStatus();
+    }
+
+    BSONObjBuilder cmdBuilder;
+    cmdBuilder.append("aggregate", nss.coll());
+    cmdBuilder.append("pipeline",
+                      BSON_ARRAY(BSON("$collStats" << BSON(kStorageStatsField
+                                                           << BSONObj()
+                                                           << kLatencyStatsField
+                                                           << BSONObj()))));
+    cmdBuilder.append("cursor", BSONObj());
+
+    auto commandResponse = shardStatus.getValue()->runCommandWithFixedRetryAttempts(
+        opCtx,
+        ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+        nss.db().toString(),
+        cmdBuilder.obj(),
+        Shard::RetryPolicy::kIdempotent);
+    if (!commandResponse.isOK()) {
+        return commandResponse.getStatus();
+    }
+    if (!commandResponse.getValue().commandStatus.isOK()) {
+        return commandResponse.getValue().commandStatus;
+    }
+
+    const BSONObj& response = commandResponse.getValue().response;
+    const auto firstBatch = response["cursor"]["firstBatch"];
+    if (firstBatch.type() != Array || firstBatch.Obj().isEmpty()) {
+        return {ErrorCodes::NoSuchKey,
+                str::stream() << "$collStats returned no statistics for " << nss.ns()};
+    }
+
+    return firstBatch.Obj().firstElement().Obj().getOwned();
+}
+
 }  // namespace
 
 using ShardStatistics = ClusterStatistics::ShardStatistics;
@@ -97,6 +147,30 @@ ClusterStatisticsImpl::ClusterStatisticsImpl(BalancerRandomSource& random) : _ra
 
 ClusterStatisticsImpl::~ClusterStatisticsImpl() = default;
 
+uint64_t ClusterStatisticsImpl::_updateOpRate(const NamespaceString& nss,
+                                              const ShardId& shardId,
+                                              long long opCount,
+                                              Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _lastOpCounts.find(std::make_pair(nss, shardId));
+    if (it == _lastOpCounts.end()) {
+        _lastOpCounts.emplace(std::make_pair(nss, shardId), std::make_pair(opCount, now));
+        return 0;
+    }
+
+    const long long lastOpCount = it->second.first;
+    const Milliseconds elapsed = now - it->second.second;
+    it->second = std::make_pair(opCount, now);
+
+    // The counters restart from zero when the shard's primary restarts or changes
+    if (opCount < lastOpCount || elapsed < Seconds(1)) {
+        return 0;
+    }
+
+    return (opCount - lastOpCount) * 1000 / durationCount<Milliseconds>(elapsed);
+}
+
 StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationContext* opCtx) {
     // Get a list of all the shards that are participating in this balance round along with any
     // maximum allowed quotas and current utilization. We get the latter by issuing
@@ -161,4 +235,34 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
     return stats;
 }
 
+StatusWith<ClusterStatistics::CollectionStatisticsMap> ClusterStatisticsImpl::getCollectionStats(
+    OperationContext* opCtx, const NamespaceString& nss, const std::vector<ShardId>& shardIds) {
+    CollectionStatisticsMap stats;
+
+    for (const auto& shardId : shardIds) {
+        auto collStatsStatus = retrieveShardCollectionStats(opCtx, shardId, nss);
+        if (!collStatsStatus.isOK()) {
+            return collStatsStatus.getStatus().withContext(
+                str::stream() << "Unable to obtain statistics of collection " << nss.ns()
+                              << " from "
+                              << shardId);
+        }
+
+        const auto& collStats = collStatsStatus.getValue();
+
+        // Operations are counted per collection since the shard's primary started
+        long long opCount = 0;
+        for (const auto& section : {"reads", "writes", "commands"}) {
+            opCount += collStats[kLatencyStatsField][section]["ops"].safeNumberLong();
+        }
+
+        auto& collectionStats = stats[shardId];
+        collectionStats.dataSizeBytes =
+            std::max(collStats[kStorageStatsField]["size"].safeNumberLong(), 0LL);
+        collectionStats.opsPerSecond = _updateOpRate(nss, shardId, opCount, Date_t::now());
+    }
+
+    return stats;
+}
+
 }  // namespace mongo
@@ -28,8 +28,14 @@
 
 #pragma once
 
+#include <map>
+#include <utility>
+
+#include "mongo/db/namespace_string.h"
 #include "mongo/db/s/balancer/balancer_random.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -45,9 +51,31 @@ public:
 
     StatusWith<std::vector<ShardStatistics>> getStats(OperationContext* opCtx) override;
 
+    StatusWith<CollectionStatisticsMap> getCollectionStats(
+        OperationContext* opCtx,
+        const NamespaceString& nss,
+        const std::vector<ShardId>& shardIds) override;
+
 private:
+    /**
+     * Records that the primary of 'shardId' had served 'opCount' operations on 'nss' in total at
+     * 'now' and returns the rate at which it served them since the previous call for the same
+     * collection and shard.
+     */
+    uint64_t _updateOpRate(const NamespaceString& nss,
+                           const ShardId& shardId,
+                           long long opCount,
+                           Date_t now);
+
     // Source of randomness when metadata needs to be randomized.
     BalancerRandomSource& _random;
+
+    // Protects '_lastOpCounts'
+    stdx::mutex _mutex;
+
+    // The total number of operations each shard had served on each collection at the last
+    // statistics snapshot, used to calculate the rate of operations
+    std::map<std::pair<NamespaceString, ShardId>, std::pair<long long, Date_t>> _lastOpCounts;
 };
 
 }  // namespace mongo
@@ -43,6 +43,7 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/s/start_chunk_clone_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
@@ -58,6 +59,15 @@
 #include "mongo/util/time_support.h"
 
 namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneClaimBatchSize, int, 128)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue, "migrateCloneClaimBatchSize must be at least 1");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 const char kRecvChunkStatus[] = "_recvChunkStatus";
@@ -471,39 +481,90 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
                            internalQueryExecYieldIterations.load(),
                            Milliseconds(internalQueryExecYieldPeriodMS.load()));
 
-    stdx::lock_guard<stdx::mutex> sl(_mutex);
+    // Record ids are claimed from '_cloneLocs' in small runs and their documents are fetched
+    // without holding '_mutex', so that concurrent _migrateClone requests from the recipient read
+    // disjoint parts of the chunk in parallel. Since '_cloneLocs' is ordered, each run is still
+    // read in disk order.
+    const std::size_t claimSize = std::max(1, migrateCloneClaimBatchSize.load());
+    std::vector<RecordId> claimedLocs;
+    bool batchFull = false;
+
+    while (!batchFull) {
+        claimedLocs.clear();
+
+        {
+            stdx::lock_guard<stdx::mutex> sl(_mutex);
 
-    std::set<RecordId>::iterator it;
+            auto it = _cloneLocs.begin();
+            for (; it != _cloneLocs.end() && claimedLocs.size() < claimSize; ++it) {
+                claimedLocs.push_back(*it);
+            }
+
+            _cloneLocs.erase(_cloneLocs.begin(), it);
+            if (!claimedLocs.empty()) {
+                ++_numOutstandingClaims;
+            }
+        }
 
-    for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
-        // We must always make progress in this method by at least one document because empty return
-        // indicates there is no more initial clone data.
-        if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
+        if (claimedLocs.empty()) {
             break;
         }
 
-        Snapshotted<BSONObj> doc;
-        if (collection->findDoc(opCtx, *it, &doc)) {
-            // Use the builder size instead of accumulating the document sizes directly so that we
-            // take into consideration the overhead of BSONArray indices.
-            if (arrBuilder->arrSize() &&
-                (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
+        // If reading the run fails, none of it is returned, so give all of it back.
+        auto releaseClaimGuard = MakeGuard([&] {
+            stdx::lock_guard<stdx::mutex> sl(_mutex);
+            _cloneLocs.insert(claimedLocs.begin(), claimedLocs.end());
+            --_numOutstandingClaims;
+        });
+
+        auto it = claimedLocs.begin();
+        for (; it != claimedLocs.end(); ++it) {
+            // We must always make progress in this method by at least one document because empty
+            // return indicates there is no more initial clone data.
+            if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
+                batchFull = true;
                 break;
             }
 
-            arrBuilder->append(doc.value());
+            Snapshotted<BSONObj> doc;
+            if (collection->findDoc(opCtx, *it, &doc)) {
+                // Use the builder size instead of accumulating the document sizes directly so that
+                // we take into consideration the overhead of BSONArray indices.
+                if (arrBuilder->arrSize() &&
+                    (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
+                    batchFull = true;
+                    break;
+                }
+
+                arrBuilder->append(doc.value());
+            }
         }
-    }
 
-    _cloneLocs.erase(_cloneLocs.begin(), it);
+        releaseClaimGuard.Dismiss();
+
+        // Give back the record ids which did not make it into this batch, so that the next request
+        // picks them up
+        stdx::lock_guard<stdx::mutex> sl(_mutex);
+        _cloneLocs.insert(it, claimedLocs.end());
+        --_numOutstandingClaims;
+    }
 
     // If we have drained all the cloned data, there is no need to keep the delete notify executor
-    // around
-    if (_cloneLocs.empty() && _deleteNotifyExec) {
+    // around. Record ids claimed by concurrent requests may still be given back, and deletions of
+    // those must be noticed until then.
+    std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> deleteNotifyExec;
+    {
+        stdx::lock_guard<stdx::mutex> sl(_mutex);
+        if (_cloneLocs.empty() && _numOutstandingClaims == 0) {
+            deleteNotifyExec = std::move(_deleteNotifyExec);
+        }
+    }
+
+    if (deleteNotifyExec) {
         // We have a different OperationContext than when we created the PlanExecutor, so need to
         // manually destroy it ourselves.
-        _deleteNotifyExec->dispose(opCtx, collection->getCursorManager());
-        _deleteNotifyExec.reset();
+        deleteNotifyExec->dispose(opCtx, collection->getCursorManager());
+        deleteNotifyExec.reset();
     }
 
     return Status::OK();
@@ -39,6 +39,7 @@
 #include "mongo/db/s/migration_chunk_cloner_source.h"
 #include "mongo/db/s/migration_session_id.h"
 #include "mongo/db/s/session_catalog_migration_source.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/request_types/move_chunk_request.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/stdx/memory.h"
@@ -53,6 +54,10 @@ class Collection;
 class Database;
 class RecordId;
 
+// The number of record ids a _migrateClone request claims from the initial clone at a time. Reading
+// the documents of a claimed run does not block concurrent requests of the same migration.
+extern AtomicInt32 migrateCloneClaimBatchSize;
+
 class MigrationChunkClonerSourceLegacy final : public MigrationChunkClonerSource {
     MONGO_DISALLOW_COPYING(MigrationChunkClonerSourceLegacy);
 
@@ -116,6 +121,9 @@ public:
      * give a chance to the caller to perform some form of yielding. It does not free or acquire any
      * locks on its own.
      *
+     * May be called concurrently by several clone streams of the same migration, in which case
+     * each call returns a disjoint set of documents.
+     *
      * NOTE: Must be called with the collection lock held in at least IS mode.
      */
     Status nextCloneBatch(OperationContext* opCtx,
@@ -198,7 +206,8 @@ private:
     const HostAndPort _recipientHost;
 
     // Registered deletion notifications plan executor, which will listen for document deletions
-    // during the cloning stage
+    // during the cloning stage. Released under '_mutex' once the initial clone has been drained and
+    // no record ids are claimed.
     std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> _deleteNotifyExec;
 
     std::unique_ptr<SessionCatalogMigrationSource> _sessionCatalogSource;
@@ -212,6 +221,10 @@ private:
     // List of record ids that needs to be transferred (initial clone)
     std::set<RecordId> _cloneLocs;
 
+    // The number of runs of record ids which _migrateClone requests have taken out of '_cloneLocs'
+    // and are still reading (initial clone)
+    std::size_t _numOutstandingClaims{0};
+
     // The estimated average object size during the clone phase. Used for buffer size
     // pre-allocation (initial clone).
     uint64_t _averageObjectSizeForCloneLocs{0};
@@ -28,6 +28,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
 #include "mongo/client/remote_command_targeter_mock.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/dbdirectclient.h"
@@ -37,8 +39,11 @@
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/shard_server_test_fixture.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -295,6 +300,89 @@ TEST_F(MigrationChunkClonerSourceLegacyTest, CorrectDocumentsFetched) {
     futureCommit.timed_get(kFutureTimeout);
 }
 
+TEST_F(MigrationChunkClonerSourceLegacyTest, ConcurrentCloneBatchesAreDisjoint) {
+    const int kNumDocs = 200;
+    const int kNumStreams = 4;
+
+    std::vector<BSONObj> contents;
+    for (int i = 0; i < kNumDocs; i++) {
+        contents.push_back(createCollectionDocument(i));
+    }
+
+    createShardedCollection(contents);
+
+    // Claim only a few record ids at a time, so that the streams interleave
+    const auto savedClaimBatchSize = migrateCloneClaimBatchSize.load();
+    migrateCloneClaimBatchSize.store(3);
+    ON_BLOCK_EXIT([&] { migrateCloneClaimBatchSize.store(savedClaimBatchSize); });
+
+    MigrationChunkClonerSourceLegacy cloner(
+        createMoveChunkRequest(ChunkRange(BSON("X" << 0), BSON("X" << kNumDocs))),
+        kShardKeyPattern,
+        kDonorConnStr,
+        kRecipientConnStr.getServers()[0]);
+
+    {
+        auto futureStartClone = launchAsync([&]() {
+            onCommand([&](const RemoteCommandRequest& request) { return BSON("ok" << true); });
+        });
+
+        ASSERT_OK(cloner.startClone(operationContext()));
+        futureStartClone.timed_get(kFutureTimeout);
+    }
+
+    // Each stream fetches batches until the initial clone is exhausted, like a recipient with
+    // several concurrent _migrateClone requests would
+    std::vector<std::vector<int>> streamValues(kNumStreams);
+    std::vector<Status> streamStatuses(kNumStreams, Status::OK());
+    std::vector<stdx::thread> streams;
+    for (int i = 0; i < kNumStreams; i++) {
+        streams.emplace_back([&, i] {
+            Client::initThread(str::stream() << "cloneStream-" << i);
+            auto opCtx = Client::getCurrent()->makeOperationContext();
+
+            while (true) {
+                AutoGetCollection autoColl(opCtx.get(), kNss, MODE_IS);
+
+                BSONArrayBuilder arrBuilder;
+                streamStatuses[i] =
+                    cloner.nextCloneBatch(opCtx.get(), autoColl.getCollection(), &arrBuilder);
+                if (!streamStatuses[i].isOK() || !arrBuilder.arrSize()) {
+                    return;
+                }
+
+                for (const auto& elem : arrBuilder.arr()) {
+                    streamValues[i].push_back(elem.Obj()["X"].numberInt());
+                }
+            }
+        });
+    }
+
+    for (auto& stream : streams) {
+        stream.join();
+    }
+
+    std::vector<int> allValues;
+    for (int i = 0; i < kNumStreams; i++) {
+        ASSERT_OK(streamStatuses[i]);
+        allValues.insert(allValues.end(), streamValues[i].begin(), streamValues[i].end());
+    }
+
+    // Every document is returned by exactly one of the streams
+    std::sort(allValues.begin(), allValues.end());
+    ASSERT_EQ(static_cast<size_t>(kNumDocs), allValues.size());
+    for (int i = 0; i < kNumDocs; i++) {
+        ASSERT_EQ(i, allValues[i]);
+    }
+
+    auto futureCancel = launchAsync([&]() {
+        onCommand([&](const RemoteCommandRequest& request) { return BSON("ok" << true); });
+    });
+
+    cloner.cancelClone(operationContext());
+    futureCancel.timed_get(kFutureTimeout);
+}
+
 TEST_F(MigrationChunkClonerSourceLegacyTest, CollectionNotFound) {
     MigrationChunkClonerSourceLegacy cloner(
         createMoveChunkRequest(ChunkRange(BSON("X" << 100), BSON("X" << 200))),
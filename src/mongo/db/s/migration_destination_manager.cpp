@@ -51,6 +51,7 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/migration_util.h"
 #include "mongo/db/s/move_timing_helper.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard_registry.h"
@@ -69,6 +70,26 @@ namespace {
 const auto getMigrationDestinationManager =
     ServiceContext::declareDecoration<MigrationDestinationManager>();
 
+// Number of _migrateClone requests the recipient keeps in flight against the donor during the
+// initial clone of a chunk. Each stream uses its own connection to the donor.
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneStreams, int, 2)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 16) {
+            return Status(ErrorCodes::BadValue, "migrateCloneStreams must be between 1 and 16");
+        }
+        return Status::OK();
+    });
+
+// Number of threads which insert the cloned documents on the recipient.
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneInserterThreads, int, 2)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 16) {
+            return Status(ErrorCodes::BadValue,
+                          "migrateCloneInserterThreads must be between 1 and 16");
+        }
+        return Status::OK();
+    });
+
 const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 // Note: Even though we're setting UNSET here,
                                                 // kMajority implies JOURNAL if journaling is
@@ -374,47 +395,121 @@ void MigrationDestinationManager::cloneDocumentsFromDonor(
     OperationContext* opCtx,
     stdx::function<void(OperationContext*, BSONObjIterator)> insertBatchFn,
     stdx::function<BSONObj(OperationContext*)> fetchBatchFn) {
+    cloneDocumentsFromDonor(opCtx, std::move(insertBatchFn), {std::move(fetchBatchFn)}, 1);
+}
 
-    ProducerConsumerQueue<BSONObj> batches(1);
-    stdx::thread inserterThread{[&] {
-        Client::initThreadIfNotAlready("chunkInserter");
-        auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
-        auto consumerGuard = MakeGuard([&] { batches.closeConsumerEnd(); });
-        try {
-            while (true) {
-                auto nextBatch = batches.pop(inserterOpCtx.get());
-                auto arr = nextBatch["objects"].Obj();
-                if (arr.isEmpty()) {
-                    return;
-                }
-                insertBatchFn(inserterOpCtx.get(), BSONObjIterator(arr));
-            }
-        } catch (...) {
+void MigrationDestinationManager::cloneDocumentsFromDonor(
+    OperationContext* opCtx,
+    stdx::function<void(OperationContext*, BSONObjIterator)> insertBatchFn,
+    std::vector<stdx::function<BSONObj(OperationContext*)>> fetchBatchFns,
+    size_t numInserterThreads) {
+    invariant(!fetchBatchFns.empty());
+    invariant(numInserterThreads > 0);
+
+    // Each stream may have one batch waiting to be inserted while it fetches the next one from the
+    // donor.
+    ProducerConsumerQueue<BSONObj> batches(fetchBatchFns.size());
+
+    // The queue allows only a single producer at a time, so the streams take turns to push.
+    stdx::mutex pushMutex;
+
+    // Interrupts the migration thread with the error which caused a helper thread to fail and
+    // closes the queue, so that all the other threads stop as well.
+    auto abortClone = [&](StringData what) {
+        const auto status = exceptionToStatus();
+        {
             stdx::lock_guard<Client> lk(*opCtx->getClient());
-            opCtx->getServiceContext()->killOperation(opCtx, exceptionToStatus().code());
-            log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
+            opCtx->getServiceContext()->killOperation(opCtx, status.code());
+        }
+        log() << what << causedBy(redact(status));
+        batches.closeConsumerEnd();
+    };
+
+    auto fetchBatches = [&](OperationContext* fetchOpCtx,
+                            const stdx::function<BSONObj(OperationContext*)>& fetchBatchFn) {
+        while (true) {
+            fetchOpCtx->checkForInterrupt();
+
+            auto res = fetchBatchFn(fetchOpCtx);
+
+            fetchOpCtx->checkForInterrupt();
+            if (res["objects"].Obj().isEmpty()) {
+                return;
+            }
+
+            try {
+                stdx::lock_guard<stdx::mutex> lk(pushMutex);
+                batches.push(res.getOwned(), fetchOpCtx);
+            } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+                // Prefer the error which caused the queue to be closed, if it was delivered to
+                // this operation
+                fetchOpCtx->checkForInterrupt();
+                throw;
+            }
         }
-    }};
-    auto inserterThreadJoinGuard = MakeGuard([&] {
+    };
+
+    std::vector<stdx::thread> inserterThreads;
+    std::vector<stdx::thread> fetcherThreads;
+    auto threadsJoinGuard = MakeGuard([&] {
         batches.closeProducerEnd();
-        inserterThread.join();
+        batches.closeConsumerEnd();
+        for (auto& thread : fetcherThreads) {
+            thread.join();
+        }
+        for (auto& thread : inserterThreads) {
+            thread.join();
+        }
     });
 
-    while (true) {
-        opCtx->checkForInterrupt();
+    for (size_t i = 0; i < numInserterThreads; i++) {
+        inserterThreads.emplace_back([&, i] {
+            Client::initThreadIfNotAlready(str::stream() << "chunkInserter-" << i);
+            auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
+            try {
+                while (true) {
+                    auto nextBatch = batches.pop(inserterOpCtx.get());
+                    insertBatchFn(inserterOpCtx.get(),
+                                  BSONObjIterator(nextBatch["objects"].Obj()));
+                }
+            } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+                // Either all the batches have been inserted or some other thread failed
+            } catch (...) {
+                abortClone("Batch insertion failed");
+            }
+        });
+    }
 
-        auto res = fetchBatchFn(opCtx);
+    // The first stream is driven by the migration thread itself
+    for (size_t i = 1; i < fetchBatchFns.size(); i++) {
+        fetcherThreads.emplace_back([&, i] {
+            Client::initThreadIfNotAlready(str::stream() << "chunkFetcher-" << i);
+            auto fetcherOpCtx = Client::getCurrent()->makeOperationContext();
+            try {
+                fetchBatches(fetcherOpCtx.get(), fetchBatchFns[i]);
+            } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+                // Some other thread failed
+            } catch (...) {
+                abortClone("Batch fetch failed");
+            }
+        });
+    }
 
-        opCtx->checkForInterrupt();
-        batches.push(res.getOwned(), opCtx);
-        auto arr = res["objects"].Obj();
-        if (arr.isEmpty()) {
-            inserterThreadJoinGuard.Dismiss();
-            inserterThread.join();
-            opCtx->checkForInterrupt();
-            break;
-        }
+    fetchBatches(opCtx, fetchBatchFns.front());
+
+    for (auto& thread : fetcherThreads) {
+        thread.join();
     }
+    fetcherThreads.clear();
+
+    batches.closeProducerEnd();
+    for (auto& thread : inserterThreads) {
+        thread.join();
+    }
+    inserterThreads.clear();
+
+    threadsJoinGuard.Dismiss();
+    opCtx->checkForInterrupt();
 }
 
 Status MigrationDestinationManager::abort(const MigrationSessionId& sessionId) {
@@ -813,20 +908,41 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
             }
         };
 
-        auto fetchBatchFn = [&](OperationContext* opCtx) {
-            BSONObj res;
-            if (!conn->runCommand("admin",
-                                  migrateCloneRequest,
-                                  res)) {  // gets array of objects to copy, in disk order
-                conn.done();
-                const std::string errMsg = str::stream() << "_migrateClone failed: "
-                                                         << redact(res.toString());
-                uasserted(50747, errMsg);
-            }
-            return res;
+        // The first clone stream reuses the connection of the migration thread, while every other
+        // stream gets a connection of its own
+        std::vector<std::unique_ptr<ScopedDbConnection>> cloneConns;
+        for (int i = 1; i < migrateCloneStreams.load(); i++) {
+            cloneConns.push_back(stdx::make_unique<ScopedDbConnection>(fromShardConnString));
+        }
+
+        auto makeFetchBatchFn = [&](ScopedDbConnection* cloneConn) {
+            return [&, cloneConn](OperationContext* opCtx) {
+                // Gets array of objects to copy, in disk order
+                BSONObj res;
+                if (!cloneConn->get()->runCommand("admin", migrateCloneRequest, res)) {
+                    cloneConn->done();
+                    const std::string errMsg = str::stream() << "_migrateClone failed: "
+                                                             << redact(res.toString());
+                    uasserted(50747, errMsg);
+                }
+                return res;
+            };
         };
 
-        cloneDocumentsFromDonor(opCtx, insertBatchFn, fetchBatchFn);
+        std::vector<stdx::function<BSONObj(OperationContext*)>> fetchBatchFns;
+        fetchBatchFns.push_back(makeFetchBatchFn(&conn));
+        for (auto& cloneConn : cloneConns) {
+            fetchBatchFns.push_back(makeFetchBatchFn(cloneConn.get()));
+        }
+
+        cloneDocumentsFromDonor(opCtx,
+                                insertBatchFn,
+                                std::move(fetchBatchFns),
+                                static_cast<size_t>(migrateCloneInserterThreads.load()));
+
+        for (auto& cloneConn : cloneConns) {
+            cloneConn->done();
+        }
 
         timing.done(3);
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(migrateThreadHangAtStep3);
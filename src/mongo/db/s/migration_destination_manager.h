@@ -119,6 +119,18 @@ public:
         stdx::function<void(OperationContext*, BSONObjIterator)> insertBatchFn,
         stdx::function<BSONObj(OperationContext*)> fetchBatchFn);
 
+    /**
+     * Clones documents from a donor shard over several concurrent streams, one for each of
+     * 'fetchBatchFns', and inserts them using 'numInserterThreads' threads. Each stream keeps
+     * fetching batches until the donor returns an empty one. The batches are inserted in no
+     * particular order.
+     */
+    static void cloneDocumentsFromDonor(
+        OperationContext* opCtx,
+        stdx::function<void(OperationContext*, BSONObjIterator)> insertBatchFn,
+        std::vector<stdx::function<BSONObj(OperationContext*)>> fetchBatchFns,
+        size_t numInserterThreads);
+
     /**
      * Idempotent method, which causes the current ongoing migration to abort only if it has the
      * specified session id. If the migration is already aborted, does nothing.
@@ -156,5 +156,76 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsCatchesInsertErrors) {
     ASSERT_EQ(operationContext()->getKillStatus(), ErrorCodes::FailedToParse);
 }
 
+// Tests that several concurrent streams clone every document exactly once.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorOverSeveralStreams) {
+    const int kNumDocs = 200;
+    const int kBatchSize = 10;
+
+    stdx::mutex mutex;
+    int nextDocToFetch = 0;
+    std::vector<BSONObj> resultDocs;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        BSONArrayBuilder arrayBuilder;
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            for (int i = 0; i < kBatchSize && nextDocToFetch < kNumDocs; i++) {
+                arrayBuilder.append(createDocument(nextDocToFetch++));
+            }
+        }
+
+        BSONObjBuilder fetchBatchResultBuilder;
+        fetchBatchResultBuilder.append("objects", arrayBuilder.arr());
+        return fetchBatchResultBuilder.obj();
+    };
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObjIterator docs) {
+        while (docs.more()) {
+            auto doc = docs.next().Obj().getOwned();
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            resultDocs.push_back(doc);
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, {fetchBatchFn, fetchBatchFn, fetchBatchFn}, 4);
+
+    ASSERT_EQ(kNumDocs, static_cast<int>(resultDocs.size()));
+
+    std::sort(resultDocs.begin(), resultDocs.end(), [](const BSONObj& lhs, const BSONObj& rhs) {
+        return lhs["_id"].numberInt() < rhs["_id"].numberInt();
+    });
+    for (int i = 0; i < kNumDocs; i++) {
+        ASSERT_BSONOBJ_EQ(createDocument(i), resultDocs[i]);
+    }
+}
+
+// Tests that an exception in a stream other than the one driven by the calling thread interrupts
+// the clone.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsThrowsFetchErrorsFromOtherStreams) {
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        BSONObjBuilder fetchBatchResultBuilder;
+        fetchBatchResultBuilder.append("objects", createDocumentsToCloneArray());
+        return fetchBatchResultBuilder.obj();
+    };
+
+    auto failingFetchBatchFn = [&](OperationContext* opCtx) -> BSONObj {
+        uasserted(ErrorCodes::NetworkTimeout, "network error");
+    };
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObjIterator docs) {};
+
+    ASSERT_THROWS_CODE_AND_WHAT(MigrationDestinationManager::cloneDocumentsFromDonor(
+                                    operationContext(),
+                                    insertBatchFn,
+                                    {fetchBatchFn, failingFetchBatchFn},
+                                    2),
+                                DBException,
+                                ErrorCodes::NetworkTimeout,
+                                "operation was interrupted");
+
+    ASSERT_EQ(operationContext()->getKillStatus(), ErrorCodes::NetworkTimeout);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -31,6 +31,7 @@
 #include "mongo/db/stats/operation_latency_histogram.h"
 
 #include <algorithm>
+#include <cmath>
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/namespace_string.h"
@@ -98,16 +99,29 @@ void OperationLatencyHistogram::_append(const HistogramData& data,
 
     BSONObjBuilder histogramBuilder(builder->subobjStart(key));
     if (includeHistograms) {
+        std::array<uint64_t, kMaxBuckets> coarseBuckets{};
+        for (int i = 0; i < static_cast<int>(data.buckets.size()); i++) {
+            coarseBuckets[_getCoarseBucket(_getBucketLowerBound(i))] += data.buckets[i];
+        }
+
         BSONArrayBuilder arrayBuilder(histogramBuilder.subarrayStart("histogram"));
         for (int i = 0; i < kMaxBuckets; i++) {
-            if (data.buckets[i] == 0)
+            if (coarseBuckets[i] == 0)
                 continue;
             BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
             entryBuilder.append("micros", static_cast<long long>(kLowerBounds[i]));
-            entryBuilder.append("count", static_cast<long long>(data.buckets[i]));
+            entryBuilder.append("count", static_cast<long long>(coarseBuckets[i]));
             entryBuilder.doneFast();
         }
         arrayBuilder.doneFast();
+
+        if (data.entryCount > 0) {
+            BSONObjBuilder percentilesBuilder(histogramBuilder.subobjStart("percentiles"));
+            percentilesBuilder.append("p50", static_cast<long long>(_getPercentile(data, 50)));
+            percentilesBuilder.append("p99", static_cast<long long>(_getPercentile(data, 99)));
+            percentilesBuilder.append("p999", static_cast<long long>(_getPercentile(data, 99.9)));
+            percentilesBuilder.doneFast();
+        }
     }
     histogramBuilder.append("latency", static_cast<long long>(data.sum));
     histogramBuilder.append("ops", static_cast<long long>(data.entryCount));
@@ -120,8 +134,58 @@ void OperationLatencyHistogram::append(bool includeHistograms, BSONObjBuilder* b
     _append(_commands, "commands", includeHistograms, builder);
 }
 
+int OperationLatencyHistogram::_getBucket(uint64_t latency) {
+    if (latency < static_cast<uint64_t>(kSubBuckets)) {
+        return static_cast<int>(latency);
+    }
+
+    int log2 = 63 - countLeadingZeros64(latency);
+    if (log2 > kMaxExponent - 1) {
+        return kNumFineBuckets - 1;
+    }
+
+    // The kSubBucketBits bits below the leading bit choose the bucket within the power of two.
+    int subBucket = static_cast<int>(latency >> (log2 - kSubBucketBits)) - kSubBuckets;
+    return kSubBuckets * (log2 - kSubBucketBits + 1) + subBucket;
+}
+
+uint64_t OperationLatencyHistogram::_getBucketLowerBound(int bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    } else if (bucket == kNumFineBuckets - 1) {
+        return 1ULL << kMaxExponent;
+    }
+
+    int log2 = bucket / kSubBuckets + kSubBucketBits - 1;
+    uint64_t subBucket = bucket % kSubBuckets;
+    return (kSubBuckets + subBucket) << (log2 - kSubBucketBits);
+}
+
+uint64_t OperationLatencyHistogram::_getPercentile(const HistogramData& data, double percentile) {
+    if (data.entryCount == 0) {
+        return 0;
+    }
+
+    // The rank of the operation at the percentile, counting from 1.
+    uint64_t rank = std::max<uint64_t>(
+        1, static_cast<uint64_t>(std::ceil(percentile / 100 * data.entryCount)));
+    uint64_t seen = 0;
+    for (int i = 0; i < kNumFineBuckets - 1; i++) {
+        seen += data.buckets[i];
+        if (seen >= rank) {
+            return _getBucketLowerBound(i + 1) - 1;
+        }
+    }
+    return _getBucketLowerBound(kNumFineBuckets - 1);
+}
+
+uint64_t OperationLatencyHistogram::getPercentile(Command::ReadWriteType type,
+                                                  double percentile) const {
+    return _getPercentile(_getData(type), percentile);
+}
+
 // Computes the log base 2 of value, and checks for cases of split buckets.
-int OperationLatencyHistogram::_getBucket(uint64_t value) {
+int OperationLatencyHistogram::_getCoarseBucket(uint64_t value) {
     // Zero is a special case since log(0) is undefined.
     if (value == 0) {
         return 0;
@@ -148,11 +212,47 @@ int OperationLatencyHistogram::_getBucket(uint64_t value) {
 }
 
 void OperationLatencyHistogram::_incrementData(uint64_t latency, int bucket, HistogramData* data) {
+    if (data->buckets.empty()) {
+        data->buckets.resize(kNumFineBuckets);
+    }
     data->buckets[bucket]++;
     data->entryCount++;
     data->sum += latency;
 }
 
+void OperationLatencyHistogram::merge(const OperationLatencyHistogram& other) {
+    for (auto&& pair : {std::make_pair(&_reads, &other._reads),
+                        std::make_pair(&_writes, &other._writes),
+                        std::make_pair(&_commands, &other._commands)}) {
+        HistogramData* data = pair.first;
+        const HistogramData* otherData = pair.second;
+        if (otherData->buckets.empty()) {
+            continue;
+        }
+        if (data->buckets.empty()) {
+            data->buckets.resize(kNumFineBuckets);
+        }
+        for (int i = 0; i < kNumFineBuckets; i++) {
+            data->buckets[i] += otherData->buckets[i];
+        }
+        data->entryCount += otherData->entryCount;
+        data->sum += otherData->sum;
+    }
+}
+
+const OperationLatencyHistogram::HistogramData& OperationLatencyHistogram::_getData(
+    Command::ReadWriteType type) const {
+    switch (type) {
+        case Command::ReadWriteType::kRead:
+            return _reads;
+        case Command::ReadWriteType::kWrite:
+            return _writes;
+        case Command::ReadWriteType::kCommand:
+            return _commands;
+    }
+    MONGO_UNREACHABLE;
+}
+
 void OperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteType type) {
     int bucket = _getBucket(latency);
     switch (type) {
@@ -28,6 +28,7 @@
 #pragma once
 
 #include <array>
+#include <vector>
 
 #include "mongo/db/commands.h"
 
@@ -38,6 +39,13 @@ class BSONObjBuilder;
 /**
  * Stores statistics for latencies of read, write, and command operations.
  *
+ * Latencies are counted in log-linear buckets: latencies below kSubBuckets microseconds each have
+ * a bucket, and each power of two above that is split into kSubBuckets buckets of equal width, so
+ * that a percentile read from the histogram is within 1/kSubBuckets of the true latency. The
+ * histogram reported by append() uses the coarser buckets given by kLowerBounds, each of which is
+ * a union of the finer buckets. The kNumFineBuckets counters of each operation type take about
+ * 2.4KB, so they are only allocated once an operation of that type is recorded.
+ *
  * Note: This class is not thread-safe.
  */
 class OperationLatencyHistogram {
@@ -47,26 +55,62 @@ public:
     // Inclusive lower bounds of the histogram buckets.
     static const std::array<uint64_t, kMaxBuckets> kLowerBounds;
 
+    static const int kSubBucketBits = 3;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+
+    // Latencies of 2^kMaxExponent microseconds or more share the last of the finer buckets.
+    static const int kMaxExponent = 40;
+    static const int kNumFineBuckets = kSubBuckets * (kMaxExponent - kSubBucketBits + 1) + 1;
+
     /**
      * Increments the bucket of the histogram based on the operation type.
      */
     void increment(uint64_t latency, Command::ReadWriteType type);
 
     /**
-     * Appends the three histograms with latency totals and operation counts.
+     * Adds the counts of 'other' to this histogram.
+     */
+    void merge(const OperationLatencyHistogram& other);
+
+    /**
+     * Returns the latency, in microseconds, below which 'percentile' percent of the operations of
+     * the given type fall, or 0 if there have been no such operations. The result is the largest
+     * latency counted by the bucket containing the percentile.
+     */
+    uint64_t getPercentile(Command::ReadWriteType type, double percentile) const;
+
+    /**
+     * Appends the three histograms with latency totals and operation counts. Along with the
+     * histograms, appends the 50th, 99th and 99.9th percentile latencies of each.
      */
     void append(bool includeHistograms, BSONObjBuilder* builder) const;
 
 private:
     struct HistogramData {
-        std::array<uint64_t, kMaxBuckets> buckets{};
+        // Empty until the first latency is counted, and kNumFineBuckets long afterwards.
+        std::vector<uint64_t> buckets;
         uint64_t entryCount = 0;
         uint64_t sum = 0;
     };
 
+    /**
+     * Returns the finer bucket counting 'latency'.
+     */
     static int _getBucket(uint64_t latency);
 
-    static uint64_t _getBucketMicros(int bucket);
+    /**
+     * Returns the inclusive lower bound of the finer bucket 'bucket'.
+     */
+    static uint64_t _getBucketLowerBound(int bucket);
+
+    /**
+     * Returns the bucket of kLowerBounds counting 'latency'.
+     */
+    static int _getCoarseBucket(uint64_t latency);
+
+    static uint64_t _getPercentile(const HistogramData& data, double percentile);
+
+    const HistogramData& _getData(Command::ReadWriteType type) const;
 
     void _append(const HistogramData& data,
                  const char* key,
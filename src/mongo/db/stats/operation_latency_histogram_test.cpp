@@ -89,4 +89,68 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
         ASSERT_EQUALS(bucket["count"].Long(), (i < kMaxBuckets - 1) ? 3 : 2);
     }
 }
+
+TEST(OperationLatencyHistogram, PercentilesAreWithinBucketPrecision) {
+    OperationLatencyHistogram hist;
+    ASSERT_EQUALS(hist.getPercentile(Command::ReadWriteType::kRead, 50), 0ULL);
+
+    // One operation for each latency from 1 to 100,000 microseconds.
+    const uint64_t kNumOps = 100 * 1000;
+    for (uint64_t latency = 1; latency <= kNumOps; latency++) {
+        hist.increment(latency, Command::ReadWriteType::kRead);
+    }
+
+    const double maxError = 1.0 / OperationLatencyHistogram::kSubBuckets;
+    for (double percentile : {50.0, 90.0, 99.0, 99.9}) {
+        const double expected = percentile / 100 * kNumOps;
+        const double actual = hist.getPercentile(Command::ReadWriteType::kRead, percentile);
+        ASSERT_GTE(actual, expected);
+        ASSERT_LTE(actual, expected * (1 + maxError));
+    }
+
+    // Small latencies are counted exactly.
+    OperationLatencyHistogram small;
+    small.increment(3, Command::ReadWriteType::kWrite);
+    small.increment(5, Command::ReadWriteType::kWrite);
+    ASSERT_EQUALS(small.getPercentile(Command::ReadWriteType::kWrite, 50), 3ULL);
+    ASSERT_EQUALS(small.getPercentile(Command::ReadWriteType::kWrite, 99), 5ULL);
+}
+
+TEST(OperationLatencyHistogram, LatenciesBeyondRangeShareLastBucket) {
+    OperationLatencyHistogram hist;
+    const uint64_t kMaxTracked = 1ULL << OperationLatencyHistogram::kMaxExponent;
+    hist.increment(kMaxTracked * 4, Command::ReadWriteType::kCommand);
+    ASSERT_EQUALS(hist.getPercentile(Command::ReadWriteType::kCommand, 50), kMaxTracked);
+
+    BSONObjBuilder outBuilder;
+    hist.append(true, &outBuilder);
+    BSONObj out = outBuilder.done();
+    std::vector<BSONElement> buckets = out["commands"]["histogram"].Array();
+    ASSERT_EQUALS(buckets.size(), 1U);
+    ASSERT_EQUALS(static_cast<uint64_t>(buckets[0]["micros"].Long()), kLowerBounds.back());
+}
+
+TEST(OperationLatencyHistogram, MergeAddsCounts) {
+    OperationLatencyHistogram first;
+    OperationLatencyHistogram second;
+    for (uint64_t latency = 1; latency <= 100; latency++) {
+        first.increment(latency, Command::ReadWriteType::kRead);
+        second.increment(latency * 1000, Command::ReadWriteType::kRead);
+        second.increment(latency, Command::ReadWriteType::kWrite);
+    }
+    first.merge(second);
+
+    BSONObjBuilder outBuilder;
+    first.append(true, &outBuilder);
+    BSONObj out = outBuilder.done();
+    ASSERT_EQUALS(out["reads"]["ops"].Long(), 200);
+    ASSERT_EQUALS(out["reads"]["latency"].Long(), 5050 + 5050 * 1000);
+    ASSERT_EQUALS(out["writes"]["ops"].Long(), 100);
+    ASSERT_EQUALS(out["commands"]["ops"].Long(), 0);
+
+    // Half of the reads took at most 100 microseconds.
+    ASSERT_EQUALS(out["reads"]["percentiles"]["p50"].Long(), 103);
+    ASSERT_GTE(out["reads"]["percentiles"]["p99"].Long(), 98 * 1000);
+    ASSERT_FALSE(out["commands"].Obj().hasField("percentiles"));
+}
 }  // namespace mongo
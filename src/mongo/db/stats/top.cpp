@@ -35,6 +35,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -48,8 +49,14 @@ namespace {
 
 const auto getTop = ServiceContext::declareDecoration<Top>();
 
+// Threads are assigned global histogram shards in the order in which they first record latency.
+AtomicUInt32 nextGlobalHistogramShard;
+thread_local std::size_t globalHistogramShard = nextGlobalHistogramShard.fetchAndAdd(1);
+
 }  // namespace
 
+Top::Top() : _globalHistogramShards(kNumGlobalHistogramShards) {}
+
 Top::UsageData::UsageData(const UsageData& older, const UsageData& newer) {
     // this won't be 100% accurate on rollovers and drop(), but at least it won't be negative
     time = (newer.time >= older.time) ? (newer.time - older.time) : newer.time;
@@ -83,14 +90,15 @@ void Top::record(OperationContext* opCtx,
         return;
 
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    const std::size_t partitionId = hashedNs.hash() % kNumUsagePartitions;
+    auto usage = _usage.lockOnePartitionById(partitionId);
 
-    if ((command || logicalOp == LogicalOp::opQuery) && ns == _lastDropped) {
-        _lastDropped = "";
+    if ((command || logicalOp == LogicalOp::opQuery) && ns == _lastDropped[partitionId]) {
+        _lastDropped[partitionId] = "";
         return;
     }
 
-    CollectionData& coll = _usage[hashedNs];
+    CollectionData& coll = (*usage)[hashedNs];
     _record(opCtx, coll, logicalOp, lockType, micros, readWriteType);
 }
 
@@ -140,39 +148,50 @@ void Top::_record(OperationContext* opCtx,
 }
 
 void Top::collectionDropped(StringData ns, bool databaseDropped) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _usage.erase(ns);
+    auto hashedNs = UsageMap::HashedKey(ns);
+    const std::size_t partitionId = hashedNs.hash() % kNumUsagePartitions;
+    auto usage = _usage.lockOnePartitionById(partitionId);
+    usage->erase(hashedNs);
     if (!databaseDropped) {
         // If a collection drop occurred, there will be a subsequent call to record for this
         // collection namespace which must be ignored. This does not apply to a database drop.
-        _lastDropped = ns.toString();
+        _lastDropped[partitionId] = ns.toString();
     }
 }
 
 void Top::cloneMap(Top::UsageMap& out) const {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    out = _usage;
+    out.clear();
+    auto all = _usage.lockAllPartitions();
+    for (auto&& partition : all) {
+        for (auto&& entry : partition) {
+            out[entry.first] = entry.second;
+        }
+    }
 }
 
 void Top::append(BSONObjBuilder& b) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _appendToUsageMap(b, _usage);
-}
+    auto all = _usage.lockAllPartitions();
 
-void Top::_appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const {
     // pull all the names into a vector so we can sort them for the user
-
-    vector<string> names;
-    for (UsageMap::const_iterator i = map.begin(); i != map.end(); ++i) {
-        names.push_back(i->first);
+    UsageEntries entries;
+    for (auto&& partition : all) {
+        for (auto&& entry : partition) {
+            entries.emplace_back(entry.first, &entry.second);
+        }
     }
 
-    std::sort(names.begin(), names.end());
+    std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+    });
 
-    for (size_t i = 0; i < names.size(); i++) {
-        BSONObjBuilder bb(b.subobjStart(names[i]));
+    _appendToUsageMap(b, entries);
+}
+
+void Top::_appendToUsageMap(BSONObjBuilder& b, const UsageEntries& entries) const {
+    for (auto&& entry : entries) {
+        BSONObjBuilder bb(b.subobjStart(entry.first));
 
-        const CollectionData& coll = map.find(names[i])->second;
+        const CollectionData& coll = *entry.second;
 
         _appendStatsEntry(b, "total", coll.total);
 
@@ -199,9 +218,9 @@ void Top::_appendStatsEntry(BSONObjBuilder& b, const char* statsName, const Usag
 
 void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder) {
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    auto usage = _usage.lockOnePartitionById(hashedNs.hash() % kNumUsagePartitions);
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    (*usage)[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
     builder->append("ns", ns);
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
@@ -209,13 +228,22 @@ void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuild
 void Top::incrementGlobalLatencyStats(OperationContext* opCtx,
                                       uint64_t latency,
                                       Command::ReadWriteType readWriteType) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(opCtx, latency, &_globalHistogramStats, readWriteType);
+    auto& shard = _getGlobalHistogramShard();
+    stdx::lock_guard<SimpleMutex> guard(shard.lock);
+    _incrementHistogram(opCtx, latency, &shard.histogram, readWriteType);
 }
 
 void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.append(includeHistograms, builder);
+    OperationLatencyHistogram globalHistogramStats;
+    for (auto&& shard : _globalHistogramShards) {
+        stdx::lock_guard<SimpleMutex> guard(shard.lock);
+        globalHistogramStats.merge(shard.histogram);
+    }
+    globalHistogramStats.append(includeHistograms, builder);
+}
+
+Top::GlobalHistogramShard& Top::_getGlobalHistogramShard() {
+    return _globalHistogramShards[globalHistogramShard % kNumGlobalHistogramShards];
 }
 
 void Top::_incrementHistogram(OperationContext* opCtx,
@@ -29,13 +29,18 @@
 
 #pragma once
 
+#include <array>
+#include <boost/align/aligned_allocator.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <vector>
 
+#include "mongo/db/catalog/util/partitioned.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/operation_latency_histogram.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/string_map.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -43,12 +48,17 @@ class ServiceContext;
 
 /**
  * tracks usage by collection
+ *
+ * Usage is kept in partitions chosen by the hash of the namespace, each with its own lock, so that
+ * operations on different collections rarely contend. Operations on the same collection still
+ * serialize on its partition's lock. The global latency histogram is split into shards chosen by
+ * thread, which are merged when the statistics are read.
  */
 class Top {
 public:
     static Top& get(ServiceContext* service);
 
-    Top() = default;
+    Top();
 
     struct UsageData {
         UsageData() : time(0), count(0) {}
@@ -91,6 +101,9 @@ public:
 
     typedef StringMap<CollectionData> UsageMap;
 
+    static const std::size_t kNumUsagePartitions = 16;
+    static const std::size_t kNumGlobalHistogramShards = 16;
+
 public:
     void record(OperationContext* opCtx,
                 StringData ns,
@@ -124,7 +137,28 @@ public:
     void appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder);
 
 private:
-    void _appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const;
+    struct NamespacePartitioner {
+        std::size_t operator()(StringData ns, std::size_t nPartitions) const {
+            return StringMapTraits::hash(ns) % nPartitions;
+        }
+    };
+
+    struct GlobalHistogramShard {
+        SimpleMutex lock;
+        OperationLatencyHistogram histogram;
+    };
+
+    using PartitionedUsageMap = Partitioned<UsageMap, kNumUsagePartitions, NamespacePartitioner>;
+
+    template <typename T>
+    using AlignedVector = std::vector<T, boost::alignment::aligned_allocator<T>>;
+
+    using UsageEntries = std::vector<std::pair<StringData, const CollectionData*>>;
+
+    /**
+     * Appends the usage of each namespace in 'entries', which must be sorted by namespace.
+     */
+    void _appendToUsageMap(BSONObjBuilder& b, const UsageEntries& entries) const;
 
     void _appendStatsEntry(BSONObjBuilder& b, const char* statsName, const UsageData& map) const;
 
@@ -140,10 +174,19 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
-    mutable SimpleMutex _lock;
-    OperationLatencyHistogram _globalHistogramStats;
-    UsageMap _usage;
-    std::string _lastDropped;
+    /**
+     * Returns the global histogram shard for the calling thread.
+     */
+    GlobalHistogramShard& _getGlobalHistogramShard();
+
+    // Not mutated by readers, but locking a partition requires a non-const Partitioned.
+    mutable PartitionedUsageMap _usage;
+
+    // The namespace of the last collection dropped in each partition of '_usage', protected by the
+    // lock of that partition.
+    std::array<std::string, kNumUsagePartitions> _lastDropped;
+
+    AlignedVector<CacheAligned<GlobalHistogramShard>> _globalHistogramShards;
 };
 
 }  // namespace mongo
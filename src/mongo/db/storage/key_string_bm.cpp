@@ -0,0 +1,161 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * The index key shapes exercised by the benchmarks below. Each benchmark takes the KeyString
+ * version as its first argument and the key shape as its second.
+ */
+enum KeyShape : int {
+    kInt = 0,
+    kDouble = 1,
+    kString = 2,
+    kObjectId = 3,
+    // A compound key on {status: 1, customerId: 1, createdAt: -1}.
+    kCompound = 4,
+};
+
+const char* shapeName(int shape) {
+    switch (shape) {
+        case kInt:
+            return "int";
+        case kDouble:
+            return "double";
+        case kString:
+            return "string";
+        case kObjectId:
+            return "objectid";
+        case kCompound:
+            return "compound";
+    }
+    MONGO_UNREACHABLE;
+}
+
+BSONObj makeKey(int shape) {
+    switch (shape) {
+        case kInt:
+            return BSON("" << 123456789);
+        case kDouble:
+            return BSON("" << 3.14159);
+        case kString:
+            return BSON(""
+                        << "firstname.lastname@example.com");
+        case kObjectId:
+            return BSON("" << OID::gen());
+        case kCompound:
+            return BSON(""
+                        << "shipped"
+                        << ""
+                        << 1234567LL
+                        << ""
+                        << Date_t::fromMillisSinceEpoch(1500000000000LL));
+    }
+    MONGO_UNREACHABLE;
+}
+
+Ordering makeOrdering(int shape) {
+    if (shape == kCompound) {
+        return Ordering::make(BSON("status" << 1 << "customerId" << 1 << "createdAt" << -1));
+    }
+    return Ordering::make(BSON("a" << 1));
+}
+
+KeyString::Version getVersion(benchmark::State& state) {
+    return state.range(0) == 0 ? KeyString::Version::V0 : KeyString::Version::V1;
+}
+
+void setLabel(benchmark::State& state) {
+    state.SetLabel(str::stream() << "V" << state.range(0) << " " << shapeName(state.range(1)));
+}
+
+void BM_KeyStringEncode(benchmark::State& state) {
+    const auto version = getVersion(state);
+    const BSONObj key = makeKey(state.range(1));
+    const Ordering ord = makeOrdering(state.range(1));
+    setLabel(state);
+
+    KeyString ks(version);
+    size_t bytes = 0;
+    for (auto keepRunning : state) {
+        ks.resetToKey(key, ord, RecordId(1234));
+        bytes += ks.getSize();
+        benchmark::DoNotOptimize(ks.getBuffer());
+    }
+    state.SetBytesProcessed(bytes);
+}
+
+void BM_KeyStringDecode(benchmark::State& state) {
+    const auto version = getVersion(state);
+    const Ordering ord = makeOrdering(state.range(1));
+    const KeyString ks(version, makeKey(state.range(1)), ord, RecordId(1234));
+    setLabel(state);
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(
+            KeyString::toBson(ks.getBuffer(), ks.getSize(), ord, ks.getTypeBits()));
+    }
+    state.SetBytesProcessed(state.iterations() * ks.getSize());
+}
+
+void BM_KeyStringDecodeRecordId(benchmark::State& state) {
+    const auto version = getVersion(state);
+    const KeyString ks(
+        version, makeKey(state.range(1)), makeOrdering(state.range(1)), RecordId(1234));
+    setLabel(state);
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(KeyString::decodeRecordIdAtEnd(ks.getBuffer(), ks.getSize()));
+    }
+}
+
+void KeyStringArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"version", "shape"});
+    for (int version = 0; version <= 1; ++version) {
+        for (int shape = kInt; shape <= kCompound; ++shape) {
+            b->Args({version, shape});
+        }
+    }
+}
+
+BENCHMARK(BM_KeyStringEncode)->Apply(KeyStringArgs);
+BENCHMARK(BM_KeyStringDecode)->Apply(KeyStringArgs);
+BENCHMARK(BM_KeyStringDecodeRecordId)->Apply(KeyStringArgs);
+
+}  // namespace
+}  // namespace mongo
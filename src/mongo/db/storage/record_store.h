@@ -243,6 +243,23 @@ public:
      */
     virtual boost::optional<Record> seekExact(const RecordId& id) = 0;
 
+    /**
+     * Positions a forward cursor on the first Record whose id is greater than or equal to 'id' and
+     * returns it, or returns boost::none if there is no such Record. Subsequent calls to next()
+     * continue from the returned Record.
+     *
+     * The default implementation advances with next() and is therefore only correct on a cursor
+     * that has not yet been positioned. Capped visibility rules are not guaranteed to be applied,
+     * so callers must not use this on capped collections.
+     */
+    virtual boost::optional<Record> seekAtOrAfter(const RecordId& id) {
+        while (auto record = next()) {
+            if (record->id >= id)
+                return record;
+        }
+        return boost::none;
+    }
+
     /**
      * Prepares for state changes in underlying data without necessarily saving the current
      * state.
@@ -443,5 +443,61 @@ TEST(RecordStoreTestHarness, SeekAfterEofAndContinue) {
     ASSERT(!cursor->next());
 }
 
+// Position forward iterators at or after a RecordId, including one which has been deleted, and
+// continue iterating from there.
+TEST(RecordStoreTestHarness, SeekAtOrAfterAndContinue) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+    const int nToInsert = 10;
+    RecordId locs[nToInsert];
+    for (int i = 0; i < nToInsert; i++) {
+        StringBuilder sb;
+        sb << "record " << i;
+        string data = sb.str();
+
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res =
+            rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp(), false);
+        ASSERT_OK(res.getStatus());
+        locs[i] = res.getValue();
+        uow.commit();
+    }
+    std::sort(locs, locs + nToInsert);  // inserted records may not be in RecordId order
+
+    {
+        auto cursor = rs->getCursor(opCtx.get());
+        const auto record = cursor->seekAtOrAfter(locs[3]);
+        ASSERT(record);
+        ASSERT_EQUALS(locs[3], record->id);
+        const auto next = cursor->next();
+        ASSERT(next);
+        ASSERT_EQUALS(locs[4], next->id);
+    }
+
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        rs->deleteRecord(opCtx.get(), locs[5]);
+        uow.commit();
+    }
+
+    {
+        auto cursor = rs->getCursor(opCtx.get());
+        const auto record = cursor->seekAtOrAfter(locs[5]);
+        ASSERT(record);
+        ASSERT_EQUALS(locs[6], record->id);
+        const auto next = cursor->next();
+        ASSERT(next);
+        ASSERT_EQUALS(locs[7], next->id);
+    }
+
+    {
+        auto cursor = rs->getCursor(opCtx.get());
+        ASSERT(!cursor->seekAtOrAfter(RecordId(locs[nToInsert - 1].repr() + 1)));
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -76,6 +76,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_tuner.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/background.h"
@@ -438,8 +439,170 @@ TicketServerParameter openReadTransactionParam(&openReadTransaction,
 stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](StringData) -> bool {
     fassertFailed(40358);
 };
+
+// When enabled, the number of concurrent read and write transactions is tuned periodically, within
+// the bounds below, from the throughput of the admitted operations and the pressure on the cache.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrency, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrencyMinTickets, int, 16)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 5) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerAdaptiveConcurrencyMinTickets must be at least 5");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrencyMaxTickets, int, 512)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 5) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerAdaptiveConcurrencyMaxTickets must be at least 5");
+        }
+        return Status::OK();
+    });
+
+const auto kTicketTunerPeriod = Seconds(1);
+
+// WiredTiger's default eviction triggers, as fractions of the cache size. Beyond these,
+// application threads are made to evict pages, so admitting more transactions only adds latency.
+const double kCacheUsedTriggerRatio = 0.95;
+const double kCacheDirtyTriggerRatio = 0.2;
 }  // namespace
 
+class WiredTigerKVEngine::WiredTigerTicketTunerThread : public BackgroundJob {
+public:
+    WiredTigerTicketTunerThread(WiredTigerSessionCache* sessionCache,
+                                TicketHolder* readTickets,
+                                TicketHolder* writeTickets)
+        : BackgroundJob(false /* deleteSelf */),
+          _sessionCache(sessionCache),
+          _read("read", readTickets),
+          _write("write", writeTickets) {}
+
+    virtual string name() const {
+        return "WTTicketTuner";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        LOG(1) << "starting " << name() << " thread";
+
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(lock, kTicketTunerPeriod.toSystemDuration());
+            }
+
+            if (_shuttingDown.load()) {
+                break;
+            }
+
+            if (!wiredTigerAdaptiveConcurrency.load()) {
+                // Start over from a fresh sample once tuning is enabled again.
+                _read.tuner.reset();
+                _write.tuner.reset();
+                continue;
+            }
+
+            try {
+                _tune();
+            } catch (const AssertionException& e) {
+                LOG(1) << "Failed to tune the number of concurrent transactions: " << e;
+            }
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        _condvar.notify_one();
+        wait();
+    }
+
+private:
+    struct TunedTickets {
+        TunedTickets(StringData name, TicketHolder* holder) : name(name), holder(holder) {}
+
+        const StringData name;
+        TicketHolder* const holder;
+        std::unique_ptr<WiredTigerTicketTuner> tuner;
+
+        // The value of 'holder->numReleased()' when the previous sample was taken.
+        long long lastNumReleased = 0;
+    };
+
+    void _tune() {
+        const int minTickets = wiredTigerAdaptiveConcurrencyMinTickets.load();
+        const int maxTickets = std::max(minTickets, wiredTigerAdaptiveConcurrencyMaxTickets.load());
+
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        WT_SESSION* s = session->getSession();
+        auto getStat = [s](int key) {
+            return uassertStatusOK(
+                WiredTigerUtil::getStatisticsValueAs<int64_t>(s, "statistics:", "", key));
+        };
+        const int64_t bytesMax = getStat(WT_STAT_CONN_CACHE_BYTES_MAX);
+        const int64_t bytesInUse = getStat(WT_STAT_CONN_CACHE_BYTES_INUSE);
+        const int64_t bytesDirty = getStat(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+        const int64_t appEvictions = getStat(WT_STAT_CONN_CACHE_EVICTION_APP);
+
+        const bool appThreadsEvicting = _lastAppEvictions >= 0 && appEvictions > _lastAppEvictions;
+        _lastAppEvictions = appEvictions;
+        const bool cacheFull = bytesInUse > bytesMax * kCacheUsedTriggerRatio;
+        const bool cacheDirty = bytesDirty > bytesMax * kCacheDirtyTriggerRatio;
+
+        // Dirty data is only produced by writes, so only writers are held back while it builds up.
+        _tuneTickets(&_read, minTickets, maxTickets, cacheFull || appThreadsEvicting);
+        _tuneTickets(
+            &_write, minTickets, maxTickets, cacheFull || cacheDirty || appThreadsEvicting);
+    }
+
+    void _tuneTickets(TunedTickets* tickets, int minTickets, int maxTickets, bool underPressure) {
+        const long long numReleased = tickets->holder->numReleased();
+        if (!tickets->tuner || tickets->tuner->getMinTickets() != minTickets ||
+            tickets->tuner->getMaxTickets() != maxTickets) {
+            tickets->tuner = stdx::make_unique<WiredTigerTicketTuner>(minTickets, maxTickets);
+            tickets->lastNumReleased = numReleased;
+            return;
+        }
+
+        WiredTigerTicketTuner::Sample sample;
+        sample.numReleased = numReleased - tickets->lastNumReleased;
+        sample.used = tickets->holder->used();
+        sample.cacheUnderPressure = underPressure;
+        tickets->lastNumReleased = numReleased;
+
+        const int current = tickets->holder->outof();
+        const int next = tickets->tuner->nextTicketCount(current, sample);
+        if (next == current) {
+            return;
+        }
+
+        LOG(1) << "Resizing concurrent " << tickets->name << " transactions from " << current
+               << " to " << next << "; cache under pressure: " << underPressure
+               << ", tickets released: " << sample.numReleased;
+        Status status = tickets->holder->resize(next);
+        if (!status.isOK()) {
+            LOG(1) << "Failed to resize concurrent " << tickets->name
+                   << " transactions: " << status;
+        }
+    }
+
+    WiredTigerSessionCache* _sessionCache;
+
+    // _mutex/_condvar used to notify when _shuttingDown is flipped.
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    AtomicBool _shuttingDown{false};
+
+    TunedTickets _read;
+    TunedTickets _write;
+    int64_t _lastAppEvictions = -1;
+};
+
 WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
                                        const std::string& path,
                                        ClockSource* cs,
@@ -568,6 +731,10 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
             setStableTimestamp(_recoveryTimestamp);
         }
         _checkpointThread->go();
+
+        _ticketTunerThread = stdx::make_unique<WiredTigerTicketTunerThread>(
+            _sessionCache.get(), &openReadTransaction, &openWriteTransaction);
+        _ticketTunerThread->go();
     }
 
     _sizeStorerUri = "table:sizeStorer";
@@ -624,6 +791,11 @@ void WiredTigerKVEngine::cleanShutdown() {
         _journalFlusher->shutdown();
         log() << "Finished shutting down journal flusher thread";
     }
+    if (_ticketTunerThread) {
+        log() << "Shutting down ticket tuner thread";
+        _ticketTunerThread->shutdown();
+        log() << "Finished shutting down ticket tuner thread";
+    }
     if (_checkpointThread) {
         log() << "Shutting down checkpoint thread";
         _checkpointThread->shutdown();
@@ -1356,6 +1528,7 @@ StatusWith<Timestamp> WiredTigerKVEngine::recoverToStableTimestamp(OperationCont
     // Shutdown WiredTigerKVEngine owned accesses into the storage engine.
     _journalFlusher->shutdown();
     _checkpointThread->shutdown();
+    _ticketTunerThread->shutdown();
 
     const auto stableTimestamp = Timestamp(_checkpointThread->getStableTimestamp());
     const auto initialDataTimestamp = Timestamp(_checkpointThread->getInitialDataTimestamp());
@@ -1374,6 +1547,9 @@ StatusWith<Timestamp> WiredTigerKVEngine::recoverToStableTimestamp(OperationCont
     _checkpointThread->setInitialDataTimestamp(initialDataTimestamp);
     _checkpointThread->setStableTimestamp(stableTimestamp);
     _checkpointThread->go();
+    _ticketTunerThread = std::make_unique<WiredTigerTicketTunerThread>(
+        _sessionCache.get(), &openReadTransaction, &openWriteTransaction);
+    _ticketTunerThread->go();
 
     _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
 
@@ -175,6 +175,10 @@ public:
         return &_sessionCache->snapshotManager();
     }
 
+    WiredTigerSessionCache* getSessionCache() const {
+        return _sessionCache.get();
+    }
+
     void setJournalListener(JournalListener* jl) final;
 
     virtual void setStableTimestamp(Timestamp stableTimestamp) override;
@@ -280,6 +284,7 @@ public:
 private:
     class WiredTigerJournalFlusher;
     class WiredTigerCheckpointThread;
+    class WiredTigerTicketTunerThread;
 
     Status _salvageIfNeeded(const char* uri);
     void _checkIdentPath(StringData ident);
@@ -329,6 +334,7 @@ private:
     bool _readOnly;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerTicketTunerThread> _ticketTunerThread;
 
     std::string _rsOptions;
     std::string _indexOptions;
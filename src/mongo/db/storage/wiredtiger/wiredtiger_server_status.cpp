@@ -78,6 +78,8 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
 
     WiredTigerKVEngine::appendGlobalStats(bob);
 
+    _engine->getSessionCache()->appendStats(bob);
+
     WiredTigerUtil::appendSnapshotWindowSettings(_engine, session, &bob);
 
     return bob.obj();
@@ -35,7 +35,10 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
+
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/server_parameters.h"
@@ -184,11 +187,35 @@ uint64_t WiredTigerSession::genTableId() {
 
 // -----------------------
 
+namespace {
+
+// Upper bound on the number of session cache partitions, regardless of the number of cores.
+const size_t kMaxSessionCachePartitions = 64;
+
+// Hands out home partitions to threads in turn, so that threads are spread evenly across them.
+AtomicUInt32 nextHomePartition;
+
+size_t numSessionCachePartitions() {
+    return std::max(size_t(1),
+                    std::min(size_t(stdx::thread::hardware_concurrency()),
+                             kMaxSessionCachePartitions));
+}
+
+}  // namespace
+
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
-    : _engine(engine), _conn(engine->getConnection()), _shuttingDown(0) {}
+    : WiredTigerSessionCache(engine->getConnection()) {
+    _engine = engine;
+}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn)
-    : _engine(NULL), _conn(conn), _shuttingDown(0) {}
+    : _engine(NULL), _conn(conn), _shuttingDown(0) {
+    const size_t numPartitions = numSessionCachePartitions();
+    _partitions.reserve(numPartitions);
+    for (size_t i = 0; i < numPartitions; ++i) {
+        _partitions.push_back(stdx::make_unique<Partition>());
+    }
+}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
@@ -308,9 +335,11 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition->mutex);
+        for (auto&& session : partition->sessions) {
+            session->closeAllCursors(uri);
+        }
     }
 }
 
@@ -318,24 +347,31 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition->mutex);
+        for (auto&& session : partition->sessions) {
+            session->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. This happens before
+    // emptying the partitions, so that a session released into a partition after it has been
+    // emptied sees the new epoch under the partition lock and is deleted rather than cached.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
-    }
+    for (auto&& partition : _partitions) {
+        std::vector<WiredTigerSession*> swap;
+        {
+            stdx::lock_guard<stdx::mutex> lock(partition->mutex);
+            partition->sessions.swap(swap);
+            partition->numCached.store(0);
+        }
 
-    for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
-        delete (*i);
+        for (auto&& session : swap) {
+            delete session;
+        }
     }
 }
 
@@ -348,17 +384,48 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
+    Partition& home = _homePartition();
     {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
+        stdx::unique_lock<stdx::mutex> lock(home.mutex, stdx::try_to_lock);
+        if (!lock.owns_lock()) {
+            lock.lock();
+            home.contended.fetchAndAdd(1);
+        }
+
+        if (!home.sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+            WiredTigerSession* cachedSession = home.sessions.back();
+            home.sessions.pop_back();
+            home.numCached.subtractAndFetch(1);
+            home.hits.fetchAndAdd(1);
             return UniqueWiredTigerSession(cachedSession);
         }
     }
 
+    // The home partition is empty, so take a session from another partition rather than create
+    // one. Partitions which look empty or are busy are skipped rather than waited for.
+    for (auto&& partition : _partitions) {
+        if (partition.get() == &home || partition->numCached.load() == 0) {
+            continue;
+        }
+
+        stdx::unique_lock<stdx::mutex> lock(partition->mutex, stdx::try_to_lock);
+        if (!lock.owns_lock() || partition->sessions.empty()) {
+            continue;
+        }
+
+        WiredTigerSession* cachedSession = partition->sessions.back();
+        partition->sessions.pop_back();
+        partition->numCached.subtractAndFetch(1);
+        lock.unlock();
+
+        home.steals.fetchAndAdd(1);
+        return UniqueWiredTigerSession(cachedSession);
+    }
+
+    home.misses.fetchAndAdd(1);
+
     // Outside of the cache partition lock, but on release will be put back on the cache
     return UniqueWiredTigerSession(
         new WiredTigerSession(_conn, this, _epoch.load(), _cursorEpoch.load()));
@@ -413,10 +480,12 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->dropQueuedIdentsAtSessionEndAllowed(true);
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        Partition& home = _homePartition();
+        stdx::lock_guard<stdx::mutex> lock(home.mutex);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            home.sessions.push_back(session);
+            home.numCached.addAndFetch(1);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -429,6 +498,36 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
 }
 
 
+WiredTigerSessionCache::Partition& WiredTigerSessionCache::_homePartition() {
+    // Threads keep their home partition for their lifetime, so that an operation usually gets
+    // back a session whose cursors its thread has recently used.
+    static thread_local uint32_t homePartition = nextHomePartition.fetchAndAdd(1);
+    return *_partitions[homePartition % _partitions.size()];
+}
+
+void WiredTigerSessionCache::appendStats(BSONObjBuilder& builder) const {
+    long long cachedSessions = 0;
+    long long hits = 0;
+    long long steals = 0;
+    long long misses = 0;
+    long long contended = 0;
+    for (auto&& partition : _partitions) {
+        cachedSessions += partition->numCached.load();
+        hits += partition->hits.load();
+        steals += partition->steals.load();
+        misses += partition->misses.load();
+        contended += partition->contended.load();
+    }
+
+    BSONObjBuilder sub(builder.subobjStart("sessionCache"));
+    sub.append("partitions", static_cast<int>(_partitions.size()));
+    sub.append("cachedSessions", cachedSessions);
+    sub.append("hits", hits);
+    sub.append("steals", steals);
+    sub.append("misses", misses);
+    sub.append("contendedAcquisitions", contended);
+}
+
 void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
     _journalListener = jl;
@@ -32,7 +32,9 @@
 #pragma once
 
 #include <list>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
@@ -44,6 +46,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -152,6 +155,11 @@ private:
 /**
  *  This cache implements a shared pool of WiredTiger sessions with the goal to amortize the
  *  cost of session creation and destruction over multiple uses.
+ *
+ *  The pool is split into partitions, each with its own lock. A thread always starts from the
+ *  same partition, so that it tends to get back a session whose cached cursors it has used
+ *  before, and threads on different partitions do not contend with each other. A thread whose
+ *  partition is empty takes a session from another partition before creating a new one.
  */
 class WiredTigerSessionCache {
 public:
@@ -252,7 +260,41 @@ public:
         return _engine;
     }
 
+    /**
+     * Appends the number of cached sessions and counters describing how sessions were obtained
+     * from the cache to 'builder'.
+     */
+    void appendStats(BSONObjBuilder& builder) const;
+
 private:
+    /**
+     * One shard of the pool of cached sessions, along with counters of how its sessions were
+     * obtained. 'sessions' is guarded by 'mutex'. The counters are atomic and are updated and read
+     * without holding 'mutex', since steals and misses are counted against the home partition
+     * while another partition's mutex, or none, is held.
+     */
+    struct Partition {
+        stdx::mutex mutex;
+        std::vector<WiredTigerSession*> sessions;
+
+        // The number of sessions in 'sessions', readable without holding 'mutex'.
+        AtomicUInt32 numCached;
+
+        // Sessions obtained from this partition by the threads which start from it.
+        AtomicUInt64 hits;
+        // Sessions obtained from other partitions by the threads which start from this one.
+        AtomicUInt64 steals;
+        // Sessions created because no partition had one to spare.
+        AtomicUInt64 misses;
+        // Times a thread found this partition's mutex already held when getting a session.
+        AtomicUInt64 contended;
+    };
+
+    /**
+     * Returns the partition that the calling thread gets sessions from first.
+     */
+    Partition& _homePartition();
+
     WiredTigerKVEngine* _engine;  // not owned, might be NULL
     WT_CONNECTION* _conn;         // not owned
     WiredTigerSnapshotManager _snapshotManager;
@@ -263,15 +305,14 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
-    typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+    // Allocated separately so that the mutexes of different partitions do not share cache lines.
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
     // Bumped when all open sessions need to be closed
-    AtomicUInt64 _epoch;  // atomic so we can check it outside of the lock
+    AtomicUInt64 _epoch;  // atomic so we can check it outside of the partition locks
 
     // Bumped when all open cursors need to be closed
-    AtomicUInt64 _cursorEpoch;  // atomic so we can check it outside of the lock
+    AtomicUInt64 _cursorEpoch;  // atomic so we can check it outside of the partition locks
 
     // Counter and critical section mutex for waitUntilDurable
     AtomicUInt32 _lastSyncTime;
@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class WiredTigerConnection {
+public:
+    WiredTigerConnection(StringData dbpath) : _conn(NULL) {
+        int ret = wiredtiger_open(dbpath.toString().c_str(), NULL, "create,", &_conn);
+        ASSERT_OK(wtRCToStatus(ret));
+        ASSERT(_conn);
+    }
+    ~WiredTigerConnection() {
+        _conn->close(_conn, NULL);
+    }
+    WT_CONNECTION* getConnection() const {
+        return _conn;
+    }
+
+private:
+    WT_CONNECTION* _conn;
+};
+
+class WiredTigerSessionCacheTest : public mongo::unittest::Test {
+public:
+    WiredTigerSessionCacheTest()
+        : _dbpath("wt_test"),
+          _connection(_dbpath.path()),
+          _sessionCache(_connection.getConnection()) {}
+
+protected:
+    WiredTigerSessionCache* getSessionCache() {
+        return &_sessionCache;
+    }
+
+    BSONObj getStats() {
+        BSONObjBuilder builder;
+        _sessionCache.appendStats(builder);
+        return builder.obj().getObjectField("sessionCache").getOwned();
+    }
+
+private:
+    unittest::TempDir _dbpath;
+    WiredTigerConnection _connection;
+    WiredTigerSessionCache _sessionCache;
+};
+
+TEST_F(WiredTigerSessionCacheTest, ReleasedSessionIsReusedBySameThread) {
+    WiredTigerSession* first;
+    {
+        UniqueWiredTigerSession session = getSessionCache()->getSession();
+        first = session.get();
+    }
+    ASSERT_EQ(1, getStats()["cachedSessions"].numberLong());
+    ASSERT_EQ(1, getStats()["misses"].numberLong());
+
+    UniqueWiredTigerSession session = getSessionCache()->getSession();
+    ASSERT_EQ(first, session.get());
+
+    BSONObj stats = getStats();
+    ASSERT_EQ(0, stats["cachedSessions"].numberLong());
+    ASSERT_EQ(1, stats["hits"].numberLong());
+    ASSERT_EQ(1, stats["misses"].numberLong());
+}
+
+TEST_F(WiredTigerSessionCacheTest, SessionCachedByAnotherThreadIsNotRecreated) {
+    WiredTigerSession* cached;
+    stdx::thread([&] {
+        UniqueWiredTigerSession session = getSessionCache()->getSession();
+        cached = session.get();
+    }).join();
+
+    // This thread either shares the home partition of the other thread or takes the session from
+    // it. Either way, no new session is created.
+    UniqueWiredTigerSession session = getSessionCache()->getSession();
+    ASSERT_EQ(cached, session.get());
+
+    BSONObj stats = getStats();
+    ASSERT_EQ(1, stats["misses"].numberLong());
+    ASSERT_EQ(1, stats["hits"].numberLong() + stats["steals"].numberLong());
+}
+
+TEST_F(WiredTigerSessionCacheTest, CloseAllEmptiesEveryPartition) {
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            UniqueWiredTigerSession first = getSessionCache()->getSession();
+            UniqueWiredTigerSession second = getSessionCache()->getSession();
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_GT(getStats()["cachedSessions"].numberLong(), 0);
+
+    UniqueWiredTigerSession outstanding = getSessionCache()->getSession();
+    getSessionCache()->closeAll();
+    ASSERT_EQ(0, getStats()["cachedSessions"].numberLong());
+
+    // A session from before closeAll() is not cached when it is released.
+    outstanding.reset();
+    ASSERT_EQ(0, getStats()["cachedSessions"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,88 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+namespace mongo {
+
+/**
+ * Chooses the number of concurrent transactions of one kind, reads or writes, that WiredTiger
+ * admits, from samples of the throughput of the admitted operations and of the pressure on the
+ * cache taken at regular intervals.
+ *
+ * While the cache is under pressure the number of tickets is cut by a quarter each interval, since
+ * more concurrent transactions only make application threads do more eviction. Otherwise, while
+ * nearly every ticket is in use, the number of tickets grows by an eighth each interval for as
+ * long as doing so does not reduce throughput. An increase that is followed by a drop in
+ * throughput is undone.
+ */
+class WiredTigerTicketTuner {
+public:
+    struct Sample {
+        // The number of tickets released since the previous sample.
+        long long numReleased = 0;
+
+        // The number of tickets in use when the sample was taken.
+        int used = 0;
+
+        // Whether the cache was under pressure since the previous sample.
+        bool cacheUnderPressure = false;
+    };
+
+    // An increase is undone if throughput in the following interval falls below this fraction of
+    // the throughput before it.
+    static constexpr double kThroughputDropRatio = 0.95;
+
+    WiredTigerTicketTuner(int minTickets, int maxTickets);
+
+    /**
+     * Returns the number of tickets to use for the next interval, given that 'current' tickets
+     * were in use during the interval described by 'sample'.
+     */
+    int nextTicketCount(int current, const Sample& sample);
+
+    int getMinTickets() const {
+        return _minTickets;
+    }
+
+    int getMaxTickets() const {
+        return _maxTickets;
+    }
+
+private:
+    const int _minTickets;
+    const int _maxTickets;
+
+    // The size of the last increase, or 0 if the last interval did not increase the tickets.
+    int _lastIncrease = 0;
+
+    // The throughput of the interval before the last one.
+    long long _lastNumReleased = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_tuner.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+WiredTigerTicketTuner::Sample makeSample(long long numReleased, int used, bool pressure = false) {
+    WiredTigerTicketTuner::Sample sample;
+    sample.numReleased = numReleased;
+    sample.used = used;
+    sample.cacheUnderPressure = pressure;
+    return sample;
+}
+
+TEST(WiredTigerTicketTunerTest, HoldsWhileTicketsAreNotSaturated) {
+    WiredTigerTicketTuner tuner(16, 512);
+    ASSERT_EQ(128, tuner.nextTicketCount(128, makeSample(1000, 10)));
+    ASSERT_EQ(128, tuner.nextTicketCount(128, makeSample(2000, 100)));
+}
+
+TEST(WiredTigerTicketTunerTest, GrowsWhileSaturatedAndThroughputHolds) {
+    WiredTigerTicketTuner tuner(16, 512);
+    ASSERT_EQ(144, tuner.nextTicketCount(128, makeSample(1000, 128)));
+    ASSERT_EQ(162, tuner.nextTicketCount(144, makeSample(1100, 140)));
+    ASSERT_EQ(182, tuner.nextTicketCount(162, makeSample(1100, 162)));
+}
+
+TEST(WiredTigerTicketTunerTest, UndoesIncreaseWhenThroughputDrops) {
+    WiredTigerTicketTuner tuner(16, 512);
+    ASSERT_EQ(144, tuner.nextTicketCount(128, makeSample(1000, 128)));
+    ASSERT_EQ(128, tuner.nextTicketCount(144, makeSample(900, 144)));
+
+    // Only the increase is undone; a later saturated interval may probe upwards again.
+    ASSERT_EQ(144, tuner.nextTicketCount(128, makeSample(900, 128)));
+}
+
+TEST(WiredTigerTicketTunerTest, BacksOffUnderCachePressure) {
+    WiredTigerTicketTuner tuner(16, 512);
+    ASSERT_EQ(96, tuner.nextTicketCount(128, makeSample(1000, 128, true)));
+    ASSERT_EQ(72, tuner.nextTicketCount(96, makeSample(1000, 96, true)));
+    ASSERT_EQ(54, tuner.nextTicketCount(72, makeSample(1000, 72, true)));
+
+    // Once the pressure is gone, saturated tickets grow gradually.
+    ASSERT_EQ(60, tuner.nextTicketCount(54, makeSample(1000, 54)));
+}
+
+TEST(WiredTigerTicketTunerTest, StaysWithinBounds) {
+    WiredTigerTicketTuner tuner(16, 150);
+    ASSERT_EQ(16, tuner.nextTicketCount(18, makeSample(1000, 18, true)));
+    ASSERT_EQ(16, tuner.nextTicketCount(16, makeSample(1000, 16, true)));
+    ASSERT_EQ(150, tuner.nextTicketCount(140, makeSample(1000, 140)));
+    ASSERT_EQ(150, tuner.nextTicketCount(150, makeSample(1000, 150)));
+
+    // A current value outside of the bounds, as set by the user, is brought back within them.
+    ASSERT_EQ(150, tuner.nextTicketCount(400, makeSample(1000, 0)));
+}
+
+}  // namespace
+}  // namespace mongo
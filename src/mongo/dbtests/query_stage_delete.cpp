@@ -188,6 +188,83 @@ public:
     }
 };
 
+//
+// Test that a multi delete with a batch size deletes the documents returned by its child in
+// batches, and skips a document in the batch being gathered which is invalidated.
+//
+class QueryStageDeleteBatched : public QueryStageDeleteBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, nss.ns());
+
+        Collection* coll = ctx.getCollection();
+
+        // Get the RecordIds that would be returned by an in-order scan.
+        vector<RecordId> recordIds;
+        getRecordIds(coll, CollectionScanParams::FORWARD, &recordIds);
+
+        // Configure the scan.
+        CollectionScanParams collScanParams;
+        collScanParams.collection = coll;
+        collScanParams.direction = CollectionScanParams::FORWARD;
+        collScanParams.tailable = false;
+
+        // Configure the delete stage.
+        const size_t batchSize = 8;
+        DeleteStageParams deleteStageParams;
+        deleteStageParams.isMulti = true;
+        deleteStageParams.batchSize = batchSize;
+
+        WorkingSet ws;
+        DeleteStage deleteStage(&_opCtx,
+                                deleteStageParams,
+                                &ws,
+                                coll,
+                                new CollectionScan(&_opCtx, collScanParams, &ws, NULL));
+
+        const DeleteStats* stats = static_cast<const DeleteStats*>(deleteStage.getSpecificStats());
+
+        // Nothing is deleted until a whole batch has been gathered.
+        while (stats->docsDeleted < batchSize) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = deleteStage.work(&id);
+            ASSERT_EQUALS(PlanStage::NEED_TIME, state);
+            ASSERT(stats->docsDeleted == 0 || stats->docsDeleted == batchSize);
+        }
+
+        // Gather the next three documents into the batch.
+        for (size_t i = 0; i < 3; ++i) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            ASSERT_EQUALS(PlanStage::NEED_TIME, deleteStage.work(&id));
+        }
+        ASSERT_EQUALS(batchSize, stats->docsDeleted);
+
+        // Remove recordIds[batchSize + 1], which is now held in the batch.
+        const size_t targetDocIndex = batchSize + 1;
+        deleteStage.saveState();
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            deleteStage.invalidate(&_opCtx, recordIds[targetDocIndex], INVALIDATION_DELETION);
+            wunit.commit();
+        }
+        BSONObj targetDoc = coll->docFor(&_opCtx, recordIds[targetDocIndex]).value();
+        ASSERT(!targetDoc.isEmpty());
+        remove(targetDoc);
+        deleteStage.restoreState();
+
+        // Remove the rest.
+        while (!deleteStage.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = deleteStage.work(&id);
+            invariant(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+        }
+
+        ASSERT_EQUALS(numObj() - 1, stats->docsDeleted);
+        ASSERT_EQUALS(1U, stats->nInvalidateSkips);
+        ASSERT_EQUALS(0U, coll->numRecords(&_opCtx));
+    }
+};
+
 /**
  * Test that the delete stage returns an owned copy of the original document if returnDeleted is
  * specified.
@@ -312,6 +389,7 @@ public:
     void setupTests() {
         // Stage-specific tests below.
         add<QueryStageDeleteInvalidateUpcomingObject>();
+        add<QueryStageDeleteBatched>();
         add<QueryStageDeleteReturnOldDoc>();
         add<QueryStageDeleteSkipOwnedObjects>();
     }
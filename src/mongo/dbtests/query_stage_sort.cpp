@@ -41,8 +41,10 @@
 #include "mongo/db/exec/sort.h"
 #include "mongo/db/json.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/scopeguard.h"
 
 /**
  * This file tests db/exec/sort.cpp
@@ -157,6 +159,7 @@ public:
         params.collection = coll;
         params.pattern = BSON("foo" << direction);
         params.limit = limit();
+        params.allowDiskUse = allowDiskUse();
 
         auto keyGenStage = make_unique<SortKeyGeneratorStage>(
             &_opCtx, queuedDataStage.release(), ws.get(), params.pattern, nullptr);
@@ -193,6 +196,14 @@ public:
         }
         ASSERT_EQUALS(PlanExecutor::IS_EOF, state);
         checkCount(count);
+
+        // If external sorting was allowed, the tests below make sure the buffered data exceeds
+        // the memory limit, so the sort must have spilled.
+        if (allowDiskUse()) {
+            const SortStats* sortStats = static_cast<const SortStats*>(
+                exec->getRootStage()->getChildren()[0]->getSpecificStats());
+            ASSERT(sortStats->usedDisk);
+        }
     }
 
     /**
@@ -216,6 +227,11 @@ public:
         return 0;
     };
 
+    // Returns whether the sort stage may spill to disk.
+    virtual bool allowDiskUse() const {
+        return false;
+    }
+
 
     static const char* ns() {
         return "unittests.QueryStageSort";
@@ -303,6 +319,31 @@ public:
     }
 };
 
+// Sort a big bunch of objects using more memory than allowed, spilling to disk.
+class QueryStageSortExtSpill : public QueryStageSortExt {
+public:
+    bool allowDiskUse() const override {
+        return true;
+    }
+
+    void run() {
+        const int oldMaxBlockingSortBytes = internalQueryExecMaxBlockingSortBytes.load();
+        internalQueryExecMaxBlockingSortBytes.store(64 * 1024);
+        ON_BLOCK_EXIT(
+            [&] { internalQueryExecMaxBlockingSortBytes.store(oldMaxBlockingSortBytes); });
+
+        QueryStageSortExt::run();
+    }
+};
+
+// Spill to disk with a limit too large to satisfy from memory.
+class QueryStageSortExtSpillWithLimit : public QueryStageSortExtSpill {
+public:
+    int limit() const override {
+        return 2000;
+    }
+};
+
 // Mutation invalidation of docs fed to sort.
 class QueryStageSortMutationInvalidation : public QueryStageSortTestBase {
 public:
@@ -590,6 +631,8 @@ public:
         // and a special case for limit == 1
         add<QueryStageSortDecWithLimit<1>>();
         add<QueryStageSortExt>();
+        add<QueryStageSortExtSpill>();
+        add<QueryStageSortExtSpillWithLimit>();
         add<QueryStageSortMutationInvalidation>();
         add<QueryStageSortDeletionInvalidation>();
         add<QueryStageSortDeletionInvalidationWithLimit<10>>();
@@ -360,6 +360,135 @@ public:
     }
 };
 
+/**
+ * Test that a multi-update with a batch size updates the documents returned by its child in
+ * batches, and skips a document in the batch being gathered which is invalidated.
+ */
+class QueryStageUpdateBatched : public QueryStageUpdateBase {
+public:
+    void run() {
+        // Run the update.
+        {
+            OldClientWriteContext ctx(&_opCtx, nss.ns());
+
+            // Populate the collection.
+            for (int i = 0; i < 10; ++i) {
+                insert(BSON("_id" << i << "foo" << i));
+            }
+            ASSERT_EQUALS(10U, count(BSONObj()));
+
+            CurOp& curOp = *CurOp::get(_opCtx);
+            OpDebug* opDebug = &curOp.debug();
+            const CollatorInterface* collator = nullptr;
+            UpdateDriver driver(new ExpressionContext(&_opCtx, collator));
+            Database* db = ctx.db();
+            Collection* coll = db->getCollection(&_opCtx, nss);
+
+            // Get the RecordIds that would be returned by an in-order scan.
+            vector<RecordId> recordIds;
+            getRecordIds(coll, CollectionScanParams::FORWARD, &recordIds);
+
+            UpdateRequest request(nss);
+            UpdateLifecycleImpl updateLifecycle(nss);
+            request.setLifecycle(&updateLifecycle);
+
+            // Update is a multi-update that sets 'bar' to 3 in every document
+            // where foo is less than 8.
+            BSONObj query = fromjson("{foo: {$lt: 8}}");
+            BSONObj updates = fromjson("{$set: {bar: 3}}");
+
+            request.setMulti();
+            request.setQuery(query);
+            request.setUpdates(updates);
+
+            const std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+
+            ASSERT_OK(driver.parse(request.getUpdates(), arrayFilters, request.isMulti()));
+
+            // Configure the scan.
+            CollectionScanParams collScanParams;
+            collScanParams.collection = coll;
+            collScanParams.direction = CollectionScanParams::FORWARD;
+            collScanParams.tailable = false;
+
+            // Configure the update.
+            const size_t batchSize = 3;
+            UpdateStageParams updateParams(&request, &driver, opDebug);
+            unique_ptr<CanonicalQuery> cq(canonicalize(query));
+            updateParams.canonicalQuery = cq.get();
+            updateParams.batchSize = batchSize;
+
+            auto ws = make_unique<WorkingSet>();
+            auto cs = make_unique<CollectionScan>(&_opCtx, collScanParams, ws.get(), cq->root());
+
+            auto updateStage =
+                make_unique<UpdateStage>(&_opCtx, updateParams, ws.get(), coll, cs.release());
+
+            const UpdateStats* stats =
+                static_cast<const UpdateStats*>(updateStage->getSpecificStats());
+
+            // Nothing is updated until a whole batch has been gathered.
+            while (stats->nModified < batchSize) {
+                WorkingSetID id = WorkingSet::INVALID_ID;
+                PlanStage::StageState state = updateStage->work(&id);
+                ASSERT_EQUALS(PlanStage::NEED_TIME, state);
+                ASSERT(stats->nModified == 0 || stats->nModified == batchSize);
+            }
+
+            // Gather the next two documents into the batch.
+            for (size_t i = 0; i < 2; ++i) {
+                WorkingSetID id = WorkingSet::INVALID_ID;
+                ASSERT_EQUALS(PlanStage::NEED_TIME, updateStage->work(&id));
+            }
+            ASSERT_EQUALS(batchSize, stats->nModified);
+
+            // Remove recordIds[targetDocIndex], which is now held in the batch.
+            const size_t targetDocIndex = 4;
+            updateStage->saveState();
+            {
+                WriteUnitOfWork wunit(&_opCtx);
+                updateStage->invalidate(&_opCtx, recordIds[targetDocIndex], INVALIDATION_DELETION);
+                wunit.commit();
+            }
+            BSONObj targetDoc = coll->docFor(&_opCtx, recordIds[targetDocIndex]).value();
+            ASSERT(!targetDoc.isEmpty());
+            remove(targetDoc);
+            updateStage->restoreState();
+
+            // Do the remaining updates.
+            while (!updateStage->isEOF()) {
+                WorkingSetID id = WorkingSet::INVALID_ID;
+                PlanStage::StageState state = updateStage->work(&id);
+                ASSERT(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+            }
+
+            // 7 of the 8 matching documents should have been modified (one was deleted).
+            ASSERT_EQUALS(7U, stats->nModified);
+            ASSERT_EQUALS(7U, stats->nMatched);
+            ASSERT_EQUALS(1U, stats->nInvalidateSkips);
+        }
+
+        // Check the contents of the collection.
+        {
+            AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+            Collection* collection = ctx.getCollection();
+
+            vector<BSONObj> objs;
+            getCollContents(collection, &objs);
+
+            // Verify that the collection now has 9 docs (one was deleted).
+            ASSERT_EQUALS(9U, objs.size());
+
+            assertHasDoc(objs, fromjson("{_id: 0, foo: 0, bar: 3}"));
+            assertHasDoc(objs, fromjson("{_id: 3, foo: 3, bar: 3}"));
+            assertHasDoc(objs, fromjson("{_id: 5, foo: 5, bar: 3}"));
+            assertHasDoc(objs, fromjson("{_id: 7, foo: 7, bar: 3}"));
+            assertHasDoc(objs, fromjson("{_id: 8, foo: 8}"));
+            assertHasDoc(objs, fromjson("{_id: 9, foo: 9}"));
+        }
+    }
+};
+
 /**
  * Test that the update stage returns an owned copy of the original document if
  * ReturnDocOption::RETURN_OLD is specified.
@@ -614,6 +743,7 @@ public:
         // Stage-specific tests below.
         add<QueryStageUpdateUpsertEmptyColl>();
         add<QueryStageUpdateSkipInvalidatedDoc>();
+        add<QueryStageUpdateBatched>();
         add<QueryStageUpdateReturnOldDoc>();
         add<QueryStageUpdateReturnNewDoc>();
         add<QueryStageUpdateSkipOwnedObjects>();
@@ -43,7 +43,7 @@
 #include "mongo/util/scopeguard.h"
 
 // One interesting implementation note herein concerns how setup() and
-// refresh() are invoked outside of the global lock, but setTimeout is not.
+// refresh() are invoked outside of the specific pool's lock, but setTimeout is not.
 // This implementation detail simplifies mocks, allowing them to return
 // synchronously sometimes, whereas having timeouts fire instantly adds little
 // value. In practice, dumping the locks is always safe (because we restrict
@@ -68,7 +68,7 @@ public:
      *
      * The complexity comes from the need to hold a lock when writing to the
      * _activeClients param on the specific pool.  Because the code beneath the client needs to lock
-     * and unlock the parent mutex (and can leave unlocked), we want to start the client with the
+     * and unlock the pool's mutex (and can leave unlocked), we want to start the client with the
      * lock acquired, move it into the client, then re-acquire to decrement the counter on the way
      * out.
      *
@@ -78,8 +78,7 @@ public:
      */
     template <typename Callback>
     auto runWithActiveClient(Callback&& cb) {
-        return runWithActiveClient(stdx::unique_lock<stdx::mutex>(_parent->_mutex),
-                                   std::forward<Callback>(cb));
+        return runWithActiveClient(lockPool(), std::forward<Callback>(cb));
     }
 
     template <typename Callback>
@@ -90,7 +89,7 @@ public:
 
         const auto guard = MakeGuard([&] {
             invariant(!lk.owns_lock());
-            stdx::lock_guard<stdx::mutex> lk(_parent->_mutex);
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
             _activeClients--;
         });
 
@@ -104,8 +103,18 @@ public:
     ~SpecificPool();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Acquires the mutex guarding this pool.
+     */
+    stdx::unique_lock<stdx::mutex> lockPool() {
+        return stdx::unique_lock<stdx::mutex>(_mutex);
+    }
+
+    /**
+     * Gets a connection from the specific pool. Sinks a unique_lock on _mutex
+     * to preserve the lock.
+     *
+     * If no other request is waiting and a ready connection is available, the
+     * connection is returned in a ready future without queueing a request.
      */
     Future<ConnectionHandle> getConnection(const HostAndPort& hostAndPort,
                                            Milliseconds timeout,
@@ -119,8 +128,8 @@ public:
     void processFailure(const Status& status, stdx::unique_lock<stdx::mutex> lk);
 
     /**
-     * Returns a connection to a specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Returns a connection to a specific pool. Sinks a unique_lock on _mutex
+     * to preserve the lock.
      */
     void returnConnection(ConnectionInterface* connection, stdx::unique_lock<stdx::mutex> lk);
 
@@ -151,6 +160,21 @@ public:
      */
     size_t openConnections(const stdx::unique_lock<stdx::mutex>& lk);
 
+    /**
+     * Returns the histogram of the number of requests already waiting when
+     * each request arrived.
+     */
+    const ConnectionPoolHistogram& queueDepth(const stdx::unique_lock<stdx::mutex>& lk) const {
+        return _queueDepth;
+    }
+
+    /**
+     * Returns the histogram of the time requests waited for a connection.
+     */
+    const ConnectionPoolHistogram& waitTimeMillis(const stdx::unique_lock<stdx::mutex>& lk) const {
+        return _waitTimeMillis;
+    }
+
     /**
      * Return true if the tags on the specific pool match the passed in tags
      */
@@ -184,15 +208,32 @@ private:
     using OwnedConnection = std::shared_ptr<ConnectionInterface>;
     using OwnershipPool = stdx::unordered_map<ConnectionInterface*, OwnedConnection>;
     using LRUOwnershipPool = LRUCache<OwnershipPool::key_type, OwnershipPool::mapped_type>;
-    using Request = std::pair<Date_t, SharedPromise<ConnectionHandle>>;
+    struct Request {
+        Date_t expiration;
+        Date_t enqueued;
+        SharedPromise<ConnectionHandle> promise;
+    };
     struct RequestComparator {
         bool operator()(const Request& a, const Request& b) {
-            return a.first > b.first;
+            return a.expiration > b.expiration;
         }
     };
 
     void addToReady(stdx::unique_lock<stdx::mutex>& lk, OwnedConnection conn);
 
+    /**
+     * Takes the most recently used healthy connection out of the ready pool,
+     * dropping any unhealthy connections ahead of it. Returns nullptr if there
+     * is none.
+     */
+    OwnedConnection takeReadyConnection(stdx::unique_lock<stdx::mutex>& lk);
+
+    /**
+     * Checks out a connection taken from the ready pool and wraps it in a
+     * handle for the user.
+     */
+    ConnectionHandle checkOut(stdx::unique_lock<stdx::mutex>& lk, OwnedConnection conn);
+
     void fulfillRequests(stdx::unique_lock<stdx::mutex>& lk);
 
     void spawnConnections(stdx::unique_lock<stdx::mutex>& lk);
@@ -212,6 +253,9 @@ private:
 
     const HostAndPort _hostAndPort;
 
+    // Guards all of the state below.
+    stdx::mutex _mutex;
+
     LRUOwnershipPool _readyPool;
     OwnershipPool _processingPool;
     OwnershipPool _droppedProcessingPool;
@@ -228,6 +272,9 @@ private:
 
     size_t _created;
 
+    ConnectionPoolHistogram _queueDepth;
+    ConnectionPoolHistogram _waitTimeMillis;
+
     transport::Session::TagMask _tags = transport::Session::kPending;
 
     /**
@@ -294,43 +341,42 @@ void ConnectionPool::shutdown() {
     // Ensure we decrement active clients for all pools that we inc on (because we intend to process
     // failures)
     const auto guard = MakeGuard([&] {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
-
         for (const auto& pool : pools) {
-            pool->decActiveClients(lk);
+            pool->decActiveClients(pool->lockPool());
         }
     });
 
-    // Grab all current pools (under the lock)
+    // Grab all current pools (under the partition locks)
     {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        auto all = _pools.lockAllPartitions();
 
-        for (auto& pair : _pools) {
-            pools.push_back(pair.second.get());
-            pair.second->incActiveClients(lk);
+        for (auto& partition : all) {
+            for (auto& pair : partition) {
+                pools.push_back(pair.second.get());
+                pair.second->incActiveClients(pair.second->lockPool());
+            }
         }
     }
 
     // Reacquire the lock per pool and process failures.  We'll dec active clients when we're all
     // through in the guard
     for (const auto& pool : pools) {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
         pool->processFailure(
             Status(ErrorCodes::ShutdownInProgress, "Shutting down the connection pool"),
-            std::move(lk));
+            pool->lockPool());
     }
 }
 
 void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    stdx::unique_lock<stdx::mutex> lk;
 
-    auto iter = _pools.find(hostAndPort);
+    auto pool = findAndLockPool(hostAndPort, &lk);
 
-    if (iter == _pools.end())
+    if (!pool)
         return;
 
-    iter->second->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
-        iter->second->processFailure(
+    pool->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
+        pool->processFailure(
             Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"),
             std::move(lk));
     });
@@ -342,21 +388,22 @@ void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
     // Ensure we decrement active clients for all pools that we inc on (because we intend to process
     // failures)
     const auto guard = MakeGuard([&] {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
-
         for (const auto& pool : pools) {
-            pool->decActiveClients(lk);
+            pool->decActiveClients(pool->lockPool());
         }
     });
 
-    // Grab all current pools that don't match tags (under the lock)
+    // Grab all current pools that don't match tags (under the partition locks)
     {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-        for (auto& pair : _pools) {
-            if (!pair.second->matchesTags(lk, tags)) {
-                pools.push_back(pair.second.get());
-                pair.second->incActiveClients(lk);
+        auto all = _pools.lockAllPartitions();
+
+        for (auto& partition : all) {
+            for (auto& pair : partition) {
+                auto lk = pair.second->lockPool();
+                if (!pair.second->matchesTags(lk, tags)) {
+                    pools.push_back(pair.second.get());
+                    pair.second->incActiveClients(lk);
+                }
             }
         }
     }
@@ -364,24 +411,23 @@ void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
     // Reacquire the lock per pool and process failures.  We'll dec active clients when we're all
     // through in the guard
     for (const auto& pool : pools) {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
         pool->processFailure(
             Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"),
-            std::move(lk));
+            pool->lockPool());
     }
 }
 
 void ConnectionPool::mutateTags(
     const HostAndPort& hostAndPort,
     const stdx::function<transport::Session::TagMask(transport::Session::TagMask)>& mutateFunc) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    stdx::unique_lock<stdx::mutex> lk;
 
-    auto iter = _pools.find(hostAndPort);
+    auto pool = findAndLockPool(hostAndPort, &lk);
 
-    if (iter == _pools.end())
+    if (!pool)
         return;
 
-    iter->second->mutateTags(lk, mutateFunc);
+    pool->mutateTags(lk, mutateFunc);
 }
 
 void ConnectionPool::get(const HostAndPort& hostAndPort,
@@ -394,16 +440,19 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPort&
                                                              Milliseconds timeout) {
     SpecificPool* pool;
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    stdx::unique_lock<stdx::mutex> lk;
+
+    {
+        auto partition = _pools.lockOnePartition(hostAndPort);
 
-    auto iter = _pools.find(hostAndPort);
+        auto& handle = (*partition)[hostAndPort];
+
+        if (!handle) {
+            handle = stdx::make_unique<SpecificPool>(this, hostAndPort);
+        }
 
-    if (iter == _pools.end()) {
-        auto handle = stdx::make_unique<SpecificPool>(this, hostAndPort);
         pool = handle.get();
-        _pools[hostAndPort] = std::move(handle);
-    } else {
-        pool = iter->second.get();
+        lk = pool->lockPool();
     }
 
     invariant(pool);
@@ -414,44 +463,64 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPort&
 }
 
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    for (const auto& kv : _pools) {
-        HostAndPort host = kv.first;
-
-        auto& pool = kv.second;
-        ConnectionStatsPer hostStats{pool->inUseConnections(lk),
-                                     pool->availableConnections(lk),
-                                     pool->createdConnections(lk),
-                                     pool->refreshingConnections(lk)};
-        stats->updateStatsForHost(_name, host, hostStats);
+    auto all = _pools.lockAllPartitions();
+
+    for (const auto& partition : all) {
+        for (const auto& kv : partition) {
+            HostAndPort host = kv.first;
+
+            auto& pool = kv.second;
+            auto lk = pool->lockPool();
+            ConnectionStatsPer hostStats{pool->inUseConnections(lk),
+                                         pool->availableConnections(lk),
+                                         pool->createdConnections(lk),
+                                         pool->refreshingConnections(lk)};
+            hostStats.queueDepth = pool->queueDepth(lk);
+            hostStats.waitTimeMillis = pool->waitTimeMillis(lk);
+            stats->updateStatsForHost(_name, host, hostStats);
+        }
     }
 }
 
 size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    auto iter = _pools.find(hostAndPort);
-    if (iter != _pools.end()) {
-        return iter->second->openConnections(lk);
+    stdx::unique_lock<stdx::mutex> lk;
+    auto pool = findAndLockPool(hostAndPort, &lk);
+    if (pool) {
+        return pool->openConnections(lk);
     }
 
     return 0;
 }
 
 void ConnectionPool::returnConnection(ConnectionInterface* conn) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    stdx::unique_lock<stdx::mutex> lk;
 
-    auto iter = _pools.find(conn->getHostAndPort());
+    auto pool = findAndLockPool(conn->getHostAndPort(), &lk);
 
-    invariant(iter != _pools.end(),
+    invariant(pool,
               str::stream() << "Tried to return connection but no pool found for "
                             << conn->getHostAndPort());
 
-    iter->second->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
-        iter->second->returnConnection(conn, std::move(lk));
+    pool->runWithActiveClient(std::move(lk), [&](decltype(lk) lk) {
+        pool->returnConnection(conn, std::move(lk));
     });
 }
 
+ConnectionPool::SpecificPool* ConnectionPool::findAndLockPool(
+    const HostAndPort& hostAndPort, stdx::unique_lock<stdx::mutex>* lk) const {
+    auto partition = _pools.lockOnePartition(hostAndPort);
+
+    auto iter = partition->find(hostAndPort);
+
+    if (iter == partition->end())
+        return nullptr;
+
+    // The pool cannot be removed from the partition while its lock is held, so it remains valid
+    // once the partition is unlocked.
+    *lk = iter->second->lockPool();
+    return iter->second.get();
+}
+
 ConnectionPool::SpecificPool::SpecificPool(ConnectionPool* parent, const HostAndPort& hostAndPort)
     : _parent(parent),
       _hostAndPort(hostAndPort),
@@ -496,10 +565,21 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
         timeout = _parent->_options.refreshTimeout;
     }
 
-    const auto expiration = _parent->_factory->now() + timeout;
+    _queueDepth.increment(_requests.size());
+
+    // Only hand out a ready connection directly if no one is waiting ahead of us
+    if (_requests.empty()) {
+        if (auto conn = takeReadyConnection(lk)) {
+            _waitTimeMillis.increment(0);
+            return Future<ConnectionHandle>::makeReady(checkOut(lk, std::move(conn)));
+        }
+    }
+
+    const auto now = _parent->_factory->now();
+    const auto expiration = now + timeout;
     auto pf = makePromiseFuture<ConnectionHandle>();
 
-    _requests.push_back(make_pair(expiration, pf.promise.share()));
+    _requests.push_back(Request{expiration, now, pf.promise.share()});
     std::push_heap(begin(_requests), end(_requests), RequestComparator{});
 
     updateStateInLock();
@@ -673,7 +753,7 @@ void ConnectionPool::SpecificPool::processFailure(const Status& status,
     lk.unlock();
 
     for (auto& request : requestsToFail) {
-        request.second.setError(status);
+        request.promise.setError(status);
     }
 }
 
@@ -688,50 +768,74 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
     auto guard = MakeGuard([&] { _inFulfillRequests = false; });
 
     while (_requests.size()) {
-        // _readyPool is an LRUCache, so its begin() object is the MRU item.
-        auto iter = _readyPool.begin();
+        auto conn = takeReadyConnection(lk);
 
-        if (iter == _readyPool.end())
+        if (!conn)
             break;
 
+        // Spawning connections for an unhealthy one may have dropped the lock, and the requests
+        // may have timed out in the meantime
+        if (_requests.empty()) {
+            addToReady(lk, std::move(conn));
+            break;
+        }
+
+        // Grab the request and callback
+        auto promise = std::move(_requests.front().promise);
+        _waitTimeMillis.increment(
+            durationCount<Milliseconds>(_parent->_factory->now() - _requests.front().enqueued));
+        std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
+        _requests.pop_back();
+
+        auto handle = checkOut(lk, std::move(conn));
+
+        // pass it to the user
+        lk.unlock();
+        promise.emplaceValue(std::move(handle));
+        lk.lock();
+    }
+}
+
+ConnectionPool::SpecificPool::OwnedConnection ConnectionPool::SpecificPool::takeReadyConnection(
+    stdx::unique_lock<stdx::mutex>& lk) {
+    while (!_readyPool.empty()) {
+        // _readyPool is an LRUCache, so its begin() object is the MRU item.
+        auto iter = _readyPool.begin();
+
         // Grab the connection and cancel its timeout
         auto conn = std::move(iter->second);
         _readyPool.erase(iter);
         conn->cancelTimeout();
 
-        if (!conn->isHealthy()) {
-            log() << "dropping unhealthy pooled connection to " << conn->getHostAndPort();
+        if (conn->isHealthy()) {
+            return conn;
+        }
 
-            if (_readyPool.empty()) {
-                log() << "after drop, pool was empty, going to spawn some connections";
-                // Spawn some more connections to the bad host if we're all out.
-                spawnConnections(lk);
-            }
+        log() << "dropping unhealthy pooled connection to " << conn->getHostAndPort();
 
-            // Drop the bad connection.
-            conn.reset();
-            // Retry.
-            continue;
+        if (_readyPool.empty()) {
+            log() << "after drop, pool was empty, going to spawn some connections";
+            // Spawn some more connections to the bad host if we're all out.
+            spawnConnections(lk);
         }
 
-        // Grab the request and callback
-        auto promise = std::move(_requests.front().second);
-        std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
-        _requests.pop_back();
+        // Drop the bad connection and retry.
+    }
 
-        auto connPtr = conn.get();
+    return nullptr;
+}
 
-        // check out the connection
-        _checkedOutPool[connPtr] = std::move(conn);
+ConnectionPool::ConnectionHandle ConnectionPool::SpecificPool::checkOut(
+    stdx::unique_lock<stdx::mutex>& lk, OwnedConnection conn) {
+    auto connPtr = conn.get();
 
-        updateStateInLock();
+    // check out the connection
+    _checkedOutPool[connPtr] = std::move(conn);
 
-        // pass it to the user
-        connPtr->resetToUnknown();
-        lk.unlock();
-        promise.emplaceValue(ConnectionHandle(connPtr, ConnectionHandleDeleter(_parent)));
-        lk.lock();
-    }
+    updateStateInLock();
+
+    connPtr->resetToUnknown();
+    return ConnectionHandle(connPtr, ConnectionHandleDeleter(_parent));
 }
 
 // spawn enough connections to satisfy open requests and minpool, while
@@ -803,7 +907,9 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
 
 // Called every second after hostTimeout until all processing connections reap
 void ConnectionPool::SpecificPool::shutdown() {
-    stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+    // Lock our partition first, so that no new client can find this pool while we remove it
+    auto partition = _parent->_pools.lockOnePartition(_hostAndPort);
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     // We're racing:
     //
@@ -837,7 +943,10 @@ void ConnectionPool::SpecificPool::shutdown() {
     invariant(_requests.empty());
     invariant(_checkedOutPool.empty());
 
-    _parent->_pools.erase(_hostAndPort);
+    // Removing the pool destroys its mutex, so release it first. Holding the partition's lock keeps
+    // new clients out in the meantime.
+    lk.unlock();
+    partition->erase(_hostAndPort);
 }
 
 template <typename OwnershipPoolType>
@@ -867,16 +976,16 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
 
         // If we were already running and the timer is the same as it was
         // before, nothing to do
-        if (_state == State::kRunning && _requestTimerExpiration == _requests.front().first)
+        if (_state == State::kRunning && _requestTimerExpiration == _requests.front().expiration)
             return;
 
         _state = State::kRunning;
 
         _requestTimer->cancelTimeout();
 
-        _requestTimerExpiration = _requests.front().first;
+        _requestTimerExpiration = _requests.front().expiration;
 
-        auto timeout = _requests.front().first - _parent->_factory->now();
+        auto timeout = _requests.front().expiration - _parent->_factory->now();
 
         // We set a timer for the most recent request, then invoke each timed
         // out request we couldn't service
@@ -887,8 +996,8 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
                 while (_requests.size()) {
                     auto& x = _requests.front();
 
-                    if (x.first <= now) {
-                        auto promise = std::move(x.second);
+                    if (x.expiration <= now) {
+                        auto promise = std::move(x.promise);
                         std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
                         _requests.pop_back();
 
@@ -31,6 +31,7 @@
 #include <queue>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/db/catalog/util/partitioned.h"
 #include "mongo/executor/egress_tag_closer.h"
 #include "mongo/executor/egress_tag_closer_manager.h"
 #include "mongo/stdx/chrono.h"
@@ -58,6 +59,9 @@ struct ConnectionPoolStats;
  *
  * The overall workflow here is to manage separate pools for each unique
  * HostAndPort. See comments on the various Options for how the pool operates.
+ *
+ * Each specific pool has its own mutex, and the pools are found through a map which is partitioned
+ * by host, so that requests for different hosts rarely contend with each other.
  */
 class ConnectionPool : public EgressTagCloser {
     class SpecificPool;
@@ -155,8 +159,23 @@ public:
     size_t getNumConnectionsPerHost(const HostAndPort& hostAndPort) const;
 
 private:
+    struct HostPartitioner {
+        std::size_t operator()(const HostAndPort& hostAndPort, std::size_t nPartitions) const {
+            return std::hash<HostAndPort>()(hostAndPort) % nPartitions;
+        }
+    };
+
+    using PoolMap = stdx::unordered_map<HostAndPort, std::unique_ptr<SpecificPool>>;
+
     void returnConnection(ConnectionInterface* connection);
 
+    /**
+     * Returns the specific pool for 'hostAndPort' with its mutex held by 'lk', or nullptr if there
+     * is no such pool.
+     */
+    SpecificPool* findAndLockPool(const HostAndPort& hostAndPort,
+                                  stdx::unique_lock<stdx::mutex>* lk) const;
+
     std::string _name;
 
     // Options are set at startup and never changed at run time, so these are
@@ -165,9 +184,10 @@ private:
 
     const std::unique_ptr<DependentTypeFactoryInterface> _factory;
 
-    // The global mutex for specific pool access and the generation counter
-    mutable stdx::mutex _mutex;
-    stdx::unordered_map<HostAndPort, std::unique_ptr<SpecificPool>> _pools;
+    // The specific pools, by host. A partition's mutex guards only which pools are in that
+    // partition; each pool's state is guarded by the pool's own mutex. A pool's mutex may be
+    // acquired while holding its partition's mutex, but never the other way around.
+    mutable Partitioned<PoolMap, 16, HostPartitioner> _pools;
 
     EgressTagCloserManager* _manager;
 };
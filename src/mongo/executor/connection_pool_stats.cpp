@@ -30,12 +30,42 @@
 
 #include "mongo/executor/connection_pool_stats.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/bits.h"
 #include "mongo/util/map_util.h"
 
 namespace mongo {
 namespace executor {
 
+void ConnectionPoolHistogram::increment(uint64_t value) {
+    size_t bucket = 0;
+    if (value > 0) {
+        bucket = std::min<size_t>(64 - countLeadingZeros64(value), kNumBuckets - 1);
+    }
+    buckets[bucket]++;
+}
+
+ConnectionPoolHistogram& ConnectionPoolHistogram::operator+=(const ConnectionPoolHistogram& other) {
+    for (size_t i = 0; i < kNumBuckets; i++) {
+        buckets[i] += other.buckets[i];
+    }
+
+    return *this;
+}
+
+void ConnectionPoolHistogram::appendToBSON(StringData name, BSONObjBuilder* builder) const {
+    BSONObjBuilder histogramBuilder(builder->subobjStart(name));
+    for (size_t i = 0; i < kNumBuckets; i++) {
+        if (buckets[i] == 0)
+            continue;
+        const long long lowerBound = (i == 0) ? 0 : 1LL << (i - 1);
+        histogramBuilder.appendNumber(std::to_string(lowerBound),
+                                      static_cast<long long>(buckets[i]));
+    }
+}
+
 ConnectionStatsPer::ConnectionStatsPer(size_t nInUse,
                                        size_t nAvailable,
                                        size_t nCreated,
@@ -49,6 +79,8 @@ ConnectionStatsPer& ConnectionStatsPer::operator+=(const ConnectionStatsPer& oth
     available += other.available;
     created += other.created;
     refreshing += other.refreshing;
+    queueDepth += other.queueDepth;
+    waitTimeMillis += other.waitTimeMillis;
 
     return *this;
 }
@@ -83,6 +115,8 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             poolInfo.appendNumber("poolAvailable", poolStats.available);
             poolInfo.appendNumber("poolCreated", poolStats.created);
             poolInfo.appendNumber("poolRefreshing", poolStats.refreshing);
+            poolStats.queueDepth.appendToBSON("poolQueueDepth", &poolInfo);
+            poolStats.waitTimeMillis.appendToBSON("poolWaitTimeMillis", &poolInfo);
             for (auto&& host : statsByPoolHost[pool.first]) {
                 BSONObjBuilder hostInfo(poolInfo.subobjStart(host.first.toString()));
                 auto hostStats = host.second;
@@ -90,6 +124,8 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
                 hostInfo.appendNumber("available", hostStats.available);
                 hostInfo.appendNumber("created", hostStats.created);
                 hostInfo.appendNumber("refreshing", hostStats.refreshing);
+                hostStats.queueDepth.appendToBSON("queueDepth", &hostInfo);
+                hostStats.waitTimeMillis.appendToBSON("waitTimeMillis", &hostInfo);
             }
         }
     }
@@ -102,6 +138,8 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             hostInfo.appendNumber("available", hostStats.available);
             hostInfo.appendNumber("created", hostStats.created);
             hostInfo.appendNumber("refreshing", hostStats.refreshing);
+            hostStats.queueDepth.appendToBSON("queueDepth", &hostInfo);
+            hostStats.waitTimeMillis.appendToBSON("waitTimeMillis", &hostInfo);
         }
     }
 }
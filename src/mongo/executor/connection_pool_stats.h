@@ -28,12 +28,39 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+
+#include "mongo/base/string_data.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
+
+class BSONObjBuilder;
+
 namespace executor {
 
+/**
+ * Counts values in buckets bounded by powers of two. The first bucket counts zeros, bucket i counts
+ * values in [2^(i-1), 2^i), and the last bucket also counts every larger value.
+ */
+struct ConnectionPoolHistogram {
+    static const size_t kNumBuckets = 20;
+
+    void increment(uint64_t value);
+
+    ConnectionPoolHistogram& operator+=(const ConnectionPoolHistogram& other);
+
+    /**
+     * Appends a subobject called 'name' mapping the lower bound of each non-empty bucket to its
+     * count.
+     */
+    void appendToBSON(StringData name, BSONObjBuilder* builder) const;
+
+    std::array<uint64_t, kNumBuckets> buckets{};
+};
+
 /**
  * Holds connection information for a specific pool or remote host. These objects are maintained by
  * a parent ConnectionPoolStats object and should not need to be created directly.
@@ -49,6 +76,12 @@ struct ConnectionStatsPer {
     size_t available = 0u;
     size_t created = 0u;
     size_t refreshing = 0u;
+
+    // The number of requests already waiting when each request for a connection arrived.
+    ConnectionPoolHistogram queueDepth;
+
+    // The time each request that was given a connection waited for it.
+    ConnectionPoolHistogram waitTimeMillis;
 };
 
 /**
@@ -34,6 +34,7 @@
 #include "mongo/executor/connection_pool_test_fixture.h"
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -1376,6 +1377,70 @@ TEST_F(ConnectionPoolTest, DropConnectionsByTagInMultipleViaManager) {
     dropConnectionsByTagTest(pool, manager);
 }
 
+/**
+ * Verify that the pool reports how many requests were already waiting as each request arrived, and
+ * how long requests waited for a connection.
+ */
+TEST_F(ConnectionPoolTest, QueueDepthAndWaitTimeAreReported) {
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool");
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    std::vector<ConnectionPool::ConnectionHandle> connections;
+    const auto guard = MakeGuard([&] {
+        for (auto&& conn : connections) {
+            doneWith(conn);
+        }
+        connections.clear();
+    });
+
+    // Queue up two requests behind connections which take 10ms to set up.
+    for (size_t i = 0; i != 2; ++i) {
+        pool.get(HostAndPort(),
+                 Milliseconds(5000),
+                 [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                     ASSERT(swConn.isOK());
+                     connections.push_back(std::move(swConn.getValue()));
+                 });
+    }
+    ASSERT(connections.empty());
+
+    PoolImpl::setNow(now + Milliseconds(10));
+    ConnectionImpl::pushSetup(Status::OK());
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT_EQ(connections.size(), 2ul);
+
+    // Return the connections, so that the next request is handed a ready connection immediately.
+    for (auto&& conn : connections) {
+        doneWith(conn);
+    }
+    connections.clear();
+
+    bool reached = false;
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 reached = true;
+                 doneWith(swConn.getValue());
+             });
+    ASSERT(reached);
+
+    ConnectionPoolStats stats;
+    pool.appendConnectionStats(&stats);
+    const auto& hostStats = stats.statsByHost[HostAndPort()];
+
+    // The first and third requests found no one waiting, and the second found one request waiting.
+    ASSERT_EQ(hostStats.queueDepth.buckets[0], 2ul);
+    ASSERT_EQ(hostStats.queueDepth.buckets[1], 1ul);
+
+    // The first two requests waited 10ms, which is counted in the bucket starting at 8ms, and the
+    // third did not wait.
+    ASSERT_EQ(hostStats.waitTimeMillis.buckets[0], 1ul);
+    ASSERT_EQ(hostStats.waitTimeMillis.buckets[4], 2ul);
+}
+
 }  // namespace connection_pool_test_details
 }  // namespace executor
 }  // namespace mongo
@@ -0,0 +1,205 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_log_buffer.h"
+
+#include <algorithm>
+
+#include "mongo/logger/rotatable_file_writer.h"
+#include "mongo/util/concurrency/thread_name.h"
+
+namespace mongo {
+namespace logger {
+
+namespace {
+
+// Threads are assigned shards in the order in which they first log.
+AtomicUInt32 nextShard;
+thread_local std::size_t threadShard = nextShard.fetchAndAdd(1);
+
+}  // namespace
+
+const size_t AsyncLogBuffer::kNumShards;
+
+AsyncLogBuffer::AsyncLogBuffer(RotatableFileWriter* writer, Options options, Stats* stats)
+    : _writer(writer), _options(std::move(options)), _stats(stats) {
+    const size_t shardCapacity = std::max<size_t>(1, _options.capacity / kNumShards);
+    for (size_t i = 0; i < kNumShards; i++) {
+        _shards.push_back(std::make_unique<Shard>());
+        _shards.back()->ring.resize(shardCapacity);
+    }
+
+    _thread = stdx::thread([this] { _writerThread(); });
+}
+
+AsyncLogBuffer::~AsyncLogBuffer() {
+    shutdown();
+}
+
+bool AsyncLogBuffer::push(std::string line) {
+    Shard& shard = *_shards[threadShard % kNumShards];
+    stdx::unique_lock<stdx::mutex> lk(shard.mutex);
+
+    if (shard.size == shard.ring.size() && !shard.closed) {
+        if (_options.fullPolicy == FullPolicy::kDrop) {
+            _stats->dropped.increment();
+            return false;
+        }
+
+        // The shard's lines are counted in '_numPending', so the writer thread is awake and will
+        // make room.
+        _stats->blocked.increment();
+        shard.spaceAvailable.wait(
+            lk, [&] { return shard.size < shard.ring.size() || shard.closed; });
+    }
+
+    if (shard.closed) {
+        lk.unlock();
+        pushAndFlush(line).ignore();
+        return true;
+    }
+
+    Entry& entry = shard.ring[(shard.begin + shard.size) % shard.ring.size()];
+    entry.sequence = _nextSequence.fetchAndAdd(1);
+    entry.line = std::move(line);
+    shard.size++;
+    const bool wakeWriter = _numPending.fetchAndAdd(1) == 0;
+    lk.unlock();
+
+    _stats->enqueued.increment();
+
+    if (wakeWriter) {
+        stdx::lock_guard<stdx::mutex> writerLock(_writerMutex);
+        _writerCondition.notify_one();
+    }
+    return true;
+}
+
+Status AsyncLogBuffer::pushAndFlush(StringData line) {
+    stdx::unique_lock<stdx::mutex> drainLock(_drainMutex);
+    return _drainAndWrite(drainLock, line);
+}
+
+void AsyncLogBuffer::flush() {
+    stdx::unique_lock<stdx::mutex> drainLock(_drainMutex);
+    _drainAndWrite(drainLock).ignore();
+}
+
+void AsyncLogBuffer::shutdown() {
+    {
+        stdx::lock_guard<stdx::mutex> writerLock(_writerMutex);
+        if (_inShutdown)
+            return;
+        _inShutdown = true;
+        _writerCondition.notify_one();
+    }
+
+    // Once a shard is closed, threads write their own lines, so the final flush below leaves
+    // nothing behind in the shards.
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lk(shard->mutex);
+        shard->closed = true;
+        shard->spaceAvailable.notify_all();
+    }
+
+    _thread.join();
+    flush();
+}
+
+void AsyncLogBuffer::_writerThread() {
+    setThreadName("AsyncLogWriter");
+
+    while (true) {
+        {
+            stdx::unique_lock<stdx::mutex> writerLock(_writerMutex);
+            _writerCondition.wait(writerLock,
+                                  [&] { return _numPending.load() > 0 || _inShutdown; });
+            if (_inShutdown)
+                return;
+        }
+
+        // There is nowhere to report a failure to write, and the next write will try again.
+        stdx::unique_lock<stdx::mutex> drainLock(_drainMutex);
+        _drainAndWrite(drainLock).ignore();
+    }
+}
+
+Status AsyncLogBuffer::_drainAndWrite(const stdx::unique_lock<stdx::mutex>& drainLock,
+                                      StringData lastLine) {
+    // Only drain the lines pushed before the drain started. A line is given its sequence number
+    // and queued under its shard's lock, so every line numbered below 'cutoff' is in its shard by
+    // the time the shard is visited. Lines pushed during the drain are left for the next one, so
+    // that a line pushed to a shard which was already visited is not written after a later line
+    // found in a shard which was not.
+    const uint64_t cutoff = _nextSequence.load();
+
+    std::vector<Entry> entries;
+    for (auto&& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lk(shard->mutex);
+        const bool wasFull = shard->size == shard->ring.size();
+        size_t numDrained = 0;
+        for (; shard->size > 0 && shard->ring[shard->begin].sequence < cutoff; shard->size--) {
+            entries.push_back(std::move(shard->ring[shard->begin]));
+            shard->begin = (shard->begin + 1) % shard->ring.size();
+            numDrained++;
+        }
+
+        if (numDrained == 0)
+            continue;
+
+        _numPending.subtractAndFetch(numDrained);
+        if (wasFull)
+            shard->spaceAvailable.notify_all();
+    }
+
+    if (entries.empty() && lastLine.empty())
+        return Status::OK();
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+        return lhs.sequence < rhs.sequence;
+    });
+
+    RotatableFileWriter::Use useWriter(_writer);
+    Status status = useWriter.status();
+    if (!status.isOK())
+        return status;
+
+    for (auto&& entry : entries) {
+        useWriter.stream() << entry.line;
+    }
+    useWriter.stream() << lastLine;
+    useWriter.stream().flush();
+
+    _stats->written.increment(entries.size() + (lastLine.empty() ? 0 : 1));
+    return useWriter.status();
+}
+
+}  // namespace logger
+}  // namespace mongo
@@ -0,0 +1,182 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/counter.h"
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+namespace logger {
+
+class RotatableFileWriter;
+
+/**
+ * A bounded buffer of encoded log lines, which a background thread writes to a
+ * RotatableFileWriter, so that threads logging to a slow file do not wait for it.
+ *
+ * The buffer is split into shards, each with its own lock and a ring of lines, and each thread
+ * pushes to the shard it was assigned when it first logged. The writer thread drains every shard
+ * and writes the lines it found in the order in which they were pushed. When a shard is full, the
+ * pushing thread either waits for the writer to drain it or drops its line, according to the
+ * FullPolicy.
+ *
+ * Lines pushed after shutdown() are written on the calling thread.
+ */
+class AsyncLogBuffer {
+    MONGO_DISALLOW_COPYING(AsyncLogBuffer);
+
+public:
+    static const size_t kNumShards = 16;
+
+    enum class FullPolicy {
+        // Wait for the writer to make room in the shard.
+        kBlock,
+
+        // Drop the line, and count it in Stats::dropped.
+        kDrop,
+    };
+
+    struct Options {
+        Options() {}
+
+        // The total number of lines the buffer can hold, divided evenly between the shards.
+        size_t capacity = 16 * 1024;
+
+        FullPolicy fullPolicy = FullPolicy::kBlock;
+    };
+
+    struct Stats {
+        // Lines pushed into the buffer.
+        Counter64 enqueued;
+
+        // Lines written to the file, either by the writer thread or by a flush.
+        Counter64 written;
+
+        // Lines dropped because their shard was full.
+        Counter64 dropped;
+
+        // Pushes which waited for room in a full shard.
+        Counter64 blocked;
+    };
+
+    /**
+     * Starts the writer thread. Neither "writer" nor "stats" is owned, and both must outlive the
+     * buffer.
+     */
+    AsyncLogBuffer(RotatableFileWriter* writer, Options options, Stats* stats);
+
+    ~AsyncLogBuffer();
+
+    /**
+     * Queues "line" to be written. Returns false if the line was dropped because the buffer was
+     * full.
+     */
+    bool push(std::string line);
+
+    /**
+     * Writes every queued line, and then "line", on the calling thread before returning. Used for
+     * messages which must reach the file even if the process is about to terminate.
+     */
+    Status pushAndFlush(StringData line);
+
+    /**
+     * Blocks until every line pushed before the call has been written.
+     */
+    void flush();
+
+    /**
+     * Writes every queued line and stops the writer thread. May be called more than once.
+     */
+    void shutdown();
+
+private:
+    struct Entry {
+        uint64_t sequence;
+        std::string line;
+    };
+
+    struct Shard {
+        stdx::mutex mutex;
+        stdx::condition_variable spaceAvailable;
+
+        // A ring of 'ring.size()' entries, of which 'size' entries starting at 'begin' are queued.
+        std::vector<Entry> ring;
+        size_t begin = 0;
+        size_t size = 0;
+
+        // Set by shutdown(), after which lines are written by the pushing thread.
+        bool closed = false;
+    };
+
+    void _writerThread();
+
+    /**
+     * Moves every line queued before the call out of the shards and writes them in the order they
+     * were pushed, followed by "lastLine" if it is not empty. Must be called with '_drainMutex'
+     * held.
+     */
+    Status _drainAndWrite(const stdx::unique_lock<stdx::mutex>& drainLock,
+                          StringData lastLine = StringData());
+
+    RotatableFileWriter* const _writer;
+    const Options _options;
+    Stats* const _stats;
+
+    std::vector<std::unique_ptr<Shard>> _shards;
+
+    // Orders lines pushed to different shards.
+    AtomicUInt64 _nextSequence;
+
+    // The number of lines pushed but not yet drained, only changed with a shard's mutex held. The
+    // pusher which raises it from zero wakes the writer thread.
+    AtomicInt64 _numPending;
+
+    // Held while draining the shards and writing what was drained, so that a flush() which
+    // acquires it knows that every line drained before it has been written.
+    stdx::mutex _drainMutex;
+
+    stdx::mutex _writerMutex;
+    stdx::condition_variable _writerCondition;
+    bool _inShutdown = false;
+
+    stdx::thread _thread;
+};
+
+}  // namespace logger
+}  // namespace mongo
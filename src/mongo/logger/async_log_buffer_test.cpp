@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mongo/logger/async_log_buffer.h"
+#include "mongo/logger/rotatable_file_writer.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
+
+namespace {
+using namespace mongo;
+using namespace mongo::logger;
+
+const std::string logFileName("LogTest_AsyncLogBuffer.txt");
+
+class AsyncLogBufferTest : public mongo::unittest::Test {
+public:
+    AsyncLogBufferTest() {
+        unlink(logFileName.c_str());
+        ASSERT_OK(RotatableFileWriter::Use(&_writer).setFileName(logFileName, false));
+    }
+
+    virtual ~AsyncLogBufferTest() {
+        unlink(logFileName.c_str());
+    }
+
+protected:
+    std::vector<std::string> readLines() {
+        std::vector<std::string> lines;
+        std::ifstream ifs(logFileName.c_str());
+        ASSERT_TRUE(ifs.is_open());
+        std::string line;
+        while (std::getline(ifs, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    RotatableFileWriter _writer;
+    AsyncLogBuffer::Stats _stats;
+};
+
+TEST_F(AsyncLogBufferTest, LinesAreWrittenInOrder) {
+    AsyncLogBuffer buffer(&_writer, AsyncLogBuffer::Options(), &_stats);
+
+    const int kNumLines = 1000;
+    for (int i = 0; i < kNumLines; i++) {
+        ASSERT_TRUE(buffer.push(str::stream() << "line " << i << "\n"));
+    }
+    buffer.flush();
+
+    auto lines = readLines();
+    ASSERT_EQUALS(lines.size(), static_cast<size_t>(kNumLines));
+    for (int i = 0; i < kNumLines; i++) {
+        ASSERT_EQUALS(lines[i], std::string(str::stream() << "line " << i));
+    }
+    ASSERT_EQUALS(_stats.enqueued.get(), kNumLines);
+    ASSERT_EQUALS(_stats.written.get(), kNumLines);
+    ASSERT_EQUALS(_stats.dropped.get(), 0);
+}
+
+TEST_F(AsyncLogBufferTest, PushAndFlushWritesQueuedLinesFirst) {
+    AsyncLogBuffer buffer(&_writer, AsyncLogBuffer::Options(), &_stats);
+
+    ASSERT_TRUE(buffer.push("first\n"));
+    ASSERT_OK(buffer.pushAndFlush("second\n"));
+
+    auto lines = readLines();
+    ASSERT_EQUALS(lines.size(), 2U);
+    ASSERT_EQUALS(lines[0], "first");
+    ASSERT_EQUALS(lines[1], "second");
+}
+
+TEST_F(AsyncLogBufferTest, LinesAreDroppedWhenFull) {
+    AsyncLogBuffer::Options options;
+    options.capacity = AsyncLogBuffer::kNumShards;
+    options.fullPolicy = AsyncLogBuffer::FullPolicy::kDrop;
+    AsyncLogBuffer buffer(&_writer, options, &_stats);
+
+    const int kNumLines = 10;
+    {
+        // While the file is in use, the writer thread can take at most one line out of this
+        // thread's shard, which holds one more.
+        RotatableFileWriter::Use useWriter(&_writer);
+        for (int i = 0; i < kNumLines; i++) {
+            buffer.push(str::stream() << "line " << i << "\n");
+        }
+    }
+    buffer.flush();
+
+    ASSERT_GTE(_stats.enqueued.get(), 1);
+    ASSERT_LTE(_stats.enqueued.get(), 2);
+    ASSERT_EQUALS(_stats.enqueued.get() + _stats.dropped.get(), kNumLines);
+    ASSERT_EQUALS(_stats.written.get(), _stats.enqueued.get());
+    ASSERT_EQUALS(readLines().size(), static_cast<size_t>(_stats.written.get()));
+}
+
+TEST_F(AsyncLogBufferTest, PushBlocksWhenFull) {
+    AsyncLogBuffer::Options options;
+    options.capacity = AsyncLogBuffer::kNumShards;
+    AsyncLogBuffer buffer(&_writer, options, &_stats);
+
+    const int kNumLines = 3;
+    stdx::thread pusher;
+    {
+        RotatableFileWriter::Use useWriter(&_writer);
+        pusher = stdx::thread([&] {
+            for (int i = 0; i < kNumLines; i++) {
+                ASSERT_TRUE(buffer.push(str::stream() << "line " << i << "\n"));
+            }
+        });
+
+        while (_stats.blocked.get() == 0) {
+            sleepmillis(1);
+        }
+    }
+    pusher.join();
+    buffer.flush();
+
+    auto lines = readLines();
+    ASSERT_EQUALS(lines.size(), static_cast<size_t>(kNumLines));
+    for (int i = 0; i < kNumLines; i++) {
+        ASSERT_EQUALS(lines[i], std::string(str::stream() << "line " << i));
+    }
+    ASSERT_EQUALS(_stats.dropped.get(), 0);
+}
+
+TEST_F(AsyncLogBufferTest, PushAfterShutdownWritesSynchronously) {
+    AsyncLogBuffer buffer(&_writer, AsyncLogBuffer::Options(), &_stats);
+
+    ASSERT_TRUE(buffer.push("before\n"));
+    buffer.shutdown();
+    ASSERT_TRUE(buffer.push("after\n"));
+
+    auto lines = readLines();
+    ASSERT_EQUALS(lines.size(), 2U);
+    ASSERT_EQUALS(lines[0], "before");
+    ASSERT_EQUALS(lines[1], "after");
+}
+
+}  // namespace
@@ -50,6 +50,7 @@ const char kValue[] = "value";
 const char kEnabled[] = "enabled";
 const char kStopped[] = "stopped";
 const char kMode[] = "mode";
+const char kPolicy[] = "policy";
 const char kActiveWindow[] = "activeWindow";
 const char kWaitForDelete[] = "_waitForDelete";
 
@@ -59,6 +60,8 @@ const NamespaceString kSettingsNamespace("config", "settings");
 
 const char BalancerSettingsType::kKey[] = "balancer";
 const char* BalancerSettingsType::kBalancerModes[] = {"full", "autoSplitOnly", "off"};
+const char* BalancerSettingsType::kBalancingPolicies[] = {
+    "chunkCount", "dataSize", "dataSizeAndOpRate"};
 
 const char ChunkSizeSettingsType::kKey[] = "chunksize";
 const uint64_t ChunkSizeSettingsType::kDefaultMaxChunkSizeBytes{64 * 1024 * 1024};
@@ -100,6 +103,11 @@ Status BalancerConfiguration::setBalancerMode(OperationContext* opCtx,
     return Status::OK();
 }
 
+BalancerSettingsType::BalancingPolicy BalancerConfiguration::getBalancingPolicy() const {
+    stdx::lock_guard<stdx::mutex> lk(_balancerSettingsMutex);
+    return _balancerSettings.getPolicy();
+}
+
 bool BalancerConfiguration::shouldBalance() const {
     stdx::lock_guard<stdx::mutex> lk(_balancerSettingsMutex);
     if (_balancerSettings.getMode() == BalancerSettingsType::kOff ||
@@ -257,6 +265,21 @@ StatusWith<BalancerSettingsType> BalancerSettingsType::fromBSON(const BSONObj& o
         }
     }
 
+    {
+        std::string policyStr;
+        Status status = bsonExtractStringFieldWithDefault(
+            obj, kPolicy, kBalancingPolicies[kChunkCount], &policyStr);
+        if (!status.isOK())
+            return status;
+        auto it =
+            std::find(std::begin(kBalancingPolicies), std::end(kBalancingPolicies), policyStr);
+        if (it == std::end(kBalancingPolicies)) {
+            return Status(ErrorCodes::BadValue, "Invalid balancing policy");
+        }
+
+        settings._policy = static_cast<BalancingPolicy>(it - std::begin(kBalancingPolicies));
+    }
+
     {
         BSONElement activeWindowElem;
         Status status = bsonExtractTypedField(obj, kActiveWindow, Object, &activeWindowElem);
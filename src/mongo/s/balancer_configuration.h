@@ -52,6 +52,7 @@ class StatusWith;
  * balancer: {
  *  stopped: <true|false>,
  *  mode: <full|autoSplitOnly|off>,         // Only consulted if "stopped" is missing or false
+ *  policy: <chunkCount|dataSize|dataSizeAndOpRate>,
  *  activeWindow: { start: "<HH:MM>", stop: "<HH:MM>" }
  * }
  */
@@ -64,12 +65,22 @@ public:
         kOff,            // Balancer is completely off
     };
 
+    // Supported balancing policies, which determine what the balancer evens out across shards
+    enum BalancingPolicy {
+        kChunkCount,         // Number of chunks of each collection
+        kDataSize,           // Data size of each collection on each shard
+        kDataSizeAndOpRate,  // Data size and operation rate of each collection, weighted equally
+    };
+
     // The key under which this setting is stored on the config server
     static const char kKey[];
 
     // String representation of the balancer modes
     static const char* kBalancerModes[];
 
+    // String representation of the balancing policies
+    static const char* kBalancingPolicies[];
+
     /**
      * Constructs a settings object with the default values. To be used when no balancer settings
      * have been specified.
@@ -88,6 +99,13 @@ public:
         return _mode;
     }
 
+    /**
+     * Returns what the balancer evens out across shards.
+     */
+    BalancingPolicy getPolicy() const {
+        return _policy;
+    }
+
     /**
      * Returns true if either 'now' is in the balancing window or if no balancing window exists.
      */
@@ -112,6 +130,8 @@ private:
 
     BalancerMode _mode{kFull};
 
+    BalancingPolicy _policy{kChunkCount};
+
     boost::optional<boost::posix_time::ptime> _activeWindowStart;
     boost::optional<boost::posix_time::ptime> _activeWindowStop;
 
@@ -216,6 +236,11 @@ public:
      */
     Status setBalancerMode(OperationContext* opCtx, BalancerSettingsType::BalancerMode mode);
 
+    /**
+     * Non-blocking method, which returns what the balancer evens out across shards.
+     */
+    BalancerSettingsType::BalancingPolicy getBalancingPolicy() const;
+
     /**
      * Returns whether balancing is allowed based on both the enabled state of the balancer and the
      * balancing window.
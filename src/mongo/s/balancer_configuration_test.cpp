@@ -204,6 +204,7 @@ TEST_F(BalancerConfigurationTestFixture, BalancerSettingsDocumentBalanceForAutoS
 TEST(BalancerSettingsType, Defaults) {
     BalancerSettingsType settings = assertGet(BalancerSettingsType::fromBSON(BSONObj()));
     ASSERT_EQ(BalancerSettingsType::kFull, settings.getMode());
+    ASSERT_EQ(BalancerSettingsType::kChunkCount, settings.getPolicy());
     ASSERT_EQ(MigrationSecondaryThrottleOptions::kDefault,
               settings.getSecondaryThrottle().getSecondaryThrottle());
     ASSERT(!settings.getSecondaryThrottle().isWriteConcernSpecified());
@@ -238,6 +239,29 @@ TEST(BalancerSettingsType, InvalidBalancerModeOption) {
                   .code());
 }
 
+TEST(BalancerSettingsType, AllValidBalancingPolicyOptions) {
+    ASSERT_EQ(BalancerSettingsType::kChunkCount,
+              assertGet(BalancerSettingsType::fromBSON(BSON("policy"
+                                                            << "chunkCount")))
+                  .getPolicy());
+    ASSERT_EQ(BalancerSettingsType::kDataSize,
+              assertGet(BalancerSettingsType::fromBSON(BSON("policy"
+                                                            << "dataSize")))
+                  .getPolicy());
+    ASSERT_EQ(BalancerSettingsType::kDataSizeAndOpRate,
+              assertGet(BalancerSettingsType::fromBSON(BSON("policy"
+                                                            << "dataSizeAndOpRate")))
+                  .getPolicy());
+}
+
+TEST(BalancerSettingsType, InvalidBalancingPolicyOption) {
+    ASSERT_EQ(ErrorCodes::BadValue,
+              BalancerSettingsType::fromBSON(BSON("policy"
+                                                  << "BAD"))
+                  .getStatus()
+                  .code());
+}
+
 TEST(BalancerSettingsType, BalancingWindowStartLessThanStop) {
     BalancerSettingsType settings =
         assertGet(BalancerSettingsType::fromBSON(BSON("activeWindow" << BSON("start"
@@ -32,6 +32,8 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <algorithm>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
@@ -48,6 +50,11 @@ namespace {
 // Used to generate sequence numbers to assign to each newly created RoutingTableHistory
 AtomicUInt32 nextCMSequenceNumber(0);
 
+// Bounds on the number of entries in each block of a ChunkInfoMap. A block which grows past the
+// maximum is split in two and a block which shrinks below the minimum is merged with a neighbour.
+const size_t kMaxChunkInfoMapBlockSize = 512;
+const size_t kMinChunkInfoMapBlockSize = 64;
+
 void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
     for (auto&& element : o) {
         uassert(ErrorCodes::ConflictingOperationInProgress,
@@ -66,8 +73,224 @@ std::string extractKeyStringInternal(const BSONObj& shardKeyValue, Ordering orde
     return {ks.getBuffer(), ks.getSize()};
 }
 
+/**
+ * Checks that the chunk at 'it' starts where the chunk before it ends and ends where the chunk
+ * after it starts, and that the first and last chunks cover MinKey and MaxKey.
+ */
+void checkChunkIsContiguousWithNeighbours(const ChunkInfoMap& chunkMap,
+                                          ChunkInfoMap::const_iterator it) {
+    const auto& chunk = it->second;
+
+    if (it == chunkMap.begin()) {
+        checkAllElementsAreOfType(MinKey, chunk->getMin());
+    } else {
+        const auto& prevMax = std::prev(it)->second->getMax();
+        uassert(ErrorCodes::ConflictingOperationInProgress,
+                str::stream() << "Gap or an overlap between ranges "
+                              << ChunkRange(chunk->getMin(), chunk->getMax()).toString()
+                              << " and "
+                              << prevMax,
+                SimpleBSONObjComparator::kInstance.evaluate(prevMax == chunk->getMin()));
+    }
+
+    if (std::next(it) == chunkMap.end()) {
+        checkAllElementsAreOfType(MaxKey, chunk->getMax());
+    } else {
+        const auto& nextMin = std::next(it)->second->getMin();
+        uassert(ErrorCodes::ConflictingOperationInProgress,
+                str::stream() << "Gap or an overlap between ranges "
+                              << ChunkRange(chunk->getMin(), chunk->getMax()).toString()
+                              << " and "
+                              << nextMin,
+                SimpleBSONObjComparator::kInstance.evaluate(chunk->getMax() == nextMin));
+    }
+}
+
 }  // namespace
 
+const ChunkInfoMap::value_type& ChunkInfoMap::const_iterator::operator*() const {
+    return (*_blocks)[_blockIdx]->entries[_pos];
+}
+
+ChunkInfoMap::const_iterator& ChunkInfoMap::const_iterator::operator++() {
+    if (++_pos == (*_blocks)[_blockIdx]->entries.size()) {
+        ++_blockIdx;
+        _pos = 0;
+    }
+    return *this;
+}
+
+ChunkInfoMap::const_iterator& ChunkInfoMap::const_iterator::operator--() {
+    if (_pos == 0) {
+        --_blockIdx;
+        _pos = (*_blocks)[_blockIdx]->entries.size();
+    }
+    --_pos;
+    return *this;
+}
+
+std::pair<size_t, size_t> ChunkInfoMap::_find(const std::string& key, bool inclusive) const {
+    const auto lessThanKey = [&](const value_type& entry) {
+        return inclusive ? entry.first < key : entry.first <= key;
+    };
+
+    // Find the first block whose last entry is not before 'key'. Blocks are never empty.
+    const auto blockIt = std::partition_point(
+        _blocks.begin(), _blocks.end(), [&](const std::shared_ptr<Block>& block) {
+            return lessThanKey(block->entries.back());
+        });
+    if (blockIt == _blocks.end()) {
+        return _blocks.empty() ? std::make_pair(size_t(0), size_t(0))
+                               : std::make_pair(_blocks.size() - 1, _blocks.back()->entries.size());
+    }
+
+    const auto& entries = (*blockIt)->entries;
+    const auto entryIt = std::partition_point(entries.begin(), entries.end(), lessThanKey);
+    return {blockIt - _blocks.begin(), entryIt - entries.begin()};
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::lower_bound(const std::string& key) const {
+    const auto pos = _find(key, true);
+    if (pos.first == _blocks.size() || pos.second == _blocks[pos.first]->entries.size()) {
+        return end();
+    }
+    return {&_blocks, pos.first, pos.second};
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::upper_bound(const std::string& key) const {
+    const auto pos = _find(key, false);
+    if (pos.first == _blocks.size() || pos.second == _blocks[pos.first]->entries.size()) {
+        return end();
+    }
+    return {&_blocks, pos.first, pos.second};
+}
+
+ChunkInfoMap::Block& ChunkInfoMap::_mutableBlock(size_t blockIdx) {
+    auto& block = _blocks[blockIdx];
+    if (block.use_count() != 1) {
+        block = std::make_shared<Block>(*block);
+    }
+    block->shardVersionsValid = false;
+    return *block;
+}
+
+void ChunkInfoMap::replaceRange(const std::string& minKey,
+                                const std::string& maxKey,
+                                std::shared_ptr<ChunkInfo> chunk) {
+    if (_blocks.empty()) {
+        _blocks.push_back(std::make_shared<Block>());
+        _blocks.back()->entries.emplace_back(maxKey, std::move(chunk));
+        _size = 1;
+        return;
+    }
+
+    // The entries to remove start at the first key after 'minKey' and end before the first key
+    // after 'maxKey'.
+    const auto low = _find(minKey, false);
+    const auto high = _find(maxKey, false);
+
+    auto& lowBlock = _mutableBlock(low.first).entries;
+    if (low.first == high.first) {
+        lowBlock.erase(lowBlock.begin() + low.second, lowBlock.begin() + high.second);
+        lowBlock.emplace(lowBlock.begin() + low.second, maxKey, std::move(chunk));
+        _size = _size - (high.second - low.second) + 1;
+    } else {
+        // The removed entries are the tail of the low block, all of the blocks in between and the
+        // head of the high block.
+        _size -= lowBlock.size() - low.second;
+        lowBlock.erase(lowBlock.begin() + low.second, lowBlock.end());
+        lowBlock.emplace_back(maxKey, std::move(chunk));
+        _size += 1;
+
+        for (size_t i = low.first + 1; i < high.first; ++i) {
+            _size -= _blocks[i]->entries.size();
+        }
+        _blocks.erase(_blocks.begin() + low.first + 1, _blocks.begin() + high.first);
+
+        const size_t highIdx = low.first + 1;
+        _size -= high.second;
+        if (high.second == _blocks[highIdx]->entries.size()) {
+            _blocks.erase(_blocks.begin() + highIdx);
+        } else if (high.second > 0) {
+            auto& highBlock = _mutableBlock(highIdx).entries;
+            highBlock.erase(highBlock.begin(), highBlock.begin() + high.second);
+            _rebalance(highIdx);
+        }
+    }
+
+    _rebalance(low.first);
+}
+
+void ChunkInfoMap::_rebalance(size_t blockIdx) {
+    if (blockIdx >= _blocks.size()) {
+        return;
+    }
+
+    auto& entries = _blocks[blockIdx]->entries;
+    if (entries.size() > kMaxChunkInfoMapBlockSize) {
+        auto second = std::make_shared<Block>();
+        const auto middle = entries.begin() + entries.size() / 2;
+        second->entries.assign(std::make_move_iterator(middle),
+                               std::make_move_iterator(entries.end()));
+        entries.erase(middle, entries.end());
+        _blocks.insert(_blocks.begin() + blockIdx + 1, std::move(second));
+        return;
+    }
+
+    if (entries.size() >= kMinChunkInfoMapBlockSize || _blocks.size() == 1) {
+        return;
+    }
+
+    // Merge the block into its neighbour, unless that would produce a block which needs to be
+    // split again.
+    const size_t firstIdx = (blockIdx + 1 < _blocks.size()) ? blockIdx : blockIdx - 1;
+    if (_blocks[firstIdx]->entries.size() + _blocks[firstIdx + 1]->entries.size() >
+        kMaxChunkInfoMapBlockSize) {
+        return;
+    }
+
+    auto& first = _mutableBlock(firstIdx).entries;
+    const auto& second = _blocks[firstIdx + 1]->entries;
+    first.insert(first.end(), second.begin(), second.end());
+    _blocks.erase(_blocks.begin() + firstIdx + 1);
+}
+
+void ChunkInfoMap::updateShardVersions() {
+    for (auto& block : _blocks) {
+        if (block->shardVersionsValid) {
+            continue;
+        }
+
+        // Only blocks which have been modified, and so are not shared, can be invalid.
+        invariant(block.use_count() == 1);
+
+        block->shardVersions.clear();
+        for (const auto& entry : block->entries) {
+            const auto& chunk = entry.second;
+            auto it = block->shardVersions.emplace(chunk->getShardIdAt(boost::none),
+                                                   chunk->getLastmod());
+            if (chunk->getLastmod() > it.first->second) {
+                it.first->second = chunk->getLastmod();
+            }
+        }
+        block->shardVersionsValid = true;
+    }
+}
+
+ShardVersionMap ChunkInfoMap::getShardVersions() const {
+    ShardVersionMap shardVersions;
+    for (const auto& block : _blocks) {
+        invariant(block->shardVersionsValid);
+        for (const auto& blockShardVersion : block->shardVersions) {
+            auto it = shardVersions.insert(blockShardVersion);
+            if (blockShardVersion.second > it.first->second) {
+                it.first->second = blockShardVersion.second;
+            }
+        }
+    }
+    return shardVersions;
+}
+
 RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
                                          boost::optional<UUID> uuid,
                                          KeyPattern shardKeyPattern,
@@ -83,8 +306,7 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
       _defaultCollator(std::move(defaultCollator)),
       _unique(unique),
       _chunkMap(std::move(chunkMap)),
-      _shardVersions(
-          _constructShardVersionMap(collectionVersion.epoch(), _chunkMap, _shardKeyOrdering)),
+      _shardVersions(_chunkMap.getShardVersions()),
       _collectionVersion(collectionVersion) {}
 
 Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj& collation) const {
@@ -397,90 +619,6 @@ std::string RoutingTableHistory::toString() const {
     return sb.str();
 }
 
-ShardVersionMap RoutingTableHistory::_constructShardVersionMap(const OID& epoch,
-                                                               const ChunkInfoMap& chunkMap,
-                                                               Ordering shardKeyOrdering) {
-    ShardVersionMap shardVersions;
-    ChunkInfoMap::const_iterator current = chunkMap.cbegin();
-
-    boost::optional<BSONObj> firstMin = boost::none;
-    boost::optional<BSONObj> lastMax = boost::none;
-
-    while (current != chunkMap.cend()) {
-        const auto& firstChunkInRange = current->second;
-
-        // Tracks the max shard version for the shard on which the current range will reside
-        auto shardVersionIt = shardVersions.find(firstChunkInRange->getShardIdAt(boost::none));
-        if (shardVersionIt == shardVersions.end()) {
-            shardVersionIt = shardVersions
-                                 .emplace(firstChunkInRange->getShardIdAt(boost::none),
-                                          ChunkVersion(0, 0, epoch))
-                                 .first;
-        }
-
-        auto& maxShardVersion = shardVersionIt->second;
-
-        current = std::find_if(
-            current,
-            chunkMap.cend(),
-            [&firstChunkInRange, &maxShardVersion](const ChunkInfoMap::value_type& chunkMapEntry) {
-                const auto& currentChunk = chunkMapEntry.second;
-
-                if (currentChunk->getShardIdAt(boost::none) !=
-                    firstChunkInRange->getShardIdAt(boost::none))
-                    return true;
-
-                if (currentChunk->getLastmod() > maxShardVersion)
-                    maxShardVersion = currentChunk->getLastmod();
-
-                return false;
-            });
-
-        const auto rangeLast = std::prev(current);
-
-        const BSONObj rangeMin = firstChunkInRange->getMin();
-        const BSONObj rangeMax = rangeLast->second->getMax();
-
-        if (lastMax) {
-            uassert(ErrorCodes::ConflictingOperationInProgress,
-                    str::stream()
-                        << "Metadata contains chunks with the same or out-of-order max value; "
-                           "expected "
-                        << lastMax.get()
-                        << " < "
-                        << rangeMax,
-                    SimpleBSONObjComparator::kInstance.evaluate(lastMax.get() < rangeMax));
-            // Make sure there are no gaps in the ranges
-            uassert(ErrorCodes::ConflictingOperationInProgress,
-                    str::stream() << "Gap or an overlap between ranges "
-                                  << ChunkRange(rangeMin, rangeMax).toString()
-                                  << " and "
-                                  << lastMax.get(),
-                    SimpleBSONObjComparator::kInstance.evaluate(lastMax.get() == rangeMin));
-        }
-
-        if (!firstMin)
-            firstMin = rangeMin;
-
-        lastMax = rangeMax;
-
-        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
-        // somewhere, which should have been caught at chunk load time
-        invariant(maxShardVersion.isSet());
-    }
-
-    if (!chunkMap.empty()) {
-        invariant(!shardVersions.empty());
-        invariant(firstMin.is_initialized());
-        invariant(lastMax.is_initialized());
-
-        checkAllElementsAreOfType(MinKey, firstMin.get());
-        checkAllElementsAreOfType(MaxKey, lastMax.get());
-    }
-
-    return shardVersions;
-}
-
 std::string RoutingTableHistory::_extractKeyString(const BSONObj& shardKeyValue) const {
     return extractKeyStringInternal(shardKeyValue, _shardKeyOrdering);
 }
@@ -507,7 +645,11 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
     const std::vector<ChunkType>& changedChunks) {
 
     const auto startingCollectionVersion = getVersion();
+
+    // Only the blocks of the map which the changes touch are copied.
     auto chunkMap = _chunkMap;
+    std::vector<std::pair<std::string, const ChunkInfo*>> insertedChunks;
+    insertedChunks.reserve(changedChunks.size());
 
     ChunkVersion collectionVersion = startingCollectionVersion;
     for (const auto& chunk : changedChunks) {
@@ -526,19 +668,12 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         const auto chunkMinKeyString = _extractKeyString(chunk.getMin());
         const auto chunkMaxKeyString = _extractKeyString(chunk.getMax());
 
-        // Returns the first chunk with a max key that is > min - implies that the chunk overlaps
-        // min
-        const auto low = chunkMap.upper_bound(chunkMinKeyString);
-
-        // Returns the first chunk with a max key that is > max - implies that the next chunk cannot
-        // not overlap max
-        const auto high = chunkMap.upper_bound(chunkMaxKeyString);
-
-        // Erase all chunks from the map, which overlap the chunk we got from the persistent store
-        chunkMap.erase(low, high);
-
-        // Insert only the chunk itself
-        chunkMap.insert(std::make_pair(chunkMaxKeyString, std::make_shared<ChunkInfo>(chunk)));
+        // Replace all chunks in the map which overlap the chunk we got from the persistent store,
+        // that is those from the first chunk with a max key > min, up to but excluding the first
+        // chunk with a max key > max, with the chunk itself
+        auto chunkInfo = std::make_shared<ChunkInfo>(chunk);
+        insertedChunks.emplace_back(chunkMaxKeyString, chunkInfo.get());
+        chunkMap.replaceRange(chunkMinKeyString, chunkMaxKeyString, std::move(chunkInfo));
     }
 
     // If at least one diff was applied, the metadata is correct, but it might not have changed so
@@ -552,6 +687,17 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         return shared_from_this();
     }
 
+    // Since the chunks which were not changed were contiguous before, it is sufficient to check
+    // that each changed chunk which is still present lines up with its neighbours.
+    for (const auto& inserted : insertedChunks) {
+        const auto it = chunkMap.lower_bound(inserted.first);
+        if (it != chunkMap.end() && it->second.get() == inserted.second) {
+            checkChunkIsContiguousWithNeighbours(chunkMap, it);
+        }
+    }
+
+    chunkMap.updateShardVersions();
+
     return std::shared_ptr<RoutingTableHistory>(
         new RoutingTableHistory(_nss,
                                 _uuid,
@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <iterator>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -49,12 +51,144 @@ struct QuerySolutionNode;
 class OperationContext;
 class ChunkManager;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkInfoMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
-
 // Map from a shard is to the max chunk version on that shard
 using ShardVersionMap = std::map<ShardId, ChunkVersion>;
 
+/**
+ * Ordered map from the max for each chunk to an entry describing the chunk.
+ *
+ * The entries are kept in sorted blocks of bounded size, which copies of the map share. Copying
+ * the map only copies the pointers to its blocks and modifying it only copies the blocks being
+ * modified, so a routing table produced by an incremental refresh shares all but a few blocks with
+ * the one it was produced from. Blocks are never modified once they are shared.
+ */
+class ChunkInfoMap {
+    struct Block;
+    using BlockVector = std::vector<std::shared_ptr<Block>>;
+
+public:
+    using value_type = std::pair<std::string, std::shared_ptr<ChunkInfo>>;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ChunkInfoMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const;
+        pointer operator->() const {
+            return &**this;
+        }
+
+        const_iterator& operator++();
+        const_iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+        const_iterator& operator--();
+        const_iterator operator--(int) {
+            auto result = *this;
+            --*this;
+            return result;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _blockIdx == other._blockIdx && _pos == other._pos;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class ChunkInfoMap;
+
+        const_iterator(const BlockVector* blocks, size_t blockIdx, size_t pos)
+            : _blocks(blocks), _blockIdx(blockIdx), _pos(pos) {}
+
+        const BlockVector* _blocks{nullptr};
+        size_t _blockIdx{0};
+        size_t _pos{0};
+    };
+
+    const_iterator begin() const {
+        return {&_blocks, 0, 0};
+    }
+    const_iterator end() const {
+        return {&_blocks, _blocks.size(), 0};
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    const_iterator cend() const {
+        return end();
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+    size_t size() const {
+        return _size;
+    }
+
+    const_iterator lower_bound(const std::string& key) const;
+    const_iterator upper_bound(const std::string& key) const;
+
+    /**
+     * Removes the entries with keys in the range (minKey, maxKey] and inserts 'chunk' with key
+     * 'maxKey' in their place.
+     */
+    void replaceRange(const std::string& minKey,
+                      const std::string& maxKey,
+                      std::shared_ptr<ChunkInfo> chunk);
+
+    /**
+     * Computes the maximum chunk version on each shard for the blocks modified since the last
+     * call. Must be called before the map is copied or getShardVersions() is called.
+     */
+    void updateShardVersions();
+
+    /**
+     * Returns the maximum chunk version on each shard which owns chunks in this map.
+     */
+    ShardVersionMap getShardVersions() const;
+
+private:
+    struct Block {
+        std::vector<value_type> entries;
+
+        // Maximum chunk version on each shard which owns chunks in 'entries'. Only valid when
+        // 'shardVersionsValid' is true.
+        ShardVersionMap shardVersions;
+        bool shardVersionsValid{false};
+    };
+
+    /**
+     * Returns the position of the first entry with a key greater than (or, if 'inclusive' is
+     * true, equal to) 'key', as a block index and an offset within that block. If there is no
+     * such entry, returns the position just past the last entry of the last block.
+     */
+    std::pair<size_t, size_t> _find(const std::string& key, bool inclusive) const;
+
+    /**
+     * Returns the block at 'blockIdx', first replacing it with a copy if another map shares it.
+     */
+    Block& _mutableBlock(size_t blockIdx);
+
+    /**
+     * Splits the block at 'blockIdx' if it has grown too large, or merges it with a neighbour if
+     * it has become too small. The block must not be shared.
+     */
+    void _rebalance(size_t blockIdx);
+
+    BlockVector _blocks;
+    size_t _size{0};
+};
+
 /**
  * In-memory representation of the routing table for a single sharded collection at various points
  * in time.
@@ -150,13 +284,6 @@ public:
 
 
 private:
-    /**
-     * Does a single pass over the chunkMap and constructs the ShardVersionMap object.
-     */
-    static ShardVersionMap _constructShardVersionMap(const OID& epoch,
-                                                     const ChunkInfoMap& chunkMap,
-                                                     Ordering shardKeyOrdering);
-
     RoutingTableHistory(NamespaceString nss,
                         boost::optional<UUID> uuid,
                         KeyPattern shardKeyPattern,
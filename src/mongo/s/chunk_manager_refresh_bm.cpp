@@ -120,7 +120,48 @@ void BM_IncrementalRefreshOfPessimalBalancedDistribution(benchmark::State& state
     }
 }
 
-BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)->Args({2, 50000});
+BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)
+    ->Args({2, 50000})
+    ->Args({2, 500000});
+
+void BM_IncrementalRefreshAfterSplits(benchmark::State& state) {
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+    const int nSplits = state.range(2);
+    auto cm = makeChunkManagerWithOptimalBalancedDistribution(nShards, nChunks);
+
+    // Split 'nSplits' chunks spread evenly across the key space in half, as a refresh after a
+    // round of auto-splits would see them.
+    auto postSplitVersion = cm->getChunkManager()->getVersion();
+    const auto collName = NamespaceString(cm->getChunkManager()->getns());
+    std::vector<ChunkType> newChunks;
+    for (int i = 0; i < nSplits; ++i) {
+        const int chunkIdx = 1 + int64_t(i) * (nChunks - 2) / nSplits;
+        const auto range = getRangeForChunk(chunkIdx, nChunks);
+        const auto splitPoint = BSON("_id" << (chunkIdx - 1) * 100 + 50);
+        const auto shardId = optimalShardSelector(chunkIdx, nShards, nChunks);
+
+        postSplitVersion.incMinor();
+        newChunks.emplace_back(
+            collName, ChunkRange(range.getMin(), splitPoint), postSplitVersion, shardId);
+        postSplitVersion.incMinor();
+        newChunks.emplace_back(
+            collName, ChunkRange(splitPoint, range.getMax()), postSplitVersion, shardId);
+    }
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(runIncrementalUpdate(*cm, newChunks));
+    }
+
+    state.SetItemsProcessed(state.iterations() * newChunks.size());
+}
+
+BENCHMARK(BM_IncrementalRefreshAfterSplits)
+    ->Args({2, 50000, 1})
+    ->Args({2, 500000, 1})
+    ->Args({2, 500000, 100})
+    ->Args({100, 500000, 1})
+    ->Args({100, 500000, 100});
 
 template <typename ShardSelectorFn>
 auto BM_FullBuildOfChunkManager(benchmark::State& state, ShardSelectorFn selectShard) {
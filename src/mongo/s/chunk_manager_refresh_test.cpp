@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/s/chunk_manager.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+const KeyPattern kShardKeyPattern(BSON("x" << 1));
+
+// Enough chunks for the routing table to be split across many blocks.
+const int kNumChunks = 5000;
+
+ChunkRange getRangeForChunk(int i) {
+    const BSONObj min = (i == 0) ? BSON("x" << MINKEY) : BSON("x" << i * 10);
+    const BSONObj max = (i + 1 == kNumChunks) ? BSON("x" << MAXKEY) : BSON("x" << (i + 1) * 10);
+    return {min, max};
+}
+
+ShardId getShardForChunk(int i) {
+    return ShardId(str::stream() << "shard" << (i % 3));
+}
+
+class RoutingTableRefreshTest : public unittest::Test {
+protected:
+    void setUp() override {
+        _rt = RoutingTableHistory::makeNew(
+            kNss, UUID::gen(), kShardKeyPattern, nullptr, false, _epoch, initialChunks());
+    }
+
+    ChunkVersion nextVersion() {
+        auto version = _rt->getVersion();
+        version.incMajor();
+        return version;
+    }
+
+    static void assertChunksMatch(std::shared_ptr<RoutingTableHistory> rt,
+                                  const std::vector<ChunkType>& expected) {
+        ChunkManager cm(std::move(rt), boost::none);
+        ASSERT_EQ(expected.size(), size_t(cm.numChunks()));
+
+        auto expectedIt = expected.begin();
+        for (const auto& chunk : cm.chunks()) {
+            ASSERT_BSONOBJ_EQ(expectedIt->getMin(), chunk.getMin());
+            ASSERT_BSONOBJ_EQ(expectedIt->getMax(), chunk.getMax());
+            ASSERT_EQ(expectedIt->getShard(), chunk.getShardId());
+            ++expectedIt;
+        }
+    }
+
+    std::vector<ChunkType> initialChunks() const {
+        std::vector<ChunkType> chunks;
+        for (int i = 0; i < kNumChunks; ++i) {
+            chunks.emplace_back(
+                kNss, getRangeForChunk(i), ChunkVersion(i + 1, 0, _epoch), getShardForChunk(i));
+        }
+        return chunks;
+    }
+
+    const OID _epoch = OID::gen();
+    std::shared_ptr<RoutingTableHistory> _rt;
+};
+
+TEST_F(RoutingTableRefreshTest, FullLoad) {
+    assertChunksMatch(_rt, initialChunks());
+    ASSERT_EQ(ChunkVersion(kNumChunks, 0, _epoch), _rt->getVersion());
+    ASSERT_EQ(ChunkVersion(kNumChunks - 1, 0, _epoch), _rt->getVersion(ShardId("shard0")));
+    ASSERT_EQ(ChunkVersion(kNumChunks, 0, _epoch), _rt->getVersion(ShardId("shard1")));
+    ASSERT_EQ(ChunkVersion(kNumChunks - 2, 0, _epoch), _rt->getVersion(ShardId("shard2")));
+}
+
+TEST_F(RoutingTableRefreshTest, IncrementalSplitsLeavePreviousTableUnchanged) {
+    auto expected = initialChunks();
+
+    // Split every tenth chunk in two, which touches every block of the routing table.
+    std::vector<ChunkType> changedChunks;
+    auto version = nextVersion();
+    for (int i = kNumChunks - 10; i >= 0; i -= 10) {
+        const auto range = getRangeForChunk(i);
+        const auto splitPoint = BSON("x" << i * 10 + 5);
+
+        ChunkType left(kNss, {range.getMin(), splitPoint}, version, getShardForChunk(i));
+        version.incMinor();
+        ChunkType right(kNss, {splitPoint, range.getMax()}, version, getShardForChunk(i));
+        version.incMinor();
+
+        changedChunks.push_back(left);
+        changedChunks.push_back(right);
+        expected[i] = right;
+        expected.insert(expected.begin() + i, left);
+    }
+
+    auto updated = _rt->makeUpdated(changedChunks);
+    assertChunksMatch(updated, expected);
+    assertChunksMatch(_rt, initialChunks());
+
+    ChunkManager cm(updated, boost::none);
+    ASSERT_EQ(ShardId("shard0"),
+              cm.findIntersectingChunkWithSimpleCollation(BSON("x" << 1)).getShardId());
+    ASSERT_BSONOBJ_EQ(BSON("x" << 5),
+                      cm.findIntersectingChunkWithSimpleCollation(BSON("x" << 1)).getMax());
+    ASSERT_BSONOBJ_EQ(BSON("x" << 10),
+                      cm.findIntersectingChunkWithSimpleCollation(BSON("x" << 7)).getMax());
+}
+
+TEST_F(RoutingTableRefreshTest, IncrementalMergeAndMove) {
+    // Merge the chunks [1000, 3000) into one chunk on shard1, then move the first chunk to it.
+    const int firstMerged = 100;
+    const int lastMerged = 299;
+
+    auto version = nextVersion();
+    const ChunkRange mergedRange(getRangeForChunk(firstMerged).getMin(),
+                                 getRangeForChunk(lastMerged).getMax());
+    ChunkType merged(kNss, mergedRange, version, ShardId("shard1"));
+    version.incMajor();
+    ChunkType moved(kNss, getRangeForChunk(0), version, ShardId("shard1"));
+
+    auto updated = _rt->makeUpdated({merged, moved});
+
+    const auto initial = initialChunks();
+    std::vector<ChunkType> expected;
+    expected.push_back(moved);
+    for (int i = 1; i < kNumChunks; ++i) {
+        if (i == firstMerged) {
+            expected.push_back(merged);
+        } else if (i < firstMerged || i > lastMerged) {
+            expected.push_back(initial[i]);
+        }
+    }
+    assertChunksMatch(updated, expected);
+    ASSERT_EQ(version, updated->getVersion(ShardId("shard1")));
+    ASSERT_EQ(_rt->getVersion(ShardId("shard0")), updated->getVersion(ShardId("shard0")));
+}
+
+TEST_F(RoutingTableRefreshTest, IncrementalUpdateWithGapFails) {
+    // A chunk which only covers half of the chunk it replaces leaves a gap.
+    const auto range = getRangeForChunk(2500);
+    ChunkType shrunk(kNss, {range.getMin(), BSON("x" << 25005)}, nextVersion(), {"shard0"});
+
+    ASSERT_THROWS_CODE(
+        _rt->makeUpdated({shrunk}), DBException, ErrorCodes::ConflictingOperationInProgress);
+}
+
+}  // namespace
+}  // namespace mongo
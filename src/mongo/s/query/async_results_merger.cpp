@@ -38,6 +38,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/util/assert_util.h"
@@ -53,6 +54,10 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// The most sort key fields an Ordering can describe, and therefore the most for which sort keys
+// can be compared as KeyStrings.
+const int kMaxKeyStringSortKeyFields = 32;
+
 /**
  * Returns the sort key out of the $sortKey metadata field in 'obj'. This object is of the form
  * {'': 'firstSortKey', '': 'secondSortKey', ...}.
@@ -91,9 +96,9 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       _tailableMode(params.getTailableMode() ? *params.getTailableMode()
                                              : TailableModeEnum::kNormal),
       _params(std::move(params)),
-      _mergeQueue(MergingComparator(_remotes,
-                                    _params.getSort() ? *_params.getSort() : BSONObj(),
-                                    _params.getCompareWholeSortKey())) {
+      _useKeyStringSortKeys(_params.getSort() &&
+                            _params.getSort()->nFields() <= kMaxKeyStringSortKeyFields),
+      _sortKeyOrdering(Ordering::make(_useKeyStringSortKeys ? *_params.getSort() : BSONObj())) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
     }
@@ -179,6 +184,7 @@ void AsyncResultsMerger::addNewShardCursors(std::vector<RemoteCursor>&& newCurso
                               remote.getCursorResponse().getNSS(),
                               remote.getCursorResponse().getCursorId());
     }
+    _mergeTreeNeedsRebuild = true;
 }
 
 bool AsyncResultsMerger::_ready(WithLock lk) {
@@ -219,13 +225,17 @@ bool AsyncResultsMerger::_readySorted(WithLock lk) {
     return true;
 }
 
-bool AsyncResultsMerger::_readySortedTailable(WithLock) {
-    if (_mergeQueue.empty()) {
+bool AsyncResultsMerger::_readySortedTailable(WithLock lk) {
+    if (_remotes.empty()) {
+        return false;
+    }
+
+    auto smallestRemote = _mergeTreeWinner(lk);
+    if (!_remotes[smallestRemote].hasNext()) {
         return false;
     }
 
-    auto smallestRemote = _mergeQueue.top();
-    auto smallestResult = _remotes[smallestRemote].docBuffer.front();
+    const auto& smallestResult = _remotes[smallestRemote].docBuffer.front();
     auto keyWeWantToReturn =
         extractSortKey(*smallestResult.getResult(), _params.getCompareWholeSortKey());
     for (const auto& remote : _remotes) {
@@ -258,9 +268,58 @@ bool AsyncResultsMerger::_readyUnsorted(WithLock) {
     return allExhausted;
 }
 
+bool AsyncResultsMerger::_readyAfterNextReady(WithLock lk) {
+    if (_eofNext) {
+        return true;
+    }
+
+    // Remote statuses and batches only change in callbacks, which cannot run while we hold the
+    // mutex, so only the remote which produced the last result can have become unready.
+    if (_params.getSort()) {
+        if (_tailableMode == TailableModeEnum::kNormal && _mergeTreeDirtyLeaf) {
+            const auto& remote = _remotes[*_mergeTreeDirtyLeaf];
+            return remote.hasNext() || remote.exhausted();
+        }
+    } else if (_gettingFromRemote < _remotes.size() && _remotes[_gettingFromRemote].hasNext()) {
+        return true;
+    }
+
+    return _ready(lk);
+}
+
 StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     dassert(_ready(lk));
+    return _nextReady(lk);
+}
+
+Status AsyncResultsMerger::nextReadyBatch(size_t maxResults,
+                                          std::deque<ClusterQueryResult>* results) {
+    invariant(maxResults > 0);
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    dassert(_ready(lk));
+
+    size_t numAppended = 0;
+    do {
+        auto next = _nextReady(lk);
+        if (!next.isOK()) {
+            // Hand back what has already been merged; the error is sticky, so the next call will
+            // report it.
+            return numAppended > 0 ? Status::OK() : next.getStatus();
+        }
+
+        const bool isEOF = next.getValue().isEOF();
+        results->push_back(std::move(next.getValue()));
+        ++numAppended;
+        if (isEOF) {
+            break;
+        }
+    } while (numAppended < maxResults && _readyAfterNextReady(lk));
+
+    return Status::OK();
+}
+
+StatusWith<ClusterQueryResult> AsyncResultsMerger::_nextReady(WithLock lk) {
     if (_lifecycleState != kAlive) {
         return Status(ErrorCodes::IllegalOperation, "AsyncResultsMerger killed");
     }
@@ -277,29 +336,34 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
-    if (_mergeQueue.empty()) {
+    if (_remotes.empty()) {
         return {};
     }
 
-    size_t smallestRemote = _mergeQueue.top();
-    _mergeQueue.pop();
-
-    invariant(!_remotes[smallestRemote].docBuffer.empty());
-    invariant(_remotes[smallestRemote].status.isOK());
+    // Remotes without buffered results lose every match, so if the winner has nothing buffered
+    // then no remote does.
+    size_t smallestRemote = _mergeTreeWinner(lk);
+    auto& remote = _remotes[smallestRemote];
+    if (!remote.hasNext()) {
+        return {};
+    }
 
-    ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
-    _remotes[smallestRemote].docBuffer.pop();
+    invariant(remote.status.isOK());
 
-    // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
-    // next result.
-    if (!_remotes[smallestRemote].docBuffer.empty()) {
-        _mergeQueue.push(smallestRemote);
+    ClusterQueryResult front = std::move(remote.docBuffer.front());
+    remote.docBuffer.pop();
+    if (_useKeyStringSortKeys) {
+        remote.sortKeyBuffer.pop();
     }
 
+    // The leaf for 'smallestRemote' is replayed with its next result before the winner is needed
+    // again.
+    _mergeTreeDirtyLeaf = smallestRemote;
+
     return front;
 }
 
@@ -569,7 +633,10 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         // Clear the results buffer and cursor id.
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        std::queue<std::string> emptySortKeyBuffer;
+        std::swap(remote.sortKeyBuffer, emptySortKeyBuffer);
         remote.cursorId = 0;
+        _mergeTreeNeedsRebuild = true;
     }
 }
 
@@ -620,6 +687,8 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            const CursorResponse& response) {
     auto& remote = _remotes[remoteIndex];
     updateRemoteMetadata(&remote, response);
+    const bool hadNext = remote.hasNext();
+    KeyString sortKeyString(KeyString::Version::V1);
     for (const auto& obj : response.getBatch()) {
         // If there's a sort, we're expecting the remote node to have given us back a sort key.
         if (_params.getSort()) {
@@ -641,15 +710,24 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
             }
         }
 
+        // Encode the sort key once here, rather than extracting and comparing it as BSON every
+        // time the result plays a match in the merge.
+        if (_useKeyStringSortKeys) {
+            sortKeyString.resetToKey(extractSortKey(obj, _params.getCompareWholeSortKey()),
+                                     _sortKeyOrdering);
+            remote.sortKeyBuffer.emplace(sortKeyString.getBuffer(), sortKeyString.getSize());
+        }
+
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
         ++remote.fetchedCount;
     }
 
-    // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
-    // queue.
-    if (_params.getSort() && !response.getBatch().empty()) {
-        _mergeQueue.push(remoteIndex);
+    // If we're doing a sorted merge and this remote has a new front result, then its position in
+    // the merge tree has changed. The tree only needs rebuilding if this is not the leaf which is
+    // already due to be replayed.
+    if (_params.getSort() && !hadNext && remote.hasNext() && _mergeTreeDirtyLeaf != remoteIndex) {
+        _mergeTreeNeedsRebuild = true;
     }
     return true;
 }
@@ -757,16 +835,42 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
 }
 
 //
-// AsyncResultsMerger::MergingComparator
+// Sorted merge
 //
 
-bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
-    const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
-    const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
+bool AsyncResultsMerger::_remoteSortsBefore(size_t lhs, size_t rhs) const {
+    const auto& left = _remotes[lhs];
+    const auto& right = _remotes[rhs];
+    if (!left.hasNext() || !right.hasNext()) {
+        return left.hasNext() || (!right.hasNext() && lhs < rhs);
+    }
+
+    int cmp;
+    if (_useKeyStringSortKeys) {
+        // std::string compares bytewise as unsigned chars, which is the KeyString order.
+        cmp = left.sortKeyBuffer.front().compare(right.sortKeyBuffer.front());
+    } else {
+        const bool compareWholeSortKey = _params.getCompareWholeSortKey();
+        auto leftDoc = left.docBuffer.front().getResult();
+        auto rightDoc = right.docBuffer.front().getResult();
+        cmp = compareSortKeys(extractSortKey(*leftDoc, compareWholeSortKey),
+                              extractSortKey(*rightDoc, compareWholeSortKey),
+                              *_params.getSort());
+    }
+    return cmp < 0 || (cmp == 0 && lhs < rhs);
+}
 
-    return compareSortKeys(extractSortKey(*leftDoc.getResult(), _compareWholeSortKey),
-                           extractSortKey(*rightDoc.getResult(), _compareWholeSortKey),
-                           _sort) > 0;
+size_t AsyncResultsMerger::_mergeTreeWinner(WithLock) {
+    invariant(!_remotes.empty());
+    auto less = [this](size_t lhs, size_t rhs) { return _remoteSortsBefore(lhs, rhs); };
+    if (_mergeTreeNeedsRebuild) {
+        _mergeTree.build(_remotes.size(), less);
+        _mergeTreeNeedsRebuild = false;
+    } else if (_mergeTreeDirtyLeaf) {
+        _mergeTree.replay(*_mergeTreeDirtyLeaf, less);
+    }
+    _mergeTreeDirtyLeaf = boost::none;
+    return _mergeTree.winner();
 }
 
 void AsyncResultsMerger::blockingKill(OperationContext* opCtx) {
@@ -779,6 +883,25 @@ void AsyncResultsMerger::blockingKill(OperationContext* opCtx) {
 }
 
 StatusWith<ClusterQueryResult> AsyncResultsMerger::blockingNext() {
+    auto status = _blockUntilReady();
+    if (!status.isOK()) {
+        return status;
+    }
+
+    return nextReady();
+}
+
+Status AsyncResultsMerger::blockingNextBatch(size_t maxResults,
+                                             std::deque<ClusterQueryResult>* results) {
+    auto status = _blockUntilReady();
+    if (!status.isOK()) {
+        return status;
+    }
+
+    return nextReadyBatch(maxResults, results);
+}
+
+Status AsyncResultsMerger::_blockUntilReady() {
     while (!ready()) {
         auto nextEventStatus = nextEvent();
         if (!nextEventStatus.isOK()) {
@@ -798,7 +921,7 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::blockingNext() {
         invariant(status.getValue() == stdx::cv_status::no_timeout);
     }
 
-    return nextReady();
+    return Status::OK();
 }
 
 }  // namespace mongo
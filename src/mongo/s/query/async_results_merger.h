@@ -29,12 +29,15 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
@@ -172,6 +175,25 @@ public:
      */
     StatusWith<ClusterQueryResult> blockingNext();
 
+    /**
+     * Like nextReady(), but moves up to 'maxResults' results into 'results' while holding the
+     * mutex only once, for callers which drain the merged stream in bulk. Stops early once the next
+     * result is no longer ready, and after appending an end-of-stream (empty) ClusterQueryResult.
+     *
+     * If an error is encountered after some results have already been appended, those results are
+     * returned with an ok status and the error is reported by the next call. Returns the same
+     * errors as nextReady() if no result could be appended.
+     *
+     * Invalid to call unless ready() has returned true.
+     */
+    Status nextReadyBatch(size_t maxResults, std::deque<ClusterQueryResult>* results);
+
+    /**
+     * Blocks until at least one result is ready, all remote cursors are exhausted, or there is an
+     * error, and then behaves as nextReadyBatch().
+     */
+    Status blockingNextBatch(size_t maxResults, std::deque<ClusterQueryResult>* results);
+
     /**
      * Schedules remote work as required in order to make further results available. If there is an
      * error in scheduling this work, returns a non-ok status. On success, returns an event handle.
@@ -291,6 +313,10 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // The KeyString encodings of the sort keys of the results in 'docBuffer', in the same
+        // order. Populated only for sorted merges whose sort keys are compared as KeyStrings.
+        std::queue<std::string> sortKeyBuffer;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -303,24 +329,69 @@ private:
         long long fetchedCount = 0;
     };
 
-    class MergingComparator {
+    /**
+     * A tournament tree of losers over the indexes of '_remotes'. Each internal node remembers the
+     * remote which lost the match played there, and the overall winner is kept at the root. Once
+     * the front result of the winning remote has been consumed, the next winner is found by
+     * replaying only the matches on the path from that remote's leaf to the root, which takes
+     * log(N) comparisons instead of the 2*log(N) needed to pop and re-push a binary heap.
+     *
+     * The comparator 'less(lhs, rhs)' passed to build() and replay() must be a strict total order
+     * over the remote indexes.
+     */
+    class LoserTree {
     public:
-        MergingComparator(const std::vector<RemoteCursorData>& remotes,
-                          const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+        template <typename Less>
+        void build(size_t numLeaves, const Less& less) {
+            invariant(numLeaves > 0);
+            _numLeaves = numLeaves;
+            _nodes.assign(numLeaves, 0);
+
+            // Leaf 'i' lives at position 'numLeaves + i' of an implicit binary tree whose internal
+            // nodes are positions [1, numLeaves). Play every match bottom-up, recording the winner
+            // of each node in 'winners' and its loser in '_nodes'.
+            std::vector<size_t> winners(2 * numLeaves);
+            for (size_t i = 0; i < numLeaves; ++i) {
+                winners[numLeaves + i] = i;
+            }
+            for (size_t node = numLeaves - 1; node > 0; --node) {
+                size_t left = winners[2 * node];
+                size_t right = winners[2 * node + 1];
+                if (less(right, left)) {
+                    std::swap(left, right);
+                }
+                winners[node] = left;
+                _nodes[node] = right;
+            }
+            _nodes[0] = winners[1];
+        }
 
-        bool operator()(const size_t& lhs, const size_t& rhs);
+        /**
+         * Restores the tree after the sort position of 'leaf', which must be the current winner,
+         * has changed.
+         */
+        template <typename Less>
+        void replay(size_t leaf, const Less& less) {
+            invariant(leaf == winner());
+            size_t winner = leaf;
+            for (size_t node = (_numLeaves + leaf) / 2; node > 0; node /= 2) {
+                if (less(_nodes[node], winner)) {
+                    std::swap(_nodes[node], winner);
+                }
+            }
+            _nodes[0] = winner;
+        }
+
+        size_t winner() const {
+            return _nodes[0];
+        }
 
     private:
-        const std::vector<RemoteCursorData>& _remotes;
-
-        const BSONObj _sort;
+        size_t _numLeaves = 0;
 
-        // When '_compareWholeSortKey' is true, $sortKey is a scalar value, rather than an object.
-        // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
-        // be {$sortKey: 1}.
-        const bool _compareWholeSortKey;
+        // Position 0 holds the overall winner; every other position holds the loser of the match
+        // played at that internal node.
+        std::vector<size_t> _nodes;
     };
 
     enum LifecycleState { kAlive, kKillStarted, kKillComplete };
@@ -357,10 +428,17 @@ private:
     bool _readySortedTailable(WithLock);
     bool _readyUnsorted(WithLock);
 
+    /**
+     * Equivalent to _ready(), but cheaper when called right after _nextReady() has returned a
+     * result, since usually only the remote which produced that result needs to be checked.
+     */
+    bool _readyAfterNextReady(WithLock);
+
     //
     // Helpers for nextReady().
     //
 
+    StatusWith<ClusterQueryResult> _nextReady(WithLock);
     ClusterQueryResult _nextReadySorted(WithLock);
     ClusterQueryResult _nextReadyUnsorted(WithLock);
 
@@ -376,6 +454,19 @@ private:
      */
     void _handleBatchResponse(WithLock, CbData const&, size_t remoteIndex);
 
+    /**
+     * Returns true if the front result of the remote at 'lhs' sorts before that of the remote at
+     * 'rhs'. Remotes without buffered results sort after all others, and ties are broken by the
+     * remote index.
+     */
+    bool _remoteSortsBefore(size_t lhs, size_t rhs) const;
+
+    /**
+     * Brings '_mergeTree' up to date with the buffered results and returns the index of the remote
+     * whose front result sorts first. Invalid to call if there are no remotes.
+     */
+    size_t _mergeTreeWinner(WithLock);
+
     /**
      * Cleans up if the remote cursor was killed while waiting for a response.
      */
@@ -427,20 +518,42 @@ private:
      */
     void updateRemoteMetadata(RemoteCursorData* remote, const CursorResponse& response);
 
+    /**
+     * Schedules remote work and waits on it until ready() returns true. Returns a non-ok status if
+     * the work could not be scheduled or the wait was interrupted.
+     */
+    Status _blockUntilReady();
+
     OperationContext* _opCtx;
     executor::TaskExecutor* _executor;
     TailableModeEnum _tailableMode;
     AsyncResultsMergerParams _params;
 
+    // For sorted merges, the sort key of each result is encoded once as a KeyString when its batch
+    // arrives, so that the merge compares sort keys with memcmp rather than BSONObj::woCompare. An
+    // Ordering can describe at most 32 fields, so longer sort patterns fall back to comparing BSON.
+    const bool _useKeyStringSortKeys;
+    const Ordering _sortKeyOrdering;
+
     // Must be acquired before accessing any data members (other than _params, which is read-only).
     stdx::mutex _mutex;
 
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteCursorData> _remotes;
 
-    // The top of this priority queue is the index into '_remotes' for the remote host that has the
-    // next document to return, according to the sort order. Used only if there is a sort.
-    std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
+    // The winner of this tree is the index into '_remotes' for the remote host that has the next
+    // document to return, according to the sort order. Used only if there is a sort.
+    LoserTree _mergeTree;
+
+    // Set when results were buffered or discarded for a remote in a way that can change the order
+    // of the leaves other than through '_mergeTreeDirtyLeaf', such that the tree must be rebuilt
+    // before its winner can be trusted.
+    bool _mergeTreeNeedsRebuild = true;
+
+    // The remote whose front result was last returned from the sorted merge. Its leaf is replayed
+    // the next time the winner is needed rather than immediately, so that a remote which ran out of
+    // buffered results is usually replayed once with its next batch instead of forcing a rebuild.
+    boost::optional<size_t> _mergeTreeDirtyLeaf;
 
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
@@ -664,6 +664,112 @@ TEST_F(AsyncResultsMergerTest, SortedButNoSortKey) {
     executor()->waitForEvent(killEvent);
 }
 
+TEST_F(AsyncResultsMergerTest, SortedMergeAcrossManyRemotes) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: -1, b: 1}}");
+    const BSONObj sortPattern = fromjson("{a: -1, b: 1}");
+    const size_t kNumRemotes = 37;
+    const int kResultsPerRemote = 10;
+
+    std::vector<RemoteCursor> cursors;
+    std::vector<BSONObj> expected;
+    for (size_t i = 0; i < kNumRemotes; ++i) {
+        // Every remote returns its results in sort order. The types of the sort key values vary
+        // between remotes, so that the merge must order numbers of different types and values of
+        // different canonical types against each other.
+        std::vector<BSONObj> firstBatch;
+        for (int j = 0; j < kResultsPerRemote; ++j) {
+            const int a = kResultsPerRemote - j;
+            BSONObj sortKey;
+            if (i % 3 == 0) {
+                sortKey = BSON("" << a << "" << (i + 0.5));
+            } else if (i % 3 == 1) {
+                sortKey = BSON("" << static_cast<long long>(a) << ""
+                                  << ("str" + std::to_string(i)));
+            } else {
+                sortKey = BSON("" << static_cast<double>(a) << "" << BSONNULL);
+            }
+            firstBatch.push_back(BSON(AsyncResultsMerger::kSortKeyField << sortKey));
+            expected.push_back(firstBatch.back());
+        }
+        cursors.push_back(makeRemoteCursor(kTestShardIds[i % kTestShardIds.size()],
+                                           kTestShardHosts[i % kTestShardHosts.size()],
+                                           CursorResponse(kTestNss, 0, std::move(firstBatch))));
+    }
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    std::stable_sort(
+        expected.begin(), expected.end(), [&](const BSONObj& lhs, const BSONObj& rhs) {
+            const bool considerFieldName = false;
+            return lhs[AsyncResultsMerger::kSortKeyField].Obj().woCompare(
+                       rhs[AsyncResultsMerger::kSortKeyField].Obj(),
+                       sortPattern,
+                       considerFieldName) < 0;
+        });
+
+    // All remotes are exhausted and have buffered their results, so the ARM can return every result
+    // without scheduling any remote work.
+    for (const auto& expectedObj : expected) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(expectedObj, *unittest::assertGet(arm->nextReady()).getResult());
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, NextReadyBatchStopsWhenARemoteNeedsAnotherBatch) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    std::vector<BSONObj> firstBatch1 = {fromjson("{$sortKey: {'': 1}}"),
+                                        fromjson("{$sortKey: {'': 4}}")};
+    std::vector<BSONObj> firstBatch2 = {fromjson("{$sortKey: {'': 2}}"),
+                                        fromjson("{$sortKey: {'': 3}}"),
+                                        fromjson("{$sortKey: {'': 5}}")};
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, std::move(firstBatch1))));
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 0, std::move(firstBatch2))));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    // The batch is capped at the requested number of results.
+    ASSERT_TRUE(arm->ready());
+    std::deque<ClusterQueryResult> results;
+    ASSERT_OK(arm->nextReadyBatch(2, &results));
+    ASSERT_EQ(results.size(), 2u);
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 1}}"), *results[0].getResult());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 2}}"), *results[1].getResult());
+
+    // The batch ends once the first shard has no buffered results left, since the ARM cannot tell
+    // which result comes next until that shard has responded to a getMore.
+    results.clear();
+    ASSERT_TRUE(arm->ready());
+    ASSERT_OK(arm->nextReadyBatch(10, &results));
+    ASSERT_EQ(results.size(), 2u);
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 3}}"), *results[0].getResult());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 4}}"), *results[1].getResult());
+    ASSERT_FALSE(arm->ready());
+
+    // Schedule requests.
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_FALSE(arm->ready());
+
+    // First shard responds and closes its cursor.
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch = {fromjson("{$sortKey: {'': 6}}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch);
+    scheduleNetworkResponses(std::move(responses));
+    executor()->waitForEvent(readyEvent);
+
+    // The remaining results are returned in one batch, followed by EOF.
+    results.clear();
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(arm->remotesExhausted());
+    ASSERT_OK(arm->nextReadyBatch(10, &results));
+    ASSERT_EQ(results.size(), 3u);
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 5}}"), *results[0].getResult());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 6}}"), *results[1].getResult());
+    ASSERT_TRUE(results[2].isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, HasFirstBatch) {
     std::vector<BSONObj> firstBatch = {
         fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}")};
@@ -37,6 +37,13 @@
 
 namespace mongo {
 
+namespace {
+
+// The maximum number of merged results to take from the ARM at once.
+const size_t kMaxMergedResultsPerBatch = 128;
+
+}  // namespace
+
 RouterStageMerge::RouterStageMerge(OperationContext* opCtx,
                                    executor::TaskExecutor* executor,
                                    ClusterClientCursorParams* params)
@@ -48,9 +55,21 @@ RouterStageMerge::RouterStageMerge(OperationContext* opCtx,
 StatusWith<ClusterQueryResult> RouterStageMerge::next(ExecContext execCtx) {
     // Non-tailable and tailable non-awaitData cursors always block until ready(). AwaitData
     // cursors wait for ready() only until a specified time limit is exceeded.
-    return (_params->tailableMode == TailableModeEnum::kTailableAndAwaitData
-                ? awaitNextWithTimeout(execCtx)
-                : _arm.blockingNext());
+    if (_params->tailableMode == TailableModeEnum::kTailableAndAwaitData) {
+        return awaitNextWithTimeout(execCtx);
+    }
+
+    if (_mergedResults.empty()) {
+        auto status = _arm.blockingNextBatch(kMaxMergedResultsPerBatch, &_mergedResults);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    invariant(!_mergedResults.empty());
+    auto result = std::move(_mergedResults.front());
+    _mergedResults.pop_front();
+    return result;
 }
 
 StatusWith<ClusterQueryResult> RouterStageMerge::awaitNextWithTimeout(ExecContext execCtx) {
@@ -114,7 +133,7 @@ void RouterStageMerge::kill(OperationContext* opCtx) {
 }
 
 bool RouterStageMerge::remotesExhausted() {
-    return _arm.remotesExhausted();
+    return _mergedResults.empty() && _arm.remotesExhausted();
 }
 
 std::size_t RouterStageMerge::getNumRemotes() const {
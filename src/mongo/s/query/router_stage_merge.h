@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/async_results_merger.h"
 #include "mongo/s/query/cluster_client_cursor_params.h"
@@ -97,6 +99,11 @@ private:
 
     // Schedules remote work and merges results from 'remotes'.
     AsyncResultsMerger _arm;
+
+    // Results which have been merged by '_arm' but not yet returned from next(). Non-awaitData
+    // cursors take merged results from the ARM in batches, so that the ARM's mutex is acquired
+    // once per batch rather than once per result.
+    std::deque<ClusterQueryResult> _mergedResults;
 };
 
 }  // namespace mongo
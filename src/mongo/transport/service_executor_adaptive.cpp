@@ -79,6 +79,10 @@ MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorIdlePctThreshold, int, 60);
 // value.
 MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorRecursionLimit, int, 8);
 
+// When enabled, tasks scheduled from a worker thread are queued on that thread instead of on the
+// shared reactor queue, and idle workers steal them from busy ones.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(adaptiveServiceExecutorWorkStealing, bool, false);
+
 constexpr auto kTotalQueued = "totalQueued"_sd;
 constexpr auto kTotalExecuted = "totalExecuted"_sd;
 constexpr auto kTotalTimeExecutingUs = "totalTimeExecutingMicros"_sd;
@@ -93,6 +97,8 @@ constexpr auto kStuckDetection = "stuckThreadsDetected"_sd;
 constexpr auto kStarvation = "starvation"_sd;
 constexpr auto kReserveMinimum = "belowReserveMinimum"_sd;
 constexpr auto kThreadReasons = "threadCreationCauses"_sd;
+constexpr auto kTotalQueuedLocally = "totalQueuedLocally"_sd;
+constexpr auto kTotalStolen = "totalStolen"_sd;
 
 int64_t ticksToMicros(TickSource::Tick ticks, TickSource* tickSource) {
     invariant(tickSource->getTicksPerSecond() >= 1000000);
@@ -145,6 +151,10 @@ struct ServerParameterOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return adaptiveServiceExecutorRecursionLimit.load();
     }
+
+    bool workStealing() const final {
+        return adaptiveServiceExecutorWorkStealing;
+    }
 };
 
 }  // namespace
@@ -161,6 +171,7 @@ ServiceExecutorAdaptive::ServiceExecutorAdaptive(ServiceContext* ctx,
                                                  std::unique_ptr<Options> config)
     : _reactorHandle(reactor),
       _config(std::move(config)),
+      _workStealing(_config->workStealing()),
       _tickSource(ctx->getTickSource()),
       _lastScheduleTimer(_tickSource) {}
 
@@ -219,28 +230,37 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
         _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
             ._totalSpentQueued.addAndFetch(start - scheduleTime);
 
-        if (_localThreadState->recursionDepth++ == 0) {
-            _localThreadState->executing.markRunning();
-            _threadsInUse.addAndFetch(1);
-        }
-        const auto guard = MakeGuard([this, taskName] {
-            if (--_localThreadState->recursionDepth == 0) {
-                _localThreadState->executingCurRun += _localThreadState->executing.markStopped();
-                _threadsInUse.subtractAndFetch(1);
+        {
+            if (_localThreadState->recursionDepth++ == 0) {
+                _localThreadState->executing.markRunning();
+                _threadsInUse.addAndFetch(1);
             }
-            _totalExecuted.addAndFetch(1);
+            const auto guard = MakeGuard([this, taskName] {
+                if (--_localThreadState->recursionDepth == 0) {
+                    _localThreadState->executingCurRun +=
+                        _localThreadState->executing.markStopped();
+                    _threadsInUse.subtractAndFetch(1);
+                }
+                _totalExecuted.addAndFetch(1);
+                _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
+                    ._totalExecuted.addAndFetch(1);
+            });
+
+            TickTimer _localTimer(_tickSource);
+            task();
             _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
-                ._totalExecuted.addAndFetch(1);
-        });
+                ._totalSpentExecuting.addAndFetch(_localTimer.sinceStartTicks());
 
-        TickTimer _localTimer(_tickSource);
-        task();
-        _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
-            ._totalSpentExecuting.addAndFetch(_localTimer.sinceStartTicks());
+            if ((flags & ServiceExecutor::kMayYieldBeforeSchedule) &&
+                (_localThreadState->markIdleCounter++ & 0xf)) {
+                markThreadIdle();
+            }
+        }
 
-        if ((flags & ServiceExecutor::kMayYieldBeforeSchedule) &&
-            (_localThreadState->markIdleCounter++ & 0xf)) {
-            markThreadIdle();
+        // Once the outermost task on this thread's stack has completed, run the tasks it queued
+        // here before returning to the reactor.
+        if (_workStealing && _localThreadState->recursionDepth == 0) {
+            _runLocalTasks();
         }
     };
 
@@ -251,9 +271,18 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
     //
     // If the task is allowed to recurse and we are not over the depth limit, dispatch it so it
     // can be called immediately and recursively.
+    //
+    // In work-stealing mode, a task scheduled by another task running on a worker thread is queued
+    // on that worker thread instead, so that a session's work tends to stay on the same thread and
+    // does not contend on the reactor's queue.
     if ((flags & kMayRecurse) &&
         (_localThreadState->recursionDepth + 1 < _config->recursionLimit())) {
         _reactorHandle->schedule(Reactor::kDispatch, std::move(wrappedTask));
+    } else if (_workStealing && _localThreadState && _localThreadState->recursionDepth > 0) {
+        stdx::lock_guard<stdx::mutex> lk(_localThreadState->localTasksMutex);
+        _localThreadState->localTasks.push_back(std::move(wrappedTask));
+        _localTasksQueued.addAndFetch(1);
+        _totalQueuedLocally.addAndFetch(1);
     } else {
         _reactorHandle->schedule(Reactor::kPost, std::move(wrappedTask));
     }
@@ -361,6 +390,13 @@ void ServiceExecutorAdaptive::_controllerThreadRoutine() {
         if (!_isRunning.load())
             break;
 
+        // Tasks queued on a worker thread are only stolen by other workers when they finish a task
+        // of their own. If any are waiting, wake an idle worker through the reactor to steal them,
+        // in case the thread they are queued on is busy with a long-running task.
+        if (_workStealing && _localTasksQueued.load() > 0) {
+            _reactorHandle->schedule(Reactor::kPost, [this] { _runLocalTasks(); });
+        }
+
         if (sinceLastStuckThreadCheck.sinceStart() >= stuckThreadTimeout) {
             // Reset our timer so we know how long to sleep for the next time around;
             sinceLastStuckThreadCheck.reset();
@@ -503,6 +539,61 @@ Milliseconds ServiceExecutorAdaptive::_getThreadJitter() const {
     return Milliseconds{jitter};
 }
 
+void ServiceExecutorAdaptive::_runLocalTasks() {
+    auto state = _localThreadState;
+    if (state->runningLocalTasks)
+        return;
+
+    state->runningLocalTasks = true;
+    const auto guard = MakeGuard([state] { state->runningLocalTasks = false; });
+
+    while (true) {
+        auto task = _popLocalTask(state);
+        if (!task)
+            task = _stealLocalTask();
+        if (!task)
+            break;
+
+        task();
+    }
+}
+
+ServiceExecutor::Task ServiceExecutorAdaptive::_popLocalTask(ThreadState* state) {
+    stdx::lock_guard<stdx::mutex> lk(state->localTasksMutex);
+    if (state->localTasks.empty())
+        return nullptr;
+
+    auto task = std::move(state->localTasks.front());
+    state->localTasks.pop_front();
+    _localTasksQueued.subtractAndFetch(1);
+    return task;
+}
+
+ServiceExecutor::Task ServiceExecutorAdaptive::_stealLocalTask() {
+    // Avoid taking the threads mutex when there is nothing to steal, which is the common case when
+    // each worker keeps up with the tasks it queues.
+    if (_localTasksQueued.load() == 0)
+        return nullptr;
+
+    stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+    for (auto& thread : _threads) {
+        if (&thread == _localThreadState)
+            continue;
+
+        stdx::lock_guard<stdx::mutex> queueLk(thread.localTasksMutex);
+        if (thread.localTasks.empty())
+            continue;
+
+        auto task = std::move(thread.localTasks.front());
+        thread.localTasks.pop_front();
+        _localTasksQueued.subtractAndFetch(1);
+        _totalStolen.addAndFetch(1);
+        return task;
+    }
+
+    return nullptr;
+}
+
 void ServiceExecutorAdaptive::_accumulateTaskMetrics(MetricsArray* outArray,
                                                      const MetricsArray& inputArray) const {
     for (auto it = inputArray.begin(); it != inputArray.end(); ++it) {
@@ -569,6 +660,13 @@ void ServiceExecutorAdaptive::_workerThreadRoutine(
         _pastThreadsSpentExecuting.addAndFetch(state->executing.totalTime());
 
         _accumulateTaskMetrics(&_accumulatedMetrics, state->threadMetrics);
+
+        // Hand any tasks still queued on this thread back to the reactor so that they are not lost
+        // when it exits.
+        while (auto task = _popLocalTask(&(*state))) {
+            _reactorHandle->schedule(Reactor::kPost, std::move(task));
+        }
+
         {
             stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
             _threads.erase(state);
@@ -677,6 +775,11 @@ void ServiceExecutorAdaptive::appendStats(BSONObjBuilder* bob) const {
             << kThreadsRunning << _threadsRunning.load()                                      //
             << kThreadsPending << _threadsPending.load();
 
+    if (_workStealing) {
+        section << kTotalQueuedLocally << _totalQueuedLocally.load()  //
+                << kTotalStolen << _totalStolen.load();
+    }
+
     BSONObjBuilder threadStartReasons(section.subobjStart(kThreadReasons));
     for (size_t i = 0; i < _threadStartCounters.size(); i++) {
         threadStartReasons << _threadStartedByToString(static_cast<ThreadCreationReason>(i))
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <array>
+#include <deque>
 #include <vector>
 
 #include "mongo/db/service_context.h"
@@ -79,6 +80,13 @@ public:
         // The maximum allowable depth of recursion for tasks scheduled with the MayRecurse flag
         // before stack unwinding is forced.
         virtual int recursionLimit() const = 0;
+
+        // Whether tasks scheduled by a worker thread should be queued on that thread, to be run
+        // by it once its current task completes or stolen by another worker, rather than posted
+        // to the shared reactor queue.
+        virtual bool workStealing() const {
+            return false;
+        }
     };
 
     explicit ServiceExecutorAdaptive(ServiceContext* ctx, ReactorHandle reactor);
@@ -188,6 +196,12 @@ private:
         MetricsArray threadMetrics;
         std::int64_t markIdleCounter = 0;
         int recursionDepth = 0;
+
+        // Only used in work-stealing mode. Tasks scheduled by the tasks this thread has run, which
+        // it runs once the outermost task on its stack completes.
+        stdx::mutex localTasksMutex;
+        std::deque<Task> localTasks;
+        bool runningLocalTasks = false;
     };
 
     using ThreadList = stdx::list<ThreadState>;
@@ -199,6 +213,15 @@ private:
     bool _isStarved() const;
     Milliseconds _getThreadJitter() const;
 
+    /**
+     * Runs the tasks queued on the current worker thread, and then any tasks that can be stolen
+     * from other worker threads, until none remain. Does nothing if the current thread is already
+     * running its queued tasks further up the stack.
+     */
+    void _runLocalTasks();
+    Task _popLocalTask(ThreadState* state);
+    Task _stealLocalTask();
+
     void _accumulateTaskMetrics(MetricsArray* outArray, const MetricsArray& inputArray) const;
     void _accumulateAllTaskMetrics(MetricsArray* outputMetricsArray,
                                    const stdx::unique_lock<stdx::mutex>& lk) const;
@@ -208,6 +231,7 @@ private:
     ReactorHandle _reactorHandle;
 
     std::unique_ptr<Options> _config;
+    const bool _workStealing;
 
     mutable stdx::mutex _threadsMutex;
     ThreadList _threads;
@@ -224,6 +248,7 @@ private:
     AtomicWord<int> _threadsInUse{0};
     AtomicWord<int> _tasksQueued{0};
     AtomicWord<int> _deferredTasksQueued{0};
+    AtomicWord<int> _localTasksQueued{0};
     TickTimer _lastScheduleTimer;
     AtomicWord<TickSource::Tick> _pastThreadsSpentExecuting{0};
     AtomicWord<TickSource::Tick> _pastThreadsSpentRunning{0};
@@ -233,6 +258,8 @@ private:
     AtomicWord<int64_t> _totalQueued{0};
     AtomicWord<int64_t> _totalExecuted{0};
     AtomicWord<TickSource::Tick> _totalSpentQueued{0};
+    AtomicWord<int64_t> _totalQueuedLocally{0};
+    AtomicWord<int64_t> _totalStolen{0};
 
     // Threads signal this condition variable when they exit so we can gracefully shutdown
     // the executor.
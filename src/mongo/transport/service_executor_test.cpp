@@ -76,6 +76,40 @@ struct TestOptions : public ServiceExecutorAdaptive::Options {
     }
 };
 
+struct WorkStealingOptions : public ServiceExecutorAdaptive::Options {
+    int reservedThreads() const final {
+        return 2;
+    }
+
+    Milliseconds workerThreadRunTime() const final {
+        return Milliseconds{1000};
+    }
+
+    int runTimeJitter() const final {
+        return 0;
+    }
+
+    Milliseconds stuckThreadTimeout() const final {
+        return Milliseconds{100};
+    }
+
+    Microseconds maxQueueLatency() const final {
+        return duration_cast<Microseconds>(Milliseconds{5});
+    }
+
+    int idlePctThreshold() const final {
+        return 0;
+    }
+
+    int recursionLimit() const final {
+        return 0;
+    }
+
+    bool workStealing() const final {
+        return true;
+    }
+};
+
 /* This implements the portions of the transport::Reactor based on ASIO, but leaves out
  * the methods not needed by ServiceExecutors.
  *
@@ -149,6 +183,21 @@ protected:
     std::shared_ptr<asio::io_context> asioIOCtx;
 };
 
+class ServiceExecutorAdaptiveWorkStealingFixture : public unittest::Test {
+protected:
+    void setUp() override {
+        auto scOwned = stdx::make_unique<ServiceContextNoop>();
+        setGlobalServiceContext(std::move(scOwned));
+
+        executor = stdx::make_unique<ServiceExecutorAdaptive>(
+            getGlobalServiceContext(),
+            std::make_shared<ASIOReactor>(),
+            stdx::make_unique<WorkStealingOptions>());
+    }
+
+    std::unique_ptr<ServiceExecutorAdaptive> executor;
+};
+
 class ServiceExecutorSynchronousFixture : public unittest::Test {
 protected:
     void setUp() override {
@@ -191,6 +240,83 @@ TEST_F(ServiceExecutorAdaptiveFixture, ScheduleFailsBeforeStartup) {
     scheduleBasicTask(executor.get(), false);
 }
 
+TEST_F(ServiceExecutorAdaptiveWorkStealingFixture, BasicTaskRuns) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(Milliseconds{500})); });
+
+    scheduleBasicTask(executor.get(), true);
+}
+
+TEST_F(ServiceExecutorAdaptiveWorkStealingFixture, ScheduledTaskRunsOnSchedulingThread) {
+    ASSERT_OK(executor->start());
+    auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(Milliseconds{500})); });
+
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    boost::optional<stdx::thread::id> firstThread;
+    boost::optional<stdx::thread::id> secondThread;
+
+    auto secondTask = [&] {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        secondThread = stdx::this_thread::get_id();
+        cond.notify_all();
+    };
+    auto firstTask = [&] {
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            firstThread = stdx::this_thread::get_id();
+        }
+        ASSERT_OK(executor->schedule(secondTask,
+                                     ServiceExecutor::kEmptyFlags,
+                                     ServiceExecutorTaskName::kSSMProcessMessage));
+    };
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    ASSERT_OK(executor->schedule(
+        firstTask, ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMStartSession));
+    cond.wait(lk, [&] { return secondThread.is_initialized(); });
+    ASSERT_TRUE(firstThread == secondThread);
+}
+
+TEST_F(ServiceExecutorAdaptiveWorkStealingFixture, TaskQueuedBehindBlockedTaskIsStolen) {
+    ASSERT_OK(executor->start());
+
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    bool secondTaskRan = false;
+    bool releaseFirstTask = false;
+    auto guard = MakeGuard([&] {
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            releaseFirstTask = true;
+            cond.notify_all();
+        }
+        ASSERT_OK(executor->shutdown(Milliseconds{500}));
+    });
+
+    auto secondTask = [&] {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        secondTaskRan = true;
+        cond.notify_all();
+    };
+
+    // The first task queues the second task on its own thread and then blocks, so the second task
+    // can only run if another worker steals it.
+    auto firstTask = [&] {
+        ASSERT_OK(executor->schedule(secondTask,
+                                     ServiceExecutor::kEmptyFlags,
+                                     ServiceExecutorTaskName::kSSMProcessMessage));
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cond.wait(lk, [&] { return releaseFirstTask; });
+    };
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    ASSERT_OK(executor->schedule(
+        firstTask, ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMStartSession));
+    ASSERT_TRUE(cond.wait_for(
+        lk, Milliseconds{5000}.toSystemDuration(), [&] { return secondTaskRan; }));
+}
+
 TEST_F(ServiceExecutorSynchronousFixture, BasicTaskRuns) {
     ASSERT_OK(executor->start());
     auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(Milliseconds{500})); });
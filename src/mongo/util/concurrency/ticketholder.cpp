@@ -38,6 +38,31 @@
 
 namespace mongo {
 
+bool TicketHolder::waitForLowPriorityTicketUntil(OperationContext* opCtx,
+                                                 Date_t until,
+                                                 int reserved) {
+    const Milliseconds maxBackoff(10);
+    Milliseconds backoff(1);
+    while (true) {
+        // Another operation may take a ticket between these two calls, so the reserve is a target
+        // rather than a guarantee.
+        if (available() > reserved && tryAcquire()) {
+            return true;
+        }
+
+        const Date_t now = Date_t::now();
+        if (now >= until) {
+            return false;
+        }
+
+        sleepFor(std::min(backoff, until - now));
+        backoff = std::min(backoff * 2, maxBackoff);
+
+        if (opCtx)
+            opCtx->checkForInterrupt();
+    }
+}
+
 #if defined(__linux__)
 namespace {
 
@@ -122,6 +147,7 @@ bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
 }
 
 void TicketHolder::release() {
+    _numReleased.fetchAndAdd(1);
     check(sem_post(&_sem));
 }
 
@@ -139,7 +165,7 @@ Status TicketHolder::resize(int newSize) {
                                     << newSize);
 
     while (_outof.load() < newSize) {
-        release();
+        check(sem_post(&_sem));
         _outof.fetchAndAdd(1);
     }
 
@@ -200,6 +226,7 @@ bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
 }
 
 void TicketHolder::release() {
+    _numReleased.fetchAndAdd(1);
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
         _num++;
@@ -69,6 +69,15 @@ public:
     bool waitForTicketUntil(Date_t until) {
         return waitForTicketUntil(nullptr, until);
     }
+
+    /**
+     * Like waitForTicketUntil(), but only takes a ticket while more than 'reserved' tickets are
+     * available, leaving those for operations of normal priority. Waiting operations poll for
+     * tickets, backing off up to a few milliseconds, so this should only be used for operations,
+     * such as long running scans, which can tolerate a slower admission.
+     */
+    bool waitForLowPriorityTicketUntil(OperationContext* opCtx, Date_t until, int reserved);
+
     void release();
 
     Status resize(int newSize);
@@ -79,7 +88,17 @@ public:
 
     int outof() const;
 
+    /**
+     * Returns the number of tickets which have been released since this TicketHolder was
+     * created, which is a measure of the throughput of the operations it admits.
+     */
+    long long numReleased() const {
+        return _numReleased.load();
+    }
+
 private:
+    AtomicInt64 _numReleased;
+
 #if defined(__linux__)
     mutable sem_t _sem;
 
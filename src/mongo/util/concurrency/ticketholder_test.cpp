@@ -71,4 +71,27 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, LowPriorityLeavesReservedTickets) {
+    TicketHolder holder(5);
+    ASSERT(holder.waitForLowPriorityTicketUntil(nullptr, Date_t::now(), 3));
+    ASSERT(holder.waitForLowPriorityTicketUntil(nullptr, Date_t::now(), 3));
+    ASSERT_EQ(holder.available(), 3);
+
+    // The remaining tickets are reserved for operations of normal priority.
+    ASSERT_FALSE(holder.waitForLowPriorityTicketUntil(nullptr, Date_t::now(), 3));
+    ASSERT_FALSE(
+        holder.waitForLowPriorityTicketUntil(nullptr, Date_t::now() + Milliseconds(5), 3));
+    ASSERT(holder.waitForTicketUntil(Date_t::now()));
+    ASSERT_EQ(holder.available(), 2);
+
+    holder.release();
+    holder.release();
+    ASSERT(holder.waitForLowPriorityTicketUntil(nullptr, Date_t::now(), 3));
+    ASSERT_EQ(holder.numReleased(), 2);
+
+    holder.release();
+    holder.release();
+    ASSERT_EQ(holder.used(), 0);
+}
 }  // namespace